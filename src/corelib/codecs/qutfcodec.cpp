@@ -232,6 +232,295 @@ static inline bool simdDecodeAscii(ushort *, const uchar *, const uchar *, const
 }
 #endif
 
+#if QT_COMPILER_SUPPORTS_HERE(SSE4_2)
+// The functions below convert text mixing 1-, 2- and 3-byte UTF-8 sequences
+// (that is, everything in the BMP except surrogates). They stop at anything
+// else, including invalid input, and leave it to the scalar code.
+
+namespace {
+struct Utf8DecodeTable
+{
+    // Indexed by a bitmask of the first 8 input bytes that end a sequence.
+    // For each character, the shuffles place in one 16-bit lane its last
+    // two bytes (last) and the first byte of a 3-byte sequence (first).
+    struct Entry {
+        uchar last[16];
+        uchar first[16];
+        uchar bytes;
+        uchar chars;
+    } entries[256];
+
+    Utf8DecodeTable()
+    {
+        for (uint endMask = 0; endMask < 256; ++endMask) {
+            Entry &e = entries[endMask];
+            memset(e.last, 0x80, sizeof e.last);
+            memset(e.first, 0x80, sizeof e.first);
+            uint start = 0;
+            uint chars = 0;
+            for (uint i = 0; i < 8; ++i) {
+                if (!(endMask & (1U << i)))
+                    continue;
+                const uint len = i - start + 1;
+                if (len > 3)
+                    break;
+                e.last[2 * chars] = i;
+                if (len > 1)
+                    e.last[2 * chars + 1] = i - 1;
+                if (len > 2)
+                    e.first[2 * chars] = i - 2;
+                ++chars;
+                start = i + 1;
+            }
+            e.bytes = start;
+            e.chars = chars;
+        }
+    }
+};
+
+struct Utf8EncodeTable
+{
+    // The shuffles pack the bytes used in each lane. For 16-bit lanes,
+    // they are indexed by a bitmask of the eight characters that need two
+    // bytes. For 32-bit lanes, by a bitmask of the four characters that
+    // need more than one byte, ORed with the mask of those that need three
+    // bytes shifted by 4.
+    struct Entry {
+        uchar shuffle[16];
+        uchar bytes;
+    } lanes16[256], lanes32[256];
+
+    Utf8EncodeTable()
+    {
+        for (uint index = 0; index < 256; ++index) {
+            Entry &e = lanes16[index];
+            memset(e.shuffle, 0x80, sizeof e.shuffle);
+            uint bytes = 0;
+            for (uint i = 0; i < 8; ++i) {
+                e.shuffle[bytes++] = 2 * i;
+                if (index & (1U << i))
+                    e.shuffle[bytes++] = 2 * i + 1;
+            }
+            e.bytes = bytes;
+        }
+        for (uint index = 0; index < 256; ++index) {
+            Entry &e = lanes32[index];
+            memset(e.shuffle, 0x80, sizeof e.shuffle);
+            uint bytes = 0;
+            for (uint i = 0; i < 4; ++i) {
+                const uint len = 1 + ((index >> i) & 1) + ((index >> (i + 4)) & 1);
+                for (uint j = 0; j < len; ++j)
+                    e.shuffle[bytes++] = 4 * i + j;
+            }
+            e.bytes = bytes;
+        }
+    }
+};
+} // unnamed namespace
+
+// Decode the characters selected by a Utf8DecodeTable entry into 16-bit lanes
+QT_FUNCTION_TARGET(SSE4_2)
+static inline __m128i decodeUtf8Lanes(__m128i data, __m128i lastShuffle)
+{
+    // last two bytes: 110yyyyy 10xxxxxx, 10yyyyyy 10xxxxxx or 00000000 0xxxxxxx
+    const __m128i last = _mm_shuffle_epi8(data, lastShuffle);
+    const __m128i high = _mm_srli_epi16(_mm_and_si128(last, _mm_set1_epi16(0x3f00)), 2);
+    const __m128i lowMask = _mm_xor_si128(_mm_set1_epi16(0x7f),
+                                          _mm_srli_epi16(_mm_and_si128(last, _mm_set1_epi16(0x80)), 1));
+    return _mm_or_si128(high, _mm_and_si128(last, lowMask));
+}
+
+QT_FUNCTION_TARGET(SSE4_2)
+static inline __m128i decodeUtf8Lanes(__m128i data, __m128i lastShuffle, __m128i firstShuffle)
+{
+    // first byte of 3-byte sequences: 1110zzzz
+    const __m128i first = _mm_shuffle_epi8(data, firstShuffle);
+    const __m128i top = _mm_slli_epi16(_mm_and_si128(first, _mm_set1_epi16(0x0f)), 12);
+    return _mm_or_si128(decodeUtf8Lanes(data, lastShuffle), top);
+}
+
+QT_FUNCTION_TARGET(SSE4_2)
+static bool simdDecodeNonAscii_sse4(ushort *&dstRef, const uchar *&srcRef, const uchar *end)
+{
+    static const Utf8DecodeTable table;
+    // work on copies: the stores could alias the references
+    ushort *dst = dstRef;
+    const uchar *src = srcRef;
+
+    while (end - src >= 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const uint nonAscii = _mm_movemask_epi8(data);
+        if (!nonAscii && src != srcRef)
+            break;  // simdDecodeAscii() is faster for this
+
+        // continuation bytes are 0x80 to 0xbf (signed: less than -64)
+        const uint continuation = _mm_movemask_epi8(_mm_cmplt_epi8(data, _mm_set1_epi8(-64)));
+        const uint leads = ~continuation & 0xffff;
+
+        // Decode up to the last lead byte in 1 to 14, so that we know
+        // whether the last character decoded is complete. Computing this
+        // from the data alone keeps the table lookups out of the loop's
+        // dependency chain.
+        const uint candidates = leads & 0x7ffe;
+        if (!(leads & 1) || !candidates)
+            break;
+        const uint bytes = 31 - qCountLeadingZeroBits(candidates);
+        const uint decoded = (1U << bytes) - 1;
+
+        // leads of 2- and 3-byte sequences: 0xc0 and up, 0xe0 and up
+        const uint lead2 = _mm_movemask_epi8(_mm_cmpgt_epi8(data, _mm_set1_epi8(-65))) & nonAscii;
+        const uint lead3 = _mm_movemask_epi8(_mm_cmpgt_epi8(data, _mm_set1_epi8(-33))) & nonAscii;
+
+        // overlong 2-byte sequences (0xc0 and 0xc1) and, if there are 3-byte
+        // leads, 4-byte sequences (0xf0 and up), overlong 3-byte sequences
+        // (0xe0 followed by less than 0xa0) and surrogates (0xed followed by
+        // 0xa0 or more)
+        __m128i invalid = _mm_cmpeq_epi8(_mm_and_si128(data, _mm_set1_epi8(char(0xfe))),
+                                         _mm_set1_epi8(char(0xc0)));
+        if (lead3) {
+            const __m128i lead4 = _mm_cmpeq_epi8(_mm_max_epu8(data, _mm_set1_epi8(char(0xf0))), data);
+            const __m128i below0xa0 = _mm_cmplt_epi8(data, _mm_set1_epi8(char(0xa0)));
+            const __m128i e0 = _mm_slli_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(char(0xe0))), 1);
+            const __m128i ed = _mm_slli_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(char(0xed))), 1);
+            invalid = _mm_or_si128(_mm_or_si128(invalid, lead4),
+                                   _mm_or_si128(_mm_and_si128(below0xa0, e0), _mm_andnot_si128(below0xa0, ed)));
+        }
+
+        // Every lead must be followed by exactly as many continuation bytes
+        // as it announces, up to and including the byte after the last
+        // character.
+        const uint expectedContinuation = (lead2 << 1) | (lead3 << 2);
+        if (((expectedContinuation ^ continuation) & (decoded << 1 | 1))
+                | (_mm_movemask_epi8(invalid) & decoded)) {
+            break;
+        }
+
+        // The table covers 8 bytes: look up the rest of the window after
+        // the characters decoded by the first lookup. For valid input, the
+        // two cover at least 13 bytes. The 0x80 entries stay negative after
+        // the offset is added, so they still produce zeroes.
+        const Utf8DecodeTable::Entry &e1 = table.entries[(leads >> 1) & 0xff];
+        const Utf8DecodeTable::Entry &e2 = table.entries[(leads >> (e1.bytes + 1)) & 0xff];
+        const __m128i offset = _mm_set1_epi8(e1.bytes);
+        const __m128i last1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(e1.last));
+        const __m128i last2 = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(e2.last)), offset);
+        __m128i chars1, chars2;
+        if (lead3) {
+            const __m128i first1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(e1.first));
+            const __m128i first2 = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(e2.first)),
+                                                offset);
+            chars1 = decodeUtf8Lanes(data, last1, first1);
+            chars2 = decodeUtf8Lanes(data, last2, first2);
+        } else {
+            chars1 = decodeUtf8Lanes(data, last1);
+            chars2 = decodeUtf8Lanes(data, last2);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), chars1);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + e1.chars), chars2);
+
+        dst += qPopulationCount(leads & decoded);
+        src += bytes;
+    }
+    const bool converted = src != srcRef;
+    dstRef = dst;
+    srcRef = src;
+    return converted;
+}
+
+QT_FUNCTION_TARGET(SSE4_2)
+static bool simdEncodeNonAscii_sse4(uchar *&dstRef, const ushort *&srcRef, const ushort *end)
+{
+    static const Utf8EncodeTable table;
+    // work on copies: the stores could alias the references
+    uchar *dst = dstRef;
+    const ushort *src = srcRef;
+    const __m128i zero = _mm_setzero_si128();
+
+    // We encode eight characters at a time, which may produce 24 bytes, but
+    // the stores write up to 28: make sure the output buffer has room
+    while (end - src >= 12) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(data, _mm_set1_epi16(-0x80)), zero);
+        const uint asciiMask = _mm_movemask_epi8(_mm_packs_epi16(ascii, zero));
+        if (asciiMask == 0xff && src != srcRef)
+            break;  // simdEncodeAscii() is faster for this
+
+        const __m128i below0x800 = _mm_cmpeq_epi16(_mm_and_si128(data, _mm_set1_epi16(-0x800)), zero);
+        if (_mm_movemask_epi8(below0x800) == 0xffff) {
+            // 110yyyyy 10xxxxxx fits in the 16-bit lanes
+            const __m128i encoded2 = _mm_or_si128(_mm_or_si128(_mm_set1_epi16(0x80c0), _mm_srli_epi16(data, 6)),
+                                                  _mm_slli_epi16(_mm_and_si128(data, _mm_set1_epi16(0x3f)), 8));
+            const __m128i encoded = _mm_blendv_epi8(encoded2, data, ascii);
+            const Utf8EncodeTable::Entry &e = table.lanes16[~asciiMask & 0xff];
+            const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(e.shuffle));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(encoded, shuffle));
+            dst += e.bytes;
+            src += 8;
+            continue;
+        }
+
+        const __m128i surrogates = _mm_cmpeq_epi16(_mm_and_si128(data, _mm_set1_epi16(-0x800)),
+                                                   _mm_set1_epi16(-0x2800));
+        if (_mm_movemask_epi8(surrogates))
+            break;
+
+        for (int half = 0; half < 2; ++half) {
+            const __m128i u = half ? _mm_unpackhi_epi16(data, zero) : _mm_unpacklo_epi16(data, zero);
+            const __m128i oneByte = half ? _mm_unpackhi_epi16(ascii, ascii) : _mm_unpacklo_epi16(ascii, ascii);
+            const __m128i twoBytes = half ? _mm_unpackhi_epi16(below0x800, below0x800)
+                                          : _mm_unpacklo_epi16(below0x800, below0x800);
+
+            // 110yyyyy 10xxxxxx
+            const __m128i encoded2 = _mm_or_si128(_mm_or_si128(_mm_set1_epi32(0x80c0), _mm_srli_epi32(u, 6)),
+                                                  _mm_slli_epi32(_mm_and_si128(u, _mm_set1_epi32(0x3f)), 8));
+            // 1110zzzz 10yyyyyy 10xxxxxx
+            const __m128i encoded3 =
+                    _mm_or_si128(_mm_or_si128(_mm_set1_epi32(0x8080e0), _mm_srli_epi32(u, 12)),
+                                 _mm_or_si128(_mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(u, 6),
+                                                                           _mm_set1_epi32(0x3f)), 8),
+                                              _mm_slli_epi32(_mm_and_si128(u, _mm_set1_epi32(0x3f)), 16)));
+            const __m128i encoded = _mm_blendv_epi8(_mm_blendv_epi8(encoded3, encoded2, twoBytes),
+                                                    u, oneByte);
+
+            const uint index = (~_mm_movemask_ps(_mm_castsi128_ps(oneByte)) & 0xf)
+                    | (~_mm_movemask_ps(_mm_castsi128_ps(twoBytes)) & 0xf) << 4;
+            const Utf8EncodeTable::Entry &e = table.lanes32[index];
+            const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(e.shuffle));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(encoded, shuffle));
+            dst += e.bytes;
+        }
+        src += 8;
+    }
+    const bool converted = src != srcRef;
+    dstRef = dst;
+    srcRef = src;
+    return converted;
+}
+#endif
+
+// Returns true if it converted anything
+static inline bool simdDecodeNonAscii(ushort *&dst, const uchar *&src, const uchar *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(SSE4_2)
+    if (qCpuHasFeature(SSE4_2))
+        return simdDecodeNonAscii_sse4(dst, src, end);
+#else
+    Q_UNUSED(dst) Q_UNUSED(src) Q_UNUSED(end)
+#endif
+    return false;
+}
+
+static inline bool simdEncodeNonAscii(uchar *&dst, const ushort *&src, const ushort *end)
+{
+#if QT_COMPILER_SUPPORTS_HERE(SSE4_2)
+    if (qCpuHasFeature(SSE4_2))
+        return simdEncodeNonAscii_sse4(dst, src, end);
+#else
+    Q_UNUSED(dst) Q_UNUSED(src) Q_UNUSED(end)
+#endif
+    return false;
+}
+
 QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
 {
     // create a QByteArray with the worst case scenario size
@@ -244,6 +533,8 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len)
         const ushort *nextAscii = end;
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
+        if (simdEncodeNonAscii(dst, src, end))
+            continue;
 
         do {
             ushort uc = *src++;
@@ -296,8 +587,14 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len, QTextCodec::Conve
             surrogate_high = -1;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
         } else {
-            if (src >= nextAscii && simdEncodeAscii(cursor, nextAscii, src, end))
-                break;
+            if (src >= nextAscii) {
+                if (simdEncodeAscii(cursor, nextAscii, src, end))
+                    break;
+                if (simdEncodeNonAscii(cursor, src, end)) {
+                    nextAscii = src;
+                    continue;
+                }
+            }
 
             uc = *src++;
             res = QUtf8Functions::toUtf8<QUtf8BaseTraits>(uc, cursor, src, end);
@@ -387,6 +684,8 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, const char *chars, int len) Q_DECL
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
+            if (simdDecodeNonAscii(dst, src, end))
+                continue;
 
             do {
                 uchar b = *src++;
@@ -475,8 +774,15 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     const uchar *nextAscii = src;
     const uchar *start = src;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            if (simdDecodeAscii(dst, nextAscii, src, end))
+                break;
+            // the scalar code below takes care of the BOM
+            if (headerdone && simdDecodeNonAscii(dst, src, end)) {
+                nextAscii = src;
+                continue;
+            }
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
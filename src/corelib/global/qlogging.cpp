@@ -139,6 +139,14 @@ static QT_PREPEND_NAMESPACE(qint64) qt_gettid()
 #  include <cxxabi.h>
 #  include <execinfo.h>
 #endif
+
+#if !defined(QT_NO_THREAD) && defined(Q_COMPILER_THREAD_LOCAL)
+#  define QLOGGING_HAVE_ASYNC
+#  include "qvector.h"
+#  include "qwaitcondition.h"
+#  include "private/qthread_p.h"
+#  include <algorithm>
+#endif
 #endif // !QT_BOOTSTRAPPED
 
 #include <cstdlib>
@@ -1000,12 +1008,22 @@ struct QMessagePattern {
 
     bool fromEnvironment;
     static QBasicMutex mutex;
+
+    // what the pattern needs from the logging thread, readable without the mutex
+    enum Flag {
+        HasTime = 0x1,
+        HasThreadPointer = 0x2,
+        HasBacktrace = 0x4,
+        HasAppName = 0x8
+    };
+    static QBasicAtomicInt flags;
 };
 #ifdef QLOGGING_HAVE_BACKTRACE
 Q_DECLARE_TYPEINFO(QMessagePattern::BacktraceParams, Q_MOVABLE_TYPE);
 #endif
 
 QBasicMutex QMessagePattern::mutex;
+QBasicAtomicInt QMessagePattern::flags = Q_BASIC_ATOMIC_INITIALIZER(0);
 
 QMessagePattern::QMessagePattern()
     : literals(0)
@@ -1200,6 +1218,19 @@ void QMessagePattern::setPattern(const QString &pattern)
     literals = new const char*[literalsVar.size() + 1];
     literals[literalsVar.size()] = 0;
     memcpy(literals, literalsVar.constData(), literalsVar.size() * sizeof(const char*));
+
+    int patternFlags = 0;
+    for (int i = 0; tokens[i]; ++i) {
+        if (tokens[i] == timeTokenC)
+            patternFlags |= HasTime;
+        else if (tokens[i] == qthreadptrTokenC)
+            patternFlags |= HasThreadPointer;
+        else if (tokens[i] == backtraceTokenC)
+            patternFlags |= HasBacktrace;
+        else if (tokens[i] == appnameTokenC)
+            patternFlags |= HasAppName;
+    }
+    flags.store(patternFlags);
 }
 
 #if defined(QLOGGING_HAVE_BACKTRACE) && !defined(QT_BOOTSTRAPPED)
@@ -1339,6 +1370,20 @@ static void slog2_default_handler(QtMsgType msgType, const char *message)
 
 Q_GLOBAL_STATIC(QMessagePattern, qMessagePattern)
 
+// What formatting a message needs from the thread logging it, when the
+// message is formatted later on another thread.
+struct QMessageLogCapture
+{
+    qint64 threadId;
+    quintptr threadPointer;
+    qint64 msecsSinceReference;
+    qint64 msecsSinceEpoch;
+    QString appName;
+};
+
+static QString formatLogMessage(QtMsgType type, const QMessageLogContext &context, const QString &str,
+                                const QMessageLogCapture *capture);
+
 /*!
     \relates <QtGlobal>
     \since 5.4
@@ -1355,6 +1400,15 @@ Q_GLOBAL_STATIC(QMessagePattern, qMessagePattern)
  */
 QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, const QString &str)
 {
+    return formatLogMessage(type, context, str, 0);
+}
+
+static QString formatLogMessage(QtMsgType type, const QMessageLogContext &context, const QString &str,
+                                const QMessageLogCapture *capture)
+{
+#ifdef QT_BOOTSTRAPPED
+    Q_UNUSED(capture);
+#endif
     QString message;
 
     QMutexLocker lock(&QMessagePattern::mutex);
@@ -1419,13 +1473,16 @@ QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, con
         } else if (token == pidTokenC) {
             message.append(QString::number(QCoreApplication::applicationPid()));
         } else if (token == appnameTokenC) {
-            message.append(QCoreApplication::applicationName());
+            message.append(capture ? capture->appName : QCoreApplication::applicationName());
         } else if (token == threadidTokenC) {
             // print the TID as decimal
-            message.append(QString::number(qt_gettid()));
+            message.append(QString::number(capture ? capture->threadId : qt_gettid()));
         } else if (token == qthreadptrTokenC) {
             message.append(QLatin1String("0x"));
-            message.append(QString::number(qlonglong(QThread::currentThread()->currentThread()), 16));
+            if (capture)
+                message.append(QString::number(qlonglong(capture->threadPointer), 16));
+            else
+                message.append(QString::number(qlonglong(QThread::currentThread()->currentThread()), 16));
 #ifdef QLOGGING_HAVE_BACKTRACE
         } else if (token == backtraceTokenC) {
             QMessagePattern::BacktraceParams backtraceParams = pattern->backtraceArgs.at(backtraceArgsIdx);
@@ -1436,20 +1493,29 @@ QString qFormatLogMessage(QtMsgType type, const QMessageLogContext &context, con
             QString timeFormat = pattern->timeArgs.at(timeArgsIdx);
             timeArgsIdx++;
             if (timeFormat == QLatin1String("process")) {
-                    quint64 ms = pattern->timer.elapsed();
+                    quint64 ms = capture ? capture->msecsSinceReference - pattern->timer.msecsSinceReference()
+                                         : pattern->timer.elapsed();
                     message.append(QString::asprintf("%6d.%03d", uint(ms / 1000), uint(ms % 1000)));
             } else if (timeFormat ==  QLatin1String("boot")) {
                 // just print the milliseconds since the elapsed timer reference
                 // like the Linux kernel does
-                QElapsedTimer now;
-                now.start();
-                uint ms = now.msecsSinceReference();
+                uint ms;
+                if (capture) {
+                    ms = capture->msecsSinceReference;
+                } else {
+                    QElapsedTimer now;
+                    now.start();
+                    ms = now.msecsSinceReference();
+                }
                 message.append(QString::asprintf("%6d.%03d", uint(ms / 1000), uint(ms % 1000)));
 #if QT_CONFIG(datestring)
-            } else if (timeFormat.isEmpty()) {
-                    message.append(QDateTime::currentDateTime().toString(Qt::ISODate));
             } else {
-                message.append(QDateTime::currentDateTime().toString(timeFormat));
+                const QDateTime now = capture ? QDateTime::fromMSecsSinceEpoch(capture->msecsSinceEpoch)
+                                              : QDateTime::currentDateTime();
+                if (timeFormat.isEmpty())
+                    message.append(now.toString(Qt::ISODate));
+                else
+                    message.append(now.toString(timeFormat));
 #endif // QT_CONFIG(datestring)
             }
 #endif // !QT_BOOTSTRAPPED
@@ -1568,17 +1634,14 @@ static void android_default_message_handler(QtMsgType type,
 
 /*!
     \internal
+
+    Writes the formatted \a message to the platform's log, or to stderr.
 */
-static void qDefaultMessageHandler(QtMsgType type, const QMessageLogContext &context,
-                                   const QString &buf)
+static void qDefaultMessageOutput(QtMsgType type, const QMessageLogContext &context,
+                                  QString &logMessage)
 {
-    QString logMessage = qFormatLogMessage(type, context, buf);
-
-    // print nothing if message pattern didn't apply / was empty.
-    // (still print empty lines, e.g. because message itself was empty)
-    if (logMessage.isNull())
-        return;
-
+    Q_UNUSED(type);
+    Q_UNUSED(context);
     if (!qt_logging_to_console()) {
 #if defined(Q_OS_WIN)
         logMessage.append(QLatin1Char('\n'));
@@ -1603,6 +1666,447 @@ static void qDefaultMessageHandler(QtMsgType type, const QMessageLogContext &con
     fflush(stderr);
 }
 
+#ifdef QLOGGING_HAVE_ASYNC
+
+/*
+    Asynchronous output for the default message handler, enabled with the
+    QT_LOGGING_ASYNC environment variable.
+
+    Every thread that logs owns a single producer, single consumer ring of
+    records. A record holds the message and whatever the message pattern
+    needs from the logging thread, so the logging thread neither takes the
+    pattern's mutex nor waits for I/O. A daemon thread drains the rings,
+    restores the order in which the messages were logged, formats them
+    and writes them out. When a ring is full, the message is dropped and
+    counted, or the logging thread waits for the writer, depending on the
+    policy. Fatal messages and the exit of the process flush the rings.
+    Patterns with %{backtrace} are written on the logging thread.
+*/
+struct QAsyncLogRecord
+{
+    enum String {
+        Category,
+        File,
+        Function,
+        StringCount
+    };
+
+    QAsyncLogRecord()
+        : sequence(0), type(QtDebugMsg), line(0)
+    {
+        for (int i = 0; i < StringCount; ++i)
+            offsets[i] = -1;
+        capture.threadId = 0;
+        capture.threadPointer = 0;
+        capture.msecsSinceReference = 0;
+        capture.msecsSinceEpoch = 0;
+    }
+
+    // Copies the strings of the context, which can be gone by the time the
+    // record is written, such as the file and function of a QML message.
+    // The records of a ring keep their buffers, so that logging does not
+    // allocate once the strings fit.
+    void setStrings(const char *category, const char *file, const char *function)
+    {
+        const char *values[StringCount] = { category, file, function };
+        strings.resize(0);
+        for (int i = 0; i < StringCount; ++i) {
+            if (!values[i]) {
+                offsets[i] = -1;
+                continue;
+            }
+            offsets[i] = strings.size();
+            strings.append(values[i], int(strlen(values[i])) + 1);
+        }
+        if (!strings.isEmpty())
+            strings.reserve(strings.size()); // resize(0) keeps reserved capacity
+    }
+
+    const char *string(String which) const
+    {
+        return offsets[which] < 0 ? 0 : strings.constData() + offsets[which];
+    }
+
+    quint64 sequence;
+    QtMsgType type;
+    int line;
+    int offsets[StringCount];
+    QByteArray strings;
+    QString message;
+    QMessageLogCapture capture;
+};
+
+class QAsyncLogRing
+{
+public:
+    enum { Capacity = 1024 }; // a power of two
+
+    QAsyncLogRing() : next(0) {}
+
+    bool isEmpty() const { return head.loadAcquire() == tail.load(); }
+
+    QAsyncLogRecord records[Capacity];
+    QAtomicInteger<quint32> head; // written by the logging thread only
+    QAtomicInteger<quint32> tail; // written by the writer thread only
+    QAtomicInt dropped;
+    QAtomicInt inUse;
+    QAsyncLogRing *next;
+};
+
+class QAsyncLogger : public QDaemonThread
+{
+public:
+    enum Policy {
+        Block,
+        Drop
+    };
+
+    QAsyncLogger();
+    ~QAsyncLogger();
+
+    bool log(QtMsgType type, const QMessageLogContext &context, const QString &message);
+    void flush();
+
+    static bool isEnabled()
+    {
+        static const bool enabled = !qEnvironmentVariableIsEmpty("QT_LOGGING_ASYNC");
+        return enabled;
+    }
+
+protected:
+    void run() override;
+
+private:
+    QAsyncLogRing *ring();
+    void wake();
+    void wakeWaiting();
+    bool collect(QVector<QAsyncLogRecord> *batch, int *dropped);
+    void write(QVector<QAsyncLogRecord> *batch, int dropped, bool all);
+
+    QAtomicPointer<QAsyncLogRing> rings;
+    QAtomicInteger<quint64> sequence;
+    QAtomicInteger<quint64> written;
+    QAtomicInt sleeping;
+    QAtomicInt stopping;
+    QAtomicInt waiting;
+    QMutex mutex;
+    QWaitCondition wakeUp;
+    QWaitCondition progress; // the writer took records or wrote them
+    Policy policy;
+};
+
+Q_GLOBAL_STATIC(QAsyncLogger, asyncLogger)
+
+struct QAsyncLogThread
+{
+    QAsyncLogThread() : ring(0), threadId(qt_gettid()), threadPointer(0), isWriter(false) {}
+    ~QAsyncLogThread()
+    {
+        // hand the ring over to the next thread that logs
+        if (ring && !asyncLogger.isDestroyed())
+            ring->inUse.storeRelease(0);
+    }
+
+    QAsyncLogRing *ring;
+    qint64 threadId;
+    quintptr threadPointer;
+    bool isWriter;
+};
+
+static thread_local QAsyncLogThread asyncLogThread;
+
+QAsyncLogger::QAsyncLogger()
+    : policy(qgetenv("QT_LOGGING_ASYNC") == "drop" ? Drop : Block)
+{
+    // create the pattern and the state of the local codec first, so that
+    // they are still there when the last messages are written on exit
+    qMessagePattern();
+    (void)QString(QLatin1Char('\n')).toLocal8Bit();
+    setObjectName(QStringLiteral("Qt logging thread"));
+    start();
+}
+
+QAsyncLogger::~QAsyncLogger()
+{
+    stopping.storeRelease(1);
+    wake();
+    wakeWaiting();
+    wait();
+
+    QAsyncLogRing *r = rings.loadAcquire();
+    while (r) {
+        QAsyncLogRing *next = r->next;
+        delete r;
+        r = next;
+    }
+}
+
+QAsyncLogRing *QAsyncLogger::ring()
+{
+    QAsyncLogThread &thread = asyncLogThread;
+    if (thread.ring)
+        return thread.ring;
+
+    for (QAsyncLogRing *r = rings.loadAcquire(); r; r = r->next) {
+        if (r->inUse.testAndSetAcquire(0, 1))
+            return thread.ring = r;
+    }
+
+    QAsyncLogRing *r = new QAsyncLogRing;
+    r->inUse.store(1);
+    QAsyncLogRing *head = rings.loadAcquire();
+    do {
+        r->next = head;
+    } while (!rings.testAndSetOrdered(head, r, head));
+    return thread.ring = r;
+}
+
+void QAsyncLogger::wake()
+{
+    if (sleeping.load() && sleeping.testAndSetOrdered(1, 0)) {
+        QMutexLocker locker(&mutex);
+        wakeUp.wakeOne();
+    }
+}
+
+void QAsyncLogger::wakeWaiting()
+{
+    if (waiting.load()) {
+        QMutexLocker locker(&mutex);
+        progress.wakeAll();
+    }
+}
+
+/*
+    Queues the message for the writer thread. Returns \c false if the
+    caller has to output the message itself.
+*/
+bool QAsyncLogger::log(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    // a backtrace has to be taken on the logging thread, and is slow anyway
+    const int flags = QMessagePattern::flags.load();
+    QAsyncLogThread &thread = asyncLogThread;
+    if ((flags & QMessagePattern::HasBacktrace) || thread.isWriter || stopping.load())
+        return false;
+
+    QAsyncLogRing *r = ring();
+    const quint32 head = r->head.load();
+    if (head - r->tail.loadAcquire() == QAsyncLogRing::Capacity) {
+        if (policy == Drop) {
+            r->dropped.ref();
+            return true;
+        }
+
+        // ordered, so that either we see the space or the writer sees us waiting
+        QMutexLocker locker(&mutex);
+        waiting.ref();
+        while (head - r->tail.loadAcquire() == QAsyncLogRing::Capacity && !stopping.load()) {
+            if (sleeping.testAndSetOrdered(1, 0))
+                wakeUp.wakeOne();
+            progress.wait(&mutex, 100);
+        }
+        waiting.deref();
+        if (stopping.load())
+            return false;
+    }
+
+    QAsyncLogRecord &record = r->records[head & (QAsyncLogRing::Capacity - 1)];
+    record.type = type;
+    record.line = context.line;
+    record.setStrings(context.category, context.file, context.function);
+    record.message = message;
+
+    record.capture.threadId = thread.threadId;
+    if ((flags & QMessagePattern::HasThreadPointer) && !thread.threadPointer)
+        thread.threadPointer = quintptr(QThread::currentThread());
+    record.capture.threadPointer = thread.threadPointer;
+    if (flags & QMessagePattern::HasTime) {
+        QElapsedTimer now;
+        now.start();
+        record.capture.msecsSinceReference = now.msecsSinceReference();
+        record.capture.msecsSinceEpoch = QDateTime::currentMSecsSinceEpoch();
+    } else {
+        record.capture.msecsSinceReference = 0;
+        record.capture.msecsSinceEpoch = 0;
+    }
+    // the application object can be gone by the time the message is written
+    if (flags & QMessagePattern::HasAppName)
+        record.capture.appName = QCoreApplication::applicationName();
+    else
+        record.capture.appName.clear();
+    record.sequence = sequence.fetchAndAddRelaxed(1);
+
+    // ordered, so that either the writer sees the record or we see it sleeping
+    r->head.fetchAndStoreOrdered(head + 1);
+    wake();
+    return true;
+}
+
+/*
+    Waits, for up to a second, until everything logged so far is written.
+*/
+void QAsyncLogger::flush()
+{
+    if (asyncLogThread.isWriter)
+        return;
+
+    const quint64 target = sequence.load();
+    QElapsedTimer timer;
+    timer.start();
+    QMutexLocker locker(&mutex);
+    waiting.ref();
+    while (written.loadAcquire() < target && isRunning() && !timer.hasExpired(1000)) {
+        if (sleeping.testAndSetOrdered(1, 0))
+            wakeUp.wakeOne();
+        progress.wait(&mutex, qMax<qint64>(1, 1000 - timer.elapsed()));
+    }
+    waiting.deref();
+}
+
+bool QAsyncLogger::collect(QVector<QAsyncLogRecord> *batch, int *dropped)
+{
+    bool found = false;
+    for (QAsyncLogRing *r = rings.loadAcquire(); r; r = r->next) {
+        const quint32 head = r->head.loadAcquire();
+        quint32 tail = r->tail.load();
+        for (; tail != head; ++tail) {
+            QAsyncLogRecord &record = r->records[tail & (QAsyncLogRing::Capacity - 1)];
+            batch->append(QAsyncLogRecord());
+            QAsyncLogRecord &copy = batch->last();
+            copy.sequence = record.sequence;
+            copy.type = record.type;
+            copy.line = record.line;
+            copy.setStrings(record.string(QAsyncLogRecord::Category), record.string(QAsyncLogRecord::File),
+                            record.string(QAsyncLogRecord::Function));
+            copy.message.swap(record.message);
+            copy.capture = record.capture;
+            found = true;
+        }
+        r->tail.fetchAndStoreOrdered(tail);
+        if (const int n = r->dropped.fetchAndStoreRelaxed(0)) {
+            *dropped += n;
+            found = true;
+        }
+    }
+    return found;
+}
+
+/*
+    Writes the records of \a batch in the order in which they were logged.
+    A thread takes a sequence number before it publishes its record, so
+    the records after one that is not published yet stay in \a batch until
+    it is, unless \a all is set.
+*/
+void QAsyncLogger::write(QVector<QAsyncLogRecord> *batch, int dropped, bool all)
+{
+    // the rings are drained one after the other; restore the order of the calls
+    std::sort(batch->begin(), batch->end(), [](const QAsyncLogRecord &l, const QAsyncLogRecord &r) {
+        return l.sequence < r.sequence;
+    });
+
+    quint64 next = written.load();
+    int count = 0;
+    for (; count < batch->size() && (all || batch->at(count).sequence == next); ++count)
+        next = batch->at(count).sequence + 1;
+
+    const bool toConsole = qt_logging_to_console();
+    QByteArray console;
+    for (int i = 0; i < count; ++i) {
+        const QAsyncLogRecord &record = batch->at(i);
+        const QMessageLogContext context(record.string(QAsyncLogRecord::File), record.line,
+                                         record.string(QAsyncLogRecord::Function),
+                                         record.string(QAsyncLogRecord::Category));
+        QString logMessage = formatLogMessage(record.type, context, record.message, &record.capture);
+        if (logMessage.isNull())
+            continue;
+        if (toConsole) {
+            console += logMessage.toLocal8Bit();
+            console += '\n';
+        } else {
+            qDefaultMessageOutput(record.type, context, logMessage);
+        }
+    }
+
+    if (dropped) {
+        QMessageLogContext context;
+        QString logMessage = qFormatLogMessage(QtWarningMsg, context,
+                QString::fromLatin1("QT_LOGGING_ASYNC: dropped %1 messages").arg(dropped));
+        if (toConsole) {
+            console += logMessage.toLocal8Bit();
+            console += '\n';
+        } else {
+            qDefaultMessageOutput(QtWarningMsg, context, logMessage);
+        }
+    }
+
+    if (!console.isEmpty()) {
+        fwrite(console.constData(), 1, console.size(), stderr);
+        fflush(stderr);
+    }
+    batch->remove(0, count);
+    written.storeRelease(next);
+}
+
+void QAsyncLogger::run()
+{
+    asyncLogThread.isWriter = true;
+
+    QVector<QAsyncLogRecord> batch;
+    forever {
+        int dropped = 0;
+        if (collect(&batch, &dropped)) {
+            // let threads blocked on a full ring go on while we write
+            wakeWaiting();
+            write(&batch, dropped, false);
+            wakeWaiting();
+            continue;
+        }
+        if (stopping.loadAcquire()) {
+            write(&batch, 0, true);
+            break;
+        }
+
+        // announce that we are going to sleep, then look again
+        sleeping.fetchAndStoreOrdered(1);
+        bool pending = false;
+        for (QAsyncLogRing *r = rings.loadAcquire(); r && !pending; r = r->next)
+            pending = !r->isEmpty() || r->dropped.load();
+        if (!pending) {
+            QMutexLocker locker(&mutex);
+            if (sleeping.load() && !stopping.load())
+                wakeUp.wait(&mutex, 100);
+        }
+        sleeping.store(0);
+    }
+}
+
+#endif // QLOGGING_HAVE_ASYNC
+
+/*!
+    \internal
+*/
+static void qDefaultMessageHandler(QtMsgType type, const QMessageLogContext &context,
+                                   const QString &buf)
+{
+#ifdef QLOGGING_HAVE_ASYNC
+    if (QAsyncLogger::isEnabled() && !asyncLogger.isDestroyed()) {
+        if (!isFatal(type) && asyncLogger()->log(type, context, buf))
+            return;
+        // write fatal messages after everything that came before
+        asyncLogger()->flush();
+    }
+#endif
+
+    QString logMessage = qFormatLogMessage(type, context, buf);
+
+    // print nothing if message pattern didn't apply / was empty.
+    // (still print empty lines, e.g. because message itself was empty)
+    if (logMessage.isNull())
+        return;
+
+    qDefaultMessageOutput(type, context, logMessage);
+}
+
 /*!
     \internal
 */
@@ -1782,6 +2286,16 @@ void qErrnoWarning(int code, const char *msg, ...)
 
     To restore the message handler, call \c qInstallMessageHandler(0).
 
+    Since Qt 5.10, the default message handler can write messages from a
+    thread of its own, so that threads logging a lot of messages do not
+    wait for the output. This is enabled by setting the \c QT_LOGGING_ASYNC
+    environment variable. If a thread logs faster than messages can be
+    written, it waits for the output by default; set the variable to \c drop
+    to have such messages dropped and counted instead. Messages are written
+    in the order in which they were logged. Pending messages are written
+    before a fatal message and when the application exits, but they can be
+    lost if the application crashes.
+
     Example:
 
     \snippet code/src_corelib_global_qglobal.cpp 23
@@ -1883,6 +2397,12 @@ QtMsgHandler qInstallMsgHandler(QtMsgHandler h)
 
 void qSetMessagePattern(const QString &pattern)
 {
+#ifdef QLOGGING_HAVE_ASYNC
+    // messages logged so far are written with the old pattern
+    if (asyncLogger.exists() && !asyncLogger.isDestroyed())
+        asyncLogger()->flush();
+#endif
+
     QMutexLocker lock(&QMessagePattern::mutex);
 
     if (!qMessagePattern()->fromEnvironment)
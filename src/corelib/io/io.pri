@@ -52,7 +52,9 @@ HEADERS +=  \
         io/qfileselector.h \
         io/qfileselector_p.h \
         io/qloggingcategory.h \
-        io/qloggingregistry_p.h
+        io/qloggingregistry_p.h \
+        io/qloggingtrace.h \
+        io/qloggingtrace_p.h
 
 SOURCES += \
         io/qabstractfileengine.cpp \
@@ -91,7 +93,8 @@ SOURCES += \
         io/qfilesystemengine.cpp \
         io/qfileselector.cpp \
         io/qloggingcategory.cpp \
-        io/qloggingregistry.cpp
+        io/qloggingregistry.cpp \
+        io/qloggingtrace.cpp
 
 qtConfig(processenvironment) {
     SOURCES += \
@@ -684,6 +684,8 @@ bool QFSFileEngine::setSize(qint64 size)
         ret = QT_FTRUNCATE(QT_FILENO(d->fh), size) == 0;
     else
         ret = QT_TRUNCATE(d->fileEntry.nativeFilePath().constData(), size) == 0;
+    // the cached size is stale now, map() checks it
+    d->metaData.clearFlags(QFileSystemMetaData::SizeAttribute);
     if (!ret)
         setError(QFile::ResizeError, qt_error_string(errno));
     return ret;
@@ -0,0 +1,656 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qloggingtrace_p.h"
+
+#include "qcoreapplication.h"
+#include "qdatetime.h"
+#include "qelapsedtimer.h"
+#include "qfile.h"
+#include "qmutex.h"
+#include "qstringlist.h"
+#include "qthread.h"
+
+#if defined(Q_OS_LINUX)
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+#if defined(Q_PROCESSOR_X86) && (defined(Q_CC_GNU) || defined(Q_CC_MSVC))
+#  define QLOGGINGTRACE_HAVE_TSC
+#  ifdef Q_CC_MSVC
+#    include <intrin.h>
+#  else
+#    include <cpuid.h>
+#    include <x86intrin.h>
+#  endif
+#endif
+
+QT_BEGIN_NAMESPACE
+
+#if defined(Q_COMPILER_VARIADIC_MACROS) && defined(Q_COMPILER_VARIADIC_TEMPLATES)
+
+using namespace QLoggingTrace;
+
+/*!
+    \macro qCTraceDebug(category, format, ...)
+    \relates QLoggingCategory
+    \since 5.10
+
+    Logs a debug message \a format with the arguments that follow in the
+    category \a category, if debug messages are enabled for it. \a format
+    is an UTF-8 string that refers to the arguments with \c %1, \c %2 and
+    so on, like QString::arg() does.
+
+    Unlike qCDebug(), the message is not formatted when it is logged. If
+    the \c QT_LOGGING_TRACE environment variable holds the name of a file,
+    the arguments are written to that file in a compact binary format,
+    together with the time and the thread of the call, which makes the
+    call cheap enough to leave enabled in production. The \c qtracedump
+    tool formats the messages of such a file later. A \c %p in the file
+    name is replaced by the process id. Without \c QT_LOGGING_TRACE, the
+    message is formatted and passed to the message handler like any other
+    message.
+
+    The arguments can be numbers, enumerations, pointers, \c{const char *},
+    QByteArray, QLatin1String or QString.
+
+    \code
+    qCTraceDebug(lcDecoder, "decoded frame %1 of %2 bytes in %3 us", frame, size, elapsed);
+    \endcode
+
+    The details of a call, such as the category, the file and the format,
+    are written once for every place in the code that traces. The category
+    of such a place is not expected to change.
+
+    \note The file, line and function of a call are only recorded if
+    the message log context is available, see QMessageLogContext.
+
+    \sa qCDebug(), qCTraceInfo(), qCTraceWarning(), qCTraceCritical()
+*/
+
+/*!
+    \macro qCTraceInfo(category, format, ...)
+    \relates QLoggingCategory
+    \since 5.10
+
+    Logs an informational message \a format with the arguments that follow
+    in the category \a category, like qCTraceDebug() does.
+
+    \sa qCInfo(), qCTraceDebug()
+*/
+
+/*!
+    \macro qCTraceWarning(category, format, ...)
+    \relates QLoggingCategory
+    \since 5.10
+
+    Logs a warning message \a format with the arguments that follow in the
+    category \a category, like qCTraceDebug() does.
+
+    \sa qCWarning(), qCTraceDebug()
+*/
+
+/*!
+    \macro qCTraceCritical(category, format, ...)
+    \relates QLoggingCategory
+    \since 5.10
+
+    Logs a critical message \a format with the arguments that follow in the
+    category \a category, like qCTraceDebug() does.
+
+    \sa qCCritical(), qCTraceDebug()
+*/
+
+namespace {
+
+enum {
+    SegmentSize = 16 * 1024 * 1024,
+    ChunksPerSegment = SegmentSize / ChunkSize,
+    MaxSegments = 1024 // 16 GB
+};
+
+class QLoggingTraceWriter
+{
+public:
+    static QLoggingTraceWriter *instance()
+    {
+        if (Q_LIKELY(state.load() == Initialized))
+            return writer.load();
+        return initialize();
+    }
+
+    // only valid once a site has an id, which only the writer gives out
+    static QLoggingTraceWriter *current() { return writer.load(); }
+
+    quint32 siteId(QtPrivate::QLoggingTraceSite *site, const char *category, const char *format,
+                   const uchar *argumentTypes, int argumentCount);
+    QtPrivate::QLoggingTraceRecord reserve(quint32 site, int size);
+    void write(quint32 site, const char *data, int size);
+
+private:
+    enum State {
+        Uninitialized,
+        Initialized
+    };
+
+    QLoggingTraceWriter() : lastSiteId(0), ticksPerSecond(1000000000), useTsc(false) {}
+
+    static QLoggingTraceWriter *initialize();
+    bool open(const QString &fileName);
+    uchar *newChunk(qint64 threadId);
+    void startClock();
+
+    quint64 ticks() const
+    {
+#ifdef QLOGGINGTRACE_HAVE_TSC
+        if (useTsc)
+            return __rdtsc();
+#endif
+        return timer.nsecsElapsed();
+    }
+
+    static QBasicAtomicInt state;
+    static QBasicAtomicPointer<QLoggingTraceWriter> writer;
+
+    QFile file;
+    QElapsedTimer timer;
+    QMutex fileMutex;
+    QMutex siteMutex;
+    quint32 lastSiteId;
+    quint64 ticksPerSecond;
+    bool useTsc;
+    QAtomicInt nextChunk;
+    QAtomicInt full;
+    QAtomicPointer<uchar> segments[MaxSegments];
+};
+
+struct QLoggingTraceThread
+{
+    uchar *chunk;
+    quint32 used;
+    qint64 threadId;
+};
+
+QBasicAtomicInt QLoggingTraceWriter::state = Q_BASIC_ATOMIC_INITIALIZER(Uninitialized);
+QBasicAtomicPointer<QLoggingTraceWriter> QLoggingTraceWriter::writer = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+#ifdef Q_COMPILER_THREAD_LOCAL
+static thread_local QLoggingTraceThread traceThread = { 0, 0, 0 };
+#endif
+
+#ifdef QLOGGINGTRACE_HAVE_TSC
+static bool hasInvariantTsc()
+{
+    // CPUID 0x80000007, EDX bit 8: the TSC runs at a constant rate in all states
+    unsigned int info[4] = { 0, 0, 0, 0 };
+#  ifdef Q_CC_MSVC
+    __cpuid(reinterpret_cast<int *>(info), 0x80000000);
+    if (info[0] < 0x80000007)
+        return false;
+    __cpuid(reinterpret_cast<int *>(info), 0x80000007);
+#  else
+    if (__get_cpuid_max(0x80000000, 0) < 0x80000007)
+        return false;
+    __get_cpuid(0x80000007, &info[0], &info[1], &info[2], &info[3]);
+#  endif
+    return info[3] & (1U << 8);
+}
+#endif
+
+static qint64 currentThreadId()
+{
+#if defined(Q_OS_LINUX)
+    // the same id as %{threadid} in the message pattern
+    return syscall(SYS_gettid);
+#else
+    return qint64(quintptr(QThread::currentThreadId()));
+#endif
+}
+
+QLoggingTraceWriter *QLoggingTraceWriter::initialize()
+{
+    static QBasicMutex mutex;
+    QMutexLocker locker(&mutex);
+    if (state.load() == Initialized)
+        return writer.load();
+
+#ifdef Q_COMPILER_THREAD_LOCAL
+    QString fileName = QFile::decodeName(qgetenv("QT_LOGGING_TRACE"));
+    if (!fileName.isEmpty()) {
+        fileName.replace(QLatin1String("%p"), QString::number(QCoreApplication::applicationPid()));
+        // never deleted: other threads can write into the mapped file until the process ends
+        QLoggingTraceWriter *w = new QLoggingTraceWriter;
+        if (w->open(fileName)) {
+            writer.storeRelease(w);
+        } else {
+            qWarning("QT_LOGGING_TRACE: cannot write %s: %s", qPrintable(fileName),
+                     qPrintable(w->file.errorString()));
+            delete w;
+        }
+    }
+#endif
+    state.storeRelease(Initialized);
+    return writer.load();
+}
+
+bool QLoggingTraceWriter::open(const QString &fileName)
+{
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate))
+        return false;
+
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "QTLTRACE", sizeof(header.magic));
+    header.version = Version;
+    header.byteOrder = ByteOrderMark;
+    header.headerSize = sizeof(FileHeader);
+    header.chunkSize = ChunkSize;
+    header.pid = QCoreApplication::applicationPid();
+    header.startTime = QDateTime::currentMSecsSinceEpoch();
+    startClock();
+    header.ticksPerSecond = ticksPerSecond;
+    return file.write(reinterpret_cast<const char *>(&header), sizeof(header)) == sizeof(header)
+            && file.flush();
+}
+
+void QLoggingTraceWriter::startClock()
+{
+    timer.start();
+#ifdef QLOGGINGTRACE_HAVE_TSC
+    if (!hasInvariantTsc())
+        return;
+    // reading the TSC is several times faster than reading the monotonic
+    // clock; measure its rate once, the chunk headers correct for the error
+    const quint64 startTicks = __rdtsc();
+    const qint64 startTime = timer.nsecsElapsed();
+    qint64 elapsed;
+    while ((elapsed = timer.nsecsElapsed() - startTime) < 1000000)
+        ;
+    const quint64 elapsedTicks = __rdtsc() - startTicks;
+    if (elapsedTicks > quint64(elapsed)) {
+        ticksPerSecond = quint64(double(elapsedTicks) * 1e9 / elapsed);
+        useTsc = true;
+    }
+#endif
+}
+
+uchar *QLoggingTraceWriter::newChunk(qint64 threadId)
+{
+    if (full.load())
+        return 0;
+
+    const int chunk = nextChunk.fetchAndAddRelaxed(1);
+    const int segment = chunk / ChunksPerSegment;
+    if (segment >= MaxSegments) {
+        full.store(1);
+        return 0;
+    }
+
+    uchar *base = segments[segment].loadAcquire();
+    if (!base) {
+        QMutexLocker locker(&fileMutex);
+        base = segments[segment].load();
+        if (!base) {
+            const qint64 offset = sizeof(FileHeader) + qint64(segment) * SegmentSize;
+            if (file.size() < offset + SegmentSize && !file.resize(offset + SegmentSize)) {
+                full.store(1);
+                return 0;
+            }
+            // the mapping is shared, so what was written survives a crash
+            base = file.map(offset, SegmentSize);
+            if (!base) {
+                full.store(1);
+                return 0;
+            }
+            segments[segment].storeRelease(base);
+        }
+    }
+
+    uchar *data = base + (chunk % ChunksPerSegment) * ChunkSize;
+    ChunkHeader *header = reinterpret_cast<ChunkHeader *>(data);
+    header->threadId = threadId;
+    header->referenceTicks = ticks();
+    header->referenceTime = timer.nsecsElapsed();
+    header->used.storeRelease(sizeof(ChunkHeader));
+    header->magic = ChunkMagic;
+    return data;
+}
+
+/*
+    Returns the id of \a site, writing its definition the first time.
+*/
+quint32 QLoggingTraceWriter::siteId(QtPrivate::QLoggingTraceSite *site, const char *category,
+                                    const char *format, const uchar *argumentTypes, int argumentCount)
+{
+    QMutexLocker locker(&siteMutex);
+    if (const quint32 id = site->id.load())
+        return id;
+
+    const quint32 id = ++lastSiteId;
+    const char *strings[] = { category, site->file, site->function, format };
+    int size = 4 * sizeof(quint32) + argumentCount;
+    for (const char *string : strings)
+        size += sizeof(quint32) + (string ? int(qstrlen(string)) : 0);
+
+    QtPrivate::QLoggingTraceBuffer definition(size);
+    char *data = definition.data();
+    data = QtPrivate::writeLoggingTraceValue(data, id);
+    data = QtPrivate::writeLoggingTraceValue(data, quint32(site->type));
+    data = QtPrivate::writeLoggingTraceValue(data, qint32(site->line));
+    data = QtPrivate::writeLoggingTraceValue(data, quint32(argumentCount));
+    memcpy(data, argumentTypes, argumentCount);
+    data += argumentCount;
+    for (const char *string : strings)
+        data = QtPrivate::writeLoggingTraceString(data, string, string ? int(qstrlen(string)) : 0);
+    write(0, definition.constData(), size);
+
+    site->id.storeRelease(id);
+    return id;
+}
+
+/*
+    Returns room for a record of \a size bytes of arguments in the chunk of
+    the calling thread, with the record header written. The record counts
+    once the chunk's \c used is set to the returned end. Returns no room if
+    the record does not fit into a chunk, or the file is full.
+*/
+QtPrivate::QLoggingTraceRecord QLoggingTraceWriter::reserve(quint32 site, int size)
+{
+    QtPrivate::QLoggingTraceRecord result = { 0, 0, 0 };
+#ifdef Q_COMPILER_THREAD_LOCAL
+    QLoggingTraceThread &thread = traceThread;
+    const quint32 recordSize = sizeof(RecordHeader) + size;
+    if (Q_UNLIKELY(recordSize > ChunkSize - sizeof(ChunkHeader)))
+        return result;
+
+    if (Q_UNLIKELY(!thread.chunk || thread.used + recordSize > ChunkSize)) {
+        if (!thread.threadId)
+            thread.threadId = currentThreadId();
+        thread.chunk = newChunk(thread.threadId);
+        thread.used = sizeof(ChunkHeader);
+        if (!thread.chunk)
+            return result;
+    }
+
+    uchar *record = thread.chunk + thread.used;
+    qToUnaligned(recordSize, record + offsetof(RecordHeader, size));
+    qToUnaligned(site, record + offsetof(RecordHeader, site));
+    qToUnaligned(ticks(), record + offsetof(RecordHeader, timestamp));
+    thread.used += recordSize;
+    result.data = reinterpret_cast<char *>(record + sizeof(RecordHeader));
+    result.used = &reinterpret_cast<ChunkHeader *>(thread.chunk)->used;
+    result.end = thread.used;
+#else
+    Q_UNUSED(site);
+    Q_UNUSED(size);
+#endif
+    return result;
+}
+
+/*
+    Writes a record of \a size bytes of arguments. Records that do not fit
+    into a chunk are cut short, and marked so.
+*/
+void QLoggingTraceWriter::write(quint32 site, const char *data, int size)
+{
+    const int maximumSize = int(ChunkSize - sizeof(ChunkHeader) - sizeof(RecordHeader));
+    if (Q_UNLIKELY(size > maximumSize)) {
+        site |= RecordHeader::Truncated;
+        size = maximumSize;
+    }
+
+    const QtPrivate::QLoggingTraceRecord record = reserve(site, size);
+    if (record.data) {
+        memcpy(record.data, data, size);
+        record.used->storeRelease(record.end);
+    }
+}
+
+} // unnamed namespace
+
+/*!
+    \internal
+
+    Returns room in the trace file for \a size bytes of the arguments of a
+    call of \a site. If there is none, because there is no trace file or
+    the call does not fit, the arguments are to be passed to
+    qt_loggingTrace().
+*/
+QtPrivate::QLoggingTraceRecord QtPrivate::qt_loggingTraceRecord(QLoggingTraceSite *site, const char *category,
+                                                                const char *format, const uchar *argumentTypes,
+                                                                int argumentCount, int size)
+{
+    // pairs with the release in siteId(), so that the site's definition is
+    // written before any record that refers to it
+    quint32 id = site->id.loadAcquire();
+    QLoggingTraceWriter *writer;
+    if (Q_LIKELY(id)) {
+        writer = QLoggingTraceWriter::current();
+    } else {
+        writer = QLoggingTraceWriter::instance();
+        if (!writer) {
+            const QLoggingTraceRecord none = { 0, 0, 0 };
+            return none;
+        }
+        id = writer->siteId(site, category, format, argumentTypes, argumentCount);
+    }
+    return writer->reserve(id, size);
+}
+
+/*!
+    \internal
+
+    Writes a call of \a site to the trace file, or formats it and passes it
+    to the message handler if there is no trace file.
+*/
+void QtPrivate::qt_loggingTrace(QLoggingTraceSite *site, const char *category, const char *format,
+                                const uchar *argumentTypes, int argumentCount,
+                                const char *arguments, int size)
+{
+    if (QLoggingTraceWriter *writer = QLoggingTraceWriter::instance()) {
+        quint32 id = site->id.loadAcquire();
+        if (Q_UNLIKELY(!id))
+            id = writer->siteId(site, category, format, argumentTypes, argumentCount);
+        writer->write(id, arguments, size);
+        return;
+    }
+
+    const QMessageLogContext context(site->file, site->line, site->function, category);
+    qt_message_output(site->type, context,
+                      qt_formatLoggingTrace(format, argumentTypes, argumentCount, arguments, size));
+}
+
+namespace {
+
+class QLoggingTraceArgumentReader
+{
+public:
+    QLoggingTraceArgumentReader(const char *data, int size) : data(data), end(data + size) {}
+
+    // nothing after a truncated or unknown argument is read
+    void stop() { data = end; }
+
+    template <typename T>
+    bool read(T *value)
+    {
+        if (end - data < int(sizeof(T))) {
+            data = end;
+            return false;
+        }
+        *value = qFromUnaligned<T>(data);
+        data += sizeof(T);
+        return true;
+    }
+
+    bool readString(const char **string, int *size)
+    {
+        quint32 length;
+        if (!read(&length))
+            return false;
+        if (quint32(end - data) < length) {
+            data = end;
+            return false;
+        }
+        *string = data;
+        *size = int(length);
+        data += length;
+        return true;
+    }
+
+private:
+    const char *data;
+    const char *end;
+};
+
+} // unnamed namespace
+
+static QString loggingTraceArgument(QLoggingTraceArgumentReader &reader, uchar type)
+{
+    switch (type) {
+    case QtPrivate::LoggingTraceBool: {
+        quint8 value;
+        if (reader.read(&value))
+            return value ? QStringLiteral("true") : QStringLiteral("false");
+        break;
+    }
+    case QtPrivate::LoggingTraceInt32: {
+        qint32 value;
+        if (reader.read(&value))
+            return QString::number(value);
+        break;
+    }
+    case QtPrivate::LoggingTraceUInt32: {
+        quint32 value;
+        if (reader.read(&value))
+            return QString::number(value);
+        break;
+    }
+    case QtPrivate::LoggingTraceInt64: {
+        qint64 value;
+        if (reader.read(&value))
+            return QString::number(value);
+        break;
+    }
+    case QtPrivate::LoggingTraceUInt64: {
+        quint64 value;
+        if (reader.read(&value))
+            return QString::number(value);
+        break;
+    }
+    case QtPrivate::LoggingTraceDouble: {
+        double value;
+        if (reader.read(&value))
+            return QString::number(value);
+        break;
+    }
+    case QtPrivate::LoggingTracePointer: {
+        quint64 value;
+        if (reader.read(&value))
+            return QLatin1String("0x") + QString::number(value, 16);
+        break;
+    }
+    case QtPrivate::LoggingTraceUtf8:
+    case QtPrivate::LoggingTraceLatin1:
+    case QtPrivate::LoggingTraceUtf16: {
+        const char *string;
+        int size;
+        if (!reader.readString(&string, &size))
+            break;
+        if (type == QtPrivate::LoggingTraceUtf8)
+            return QString::fromUtf8(string, size);
+        if (type == QtPrivate::LoggingTraceLatin1)
+            return QString::fromLatin1(string, size);
+        QString result(size / int(sizeof(QChar)), Qt::Uninitialized);
+        memcpy(result.data(), string, result.size() * sizeof(QChar));
+        return result;
+    }
+    default:
+        reader.stop();
+        break;
+    }
+    return QString();
+}
+
+/*!
+    \internal
+
+    Returns \a format with \c %1, \c %2 and so on replaced by the
+    \a argumentCount arguments of the given \a argumentTypes, which are
+    stored in the \a size bytes at \a arguments. Truncated or invalid
+    arguments, and the ones after them, are left out.
+*/
+QString qt_formatLoggingTrace(const char *format, const uchar *argumentTypes, int argumentCount,
+                              const char *arguments, int size)
+{
+    QStringList values;
+    values.reserve(argumentCount);
+    QLoggingTraceArgumentReader reader(arguments, size);
+    for (int i = 0; i < argumentCount; ++i)
+        values.append(loggingTraceArgument(reader, argumentTypes[i]));
+
+    const QString pattern = QString::fromUtf8(format);
+    QString message;
+    message.reserve(pattern.size());
+    const QChar *c = pattern.constData();
+    const QChar *end = c + pattern.size();
+    while (c != end) {
+        if (*c == QLatin1Char('%') && end - c > 1 && c[1].isDigit()) {
+            // like QString::arg(), up to two digits
+            int index = c[1].digitValue();
+            const QChar *next = c + 2;
+            if (next != end && next->isDigit() && index * 10 + next->digitValue() <= argumentCount) {
+                index = index * 10 + next->digitValue();
+                ++next;
+            }
+            if (index >= 1 && index <= argumentCount) {
+                message += values.at(index - 1);
+                c = next;
+                continue;
+            }
+        }
+        message += *c++;
+    }
+    return message;
+}
+
+#endif // Q_COMPILER_VARIADIC_MACROS && Q_COMPILER_VARIADIC_TEMPLATES
+
+QT_END_NAMESPACE
@@ -0,0 +1,273 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QLOGGINGTRACE_H
+#define QLOGGINGTRACE_H
+
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <type_traits>
+
+QT_BEGIN_NAMESPACE
+
+#if (defined(Q_COMPILER_VARIADIC_MACROS) && defined(Q_COMPILER_VARIADIC_TEMPLATES)) || defined(Q_QDOC)
+
+namespace QtPrivate {
+
+struct QLoggingTraceSite
+{
+    QBasicAtomicInt id; // assigned when the site is first used
+    QtMsgType type;
+    const char *file;
+    int line;
+    const char *function;
+};
+
+// part of the trace file format, do not renumber
+enum QLoggingTraceArgumentType {
+    LoggingTraceBool = 1,
+    LoggingTraceInt32,
+    LoggingTraceUInt32,
+    LoggingTraceInt64,
+    LoggingTraceUInt64,
+    LoggingTraceDouble,
+    LoggingTracePointer,
+    LoggingTraceUtf8,
+    LoggingTraceLatin1,
+    LoggingTraceUtf16
+};
+
+typedef QVarLengthArray<char, 256> QLoggingTraceBuffer;
+
+// space for the arguments of a call in the calling thread's chunk of the trace file
+struct QLoggingTraceRecord
+{
+    char *data; // null if the arguments are not written there directly
+    QBasicAtomicInteger<quint32> *used;
+    quint32 end;
+};
+
+template <typename T>
+inline char *writeLoggingTraceValue(char *data, T value)
+{
+    qToUnaligned(value, data);
+    return data + sizeof(T);
+}
+
+inline char *writeLoggingTraceString(char *data, const void *string, int size)
+{
+    data = writeLoggingTraceValue(data, quint32(size));
+    memcpy(data, string, size);
+    return data + size;
+}
+
+// not defined for types that cannot be traced; write() gets what size() returned
+template <typename T, typename Enable = void>
+struct QLoggingTraceArgument;
+
+#define Q_LOGGING_TRACE_ARGUMENT(Type, ArgumentType, StoredType) \
+    template <> struct QLoggingTraceArgument<Type> \
+    { \
+        enum { Id = ArgumentType }; \
+        static int size(Type) { return int(sizeof(StoredType)); } \
+        static char *write(char *data, Type value, int) \
+        { return writeLoggingTraceValue(data, StoredType(value)); } \
+    };
+
+Q_LOGGING_TRACE_ARGUMENT(bool, LoggingTraceBool, quint8)
+Q_LOGGING_TRACE_ARGUMENT(char, LoggingTraceInt32, qint32)
+Q_LOGGING_TRACE_ARGUMENT(signed char, LoggingTraceInt32, qint32)
+Q_LOGGING_TRACE_ARGUMENT(short, LoggingTraceInt32, qint32)
+Q_LOGGING_TRACE_ARGUMENT(int, LoggingTraceInt32, qint32)
+Q_LOGGING_TRACE_ARGUMENT(long, LoggingTraceInt64, qint64)
+Q_LOGGING_TRACE_ARGUMENT(long long, LoggingTraceInt64, qint64)
+Q_LOGGING_TRACE_ARGUMENT(unsigned char, LoggingTraceUInt32, quint32)
+Q_LOGGING_TRACE_ARGUMENT(unsigned short, LoggingTraceUInt32, quint32)
+Q_LOGGING_TRACE_ARGUMENT(unsigned int, LoggingTraceUInt32, quint32)
+Q_LOGGING_TRACE_ARGUMENT(unsigned long, LoggingTraceUInt64, quint64)
+Q_LOGGING_TRACE_ARGUMENT(unsigned long long, LoggingTraceUInt64, quint64)
+Q_LOGGING_TRACE_ARGUMENT(float, LoggingTraceDouble, double)
+Q_LOGGING_TRACE_ARGUMENT(double, LoggingTraceDouble, double)
+
+#undef Q_LOGGING_TRACE_ARGUMENT
+
+template <typename T>
+struct QLoggingTraceArgument<T, typename std::enable_if<std::is_enum<T>::value>::type>
+{
+    enum { Id = LoggingTraceInt64 };
+    static int size(T) { return int(sizeof(qint64)); }
+    static char *write(char *data, T value, int) { return writeLoggingTraceValue(data, qint64(value)); }
+};
+
+template <typename T>
+struct QLoggingTraceArgument<T *>
+{
+    enum { Id = LoggingTracePointer };
+    static int size(const T *) { return int(sizeof(quint64)); }
+    static char *write(char *data, const T *value, int)
+    { return writeLoggingTraceValue(data, quint64(quintptr(value))); }
+};
+
+template <>
+struct QLoggingTraceArgument<const char *>
+{
+    enum { Id = LoggingTraceUtf8 };
+    static int size(const char *value) { return int(sizeof(quint32)) + (value ? int(qstrlen(value)) : 0); }
+    static char *write(char *data, const char *value, int size)
+    { return writeLoggingTraceString(data, value, size - int(sizeof(quint32))); }
+};
+
+template <>
+struct QLoggingTraceArgument<char *> : QLoggingTraceArgument<const char *> {};
+
+template <>
+struct QLoggingTraceArgument<QByteArray>
+{
+    enum { Id = LoggingTraceUtf8 };
+    static int size(const QByteArray &value) { return int(sizeof(quint32)) + value.size(); }
+    static char *write(char *data, const QByteArray &value, int)
+    { return writeLoggingTraceString(data, value.constData(), value.size()); }
+};
+
+template <>
+struct QLoggingTraceArgument<QLatin1String>
+{
+    enum { Id = LoggingTraceLatin1 };
+    static int size(QLatin1String value) { return int(sizeof(quint32)) + value.size(); }
+    static char *write(char *data, QLatin1String value, int)
+    { return writeLoggingTraceString(data, value.data(), value.size()); }
+};
+
+template <>
+struct QLoggingTraceArgument<QString>
+{
+    enum { Id = LoggingTraceUtf16 };
+    static int size(const QString &value) { return int(sizeof(quint32)) + value.size() * int(sizeof(QChar)); }
+    static char *write(char *data, const QString &value, int)
+    { return writeLoggingTraceString(data, value.constData(), value.size() * int(sizeof(QChar))); }
+};
+
+Q_CORE_EXPORT QLoggingTraceRecord qt_loggingTraceRecord(QLoggingTraceSite *site, const char *category,
+                                                        const char *format, const uchar *argumentTypes,
+                                                        int argumentCount, int size);
+Q_CORE_EXPORT void qt_loggingTrace(QLoggingTraceSite *site, const char *category, const char *format,
+                                   const uchar *argumentTypes, int argumentCount,
+                                   const char *arguments, int size);
+
+template <typename... Args>
+inline void loggingTrace(QLoggingTraceSite &site, const char *category, const char *format,
+                         const Args &... args)
+{
+    static const uchar argumentTypes[] = {
+        uchar(QLoggingTraceArgument<typename std::decay<Args>::type>::Id)..., 0
+    };
+    const int sizes[] = {
+        0, QLoggingTraceArgument<typename std::decay<Args>::type>::size(args)...
+    };
+    int size = 0;
+    for (int argumentSize : sizes)
+        size += argumentSize;
+
+    const QLoggingTraceRecord record = qt_loggingTraceRecord(&site, category, format, argumentTypes,
+                                                             int(sizeof...(Args)), size);
+    QLoggingTraceBuffer buffer;
+    char *data = record.data;
+    if (Q_UNLIKELY(!data)) {
+        buffer.resize(size);
+        data = buffer.data();
+    }
+    const int *argumentSize = sizes;
+    const int expand[] = {
+        0, (data = QLoggingTraceArgument<typename std::decay<Args>::type>::write(data, args, *++argumentSize), 0)...
+    };
+    Q_UNUSED(expand);
+    Q_UNUSED(argumentSize);
+    Q_UNUSED(data);
+
+    if (Q_LIKELY(record.data))
+        record.used->storeRelease(record.end);
+    else
+        qt_loggingTrace(&site, category, format, argumentTypes, int(sizeof...(Args)),
+                        sizeof...(Args) ? buffer.constData() : nullptr, size);
+}
+
+template <typename... Args>
+inline void noLoggingTrace(const char *, const Args &...) {}
+
+} // namespace QtPrivate
+
+#define Q_LOGGING_TRACE(category, msgType, isEnabled, ...) \
+    do { \
+        if (category().isEnabled()) { \
+            static QtPrivate::QLoggingTraceSite qt_trace_site = { Q_BASIC_ATOMIC_INITIALIZER(0), msgType, \
+                QT_MESSAGELOG_FILE, QT_MESSAGELOG_LINE, QT_MESSAGELOG_FUNC }; \
+            QtPrivate::loggingTrace(qt_trace_site, category().categoryName(), __VA_ARGS__); \
+        } \
+    } while (false)
+
+#define qCTraceDebug(category, ...) Q_LOGGING_TRACE(category, QtDebugMsg, isDebugEnabled, __VA_ARGS__)
+#define qCTraceInfo(category, ...) Q_LOGGING_TRACE(category, QtInfoMsg, isInfoEnabled, __VA_ARGS__)
+#define qCTraceWarning(category, ...) Q_LOGGING_TRACE(category, QtWarningMsg, isWarningEnabled, __VA_ARGS__)
+#define qCTraceCritical(category, ...) Q_LOGGING_TRACE(category, QtCriticalMsg, isCriticalEnabled, __VA_ARGS__)
+
+#define Q_NO_LOGGING_TRACE(...) \
+    do { if (false) QtPrivate::noLoggingTrace(__VA_ARGS__); } while (false)
+
+#if defined(QT_NO_DEBUG_OUTPUT)
+#  undef qCTraceDebug
+#  define qCTraceDebug(category, ...) Q_NO_LOGGING_TRACE(__VA_ARGS__)
+#endif
+#if defined(QT_NO_INFO_OUTPUT)
+#  undef qCTraceInfo
+#  define qCTraceInfo(category, ...) Q_NO_LOGGING_TRACE(__VA_ARGS__)
+#endif
+#if defined(QT_NO_WARNING_OUTPUT)
+#  undef qCTraceWarning
+#  define qCTraceWarning(category, ...) Q_NO_LOGGING_TRACE(__VA_ARGS__)
+#endif
+
+#endif // (Q_COMPILER_VARIADIC_MACROS && Q_COMPILER_VARIADIC_TEMPLATES) || Q_QDOC
+
+QT_END_NAMESPACE
+
+#endif // QLOGGINGTRACE_H
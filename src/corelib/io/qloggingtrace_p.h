@@ -0,0 +1,134 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QLOGGINGTRACE_P_H
+#define QLOGGINGTRACE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qloggingtrace.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Layout of a trace file, in the byte order of the traced process:
+
+    The file starts with a QLoggingTraceFileHeader, followed by chunks of
+    ChunkSize bytes. Every thread writes into a chunk of its own, which
+    starts with a QLoggingTraceChunkHeader; chunks with another magic are
+    unused. The chunk header counts the bytes written so far, including
+    the header, and is updated after every record.
+
+    Records are timestamped in ticks of the fastest clock available, the
+    CPU's time stamp counter where it runs at a constant rate. The file
+    header gives the rate of the clock, and every chunk header the ticks
+    at a known time, so that the clocks cannot drift apart by much.
+
+    A record starts with a QLoggingTraceRecordHeader. Records of site 0
+    define a call site, and are written before the first record of that
+    site, possibly in the chunk of another thread. Their payload is:
+
+        quint32 site, quint32 QtMsgType, qint32 line, quint32 argument count,
+        one byte per argument type (QtPrivate::QLoggingTraceArgumentType),
+        then the category, file, function and format, each as quint32
+        length followed by that many bytes of UTF-8
+
+    Other records carry the arguments of one call: fixed size values for
+    numbers and pointers, and a quint32 size followed by the bytes for
+    strings. The arguments of a call that do not fit into a chunk are cut
+    short, and the record's site has RecordHeader::Truncated set.
+*/
+namespace QLoggingTrace {
+
+enum {
+    Version = 1,
+    ByteOrderMark = 0x01020304,
+    ChunkMagic = 0x31435451, // "QTC1"
+    ChunkSize = 64 * 1024
+};
+
+struct FileHeader
+{
+    char magic[8]; // "QTLTRACE"
+    quint32 version;
+    quint32 byteOrder;
+    quint32 headerSize;
+    quint32 chunkSize;
+    qint64 pid;
+    qint64 startTime; // msecs since the epoch
+    quint64 ticksPerSecond;
+    qint64 reserved[2];
+};
+
+struct ChunkHeader
+{
+    quint32 magic;
+    QBasicAtomicInteger<quint32> used;
+    qint64 threadId;
+    quint64 referenceTicks;
+    qint64 referenceTime; // nsecs since the start of the trace, at referenceTicks
+};
+
+struct RecordHeader
+{
+    enum : quint32 { Truncated = 0x80000000 }; // in site
+
+    quint32 size; // including the header
+    quint32 site;
+    quint64 timestamp; // in ticks
+};
+
+} // namespace QLoggingTrace
+
+Q_CORE_EXPORT QString qt_formatLoggingTrace(const char *format, const uchar *argumentTypes, int argumentCount,
+                                            const char *arguments, int size);
+
+QT_END_NAMESPACE
+
+#endif // QLOGGINGTRACE_P_H
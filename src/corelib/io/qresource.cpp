@@ -53,6 +53,7 @@
 #include <qshareddata.h>
 #include <qplatformdefs.h>
 #include "private/qabstractfileengine_p.h"
+#include "private/qlz4_p.h"
 #include "private/qsystemerror_p.h"
 
 #ifdef Q_OS_UNIX
@@ -93,6 +94,29 @@ public:
     int m_pos;
 };
 
+// Hashes of a full resource path for the path index written by rcc's
+// -path-index option. Must match the functions of the same name in rcc.cpp.
+static inline quint64 resourcePathHash(const QChar *p, int n)
+{
+    quint64 h = Q_UINT64_C(14695981039346656037);
+    for (int i = 0; i < n; ++i) {
+        h ^= p[i].unicode();
+        h *= Q_UINT64_C(1099511628211);
+    }
+    return h;
+}
+
+static inline uint resourceIndexHash(quint64 h, uint seed)
+{
+    h += seed * Q_UINT64_C(0x9e3779b97f4a7c15);
+    h ^= h >> 33;
+    h *= Q_UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return uint(h);
+}
+
 
 //resource glue
 class QResourceRoot
@@ -100,25 +124,37 @@ class QResourceRoot
     enum Flags
     {
         Compressed = 0x01,
-        Directory = 0x02
+        Directory = 0x02,
+        CompressedLz4 = 0x04,
+        PathIndex = 0x08 // root only; its name offset is the offset of the index in the tree
     };
-    const uchar *tree, *names, *payloads;
+    const uchar *tree, *names, *payloads, *pathIndex;
     int version;
     inline int findOffset(int node) const { return node * (14 + (version >= 0x02 ? 8 : 0)); } //sizeof each tree element
     uint hash(int node) const;
     QString name(int node) const;
+    bool nameEquals(int node, const QStringRef &str) const;
     short flags(int node) const;
+    int findIndexedNode(const QString &path, const QLocale &locale) const;
 public:
     mutable QAtomicInt ref;
 
-    inline QResourceRoot(): tree(0), names(0), payloads(0), version(0) {}
+    inline QResourceRoot(): tree(0), names(0), payloads(0), pathIndex(0), version(0) {}
     inline QResourceRoot(int version, const uchar *t, const uchar *n, const uchar *d) { setSource(version, t, n, d); }
     virtual ~QResourceRoot() { }
     int findNode(const QString &path, const QLocale &locale=QLocale()) const;
     inline bool isContainer(int node) const { return flags(node) & Directory; }
-    inline bool isCompressed(int node) const { return flags(node) & Compressed; }
+    inline QResource::Compression compressionAlgorithm(int node) const
+    {
+        const short f = flags(node);
+        if (f & Compressed)
+            return QResource::ZlibCompression;
+        if (f & CompressedLz4)
+            return QResource::Lz4Compression;
+        return QResource::NoCompression;
+    }
     const uchar *data(int node, qint64 *size) const;
-    QDateTime lastModified(int node) const;
+    quint64 lastModified(int node) const;
     QStringList children(int node) const;
     virtual QString mappingRoot() const { return QString(); }
     bool mappingRootSubdir(const QString &path, QString *match=0) const;
@@ -135,6 +171,9 @@ protected:
         names = n;
         payloads = d;
         version = v;
+        pathIndex = 0;
+        if (flags(0) & PathIndex)
+            pathIndex = tree + qFromBigEndian<qint32>(tree);
     }
 };
 
@@ -195,7 +234,7 @@ static inline QStringList *resourceSearchPaths()
     which will be found in the list of paths returned by QDir::searchPaths().
 
     A QResource that is representing a file will have data backing it, this
-    data can possibly be compressed, in which case qUncompress() must be
+    data can possibly be compressed, in which case uncompressedData() must be
     used to access the real data; this happens implicitly when accessed
     through a QFile. A QResource that is representing a directory will have
     only children and no data.
@@ -243,11 +282,11 @@ public:
     QString fileName, absoluteFilePath;
     QList<QResourceRoot*> related;
     uint container : 1;
-    mutable uint compressed : 1;
+    mutable uint compressionAlgorithm : 2;
     mutable qint64 size;
     mutable const uchar *data;
     mutable QStringList children;
-    mutable QDateTime lastModified;
+    mutable quint64 lastModified; // converted to QDateTime on demand, which is slow
 
     QResource *q_ptr;
     Q_DECLARE_PUBLIC(QResource)
@@ -257,11 +296,11 @@ void
 QResourcePrivate::clear()
 {
     absoluteFilePath.clear();
-    compressed = 0;
+    compressionAlgorithm = QResource::NoCompression;
     data = 0;
     size = 0;
     children.clear();
-    lastModified = QDateTime();
+    lastModified = 0;
     container = 0;
     for(int i = 0; i < related.size(); ++i) {
         QResourceRoot *root = related.at(i);
@@ -286,11 +325,11 @@ QResourcePrivate::load(const QString &file)
                 container = res->isContainer(node);
                 if(!container) {
                     data = res->data(node, &size);
-                    compressed = res->isCompressed(node);
+                    compressionAlgorithm = res->compressionAlgorithm(node);
                 } else {
                     data = 0;
                     size = 0;
-                    compressed = 0;
+                    compressionAlgorithm = QResource::NoCompression;
                 }
                 lastModified = res->lastModified(node);
             } else if(res->isContainer(node) != container) {
@@ -302,8 +341,8 @@ QResourcePrivate::load(const QString &file)
             container = true;
             data = 0;
             size = 0;
-            compressed = 0;
-            lastModified = QDateTime();
+            compressionAlgorithm = QResource::NoCompression;
+            lastModified = 0;
             res->ref.ref();
             related.append(res);
         }
@@ -494,14 +533,75 @@ bool QResource::isValid() const
     Returns \c true if the resource represents a file and the data backing it
     is in a compressed format, false otherwise.
 
-    \sa data(), isFile()
+    \sa data(), compressionAlgorithm(), uncompressedData(), isFile()
 */
 
 bool QResource::isCompressed() const
+{
+    return compressionAlgorithm() != NoCompression;
+}
+
+/*!
+    \enum QResource::Compression
+    \since 5.10
+
+    This enum describes how the data backing a resource is compressed.
+
+    \value NoCompression   The data is not compressed.
+    \value ZlibCompression The data is compressed with zlib, as by qCompress().
+    \value Lz4Compression  The data is compressed in the LZ4 block format,
+                           which rcc uses when passed \c{--compress-algo lz4}.
+                           It uncompresses several times faster than zlib.
+*/
+
+/*!
+    \since 5.10
+
+    Returns the algorithm the data backing the resource is compressed with,
+    or NoCompression if it is not compressed.
+
+    \sa isCompressed(), uncompressedData()
+*/
+
+QResource::Compression QResource::compressionAlgorithm() const
 {
     Q_D(const QResource);
     d->ensureInitialized();
-    return d->compressed;
+    return Compression(d->compressionAlgorithm);
+}
+
+/*!
+    \since 5.10
+
+    Returns the data of the resource, uncompressed if it is compressed. If the
+    resource is a directory or the data is corrupt, an empty QByteArray is
+    returned.
+
+    Unlike data(), this function copies the data if it is not compressed.
+
+    \sa data(), compressionAlgorithm()
+*/
+
+QByteArray QResource::uncompressedData() const
+{
+    Q_D(const QResource);
+    d->ensureInitialized();
+    const char *data = reinterpret_cast<const char *>(d->data);
+    const int size = int(d->size);
+    switch (Compression(d->compressionAlgorithm)) {
+    case NoCompression:
+        return QByteArray(data, size);
+    case ZlibCompression:
+#ifndef QT_NO_COMPRESS
+        return qUncompress(d->data, size);
+#else
+        Q_ASSERT(!"QResource: Qt built without support for compression");
+        return QByteArray();
+#endif
+    case Lz4Compression:
+        return qLz4Uncompress(d->data, size);
+    }
+    return QByteArray();
 }
 
 /*!
@@ -520,7 +620,7 @@ qint64 QResource::size() const
 /*!
     Returns direct access to a read only segment of data that this resource
     represents. If the resource is compressed the data returns is
-    compressed and qUncompress() must be used to access the data. If the
+    compressed and uncompressedData() must be used to access the data. If the
     resource is a directory 0 is returned.
 
     \sa size(), isCompressed(), isFile()
@@ -541,7 +641,7 @@ QDateTime QResource::lastModified() const
 {
     Q_D(const QResource);
     d->ensureInitialized();
-    return d->lastModified;
+    return d->lastModified ? QDateTime::fromMSecsSinceEpoch(d->lastModified) : QDateTime();
 }
 
 /*!
@@ -645,6 +745,115 @@ inline QString QResourceRoot::name(int node) const
     return ret;
 }
 
+inline bool QResourceRoot::nameEquals(int node, const QStringRef &str) const
+{
+    const int offset = findOffset(node);
+    qint32 name_offset = qFromBigEndian<qint32>(tree + offset);
+    const qint16 name_length = qFromBigEndian<qint16>(names + name_offset);
+    if (name_length != str.size())
+        return false;
+    name_offset += 2;
+    name_offset += 4; //jump past hash
+
+    const QChar *c = str.unicode();
+    for (int i = 0; i < name_length; ++i) {
+        if (c[i].unicode() != qFromBigEndian<quint16>(names + name_offset + 2 * i))
+            return false;
+    }
+    return true;
+}
+
+/*
+    Looks up \a path in the perfect hash table rcc writes after the tree
+    nodes when given -path-index:
+
+        quint32 keyCount, bucketCount
+        qint32  displacement[bucketCount]
+        quint32 node[keyCount]      (any of the nodes with that path)
+        quint32 parent[nodeCount]
+
+    The bucket is resourceIndexHash(resourcePathHash(path), 0) % bucketCount.
+    A negative displacement -(slot + 1) names the slot directly, otherwise
+    the slot is resourceIndexHash(resourcePathHash(path), displacement)
+    % keyCount. Any path
+    hashes to some slot, so the names of the node and its parents are
+    compared to the segments of \a path before it is accepted.
+
+    Returns -2 if the path is not canonical and the tree has to be walked.
+*/
+int QResourceRoot::findIndexedNode(const QString &path, const QLocale &locale) const
+{
+    const quint32 keyCount = qFromBigEndian<quint32>(pathIndex);
+    const quint32 bucketCount = qFromBigEndian<quint32>(pathIndex + 4);
+    const uchar *displacements = pathIndex + 8;
+    const uchar *nodes = displacements + 4 * bucketCount;
+    const uchar *parents = nodes + 4 * keyCount;
+
+    const QChar *data = path.constData();
+    const int size = path.size();
+    if (!keyCount || !bucketCount)
+        return -1;
+
+    const quint64 pathHash = resourcePathHash(data, size);
+    const uint bucket = resourceIndexHash(pathHash, 0) % bucketCount;
+    const qint32 displacement = qFromBigEndian<qint32>(displacements + 4 * bucket);
+    const quint32 slot = displacement < 0 ? quint32(-displacement - 1)
+                                          : resourceIndexHash(pathHash, displacement) % keyCount;
+    const int node = slot < keyCount ? qFromBigEndian<qint32>(nodes + 4 * slot) : -1;
+
+    // verify the match, segment by segment from the end
+    int end = size;
+    QStringRef leaf;
+    for (int n = node; n > 0; n = qFromBigEndian<qint32>(parents + 4 * n)) {
+        const int start = end > 0 ? path.lastIndexOf(QLatin1Char('/'), end - 1) + 1 : 0;
+        const QStringRef segment(&path, start, end - start);
+        if (start == 0 || !nameEquals(n, segment)) {
+            end = -1;
+            break;
+        }
+        if (n == node)
+            leaf = segment;
+        end = start - 1;
+    }
+    if (node <= 0 || end != 0) {
+        // the tree walk also accepts relative paths and empty segments
+        if (!path.startsWith(QLatin1Char('/')) || path.endsWith(QLatin1Char('/'))
+            || path.contains(QLatin1String("//"))) {
+            return -2;
+        }
+        return -1;
+    }
+
+    // pick the best localized variant among the siblings with that name
+    int offset = findOffset(qFromBigEndian<qint32>(parents + 4 * node)) + 6; //jump past name and flags
+    const qint32 child_count = qFromBigEndian<qint32>(tree + offset);
+    const qint32 child = qFromBigEndian<qint32>(tree + offset + 4);
+    const uint h = hash(node);
+    int sub_node = node;
+    while (sub_node > child && hash(sub_node - 1) == h)
+        --sub_node;
+
+    int result = -1;
+    for (; sub_node < child + child_count && hash(sub_node) == h; ++sub_node) {
+        if (!nameEquals(sub_node, leaf))
+            continue;
+        offset = findOffset(sub_node) + 4; //jump past name
+        const qint16 flags = qFromBigEndian<qint16>(tree + offset);
+        if (flags & Directory)
+            return sub_node;
+        offset += 2;
+        const qint16 country = qFromBigEndian<qint16>(tree + offset);
+        const qint16 language = qFromBigEndian<qint16>(tree + offset + 2);
+        if (country == locale.country() && language == locale.language())
+            return sub_node;
+        if ((country == QLocale::AnyCountry && language == locale.language()) ||
+            (country == QLocale::AnyCountry && language == QLocale::C && result == -1)) {
+            result = sub_node;
+        }
+    }
+    return result;
+}
+
 int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
 {
     QString path = _path;
@@ -670,6 +879,12 @@ int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
     if(path == QLatin1String("/"))
         return 0;
 
+    if (pathIndex) {
+        const int node = findIndexedNode(path, locale);
+        if (node != -2)
+            return node;
+    }
+
     //the root node is always first
     qint32 child_count = qFromBigEndian<qint32>(tree + 6);
     qint32 child       = qFromBigEndian<qint32>(tree + 10);
@@ -710,7 +925,7 @@ int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
             while(sub_node > child && hash(sub_node-1) == h) //backup for collisions
                 --sub_node;
             for(; sub_node < child+child_count && hash(sub_node) == h; ++sub_node) { //here we go...
-                if(name(sub_node) == segment) {
+                if(nameEquals(sub_node, segment)) {
                     found = true;
                     int offset = findOffset(sub_node);
 #ifdef DEBUG_RESOURCE_MATCH
@@ -799,18 +1014,13 @@ const uchar *QResourceRoot::data(int node, qint64 *size) const
     return 0;
 }
 
-QDateTime QResourceRoot::lastModified(int node) const
+quint64 QResourceRoot::lastModified(int node) const
 {
     if (node == -1 || version < 0x02)
-        return QDateTime();
+        return 0;
 
     const int offset = findOffset(node) + 14;
-
-    const quint64 timeStamp = qFromBigEndian<quint64>(tree + offset);
-    if (timeStamp == 0)
-        return QDateTime();
-
-    return QDateTime::fromMSecsSinceEpoch(timeStamp);
+    return qFromBigEndian<quint64>(tree + offset);
 }
 
 QStringList QResourceRoot::children(int node) const
@@ -860,7 +1070,7 @@ Q_CORE_EXPORT bool qRegisterResourceData(int version, const unsigned char *tree,
                                          const unsigned char *name, const unsigned char *data)
 {
     QMutexLocker lock(resourceMutex());
-    if ((version == 0x01 || version == 0x2) && resourceList()) {
+    if (version >= 0x01 && version <= 0x03 && resourceList()) {
         bool found = false;
         QResourceRoot res(version, tree, name, data);
         for(int i = 0; i < resourceList()->size(); ++i) {
@@ -886,7 +1096,7 @@ Q_CORE_EXPORT bool qUnregisterResourceData(int version, const unsigned char *tre
         return false;
 
     QMutexLocker lock(resourceMutex());
-    if ((version == 0x01 || version == 0x02) && resourceList()) {
+    if (version >= 0x01 && version <= 0x03 && resourceList()) {
         QResourceRoot res(version, tree, name, data);
         for(int i = 0; i < resourceList()->size(); ) {
             if(*resourceList()->at(i) == res) {
@@ -949,7 +1159,7 @@ public:
         if (size >= 0 && (tree_offset >= size || data_offset >= size || name_offset >= size))
             return false;
 
-        if (version == 0x01 || version == 0x02) {
+        if (version >= 0x01 && version <= 0x03) {
             buffer = b;
             setSource(version, b+tree_offset, b+name_offset, b+data_offset);
             return true;
@@ -1224,10 +1434,15 @@ protected:
 private:
     uchar *map(qint64 offset, qint64 size, QFile::MemoryMapFlags flags);
     bool unmap(uchar *ptr);
-    void uncompress() const;
+    bool uncompress(qint64 length) const;
+    qint64 uncompressedSize() const;
+    const char *uncompressedData() const
+    { return lz4 ? lz4->data() : uncompressed.constData(); }
     qint64 offset;
     QResource resource;
     mutable QByteArray uncompressed;
+    // LZ4 data is uncompressed as it is read
+    mutable QScopedPointer<QLz4Decoder> lz4;
 protected:
     QResourceFileEnginePrivate() : offset(0) { }
 };
@@ -1283,7 +1498,6 @@ bool QResourceFileEngine::open(QIODevice::OpenMode flags)
     }
     if(flags & QIODevice::WriteOnly)
         return false;
-    d->uncompress();
     if (!d->resource.isValid()) {
         d->errorString = QSystemError::stdString(ENOENT);
         return false;
@@ -1296,6 +1510,7 @@ bool QResourceFileEngine::close()
     Q_D(QResourceFileEngine);
     d->offset = 0;
     d->uncompressed.clear();
+    d->lz4.reset();
     return true;
 }
 
@@ -1311,9 +1526,13 @@ qint64 QResourceFileEngine::read(char *data, qint64 len)
         len = size()-d->offset;
     if(len <= 0)
         return 0;
-    if(d->resource.isCompressed())
-        memcpy(data, d->uncompressed.constData()+d->offset, len);
-    else
+    if(d->resource.isCompressed()) {
+        if (!d->uncompress(d->offset + len)) {
+            setError(QFile::ReadError, QString());
+            return -1;
+        }
+        memcpy(data, d->uncompressedData()+d->offset, len);
+    } else
         memcpy(data, d->resource.data()+d->offset, len);
     d->offset += len;
     return len;
@@ -1349,10 +1568,8 @@ qint64 QResourceFileEngine::size() const
     Q_D(const QResourceFileEngine);
     if(!d->resource.isValid())
         return 0;
-    if (d->resource.isCompressed()) {
-        d->uncompress();
-        return d->uncompressed.size();
-    }
+    if (d->resource.isCompressed())
+        return d->uncompressedSize();
     return d->resource.size();
 }
 
@@ -1524,15 +1741,27 @@ bool QResourceFileEnginePrivate::unmap(uchar *ptr)
     return true;
 }
 
-void QResourceFileEnginePrivate::uncompress() const
+// Makes the first length bytes of a compressed resource available through
+// uncompressedData(). Returns false if the data is corrupt.
+bool QResourceFileEnginePrivate::uncompress(qint64 length) const
 {
-    if (resource.isCompressed() && uncompressed.isEmpty() && resource.size()) {
-#ifndef QT_NO_COMPRESS
-        uncompressed = qUncompress(resource.data(), resource.size());
-#else
-        Q_ASSERT(!"QResourceFileEngine::open: Qt built without support for compression");
-#endif
+    if (resource.compressionAlgorithm() == QResource::Lz4Compression) {
+        if (!lz4)
+            lz4.reset(new QLz4Decoder(resource.data(), int(resource.size())));
+        return lz4->decode(length);
     }
+    if (uncompressed.isEmpty() && resource.size())
+        uncompressed = resource.uncompressedData();
+    return uncompressed.size() >= length;
+}
+
+qint64 QResourceFileEnginePrivate::uncompressedSize() const
+{
+    uncompress(0);
+    // the size of LZ4 data is known before it is uncompressed
+    if (lz4)
+        return qMax(lz4->size(), qint64(0));
+    return uncompressed.size();
 }
 
 #endif // !defined(QT_BOOTSTRAPPED)
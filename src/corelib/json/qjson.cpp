@@ -457,6 +457,69 @@ void Value::copyData(const QJsonValue &v, char *dest, bool compressed)
     }
 }
 
+QVariant VariantConverter::toVariant(const Base *b, const Value &v)
+{
+    switch (v.type) {
+    case QJsonValue::Bool:
+        return v.toBoolean();
+    case QJsonValue::Double:
+        return v.toDouble(b);
+    case QJsonValue::String:
+        return v.toString(b);
+    case QJsonValue::Array:
+        return toVariantList(static_cast<Array *>(v.base(b)));
+    case QJsonValue::Object:
+        return toVariantMap(static_cast<Object *>(v.base(b)));
+    case QJsonValue::Null:
+        return QVariant::fromValue(nullptr);
+    default:
+        break;
+    }
+    return QVariant();
+}
+
+QVariantList VariantConverter::toVariantList(const Array *a)
+{
+    QVariantList list;
+    list.reserve(a->length);
+    for (int i = 0; i < (int)a->length; ++i)
+        list.append(toVariant(a, a->at(i)));
+    return list;
+}
+
+QVariantMap VariantConverter::toVariantMap(const Object *o)
+{
+    QVariantMap map;
+    for (uint i = 0; i < o->length; ++i) {
+        const Entry *e = o->entryAt(i);
+        map.insert(key(e), toVariant(o, e->value));
+    }
+    return map;
+}
+
+QVariantHash VariantConverter::toVariantHash(const Object *o)
+{
+    QVariantHash hash;
+    hash.reserve(o->length);
+    for (uint i = 0; i < o->length; ++i) {
+        const Entry *e = o->entryAt(i);
+        hash.insert(key(e), toVariant(o, e->value));
+    }
+    return hash;
+}
+
+QString VariantConverter::key(const Entry *e)
+{
+    if (!e->value.latinKey)
+        return e->key();
+
+    const QLatin1String latin1 = e->shallowLatin1Key().toQLatin1String();
+    QString &key = keys[latin1];
+    if (key.isNull())
+        key = QString(latin1);
+    return key;
+}
+
 } // namespace QJsonPrivate
 
 QT_END_NAMESPACE
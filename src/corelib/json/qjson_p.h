@@ -57,7 +57,10 @@
 #include <qjsondocument.h>
 #include <qjsonarray.h>
 #include <qatomic.h>
+#include <qfile.h>
+#include <qhash.h>
 #include <qstring.h>
+#include <qvariant.h>
 #include <qendian.h>
 #include <qnumeric.h>
 
@@ -810,6 +813,26 @@ inline Base *Value::base(const Base *b) const
     return reinterpret_cast<Base *>(data(b));
 }
 
+/*
+    Converts binary JSON to QVariants. The keys of the objects converted by
+    one converter are shared, so that the objects of an array, which usually
+    have the same keys, do not each allocate a copy of them.
+*/
+class VariantConverter
+{
+public:
+    QVariant toVariant(const Base *b, const Value &v);
+    QVariantList toVariantList(const Array *a);
+    QVariantMap toVariantMap(const Object *o);
+    QVariantHash toVariantHash(const Object *o);
+
+private:
+    QString key(const Entry *e);
+
+    // Latin-1 keys point into the binary data, which outlives the converter
+    QHash<QLatin1String, QString> keys;
+};
+
 class Data {
 public:
     enum Validation {
@@ -826,13 +849,15 @@ public:
     };
     uint compactionCounter : 31;
     uint ownsData : 1;
+    // keeps the mapping alive for documents created by fromBinaryFile()
+    QFile *mappedFile;
 
     inline Data(char *raw, int a)
-        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true)
+        : alloc(a), rawData(raw), compactionCounter(0), ownsData(true), mappedFile(0)
     {
     }
     inline Data(int reserved, QJsonValue::Type valueType)
-        : rawData(0), compactionCounter(0), ownsData(true)
+        : rawData(0), compactionCounter(0), ownsData(true), mappedFile(0)
     {
         Q_ASSERT(valueType == QJsonValue::Array || valueType == QJsonValue::Object);
 
@@ -848,7 +873,11 @@ public:
         b->length = 0;
     }
     inline ~Data()
-    { if (ownsData) free(rawData); }
+    {
+        if (ownsData)
+            free(rawData);
+        delete mappedFile;
+    }
 
     uint offsetOf(const void *ptr) const { return (uint)(((char *)ptr - rawData)); }
 
@@ -865,7 +894,8 @@ public:
     Data *clone(Base *b, int reserve = 0)
     {
         int size = sizeof(Header) + b->size;
-        if (b == header->root() && ref.load() == 1 && alloc >= size + reserve)
+        // data we don't own (raw or mapped) is never written to, always copy it
+        if (b == header->root() && ref.load() == 1 && ownsData && alloc >= size + reserve)
             return this;
 
         if (reserve) {
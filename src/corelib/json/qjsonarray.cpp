@@ -311,14 +311,9 @@ QJsonArray QJsonArray::fromVariantList(const QVariantList &list)
  */
 QVariantList QJsonArray::toVariantList() const
 {
-    QVariantList list;
-
-    if (a) {
-        list.reserve(a->length);
-        for (int i = 0; i < (int)a->length; ++i)
-            list.append(QJsonValue(d, a, a->at(i)).toVariant());
-    }
-    return list;
+    if (!a)
+        return QVariantList();
+    return QJsonPrivate::VariantConverter().toVariantList(a);
 }
 
 
@@ -1188,7 +1183,7 @@ bool QJsonArray::detach2(uint reserve)
         d->ref.ref();
         return true;
     }
-    if (reserve == 0 && d->ref.load() == 1)
+    if (reserve == 0 && d->ref.load() == 1 && d->ownsData)
         return true;
 
     QJsonPrivate::Data *x = d->clone(a, reserve);
@@ -44,6 +44,7 @@
 #include <qstringlist.h>
 #include <qvariant.h>
 #include <qdebug.h>
+#include <qfile.h>
 #include "qjsonwriter_p.h"
 #include "qjsonparser_p.h"
 #include "qjson_p.h"
@@ -73,8 +74,8 @@ QT_BEGIN_NAMESPACE
     and isObject(). The array or object contained in the document can be retrieved using
     array() or object() and then read or manipulated.
 
-    A document can also be created from a stored binary representation using fromBinaryData() or
-    fromRawData().
+    A document can also be created from a stored binary representation using fromBinaryData(),
+    fromRawData() or, without copying the data, from a file using fromBinaryFile().
 
     \sa {JSON Support in Qt}, {JSON Save Game Example}
 */
@@ -256,6 +257,68 @@ QJsonDocument QJsonDocument::fromBinaryData(const QByteArray &data, DataValidati
     return QJsonDocument(d);
 }
 
+/*!
+ \since 5.10
+
+ Creates a QJsonDocument from the binary encoded JSON document stored
+ in the file \a fileName, as written by toBinaryData().
+
+ The file is memory-mapped and the returned document, as well as any
+ QJsonObject or QJsonArray obtained from it, reads directly from the
+ mapping. No copy of the data is made until the document or one of its
+ values is modified. The file is kept open and mapped for as long as any
+ QJsonDocument, QJsonObject or QJsonArray still references it; the caller
+ must not truncate or modify the file during that time.
+
+ The header is always checked before the data is used. \a validation
+ decides whether the whole document is checked for validity as well.
+ Validation reads, but does not copy, the complete file, so
+ BypassValidation should be used for large files that come from a
+ trusted place and only a part of which is accessed.
+
+ If the file cannot be opened or mapped, or the data is not valid, the
+ method returns a null document.
+
+ \sa fromBinaryData(), fromRawData(), toBinaryData(), isNull(), DataValidation
+ */
+QJsonDocument QJsonDocument::fromBinaryFile(const QString &fileName, DataValidation validation)
+{
+    QFile *file = new QFile(fileName);
+    const qint64 fileSize = file->size();
+    if (fileSize < qint64(sizeof(QJsonPrivate::Header) + sizeof(QJsonPrivate::Base))
+        || fileSize > std::numeric_limits<int>::max()
+        || !file->open(QIODevice::ReadOnly)) {
+        delete file;
+        return QJsonDocument();
+    }
+
+    char *raw = reinterpret_cast<char *>(file->map(0, fileSize));
+    if (!raw) {
+        delete file;
+        return QJsonDocument();
+    }
+
+    // only the header is checked up front, so that pages of the mapping are
+    // not faulted in unless the caller asked for full validation
+    QJsonPrivate::Header *h = reinterpret_cast<QJsonPrivate::Header *>(raw);
+    if (h->tag != QJsonDocument::BinaryFormatTag || h->version != 1u
+        || sizeof(QJsonPrivate::Header) + h->root()->size > quint64(fileSize)) {
+        delete file;
+        return QJsonDocument();
+    }
+
+    QJsonPrivate::Data *d = new QJsonPrivate::Data(raw, sizeof(QJsonPrivate::Header) + h->root()->size);
+    d->ownsData = false;
+    d->mappedFile = file;
+
+    if (validation != BypassValidation && !d->valid()) {
+        delete d;
+        return QJsonDocument();
+    }
+
+    return QJsonDocument(d);
+}
+
 /*!
  Creates a QJsonDocument from the QVariant \a variant.
 
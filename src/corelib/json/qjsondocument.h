@@ -104,6 +104,8 @@ public:
     static QJsonDocument fromBinaryData(const QByteArray &data, DataValidation validation  = Validate);
     QByteArray toBinaryData() const;
 
+    static QJsonDocument fromBinaryFile(const QString &fileName, DataValidation validation = Validate);
+
     static QJsonDocument fromVariant(const QVariant &variant);
     QVariant toVariant() const;
 
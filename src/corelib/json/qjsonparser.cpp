@@ -258,6 +258,28 @@ void Parser::eatBOM()
 
 bool Parser::eatSpace()
 {
+    // fast path for compact documents, where most tokens aren't preceded by whitespace
+    if (json < end && *json > Space)
+        return true;
+
+#ifdef __SSE2__
+    // skip indentation 16 bytes at a time
+    const __m128i space = _mm_set1_epi8(Space);
+    const __m128i tab = _mm_set1_epi8(Tab);
+    const __m128i lineFeed = _mm_set1_epi8(LineFeed);
+    const __m128i carriageReturn = _mm_set1_epi8(Return);
+    for ( ; json + 16 <= end; json += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(chunk, lineFeed), _mm_cmpeq_epi8(chunk, carriageReturn)));
+        const uint mask = ~_mm_movemask_epi8(ws) & 0xffff;
+        if (mask) {
+            json += qCountTrailingZeroBits(mask);
+            return true;
+        }
+    }
+#endif
+
     while (json < end) {
         if (*json > Space)
             break;
@@ -732,13 +754,13 @@ bool Parser::parseValue(QJsonPrivate::Value *val, int baseOffset)
 
 */
 
-bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
+/*
+    Moves \a json past the characters making up a number and sets \a isInt
+    to whether it has neither a fraction nor an exponent.
+*/
+static inline void scanNumber(const char *&json, const char *end, bool *isInt)
 {
-    BEGIN << "parseNumber" << json;
-    val->type = QJsonValue::Double;
-
-    const char *start = json;
-    bool isInt = true;
+    *isInt = true;
 
     // minus
     if (json < end && *json == '-')
@@ -754,7 +776,7 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
 
     // frac = decimal-point 1*DIGIT
     if (json < end && *json == '.') {
-        isInt = false;
+        *isInt = false;
         ++json;
         while (json < end && *json >= '0' && *json <= '9')
             ++json;
@@ -762,13 +784,23 @@ bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
 
     // exp = e [ minus / plus ] 1*DIGIT
     if (json < end && (*json == 'e' || *json == 'E')) {
-        isInt = false;
+        *isInt = false;
         ++json;
         if (json < end && (*json == '-' || *json == '+'))
             ++json;
         while (json < end && *json >= '0' && *json <= '9')
             ++json;
     }
+}
+
+bool Parser::parseNumber(QJsonPrivate::Value *val, int baseOffset)
+{
+    BEGIN << "parseNumber" << json;
+    val->type = QJsonValue::Double;
+
+    const char *start = json;
+    bool isInt;
+    scanNumber(json, end, &isInt);
 
     if (json >= end) {
         lastError = QJsonParseError::TerminationByNumber;
@@ -912,6 +944,65 @@ static inline bool scanUtf8Char(const char *&json, const char *end, uint *result
     return true;
 }
 
+/*
+    Returns the number of bytes at the start of [json, end) that can be copied
+    into a string verbatim: 7-bit characters other than the quote and the
+    backslash. Control characters are accepted, as in the character by
+    character loop in parseString().
+*/
+static inline int plainStringLength(const char *json, const char *end)
+{
+    const char *p = json;
+#ifdef __AVX2__
+    const __m256i quote32 = _mm256_set1_epi8('"');
+    const __m256i backslash32 = _mm256_set1_epi8('\\');
+    for ( ; p + 32 <= end; p += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        // non-ASCII bytes have their sign bit set, which the movemask picks up as is
+        const __m256i special = _mm256_or_si256(chunk, _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote32),
+                                                                        _mm256_cmpeq_epi8(chunk, backslash32)));
+        const uint mask = _mm256_movemask_epi8(special);
+        if (mask)
+            return int(p - json) + qCountTrailingZeroBits(mask);
+    }
+#endif
+#ifdef __SSE2__
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for ( ; p + 16 <= end; p += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const __m128i special = _mm_or_si128(chunk, _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                                 _mm_cmpeq_epi8(chunk, backslash)));
+        const uint mask = _mm_movemask_epi8(special);
+        if (mask)
+            return int(p - json) + qCountTrailingZeroBits(mask);
+    }
+#endif
+    for ( ; p < end; ++p) {
+        if (*p == '"' || *p == '\\' || uchar(*p) >= 0x80)
+            break;
+    }
+    return int(p - json);
+}
+
+/*
+    Writes the \a length 7-bit characters at \a src as little endian UTF-16 to \a dst.
+*/
+static inline void widenPlainString(char *dst, const char *src, int length)
+{
+    int i = 0;
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; i + 16 <= length; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * i), _mm_unpacklo_epi8(chunk, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * i + 16), _mm_unpackhi_epi8(chunk, zero));
+    }
+#endif
+    for ( ; i < length; ++i)
+        *reinterpret_cast<QJsonPrivate::qle_ushort *>(dst + 2 * i) = ushort(uchar(src[i]));
+}
+
 bool Parser::parseString(bool *latin1)
 {
     *latin1 = true;
@@ -927,6 +1018,19 @@ bool Parser::parseString(bool *latin1)
 
     BEGIN << "parse string stringPos=" << stringPos << json;
     while (json < end) {
+        // copy runs of plain characters in one go, leaving the character that
+        // would exceed the latin1 length limit to the check below
+        const int run = qMin(plainStringLength(json, end), 0x7fff - int(json - start));
+        if (run > 0) {
+            int pos = reserveSpace(run);
+            if (pos < 0)
+                return false;
+            memcpy(data + pos, json, run);
+            json += run;
+            if (json >= end)
+                break;
+        }
+
         uint ch = 0;
         if (*json == '"')
             break;
@@ -979,6 +1083,17 @@ bool Parser::parseString(bool *latin1)
     current = outStart + sizeof(int);
 
     while (json < end) {
+        const int run = plainStringLength(json, end);
+        if (run > 0) {
+            int pos = reserveSpace(2 * run);
+            if (pos < 0)
+                return false;
+            widenPlainString(data + pos, json, run);
+            json += run;
+            if (json >= end)
+                break;
+        }
+
         uint ch = 0;
         if (*json == '"')
             break;
@@ -1024,4 +1139,63 @@ bool Parser::parseString(bool *latin1)
     return true;
 }
 
+/*
+    The functions below decode single values outside of a complete document
+    and are shared with QJsonStreamReader.
+*/
+
+const char *QJsonPrivate::findNumberEnd(const char *json, const char *end)
+{
+    bool isInt;
+    scanNumber(json, end, &isInt);
+    return json;
+}
+
+bool QJsonPrivate::decodeNumber(const char *begin, const char *end, double *result)
+{
+    bool ok;
+    *result = QByteArray::fromRawData(begin, int(end - begin)).toDouble(&ok);
+    return ok;
+}
+
+bool QJsonPrivate::decodeString(const char *json, const char *end, QString *result,
+                                QJsonParseError::ParseError *error, int *errorOffset)
+{
+    const char *start = json;
+    result->clear();
+    result->reserve(int(end - json));
+
+    while (json < end) {
+        const int run = plainStringLength(json, end);
+        if (run > 0) {
+            result->append(QLatin1String(json, run));
+            json += run;
+            if (json >= end)
+                break;
+        }
+
+        uint ch = 0;
+        if (*json == '\\') {
+            if (!scanEscapeSequence(json, end, &ch)) {
+                *error = QJsonParseError::IllegalEscapeSequence;
+                *errorOffset = int(json - start);
+                return false;
+            }
+        } else {
+            if (!scanUtf8Char(json, end, &ch)) {
+                *error = QJsonParseError::IllegalUTF8String;
+                *errorOffset = int(json - start);
+                return false;
+            }
+        }
+        if (QChar::requiresSurrogates(ch)) {
+            result->append(QChar(QChar::highSurrogate(ch)));
+            result->append(QChar(QChar::lowSurrogate(ch)));
+        } else {
+            result->append(QChar(ch));
+        }
+    }
+    return true;
+}
+
 QT_END_NAMESPACE
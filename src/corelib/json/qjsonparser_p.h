@@ -59,6 +59,12 @@ QT_BEGIN_NAMESPACE
 
 namespace QJsonPrivate {
 
+// used by QJsonStreamReader to decode values one at a time
+const char *findNumberEnd(const char *json, const char *end);
+bool decodeNumber(const char *begin, const char *end, double *result);
+bool decodeString(const char *json, const char *end, QString *result,
+                  QJsonParseError::ParseError *error, int *errorOffset);
+
 class Parser
 {
 public:
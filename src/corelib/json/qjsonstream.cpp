@@ -0,0 +1,1198 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qjsonstream.h"
+
+#include <qjsonobject.h>
+#include <qjsonarray.h>
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+#include <qdebug.h>
+#include "qjsonparser_p.h"
+#include "qjsonwriter_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// same limit as QJsonPrivate::Parser
+static const int nestingLimit = 1024;
+
+// number of bytes read from the device at a time
+static const int readChunkSize = 16384;
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum State {
+        ExpectValue,
+        ExpectValueOrEndArray,
+        ExpectNameOrEndObject,
+        ExpectName,
+        ExpectNameSeparator,
+        ExpectValueSeparatorOrEnd
+    };
+
+    QJsonStreamReaderPrivate()
+        : device(0), pos(0), offset(0), state(ExpectValue),
+          type(QJsonStreamReader::NoToken), error(QJsonStreamReader::NoError),
+          parseError(QJsonParseError::NoError), atEnd(false)
+    {
+    }
+
+    void init();
+    bool readMore();
+    bool endOfInput() const;
+    bool ensure(int bytes);
+    bool skipSpace();
+    void compact();
+
+    QJsonStreamReader::TokenType next();
+    QJsonStreamReader::TokenType readString(QString *result);
+    QJsonStreamReader::TokenType readNumber();
+    QJsonStreamReader::TokenType readLiteral(const char *literal, int length, const QJsonValue &literalValue);
+    QJsonStreamReader::TokenType startContainer(bool object);
+    QJsonStreamReader::TokenType endContainer(bool object);
+    QJsonStreamReader::TokenType outOfData();
+    QJsonStreamReader::TokenType premature();
+    QJsonStreamReader::TokenType raiseError(QJsonParseError::ParseError e, int errorPos);
+
+    void valueRead()
+    { state = containers.isEmpty() ? ExpectValue : ExpectValueSeparatorOrEnd; }
+
+    QIODevice *device;
+    QByteArray buffer;
+    int pos;
+    qint64 offset;
+
+    // true for objects, false for arrays
+    QVarLengthArray<bool, 32> containers;
+    State state;
+
+    QJsonStreamReader::TokenType type;
+    QJsonStreamReader::Error error;
+    QJsonParseError::ParseError parseError;
+    bool atEnd;
+
+    QString name;
+    QJsonValue value;
+};
+
+void QJsonStreamReaderPrivate::init()
+{
+    buffer.clear();
+    pos = 0;
+    offset = 0;
+    containers.clear();
+    state = ExpectValue;
+    type = QJsonStreamReader::NoToken;
+    error = QJsonStreamReader::NoError;
+    parseError = QJsonParseError::NoError;
+    atEnd = false;
+    name.clear();
+    value = QJsonValue();
+}
+
+/*
+    Drops the bytes that have been consumed already, so that the buffer only
+    ever holds the token being read plus one chunk of look-ahead.
+*/
+void QJsonStreamReaderPrivate::compact()
+{
+    if (!pos)
+        return;
+    buffer.remove(0, pos);
+    offset += pos;
+    pos = 0;
+}
+
+bool QJsonStreamReaderPrivate::readMore()
+{
+    if (!device || !device->isReadable())
+        return false;
+
+    compact();
+    const int oldSize = buffer.size();
+    buffer.resize(oldSize + readChunkSize);
+    const qint64 read = device->read(buffer.data() + oldSize, readChunkSize);
+    buffer.resize(oldSize + int(qMax(read, Q_INT64_C(0))));
+    return read > 0;
+}
+
+/*
+    Returns \c true if no more data can arrive: the device has been closed,
+    or a random-access device has been read to its end. Data added with
+    addData() and data from sequential devices may always grow.
+*/
+bool QJsonStreamReaderPrivate::endOfInput() const
+{
+    if (!device)
+        return false;
+    if (!device->isReadable())
+        return true;
+    return !device->isSequential() && device->atEnd();
+}
+
+bool QJsonStreamReaderPrivate::ensure(int bytes)
+{
+    while (buffer.size() - pos < bytes) {
+        if (!readMore())
+            return false;
+    }
+    return true;
+}
+
+bool QJsonStreamReaderPrivate::skipSpace()
+{
+    forever {
+        const char *json = buffer.constData();
+        const int size = buffer.size();
+        while (pos < size) {
+            const char c = json[pos];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+                return true;
+            ++pos;
+        }
+        if (!readMore())
+            return false;
+    }
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::outOfData()
+{
+    // running out of data between two top-level values is not an error,
+    // it is how a stream of documents (e.g. JSON lines) ends
+    if (state == ExpectValue && containers.isEmpty()) {
+        atEnd = true;
+        return QJsonStreamReader::NoToken;
+    }
+    return premature();
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::premature()
+{
+    atEnd = true;
+    error = QJsonStreamReader::PrematureEndOfDocumentError;
+    return QJsonStreamReader::Invalid;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::raiseError(QJsonParseError::ParseError e, int errorPos)
+{
+    atEnd = true;
+    error = QJsonStreamReader::NotWellFormedError;
+    parseError = e;
+    pos = errorPos;
+    return QJsonStreamReader::Invalid;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::startContainer(bool object)
+{
+    if (containers.size() >= nestingLimit)
+        return raiseError(QJsonParseError::DeepNesting, pos);
+    containers.append(object);
+    ++pos;
+    state = object ? ExpectNameOrEndObject : ExpectValueOrEndArray;
+    return object ? QJsonStreamReader::StartObject : QJsonStreamReader::StartArray;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::endContainer(bool object)
+{
+    if (containers.last() != object)
+        return raiseError(object ? QJsonParseError::UnterminatedArray : QJsonParseError::UnterminatedObject, pos);
+    containers.removeLast();
+    ++pos;
+    valueRead();
+    return object ? QJsonStreamReader::EndObject : QJsonStreamReader::EndArray;
+}
+
+/*
+    Reads the string starting at the quote at pos into \a result. The whole
+    string has to be in the buffer before it is decoded, so that truncated
+    escape sequences or UTF-8 characters aren't mistaken for invalid ones.
+*/
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readString(QString *result)
+{
+    int scanned = pos + 1;
+    int quote = -1;
+    forever {
+        const char *json = buffer.constData();
+        const int size = buffer.size();
+        while (scanned < size) {
+            if (json[scanned] == '\\') {
+                // leave a trailing backslash for the next round
+                if (scanned + 1 == size)
+                    break;
+                scanned += 2;
+            } else if (json[scanned] == '"') {
+                quote = scanned;
+                break;
+            } else {
+                ++scanned;
+            }
+        }
+        if (quote >= 0)
+            break;
+
+        const int oldPos = pos;
+        if (!readMore())
+            return premature();
+        scanned -= oldPos - pos;
+    }
+
+    int errorOffset = 0;
+    const char *json = buffer.constData();
+    if (!QJsonPrivate::decodeString(json + pos + 1, json + quote, result, &parseError, &errorOffset))
+        return raiseError(parseError, pos + 1 + errorOffset);
+    pos = quote + 1;
+    return QJsonStreamReader::Value;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readNumber()
+{
+    const char *json;
+    const char *numberEnd;
+    forever {
+        json = buffer.constData();
+        numberEnd = QJsonPrivate::findNumberEnd(json + pos, json + buffer.size());
+        // a number is only complete once we have seen the character after
+        // it, or the end of the input
+        if (numberEnd < json + buffer.size())
+            break;
+        if (!readMore()) {
+            if (!endOfInput())
+                return premature();
+            // readMore() may have moved the data
+            json = buffer.constData();
+            numberEnd = json + buffer.size();
+            break;
+        }
+    }
+
+    double d;
+    if (numberEnd == json + pos || !QJsonPrivate::decodeNumber(json + pos, numberEnd, &d))
+        return raiseError(QJsonParseError::IllegalNumber, pos);
+    pos = int(numberEnd - json);
+    value = QJsonValue(d);
+    valueRead();
+    return QJsonStreamReader::Value;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readLiteral(const char *literal, int length, const QJsonValue &literalValue)
+{
+    if (!ensure(length))
+        return premature();
+    if (memcmp(buffer.constData() + pos, literal, length) != 0)
+        return raiseError(QJsonParseError::IllegalValue, pos);
+    pos += length;
+    value = literalValue;
+    valueRead();
+    return QJsonStreamReader::Value;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::next()
+{
+    forever {
+        if (!skipSpace())
+            return outOfData();
+
+        const char c = buffer.at(pos);
+        switch (state) {
+        case ExpectNameSeparator:
+            if (c != ':')
+                return raiseError(QJsonParseError::MissingNameSeparator, pos);
+            ++pos;
+            state = ExpectValue;
+            continue;
+
+        case ExpectValueSeparatorOrEnd:
+            if (c == ',') {
+                ++pos;
+                state = containers.last() ? ExpectName : ExpectValue;
+                continue;
+            }
+            if (c == '}')
+                return endContainer(true);
+            if (c == ']')
+                return endContainer(false);
+            return raiseError(QJsonParseError::MissingValueSeparator, pos);
+
+        case ExpectNameOrEndObject:
+            if (c == '}')
+                return endContainer(true);
+            Q_FALLTHROUGH();
+        case ExpectName: {
+            if (c != '"')
+                return raiseError(QJsonParseError::UnterminatedObject, pos);
+            QJsonStreamReader::TokenType t = readString(&name);
+            if (t != QJsonStreamReader::Value)
+                return t;
+            state = ExpectNameSeparator;
+            return QJsonStreamReader::Name;
+        }
+
+        case ExpectValueOrEndArray:
+            if (c == ']')
+                return endContainer(false);
+            Q_FALLTHROUGH();
+        case ExpectValue:
+            switch (c) {
+            case '{':
+                return startContainer(true);
+            case '[':
+                return startContainer(false);
+            case '"': {
+                QString s;
+                QJsonStreamReader::TokenType t = readString(&s);
+                if (t == QJsonStreamReader::Value) {
+                    value = QJsonValue(s);
+                    valueRead();
+                }
+                return t;
+            }
+            case 't':
+                return readLiteral("true", 4, QJsonValue(true));
+            case 'f':
+                return readLiteral("false", 5, QJsonValue(false));
+            case 'n':
+                return readLiteral("null", 4, QJsonValue(QJsonValue::Null));
+            default:
+                if (c == '-' || (c >= '0' && c <= '9'))
+                    return readNumber();
+                return raiseError(QJsonParseError::IllegalValue, pos);
+            }
+        }
+    }
+}
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.10
+
+    \brief The QJsonStreamReader class provides a fast pull parser for JSON
+    text read from a QIODevice or supplied in chunks.
+
+    QJsonStreamReader is an incremental alternative to QJsonDocument::fromJson().
+    Instead of building a document for the complete input, it returns the
+    input as a stream of tokens, much like QXmlStreamReader does for XML.
+    Only the token being read is held in memory, so the memory used does not
+    depend on the size of the input.
+
+    The reader is driven by calling readNext(), which returns the type of
+    the next token:
+
+    \table
+    \header \li Token \li Meaning
+    \row \li StartObject, EndObject \li An object begins or ends.
+    \row \li StartArray, EndArray \li An array begins or ends.
+    \row \li Name \li The name of an object member, available as name().
+                      The member's value follows as the next token.
+    \row \li Value \li A string, number, boolean or null, available as value().
+    \endtable
+
+    \snippet code/src_corelib_json_qjsonstream.cpp 1
+
+    The input may contain any number of JSON values one after the other,
+    separated by whitespace, as in a JSON Lines file. atEnd() returns \c true
+    once the input is exhausted between two values.
+
+    Data can be read from a QIODevice set with setDevice(), or added in
+    chunks with addData(). If the reader runs out of data in the middle of a
+    value, readNext() returns Invalid and error() returns
+    PrematureEndOfDocumentError. This is not fatal: once more data has been
+    added, or has become available on the device, calling readNext() again
+    continues where the reader stopped. Numbers are only complete once the
+    character following them has been read, or once the end of the input has
+    been reached, i.e. the device has been closed or, unless it is
+    sequential, read to its end. A number at the very end of data added with
+    addData() or read from a sequential device that is still open remains
+    incomplete until more data arrives.
+
+    Any other error is fatal and is reported as NotWellFormedError, with
+    parseError() giving the reason in terms of QJsonParseError.
+
+    \sa QJsonStreamWriter, QJsonDocument, QXmlStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum specifies the type of token the reader just read.
+
+    \value NoToken The reader has not yet read anything, or it has read all
+    available input and is positioned between two top-level values.
+    \value Invalid An error has occurred, reported in error() and errorString().
+    \value StartObject The reader reports the start of an object.
+    \value EndObject The reader reports the end of an object.
+    \value StartArray The reader reports the start of an array.
+    \value EndArray The reader reports the end of an array.
+    \value Name The reader reports the name of an object member in name().
+    \value Value The reader reports a string, number, boolean or null value
+    in value().
+*/
+
+/*!
+    \enum QJsonStreamReader::Error
+
+    This enum specifies the different error cases.
+
+    \value NoError No error has occurred.
+    \value NotWellFormedError The input is not valid JSON. parseError()
+    returns the reason.
+    \value PrematureEndOfDocumentError The input ended in the middle of a
+    value. More data can be added with addData(), or made available on the
+    device, to continue reading.
+*/
+
+/*!
+    Constructs a stream reader.
+
+    \sa setDevice(), addData()
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Creates a new stream reader that reads from \a device.
+
+    \sa setDevice(), clear()
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Creates a new stream reader that reads from \a data.
+
+    \sa addData(), clear(), setDevice()
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d_ptr(new QJsonStreamReaderPrivate)
+{
+    addData(data);
+}
+
+/*!
+    Destructs the reader.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the current device to \a device. Setting the device resets the
+    stream to its initial state.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamReader);
+    d->init();
+    d->device = device;
+}
+
+/*!
+    Returns the current device associated with the QJsonStreamReader,
+    or 0 if no device has been assigned.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->device;
+}
+
+/*!
+    Adds more \a data for the reader to read. This function does nothing
+    if the reader has a device().
+
+    \sa readNext(), clear()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    Q_D(QJsonStreamReader);
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+    d->compact();
+    d->buffer += data;
+}
+
+/*!
+    Removes any device() or data from the reader and resets its internal
+    state to the initial state.
+
+    \sa addData()
+*/
+void QJsonStreamReader::clear()
+{
+    Q_D(QJsonStreamReader);
+    d->init();
+    d->device = 0;
+}
+
+/*!
+    Returns \c true if the reader has read all of its input and is positioned
+    between two top-level values, or if an error() has occurred. Otherwise
+    returns \c false.
+
+    When atEnd() and hasError() return \c true and error() returns
+    PrematureEndOfDocumentError, the input has been valid so far but ended in
+    the middle of a value. Reading can continue once more data is available.
+
+    \sa hasError(), error(), device(), QIODevice::atEnd()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->atEnd;
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    If an error() of type NotWellFormedError has occurred, reading is no
+    longer possible and Invalid is returned.
+
+    \sa tokenType(), tokenString()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    Q_D(QJsonStreamReader);
+    if (d->error == NotWellFormedError)
+        return d->type;
+
+    d->error = NoError;
+    d->atEnd = false;
+    d->value = QJsonValue();
+    d->type = d->next();
+    return d->type;
+}
+
+/*!
+    Reads until the end of the current object or array, skipping any child
+    values. If the current token is a Name, the member's value is skipped.
+    For any other token, this function does nothing.
+
+    If the reader runs out of data while skipping, it stops with error() set
+    to PrematureEndOfDocumentError.
+*/
+void QJsonStreamReader::skipCurrentValue()
+{
+    Q_D(QJsonStreamReader);
+    if (d->type == Name) {
+        if (readNext() != StartObject && d->type != StartArray)
+            return;
+    }
+    if (d->type != StartObject && d->type != StartArray)
+        return;
+
+    const int level = depth();
+    while (readNext() != Invalid && d->type != NoToken) {
+        if (depth() < level)
+            break;
+    }
+}
+
+/*!
+    Returns the type of the current token.
+
+    \sa tokenString()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type;
+}
+
+/*!
+    Returns the reader's current token as string.
+
+    \sa tokenType()
+*/
+QString QJsonStreamReader::tokenString() const
+{
+    Q_D(const QJsonStreamReader);
+    switch (d->type) {
+    case NoToken:
+        return QStringLiteral("NoToken");
+    case Invalid:
+        return QStringLiteral("Invalid");
+    case StartObject:
+        return QStringLiteral("StartObject");
+    case EndObject:
+        return QStringLiteral("EndObject");
+    case StartArray:
+        return QStringLiteral("StartArray");
+    case EndArray:
+        return QStringLiteral("EndArray");
+    case Name:
+        return QStringLiteral("Name");
+    case Value:
+        return QStringLiteral("Value");
+    }
+    return QString();
+}
+
+/*!
+    Returns the number of objects and arrays that are open at the current
+    position. It is 0 for top-level values and increases by one with every
+    StartObject or StartArray token.
+*/
+int QJsonStreamReader::depth() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->containers.size();
+}
+
+/*!
+    Returns the member name if the current token is a Name. Otherwise the
+    returned string is undefined.
+*/
+QString QJsonStreamReader::name() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->type == Name ? d->name : QString();
+}
+
+/*!
+    Returns the value if the current token is a Value, and an undefined
+    QJsonValue otherwise.
+*/
+QJsonValue QJsonStreamReader::value() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->value;
+}
+
+/*!
+    Returns the current character offset, counting from 0, i.e. the number
+    of bytes of input the reader has consumed. If an error occurred, it is
+    the offset at which it was detected.
+*/
+qint64 QJsonStreamReader::characterOffset() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->offset + d->pos;
+}
+
+/*!
+    Returns the type of the current error, or NoError if no error occurred.
+
+    \sa parseError(), errorString(), hasError()
+*/
+QJsonStreamReader::Error QJsonStreamReader::error() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->error;
+}
+
+/*!
+    Returns the reason why the input is not well-formed if error() is
+    NotWellFormedError, and QJsonParseError::NoError otherwise.
+*/
+QJsonParseError::ParseError QJsonStreamReader::parseError() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->error == NotWellFormedError ? d->parseError : QJsonParseError::NoError;
+}
+
+/*!
+    Returns a human readable description of the current error().
+
+    \sa error(), characterOffset()
+*/
+QString QJsonStreamReader::errorString() const
+{
+    Q_D(const QJsonStreamReader);
+    QJsonParseError e;
+    e.offset = int(characterOffset());
+    switch (d->error) {
+    case NoError:
+        e.error = QJsonParseError::NoError;
+        break;
+    case NotWellFormedError:
+        e.error = d->parseError;
+        break;
+    case PrematureEndOfDocumentError:
+        e.error = d->containers.isEmpty() || d->state == QJsonStreamReaderPrivate::ExpectValue
+                ? QJsonParseError::IllegalValue
+                : (d->containers.last() ? QJsonParseError::UnterminatedObject : QJsonParseError::UnterminatedArray);
+        break;
+    }
+    return e.errorString();
+}
+
+/*!
+    Returns \c true if an error has occurred, otherwise \c false.
+
+    \sa errorString(), error()
+*/
+bool QJsonStreamReader::hasError() const
+{
+    Q_D(const QJsonStreamReader);
+    return d->error != NoError;
+}
+
+class QJsonStreamWriterPrivate
+{
+public:
+    struct Container {
+        bool object;
+        bool hasItems;
+        bool hasName;
+    };
+
+    QJsonStreamWriterPrivate()
+        : device(0), byteArray(0), autoFormatting(false), hasError(false)
+    {
+    }
+
+    void write(const QByteArray &data);
+    void writeNewLine(QByteArray &json, int indent) const;
+    bool beginValue(const char *function);
+    void endValue(QByteArray &json);
+
+    void startContainer(bool object);
+    void endContainer(bool object, const char *function);
+    void writeName(const QString &name, const char *function);
+    void writeValue(const QJsonValue &value);
+
+    QIODevice *device;
+    QByteArray *byteArray;
+    bool autoFormatting;
+    bool hasError;
+    QVarLengthArray<Container, 32> containers;
+};
+
+void QJsonStreamWriterPrivate::write(const QByteArray &data)
+{
+    if (byteArray) {
+        byteArray->append(data);
+    } else if (device) {
+        if (device->write(data) != data.size())
+            hasError = true;
+    }
+}
+
+void QJsonStreamWriterPrivate::writeNewLine(QByteArray &json, int indent) const
+{
+    if (!autoFormatting)
+        return;
+    json += '\n';
+    json += QByteArray(4 * indent, ' ');
+}
+
+/*
+    Checks that a value may be written at this point and writes what has to
+    precede it: the separator and indentation inside an array. Inside an
+    object, writeName() has written those already.
+*/
+bool QJsonStreamWriterPrivate::beginValue(const char *function)
+{
+    if (containers.isEmpty())
+        return true;
+
+    Container &c = containers.last();
+    if (c.object) {
+        if (!c.hasName) {
+            qWarning("QJsonStreamWriter::%s: values in an object need a name", function);
+            return false;
+        }
+        c.hasName = false;
+        return true;
+    }
+
+    QByteArray json;
+    if (c.hasItems)
+        json += ',';
+    c.hasItems = true;
+    writeNewLine(json, containers.size());
+    write(json);
+    return true;
+}
+
+/*
+    Ends each top-level value with a line break, so that the output is
+    a valid JSON Lines stream.
+*/
+void QJsonStreamWriterPrivate::endValue(QByteArray &json)
+{
+    if (containers.isEmpty())
+        json += '\n';
+}
+
+void QJsonStreamWriterPrivate::startContainer(bool object)
+{
+    Container c = { object, false, false };
+    containers.append(c);
+    write(object ? QByteArrayLiteral("{") : QByteArrayLiteral("["));
+}
+
+void QJsonStreamWriterPrivate::endContainer(bool object, const char *function)
+{
+    if (containers.isEmpty() || containers.last().object != object) {
+        qWarning("QJsonStreamWriter::%s: no %s to end", function, object ? "object" : "array");
+        return;
+    }
+    if (containers.last().hasName) {
+        qWarning("QJsonStreamWriter::%s: the last member has no value", function);
+        return;
+    }
+
+    containers.removeLast();
+    QByteArray json;
+    writeNewLine(json, containers.size());
+    json += object ? '}' : ']';
+    endValue(json);
+    write(json);
+}
+
+void QJsonStreamWriterPrivate::writeName(const QString &name, const char *function)
+{
+    if (containers.isEmpty() || !containers.last().object) {
+        qWarning("QJsonStreamWriter::%s: names can only be written in an object", function);
+        return;
+    }
+    Container &c = containers.last();
+    if (c.hasName) {
+        qWarning("QJsonStreamWriter::%s: the previous member has no value", function);
+        return;
+    }
+
+    QByteArray json;
+    if (c.hasItems)
+        json += ',';
+    c.hasItems = true;
+    c.hasName = true;
+    writeNewLine(json, containers.size());
+    QJsonPrivate::Writer::stringToJson(name, json);
+    json += autoFormatting ? ": " : ":";
+    write(json);
+}
+
+void QJsonStreamWriterPrivate::writeValue(const QJsonValue &value)
+{
+    QByteArray json;
+    switch (value.type()) {
+    case QJsonValue::Object: {
+        startContainer(true);
+        const QJsonObject object = value.toObject();
+        for (QJsonObject::const_iterator it = object.constBegin(), end = object.constEnd(); it != end; ++it) {
+            writeName(it.key(), "writeValue");
+            beginValue("writeValue");
+            writeValue(it.value());
+        }
+        endContainer(true, "writeValue");
+        return;
+    }
+    case QJsonValue::Array: {
+        startContainer(false);
+        const QJsonArray array = value.toArray();
+        for (const QJsonValue &v : array) {
+            beginValue("writeValue");
+            writeValue(v);
+        }
+        endContainer(false, "writeValue");
+        return;
+    }
+    case QJsonValue::Bool:
+        json += value.toBool() ? "true" : "false";
+        break;
+    case QJsonValue::Double:
+        QJsonPrivate::Writer::doubleToJson(value.toDouble(), json);
+        break;
+    case QJsonValue::String:
+        QJsonPrivate::Writer::stringToJson(value.toString(), json);
+        break;
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        json += "null";
+        break;
+    }
+    endValue(json);
+    write(json);
+}
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 5.10
+
+    \brief The QJsonStreamWriter class provides a JSON writer with a simple
+    streaming API.
+
+    QJsonStreamWriter is the counterpart to QJsonStreamReader. It writes JSON
+    text to a QIODevice or a QByteArray as it goes, without first building a
+    QJsonDocument for the complete output, so arbitrarily large documents can
+    be written with constant memory use.
+
+    Objects and arrays are opened with writeStartObject() or
+    writeStartArray() and closed with writeEndObject() or writeEndArray().
+    Inside an object, each member is written as a name, using writeName(),
+    followed by its value. The overloads that take a name do both in one
+    call. writeValue() writes strings, numbers, booleans and null, as well
+    as complete QJsonObject and QJsonArray values.
+
+    \snippet code/src_corelib_json_qjsonstream.cpp 0
+
+    Each top-level value is followed by a line break, so writing several
+    values one after the other produces a JSON Lines stream that
+    QJsonStreamReader can read back.
+
+    With autoFormatting() enabled, the output is indented the same way as
+    QJsonDocument::toJson() with QJsonDocument::Indented. Otherwise it is
+    the same as with QJsonDocument::Compact.
+
+    Calls that would produce invalid JSON, such as writing a value into an
+    object without a name, print a warning and are ignored.
+
+    \sa QJsonStreamReader, QJsonDocument, QXmlStreamWriter
+*/
+
+/*!
+    Constructs a stream writer.
+
+    \sa setDevice()
+*/
+QJsonStreamWriter::QJsonStreamWriter()
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+}
+
+/*!
+    Constructs a stream writer that writes into \a device.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+    d_ptr->device = device;
+}
+
+/*!
+    Constructs a stream writer that appends to \a array.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *array)
+    : d_ptr(new QJsonStreamWriterPrivate)
+{
+    d_ptr->byteArray = array;
+}
+
+/*!
+    Destructs the writer.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+}
+
+/*!
+    Sets the current device to \a device.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    Q_D(QJsonStreamWriter);
+    d->device = device;
+    d->byteArray = 0;
+}
+
+/*!
+    Returns the current device associated with the QJsonStreamWriter,
+    or 0 if no device has been assigned.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->device;
+}
+
+/*!
+    Enables auto formatting if \a enable is \c true, otherwise disables it.
+
+    The default value is \c false.
+
+    \sa autoFormatting()
+*/
+void QJsonStreamWriter::setAutoFormatting(bool enable)
+{
+    Q_D(QJsonStreamWriter);
+    d->autoFormatting = enable;
+}
+
+/*!
+    Returns \c true if auto formatting is enabled, otherwise \c false.
+
+    \sa setAutoFormatting()
+*/
+bool QJsonStreamWriter::autoFormatting() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->autoFormatting;
+}
+
+/*!
+    Writes the start of an object.
+
+    \sa writeEndObject()
+*/
+void QJsonStreamWriter::writeStartObject()
+{
+    Q_D(QJsonStreamWriter);
+    if (d->beginValue("writeStartObject"))
+        d->startContainer(true);
+}
+
+/*!
+    \overload
+
+    Writes \a name followed by the start of an object, as a member of the
+    current object.
+*/
+void QJsonStreamWriter::writeStartObject(const QString &name)
+{
+    writeName(name);
+    writeStartObject();
+}
+
+/*!
+    Closes the object opened by the last writeStartObject().
+*/
+void QJsonStreamWriter::writeEndObject()
+{
+    Q_D(QJsonStreamWriter);
+    d->endContainer(true, "writeEndObject");
+}
+
+/*!
+    Writes the start of an array.
+
+    \sa writeEndArray()
+*/
+void QJsonStreamWriter::writeStartArray()
+{
+    Q_D(QJsonStreamWriter);
+    if (d->beginValue("writeStartArray"))
+        d->startContainer(false);
+}
+
+/*!
+    \overload
+
+    Writes \a name followed by the start of an array, as a member of the
+    current object.
+*/
+void QJsonStreamWriter::writeStartArray(const QString &name)
+{
+    writeName(name);
+    writeStartArray();
+}
+
+/*!
+    Closes the array opened by the last writeStartArray().
+*/
+void QJsonStreamWriter::writeEndArray()
+{
+    Q_D(QJsonStreamWriter);
+    d->endContainer(false, "writeEndArray");
+}
+
+/*!
+    Writes \a name as the name of the next member of the current object.
+    The member's value has to be written next.
+*/
+void QJsonStreamWriter::writeName(const QString &name)
+{
+    Q_D(QJsonStreamWriter);
+    d->writeName(name, "writeName");
+}
+
+/*!
+    Writes \a value. Undefined values are written as null.
+*/
+void QJsonStreamWriter::writeValue(const QJsonValue &value)
+{
+    Q_D(QJsonStreamWriter);
+    if (d->beginValue("writeValue"))
+        d->writeValue(value);
+}
+
+/*!
+    \overload
+
+    Writes a member with the name \a name and the value \a value to the
+    current object.
+*/
+void QJsonStreamWriter::writeValue(const QString &name, const QJsonValue &value)
+{
+    writeName(name);
+    writeValue(value);
+}
+
+/*!
+    Returns the number of objects and arrays that have been started and not
+    yet ended.
+*/
+int QJsonStreamWriter::depth() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->containers.size();
+}
+
+/*!
+    Returns \c true if writing to the device failed, otherwise \c false.
+*/
+bool QJsonStreamWriter::hasError() const
+{
+    Q_D(const QJsonStreamWriter);
+    return d->hasError;
+}
+
+QT_END_NAMESPACE
@@ -64,6 +64,8 @@ class Writer
 public:
     static void objectToJson(const QJsonPrivate::Object *o, QByteArray &json, int indent, bool compact = false);
     static void arrayToJson(const QJsonPrivate::Array *a, QByteArray &json, int indent, bool compact = false);
+    static void stringToJson(const QString &s, QByteArray &json);
+    static void doubleToJson(double d, QByteArray &json);
 };
 
 }
@@ -344,6 +344,8 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
+    QMutexLocker locker(&currentThreadData->postEventList.mutex);
+    currentThreadData->postEventList.takeIncoming();
     return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
 }
 
@@ -489,6 +491,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         QMutexLocker locker(&threadData->postEventList.mutex);
+        threadData->postEventList.takeIncoming();
         for (int i = 0; i < threadData->postEventList.size(); ++i) {
             const QPostEvent &pe = threadData->postEventList.at(i);
             if (pe.event) {
@@ -1404,6 +1407,27 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    // QMetaCallEvents are never compressed, so they can skip the mutex:
+    // push them onto the incoming list, which the receiving thread takes
+    // before looking at its posted events. Check the flag set by the
+    // QMetaCallEvent constructor, anyone can post a QEvent(QEvent::MetaCall)
+    if (event->metaCall) {
+        QPostEventList &list = data->postEventList;
+        list.posting.ref();
+        // moveToThread() waits for posting to drop to zero after changing the
+        // thread data, so once we've seen it unchanged the push can't be missed
+        if (data == *pdata) {
+            event->posted = true;
+            list.pushIncoming(receiver, static_cast<QMetaCallEvent *>(event), priority);
+            list.posting.deref();
+            QAbstractEventDispatcher *dispatcher = data->eventDispatcher.loadAcquire();
+            if (dispatcher)
+                dispatcher->wakeUp();
+            return;
+        }
+        list.posting.deref();
+    }
+
     // lock the post event mutex
     data->postEventList.mutex.lock();
 
@@ -1422,6 +1446,7 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
     }
 
     QMutexUnlocker locker(&data->postEventList.mutex);
+    data->postEventList.takeIncoming();
 
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
@@ -1550,6 +1575,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->postEventList.takeIncoming();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1710,6 +1736,7 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     QThreadData *data = receiver ? receiver->d_func()->threadData : QThreadData::current();
     QMutexLocker locker(&data->postEventList.mutex);
+    data->postEventList.takeIncoming();
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -1775,6 +1802,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->postEventList.takeIncoming();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
@@ -287,7 +287,7 @@ QT_BEGIN_NAMESPACE
     Contructs an event object of type \a type.
 */
 QEvent::QEvent(Type type)
-    : d(0), t(type), posted(false), spont(false), m_accept(true)
+    : d(0), t(type), posted(false), spont(false), m_accept(true), metaCall(false)
 {}
 
 /*!
@@ -299,7 +299,7 @@ QEvent::QEvent(Type type)
  */
 QEvent::QEvent(const QEvent &other)
     : d(other.d), t(other.t), posted(other.posted), spont(other.spont),
-      m_accept(other.m_accept)
+      m_accept(other.m_accept), metaCall(false)
 {
     // if QEventPrivate becomes available, make sure to implement a
     // virtual QEventPrivate *clone() const; function so we can copy here
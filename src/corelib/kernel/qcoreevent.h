@@ -317,7 +317,8 @@ private:
     ushort posted : 1;
     ushort spont : 1;
     ushort m_accept : 1;
-    ushort reserved : 13;
+    ushort metaCall : 1; // set by QMetaCallEvent
+    ushort reserved : 12;
 
     friend class QCoreApplication;
     friend class QCoreApplicationPrivate;
@@ -327,6 +328,7 @@ private:
     friend class QGraphicsView;
     friend class QGraphicsScene;
     friend class QGraphicsScenePrivate;
+    friend class QMetaCallEvent;
     // from QtTest:
     friend class QSpontaneKeyEvent;
     // needs this:
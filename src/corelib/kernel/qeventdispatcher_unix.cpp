@@ -55,10 +55,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <limits>
+
 #ifndef QT_NO_EVENTFD
 #  include <sys/eventfd.h>
 #endif
 
+#if defined(Q_OS_LINUX)
+#  include <sys/epoll.h>
+#endif
+
 // VxWorks doesn't correctly set the _POSIX_... options
 #if defined(Q_OS_VXWORKS)
 #  if defined(_POSIX_MONOTONIC_CLOCK) && (_POSIX_MONOTONIC_CLOCK <= 0)
@@ -223,17 +229,187 @@ int QThreadPipe::check(const pollfd &pfd)
 }
 
 QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
+#if defined(Q_OS_LINUX)
+    : epollfd(-1)
+#endif
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Can not continue without a thread pipe");
+
+#if defined(Q_OS_LINUX)
+    bool ok = false;
+    int value = qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL", &ok);
+    if (ok && value > 0)
+        initEpoll();
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
+#if defined(Q_OS_LINUX)
+    cleanupEpoll();
+#endif
+
     // cleanup timers
     qDeleteAll(timerList);
 }
 
+#if defined(Q_OS_LINUX)
+/*
+    The epoll(7) backend keeps the kernel's interest list in sync with
+    socketNotifiers as notifiers are registered and unregistered, so that
+    waiting costs O(ready descriptors) instead of O(registered descriptors).
+    It is only used when QT_EVENT_DISPATCHER_EPOLL is set to a positive
+    value; whenever the kernel refuses a descriptor we fall back to poll(2)
+    for the lifetime of the dispatcher.
+*/
+
+static inline quint32 pollToEpollEvents(short events)
+{
+    quint32 result = 0;
+    if (events & POLLIN)
+        result |= EPOLLIN;
+    if (events & POLLOUT)
+        result |= EPOLLOUT;
+    if (events & POLLPRI)
+        result |= EPOLLPRI;
+    return result;
+}
+
+static inline short epollToPollEvents(quint32 events)
+{
+    short result = 0;
+    if (events & EPOLLIN)
+        result |= POLLIN;
+    if (events & EPOLLOUT)
+        result |= POLLOUT;
+    if (events & EPOLLPRI)
+        result |= POLLPRI;
+    if (events & EPOLLERR)
+        result |= POLLERR;
+    if (events & EPOLLHUP)
+        result |= POLLHUP;
+    return result;
+}
+
+bool QEventDispatcherUNIXPrivate::initEpoll()
+{
+    Q_ASSERT(epollfd == -1);
+
+    epollfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollfd == -1) {
+        perror("QEventDispatcherUNIXPrivate: Unable to create epoll instance");
+        return false;
+    }
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = threadPipe.fds[0];
+    if (epoll_ctl(epollfd, EPOLL_CTL_ADD, ev.data.fd, &ev) == -1) {
+        perror("QEventDispatcherUNIXPrivate: Unable to watch thread pipe with epoll");
+        cleanupEpoll();
+        return false;
+    }
+
+    for (auto it = socketNotifiers.cbegin(); it != socketNotifiers.cend(); ++it) {
+        updateEpoll(it.key(), 0, it.value().events());
+        if (epollfd == -1)
+            return false;
+    }
+
+    return true;
+}
+
+void QEventDispatcherUNIXPrivate::cleanupEpoll()
+{
+    if (epollfd != -1) {
+        qt_safe_close(epollfd);
+        epollfd = -1;
+    }
+}
+
+void QEventDispatcherUNIXPrivate::updateEpoll(int fd, short oldEvents, short newEvents)
+{
+    if (epollfd == -1 || oldEvents == newEvents)
+        return;
+
+    epoll_event ev = {};
+    ev.events = pollToEpollEvents(newEvents);
+    ev.data.fd = fd;
+
+    int op = !oldEvents ? EPOLL_CTL_ADD : (!newEvents ? EPOLL_CTL_DEL : EPOLL_CTL_MOD);
+    if (epoll_ctl(epollfd, op, fd, &ev) == 0)
+        return;
+
+    // The kernel drops a descriptor from the interest list when it is closed,
+    // so a notifier that outlives its socket (or a reused descriptor number)
+    // can leave us out of sync; repair that instead of giving up.
+    if (op == EPOLL_CTL_DEL && (errno == ENOENT || errno == EBADF))
+        return;
+    if (op == EPOLL_CTL_MOD && errno == ENOENT
+        && epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &ev) == 0) {
+        return;
+    }
+    if (op == EPOLL_CTL_ADD && errno == EEXIST
+        && epoll_ctl(epollfd, EPOLL_CTL_MOD, fd, &ev) == 0) {
+        return;
+    }
+
+    // Descriptors that epoll cannot watch (regular files, for instance, give
+    // EPERM) are always reported ready by poll(), so use that from now on.
+    // Invalid descriptors also end up here and get POLLNVAL handling.
+    cleanupEpoll();
+}
+
+/*
+    Waits on the epoll instance and fills pollfds with the descriptors that
+    became ready, followed by the thread pipe, so that the result can be
+    processed exactly like that of qt_safe_poll().
+*/
+int QEventDispatcherUNIXPrivate::epollWait(timespec *timeout)
+{
+    Q_ASSERT(epollfd != -1);
+
+    int msecs = -1;
+    if (timeout) {
+        const qint64 ms = qint64(timeout->tv_sec) * 1000 + (timeout->tv_nsec + 999999) / 1000000;
+        msecs = int(qMin<qint64>(ms, std::numeric_limits<int>::max()));
+    }
+
+    epoll_event events[256];
+    const int nready = epoll_wait(epollfd, events, int(sizeof(events) / sizeof(events[0])), msecs);
+
+    pollfd pipefd = threadPipe.prepare();
+    pollfds.clear();
+
+    if (nready == -1) {
+        pollfds.append(pipefd);
+        // treat a signal like a spurious wakeup
+        return errno == EINTR ? 0 : -1;
+    }
+
+    // level-triggered, so anything beyond the buffer is reported next time
+    pollfds.reserve(nready + 1);
+    for (int i = 0; i < nready; ++i) {
+        const short revents = epollToPollEvents(events[i].events);
+        if (events[i].data.fd == pipefd.fd) {
+            pipefd.revents = revents;
+        } else if (socketNotifiers.contains(events[i].data.fd)) {
+            // (a file description that is still open elsewhere stays in the
+            // interest list after its descriptor was closed, so check first)
+            pollfd pfd = qt_make_pollfd(events[i].data.fd, 0);
+            pfd.revents = revents;
+            pollfds.append(pfd);
+        }
+    }
+
+    // This must be last, as it's popped off the end by processEvents()
+    pollfds.append(pipefd);
+
+    return nready;
+}
+#endif // Q_OS_LINUX
+
 void QEventDispatcherUNIXPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
 {
     Q_ASSERT(notifier);
@@ -411,7 +587,13 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
         qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
                  Q_FUNC_INFO, sockfd, socketType(type));
 
+#if defined(Q_OS_LINUX)
+    const short oldEvents = sn_set.events();
+    sn_set.notifiers[type] = notifier;
+    d->updateEpoll(sockfd, oldEvents, sn_set.events());
+#else
     sn_set.notifiers[type] = notifier;
+#endif
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -450,7 +632,13 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
         return;
     }
 
+#if defined(Q_OS_LINUX)
+    const short oldEvents = sn_set.events();
+    sn_set.notifiers[type] = nullptr;
+    d->updateEpoll(sockfd, oldEvents, sn_set.events());
+#else
     sn_set.notifiers[type] = nullptr;
+#endif
 
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
@@ -485,19 +673,30 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
         tm = &wait_tm;
 
-    d->pollfds.clear();
-    d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
+    int nready;
 
-    if (include_notifiers)
-        for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
-            d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+#if defined(Q_OS_LINUX)
+    if (include_notifiers && d->epollfd != -1) {
+        nready = d->epollWait(tm);
+    } else
+#endif
+    {
+        d->pollfds.clear();
+        d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
 
-    // This must be last, as it's popped off the end below
-    d->pollfds.append(d->threadPipe.prepare());
+        if (include_notifiers)
+            for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
+                d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+
+        // This must be last, as it's popped off the end below
+        d->pollfds.append(d->threadPipe.prepare());
+
+        nready = qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm);
+    }
 
     int nevents = 0;
 
-    switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
+    switch (nready) {
     case -1:
         perror("qt_safe_poll");
         break;
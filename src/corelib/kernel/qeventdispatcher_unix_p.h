@@ -141,6 +141,15 @@ public:
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
 
+#if defined(Q_OS_LINUX)
+    bool initEpoll();
+    void cleanupEpoll();
+    void updateEpoll(int fd, short oldEvents, short newEvents);
+    int epollWait(timespec *timeout);
+
+    int epollfd;
+#endif
+
     QThreadPipe threadPipe;
     QVector<pollfd> pollfds;
 
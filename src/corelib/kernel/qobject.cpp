@@ -61,6 +61,7 @@
 #include <qsharedpointer.h>
 
 #include <private/qorderedmutexlocker_p.h>
+#include <private/qfreelist_p.h>
 #include <private/qhooks_p.h>
 
 #include <new>
@@ -248,7 +249,7 @@ QObjectPrivate::~QObjectPrivate()
         }
     }
 
-    if (postedEvents)
+    if (postedEvents || threadData->postEventList.hasIncoming())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     threadData->deref();
@@ -447,6 +448,76 @@ void QObjectPrivate::cleanConnectionLists()
     }
 }
 
+namespace {
+struct MetaCallEventStorage
+{
+    union {
+        void *alignment;
+        char data[sizeof(QMetaCallEvent)];
+    };
+    int id;
+};
+
+struct MetaCallEventConstants : QFreeListDefaultConstants {
+    enum { BlockCount = 4, MaxIndex = 0x3fff };
+    static const int Sizes[BlockCount];
+};
+const int MetaCallEventConstants::Sizes[MetaCallEventConstants::BlockCount] = {
+    64,
+    1024,
+    4096,
+    MetaCallEventConstants::MaxIndex - (64 + 1024 + 4096)
+};
+
+typedef QFreeList<MetaCallEventStorage, MetaCallEventConstants> MetaCallEventFreeList;
+static MetaCallEventFreeList metaCallEvents;
+// the number of ids taken from metaCallEvents, so that we never ask for more
+// than it has
+static QBasicAtomicInt metaCallEventCount = Q_BASIC_ATOMIC_INITIALIZER(0);
+}
+
+/*!
+    \internal
+ */
+void *QMetaCallEvent::operator new(size_t size)
+{
+    // subclasses are rare, let them use the global operator
+    if (size != sizeof(QMetaCallEvent))
+        return ::operator new(size);
+
+    MetaCallEventStorage *storage;
+    if (metaCallEventCount.fetchAndAddRelaxed(1) < MetaCallEventConstants::MaxIndex) {
+        const int id = metaCallEvents.next();
+        storage = &metaCallEvents[id];
+        storage->id = id;
+    } else {
+        metaCallEventCount.deref();
+        storage = new MetaCallEventStorage;
+        storage->id = -1;
+    }
+    return storage->data;
+}
+
+/*!
+    \internal
+ */
+void QMetaCallEvent::operator delete(void *ptr, size_t size)
+{
+    if (size != sizeof(QMetaCallEvent)) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    MetaCallEventStorage *storage = reinterpret_cast<MetaCallEventStorage *>(
+        static_cast<char *>(ptr) - offsetof(MetaCallEventStorage, data));
+    if (storage->id < 0) {
+        delete storage;
+        return;
+    }
+    metaCallEvents.release(storage->id);
+    metaCallEventCount.deref();
+}
+
 /*!
     \internal
  */
@@ -456,7 +527,9 @@ QMetaCallEvent::QMetaCallEvent(ushort method_offset, ushort method_relative, QOb
     : QEvent(MetaCall), slotObj_(0), sender_(sender), signalId_(signalId),
       nargs_(nargs), types_(types), args_(args), semaphore_(semaphore),
       callFunction_(callFunction), method_offset_(method_offset), method_relative_(method_relative)
-{ }
+{
+    metaCall = true;
+}
 
 /*!
     \internal
@@ -467,6 +540,7 @@ QMetaCallEvent::QMetaCallEvent(QtPrivate::QSlotObjectBase *slotO, const QObject
       nargs_(nargs), types_(types), args_(args), semaphore_(semaphore),
       callFunction_(0), method_offset_(0), method_relative_(ushort(-1))
 {
+    metaCall = true;
     if (slotObj_)
         slotObj_->ref();
 }
@@ -1499,8 +1573,34 @@ void QObject::moveToThread(QThread *targetThread)
     currentData->ref();
 
     // move the object
+    currentData->postEventList.takeIncoming();
     d_func()->setThreadData_helper(currentData, targetData);
 
+    // a QMetaCallEvent may have been pushed onto currentData without the mutex
+    // after we moved the posted events; wait until no one is pushing (the
+    // ordered fetch keeps it from being read before the new thread data is
+    // stored) and move whatever arrived for the objects we've moved
+    while (currentData->postEventList.posting.fetchAndAddOrdered(0) != 0) {
+#ifndef QT_NO_THREAD
+        QThread::yieldCurrentThread();
+#endif
+    }
+    if (currentData->postEventList.takeIncoming()) {
+        int eventsMoved = 0;
+        for (int i = 0; i < currentData->postEventList.size(); ++i) {
+            const QPostEvent &pe = currentData->postEventList.at(i);
+            if (pe.event && pe.receiver->d_func()->threadData == targetData) {
+                targetData->postEventList.addEvent(pe);
+                const_cast<QPostEvent &>(pe).event = 0;
+                ++eventsMoved;
+            }
+        }
+        if (eventsMoved > 0 && targetData->eventDispatcher.load()) {
+            targetData->canWait = false;
+            targetData->eventDispatcher.load()->wakeUp();
+        }
+    }
+
     locker.unlock();
 
     // now currentData can commit suicide if it wants to
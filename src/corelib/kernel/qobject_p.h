@@ -391,6 +391,11 @@ public:
 
     virtual void placeMetaCall(QObject *object);
 
+    // QMetaCallEvents are recycled, since they are usually created in one
+    // thread and deleted in another
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr, size_t size);
+
 private:
     QtPrivate::QSlotObjectBase *slotObj_;
     const QObject *sender_;
@@ -402,6 +407,12 @@ private:
     QObjectPrivate::StaticMetaCallFunction callFunction_;
     ushort method_offset_;
     ushort method_relative_;
+
+    // set while the event is on QPostEventList::incoming
+    friend class QPostEventList;
+    QMetaCallEvent *nextIncoming_;
+    QObject *incomingReceiver_;
+    int incomingPriority_;
 };
 
 class QBoolBlocker
@@ -40,6 +40,7 @@
 
 #include <qelapsedtimer.h>
 #include <qcoreapplication.h>
+#include <qvarlengtharray.h>
 
 #include "private/qcore_unix_p.h"
 #include "private/qtimerinfo_unix_p.h"
@@ -84,6 +85,7 @@ QTimerInfoList::QTimerInfoList()
 #endif
 
     firstTimerInfo = 0;
+    insertionCounter = 0;
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -174,18 +176,140 @@ void QTimerInfoList::repairTimersIfNeeded()
 
 #endif
 
+/*
+  Timers are ordered by timeout; among timers with the same timeout, the one
+  inserted first comes first, as it did when the list was kept sorted.
+*/
+static inline bool timerLessThan(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    if (t1->timeout < t2->timeout)
+        return true;
+    if (t2->timeout < t1->timeout)
+        return false;
+    return t1->sequence < t2->sequence;
+}
+
+void QTimerInfoList::heapMoveUp(int index)
+{
+    iterator heap = begin();
+    QTimerInfo *t = heap[index];
+    while (index > 0) {
+        const int parent = (index - 1) / 2;
+        if (!timerLessThan(t, heap[parent]))
+            break;
+        heap[index] = heap[parent];
+        heap[index]->heapIndex = index;
+        index = parent;
+    }
+    heap[index] = t;
+    t->heapIndex = index;
+}
+
+void QTimerInfoList::heapMoveDown(int index)
+{
+    iterator heap = begin();
+    const int count = size();
+    QTimerInfo *t = heap[index];
+    forever {
+        int child = 2 * index + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && timerLessThan(heap[child + 1], heap[child]))
+            ++child;
+        if (!timerLessThan(heap[child], t))
+            break;
+        heap[index] = heap[child];
+        heap[index]->heapIndex = index;
+        index = child;
+    }
+    heap[index] = t;
+    t->heapIndex = index;
+}
+
 /*
   insert timer info into list
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
-            break;
+    ti->sequence = insertionCounter++;
+    ti->heapIndex = size();
+    append(ti);
+    heapMoveUp(ti->heapIndex);
+}
+
+/*
+  remove timer info from list, without deleting it
+*/
+void QTimerInfoList::timerRemove(QTimerInfo *ti)
+{
+    const int index = ti->heapIndex;
+    Q_ASSERT(index >= 0 && index < size() && at(index) == ti);
+
+    QTimerInfo *last = takeLast();
+    if (last != ti) {
+        (*this)[index] = last;
+        last->heapIndex = index;
+        if (timerLessThan(last, ti))
+            heapMoveUp(index);
+        else
+            heapMoveDown(index);
+    }
+    ti->heapIndex = -1;
+}
+
+/*
+  Returns the first timer that is not currently being activated. Only timers
+  whose event handlers are on the stack are skipped, so this visits very few
+  entries beyond the root.
+*/
+QTimerInfo *QTimerInfoList::firstInactiveTimer() const
+{
+    if (isEmpty())
+        return 0;
+    if (!constFirst()->activateRef)
+        return constFirst();
+
+    QVarLengthArray<int, 32> candidates;
+    candidates.append(0);
+    while (!candidates.isEmpty()) {
+        int best = 0;
+        for (int i = 1; i < candidates.size(); ++i) {
+            if (timerLessThan(at(candidates.at(i)), at(candidates.at(best))))
+                best = i;
+        }
+        const int index = candidates.at(best);
+        candidates.remove(best);
+
+        QTimerInfo *t = at(index);
+        if (!t->activateRef)
+            return t;
+
+        for (int child = 2 * index + 1; child <= 2 * index + 2 && child < size(); ++child)
+            candidates.append(child);
     }
-    insert(index+1, ti);
+    return 0;
+}
+
+/*
+  Returns how many timers have a timeout no later than \a currentTime,
+  visiting only those timers (and their direct children).
+*/
+int QTimerInfoList::expiredTimerCount(const timespec &currentTime) const
+{
+    int count = 0;
+    QVarLengthArray<int, 64> pending;
+    if (!isEmpty())
+        pending.append(0);
+    while (!pending.isEmpty()) {
+        const int index = pending.last();
+        pending.removeLast();
+        if (currentTime < at(index)->timeout)
+            continue;
+        ++count;
+        for (int child = 2 * index + 1; child <= 2 * index + 2 && child < size(); ++child)
+            pending.append(child);
+    }
+    return count;
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -389,13 +513,7 @@ bool QTimerInfoList::timerWait(timespec &tm)
     repairTimersIfNeeded();
 
     // Find first waiting timer not already active
-    QTimerInfo *t = 0;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
-        }
-    }
+    QTimerInfo *t = firstInactiveTimer();
 
     if (!t)
       return false;
@@ -423,16 +541,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timersById.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -451,6 +566,8 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     t->timerType = timerType;
     t->obj = object;
     t->activateRef = 0;
+    t->heapIndex = -1;
+    t->sequence = 0;
 
     timespec expected = updateCurrentTime() + interval;
 
@@ -493,6 +610,7 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
             ++t->timeout.tv_sec;
     }
 
+    timersById.insert(timerId, t);
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
@@ -508,41 +626,51 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            return true;
-        }
+    QTimerInfo *t = timersById.take(timerId);
+    if (!t) {
+        // id not found
+        return false;
     }
-    // id not found
-    return false;
+
+    timerRemove(t);
+    if (t == firstTimerInfo)
+        firstTimerInfo = 0;
+    if (t->activateRef)
+        *(t->activateRef) = 0;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
+
+    // compact the remaining timers to the front and rebuild the heap once,
+    // rather than paying for a removal per timer
+    iterator heap = begin();
+    int kept = 0;
+    for (int i = 0; i < size(); ++i) {
+        QTimerInfo *t = heap[i];
         if (t->obj == object) {
             // object found
-            removeAt(i);
+            timersById.remove(t->id);
             if (t == firstTimerInfo)
                 firstTimerInfo = 0;
             if (t->activateRef)
                 *(t->activateRef) = 0;
             delete t;
-            // move back one so that we don't skip the new current item
-            --i;
+        } else {
+            t->heapIndex = kept;
+            heap[kept++] = t;
         }
     }
+
+    if (kept != size()) {
+        erase(begin() + kept, end());
+        for (int i = kept / 2 - 1; i >= 0; --i)
+            heapMoveDown(i);
+    }
     return true;
 }
 
@@ -579,11 +707,7 @@ int QTimerInfoList::activateTimers()
 
 
     // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
-    }
+    maxCount = expiredTimerCount(currentTime);
 
     //fire the timers.
     while (maxCount--) {
@@ -605,7 +729,7 @@ int QTimerInfoList::activateTimers()
         }
 
         // remove from list
-        removeFirst();
+        timerRemove(currentTimerInfo);
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
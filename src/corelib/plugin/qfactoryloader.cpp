@@ -53,6 +53,9 @@
 #include "qjsonvalue.h"
 #include "qjsonobject.h"
 #include "qjsonarray.h"
+#if QT_CONFIG(library)
+#include "qpluginmetadatacache_p.h"
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -199,6 +202,8 @@ void QFactoryLoader::update()
             }
         }
     }
+
+    QPluginMetaDataCache::save();
 #else
     Q_D(QFactoryLoader);
     if (qt_debug_component()) {
@@ -63,6 +63,7 @@
 #include <qjsonvalue.h>
 #include "qelfparser_p.h"
 #include "qmachparser_p.h"
+#include "qpluginmetadatacache_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -716,8 +717,19 @@ void QLibraryPrivate::updatePluginState()
 #endif
 
     if (!pHnd) {
-        // scan for the plugin metadata without loading
-        success = findPatternUnloaded(fileName, this);
+        // scan for the plugin metadata without loading, unless we have it
+        // cached for this version of the file
+        const QPluginMetaDataCache::Stamp stamp = QPluginMetaDataCache::stamp(fileName);
+        if (QPluginMetaDataCache::find(fileName, stamp, &metaData)) {
+            if (qt_debug_component())
+                qDebug() << "Found cached metadata for" << fileName;
+            success = !metaData.isEmpty();
+        } else {
+            success = findPatternUnloaded(fileName, this);
+            // failing to read the file may be temporary, don't remember that
+            if (success || QFileInfo(fileName).isReadable())
+                QPluginMetaDataCache::insert(fileName, stamp, success ? metaData : QJsonObject());
+        }
     } else {
         // library is already loaded (probably via QLibrary)
         // simply get the target function and call it.
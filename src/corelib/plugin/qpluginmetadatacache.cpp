@@ -0,0 +1,250 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qpluginmetadatacache_p.h"
+
+#include "qdatetime.h"
+#include "qdebug.h"
+#include "qdir.h"
+#include "qfile.h"
+#include "qfileinfo.h"
+#include "qhash.h"
+#include "qjsondocument.h"
+#include "qmutex.h"
+#include "qsavefile.h"
+#include "qstandardpaths.h"
+#include "qsysinfo.h"
+
+QT_BEGIN_NAMESPACE
+
+bool qt_debug_component();
+
+/*
+  The cache file is named after the build ABI of Qt, so that builds for
+  different architectures sharing a cache directory keep apart. It holds a
+  binary JSON document:
+
+    {
+        "version": 1,
+        "plugins": {
+            "/canonical/path/to/plugin.so": {
+                "size": 18872,
+                "lastModified": 1508239581000,
+                "metaData": { ... }
+            },
+            ...
+        }
+    }
+
+  where "metaData" is what QLibraryPrivate::metaData holds for the file, and
+  is empty for files that are not plugins. The file is rewritten as a whole
+  when entries were added, dropping the ones for files that no longer exist.
+
+  Setting QT_NO_PLUGIN_CACHE in the environment disables the cache.
+*/
+
+enum { CacheVersion = 1 };
+
+namespace {
+struct CacheEntry
+{
+    QPluginMetaDataCache::Stamp stamp;
+    QJsonObject metaData;
+};
+
+struct MetaDataCache
+{
+    MetaDataCache() : loaded(false), dirty(false) {}
+
+    // all members are protected by mutex
+    QMutex mutex;
+    QString fileName;
+    QHash<QString, CacheEntry> entries;
+    bool loaded;
+    bool dirty;
+
+    void load();
+};
+}
+
+Q_GLOBAL_STATIC(MetaDataCache, metaDataCache)
+
+static bool isCacheEnabled()
+{
+    static const bool disabled = qEnvironmentVariableIsSet("QT_NO_PLUGIN_CACHE");
+    return !disabled;
+}
+
+void MetaDataCache::load()
+{
+    loaded = true;
+    fileName = QPluginMetaDataCache::fileName();
+    if (fileName.isEmpty())
+        return;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    const QJsonObject root = QJsonDocument::fromBinaryData(file.readAll()).object();
+    if (root.value(QLatin1String("version")).toInt() != CacheVersion)
+        return;
+
+    const QJsonObject plugins = root.value(QLatin1String("plugins")).toObject();
+    entries.reserve(plugins.size());
+    for (QJsonObject::const_iterator it = plugins.constBegin(); it != plugins.constEnd(); ++it) {
+        const QJsonObject object = it.value().toObject();
+        CacheEntry entry;
+        entry.stamp.size = qint64(object.value(QLatin1String("size")).toDouble(-1));
+        entry.stamp.lastModified = qint64(object.value(QLatin1String("lastModified")).toDouble());
+        entry.metaData = object.value(QLatin1String("metaData")).toObject();
+        entries.insert(it.key(), entry);
+    }
+
+    if (qt_debug_component())
+        qDebug() << "QPluginMetaDataCache: read" << entries.size() << "entries from" << fileName;
+}
+
+QString QPluginMetaDataCache::fileName()
+{
+#ifndef QT_NO_STANDARDPATHS
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (!dir.isEmpty())
+        return dir + QLatin1String("/qtplugincache-") + QSysInfo::buildAbi()
+                + QLatin1String(".qbjs");
+#endif
+    return QString();
+}
+
+QPluginMetaDataCache::Stamp QPluginMetaDataCache::stamp(const QString &fileName)
+{
+    Stamp stamp = { -1, 0 };
+    const QFileInfo info(fileName);
+    if (info.exists()) {
+        stamp.size = info.size();
+        stamp.lastModified = info.lastModified().toMSecsSinceEpoch();
+    }
+    return stamp;
+}
+
+bool QPluginMetaDataCache::find(const QString &fileName, const Stamp &stamp, QJsonObject *metaData)
+{
+    if (!isCacheEnabled() || !stamp.isValid())
+        return false;
+    MetaDataCache *cache = metaDataCache();
+    if (!cache)
+        return false;
+
+    QMutexLocker locker(&cache->mutex);
+    if (!cache->loaded)
+        cache->load();
+
+    QHash<QString, CacheEntry>::const_iterator it = cache->entries.constFind(fileName);
+    if (it == cache->entries.constEnd() || it->stamp != stamp)
+        return false;
+    *metaData = it->metaData;
+    return true;
+}
+
+void QPluginMetaDataCache::insert(const QString &fileName, const Stamp &stamp, const QJsonObject &metaData)
+{
+    if (!isCacheEnabled() || !stamp.isValid())
+        return;
+    MetaDataCache *cache = metaDataCache();
+    if (!cache)
+        return;
+
+    QMutexLocker locker(&cache->mutex);
+    if (!cache->loaded)
+        cache->load();
+
+    CacheEntry &entry = cache->entries[fileName];
+    entry.stamp = stamp;
+    entry.metaData = metaData;
+    cache->dirty = true;
+}
+
+void QPluginMetaDataCache::save()
+{
+#if QT_CONFIG(temporaryfile)
+    if (!isCacheEnabled())
+        return;
+    MetaDataCache *cache = metaDataCache();
+    if (!cache)
+        return;
+
+    QMutexLocker locker(&cache->mutex);
+    if (!cache->dirty || cache->fileName.isEmpty())
+        return;
+    cache->dirty = false;
+
+    QJsonObject plugins;
+    for (QHash<QString, CacheEntry>::iterator it = cache->entries.begin(); it != cache->entries.end(); ) {
+        if (!QFileInfo::exists(it.key())) {
+            it = cache->entries.erase(it);
+            continue;
+        }
+        QJsonObject object;
+        object.insert(QLatin1String("size"), double(it->stamp.size));
+        object.insert(QLatin1String("lastModified"), double(it->stamp.lastModified));
+        object.insert(QLatin1String("metaData"), it->metaData);
+        plugins.insert(it.key(), object);
+        ++it;
+    }
+
+    QJsonObject root;
+    root.insert(QLatin1String("version"), int(CacheVersion));
+    root.insert(QLatin1String("plugins"), plugins);
+
+    QDir().mkpath(QFileInfo(cache->fileName).absolutePath());
+    QSaveFile file(cache->fileName);
+    if (!file.open(QIODevice::WriteOnly)
+            || file.write(QJsonDocument(root).toBinaryData()) < 0
+            || !file.commit()) {
+        if (qt_debug_component())
+            qWarning() << "QPluginMetaDataCache: could not write" << cache->fileName << file.errorString();
+        return;
+    }
+
+    if (qt_debug_component())
+        qDebug() << "QPluginMetaDataCache: wrote" << plugins.size() << "entries to" << cache->fileName;
+#endif
+}
+
+QT_END_NAMESPACE
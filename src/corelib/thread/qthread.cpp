@@ -51,6 +51,47 @@
 
 QT_BEGIN_NAMESPACE
 
+/*
+  QPostEventList
+*/
+
+// Pushes the event onto incoming, without locking the mutex; the caller must
+// have marked it as posted.
+void QPostEventList::pushIncoming(QObject *receiver, QMetaCallEvent *event, int priority)
+{
+    event->incomingReceiver_ = receiver;
+    event->incomingPriority_ = priority;
+
+    QMetaCallEvent *head;
+    do {
+        head = incoming.load();
+        event->nextIncoming_ = head;
+    } while (!incoming.testAndSetRelease(head, event));
+}
+
+// Adds the events pushed by pushIncoming() to the list, in the order they
+// were posted. Returns true if there were any.
+bool QPostEventList::takeIncoming()
+{
+    QMetaCallEvent *event = incoming.fetchAndStoreAcquire(0);
+    if (!event)
+        return false;
+
+    QMetaCallEvent *ordered = 0;
+    while (event) {
+        QMetaCallEvent *next = event->nextIncoming_;
+        event->nextIncoming_ = ordered;
+        ordered = event;
+        event = next;
+    }
+
+    for (event = ordered; event; event = event->nextIncoming_) {
+        addEvent(QPostEvent(event->incomingReceiver_, event, event->incomingPriority_));
+        ++QObjectPrivate::get(event->incomingReceiver_)->postedEvents;
+    }
+    return true;
+}
+
 /*
   QThreadData
 */
@@ -82,6 +123,7 @@ QThreadData::~QThreadData()
     thread = 0;
     delete t;
 
+    postEventList.takeIncoming();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -114,10 +114,21 @@ public:
 
     QMutex mutex;
 
+    // incoming == QMetaCallEvents posted without locking the mutex, most recent
+    // first; takeIncoming() adds them to the list, and must be called with the
+    // mutex locked before looking at the list
+    QAtomicPointer<QMetaCallEvent> incoming;
+    // posting == number of threads that may be about to push onto incoming
+    QAtomicInt posting;
+
     inline QPostEventList()
         : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0)
     { }
 
+    bool hasIncoming() const { return incoming.load() != 0; }
+    void pushIncoming(QObject *receiver, QMetaCallEvent *event, int priority);
+    bool takeIncoming();
+
     void addEvent(const QPostEvent &ev) {
         int priority = ev.priority;
         if (isEmpty() ||
@@ -251,7 +262,7 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postEventList.hasIncoming();
     }
 
     // This class provides per-thread (by way of being a QThreadData
@@ -40,6 +40,7 @@
 #include "qthreadpool.h"
 #include "qthreadpool_p.h"
 #include "qelapsedtimer.h"
+#include "qmutexpool_p.h"
 
 #include <algorithm>
 
@@ -58,12 +59,22 @@ public:
     QThreadPoolThread(QThreadPoolPrivate *manager);
     void run() Q_DECL_OVERRIDE;
     void registerThreadInactive();
+    QRunnable *takeLocalTask();
 
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // work stealing: tasks started from this thread; the thread itself works
+    // on the back of the queue, other threads steal from the front
+    QMutex localMutex;
+    QList<QRunnable *> localQueue;
 };
 
+#if defined(Q_COMPILER_THREAD_LOCAL)
+static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+#endif
+
 /*
     QThreadPool private class.
 */
@@ -81,6 +92,10 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    currentPoolThread = this;
+#endif
+
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -88,47 +103,57 @@ void QThreadPoolThread::run()
 
         do {
             if (r) {
-                const bool autoDelete = r->autoDelete();
-
-
-                // run the task
                 locker.unlock();
+                bool locked = false;
+                do {
+                    const bool autoDelete = r->autoDelete();
+
+                    // run the task
 #ifndef QT_NO_EXCEPTIONS
-                try {
+                    try {
 #endif
-                    r->run();
+                        r->run();
 #ifndef QT_NO_EXCEPTIONS
-                } catch (...) {
-                    qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
-                             "This is not supported, exceptions thrown in worker threads must be\n"
-                             "caught before control returns to Qt Concurrent.");
-                    registerThreadInactive();
-                    throw;
-                }
+                    } catch (...) {
+                        qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
+                                 "This is not supported, exceptions thrown in worker threads must be\n"
+                                 "caught before control returns to Qt Concurrent.");
+                        registerThreadInactive();
+                        throw;
+                    }
 #endif
-                locker.relock();
 
-                if (autoDelete && !--r->ref)
-                    delete r;
+                    if (!manager->sharedRefCount.loadAcquire()) {
+                        // the reference count is protected by the pool's mutex
+                        locker.relock();
+                        locked = true;
+                        if (autoDelete && manager->derefRunnable(r))
+                            delete r;
+                        break;
+                    }
+
+                    if (autoDelete && manager->derefRunnable(r))
+                        delete r;
+
+                    // keep working on tasks started from this thread without
+                    // going through the pool's mutex, unless a task with a
+                    // higher priority is waiting in the pool's queue
+                    r = nullptr;
+                    if (manager->workStealing.loadAcquire() && !manager->priorityTaskQueued.load())
+                        r = takeLocalTask();
+                } while (r);
+                if (!locked)
+                    locker.relock();
             }
 
             // if too many threads are active, expire this thread
-            if (manager->tooManyThreadsActive())
-                break;
-
-            if (manager->queue.isEmpty()) {
-                r = nullptr;
+            if (manager->tooManyThreadsActive()) {
+                manager->requeueLocalTasks(this);
                 break;
             }
 
-            QueuePage *page = manager->queue.first();
-            r = page->pop();
-
-            if (page->isFinished()) {
-                manager->queue.removeFirst();
-                delete page;
-            }
-        } while (true);
+            r = manager->takeNextTask(this);
+        } while (r);
 
         if (manager->isExiting) {
             registerThreadInactive();
@@ -160,18 +185,51 @@ void QThreadPoolThread::registerThreadInactive()
         manager->noActiveThreads.wakeAll();
 }
 
+QRunnable *QThreadPoolThread::takeLocalTask()
+{
+    QMutexLocker locker(&localMutex);
+    return localQueue.isEmpty() ? nullptr : localQueue.takeLast();
+}
+
 
 /*
     \internal
 */
 QThreadPoolPrivate:: QThreadPoolPrivate()
-    : isExiting(false),
+    : nextVictim(0),
+      isExiting(false),
       expiryTimeout(30000),
       maxThreadCount(qAbs(QThread::idealThreadCount())),
       reservedThreads(0),
       activeThreads(0)
 { }
 
+/*
+    QRunnable::ref is protected by the pool's mutex. The threads' local
+    queues modify it without that mutex, so once work stealing has been
+    enabled, it is modified under a mutex picked by the runnable's address
+    instead. sharedRefCount is only set, never cleared, under the pool's
+    mutex, so the two ways of locking are never mixed.
+*/
+void QThreadPoolPrivate::refRunnable(QRunnable *runnable)
+{
+    if (!sharedRefCount.loadAcquire()) {
+        ++runnable->ref;
+        return;
+    }
+    QMutexLocker locker(QMutexPool::globalInstanceGet(runnable));
+    ++runnable->ref;
+}
+
+// returns \c true if the runnable is no longer referenced and should be deleted
+bool QThreadPoolPrivate::derefRunnable(QRunnable *runnable)
+{
+    if (!sharedRefCount.loadAcquire())
+        return !--runnable->ref;
+    QMutexLocker locker(QMutexPool::globalInstanceGet(runnable));
+    return !--runnable->ref;
+}
+
 bool QThreadPoolPrivate::tryStart(QRunnable *task)
 {
     Q_ASSERT(task != nullptr);
@@ -200,7 +258,7 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
         ++activeThreads;
 
         if (task->autoDelete())
-            ++task->ref;
+            refRunnable(task);
         thread->runnable = task;
         thread->start();
         return true;
@@ -220,8 +278,16 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
 {
     Q_ASSERT(runnable != nullptr);
     if (runnable->autoDelete())
-        ++runnable->ref;
+        refRunnable(runnable);
 
+    queueTask(runnable, priority);
+}
+
+/*
+    Adds \a runnable to the queue without taking a reference.
+*/
+void QThreadPoolPrivate::queueTask(QRunnable *runnable, int priority)
+{
     for (QueuePage *page : qAsConst(queue)) {
         if (page->priority() == priority && !page->isFull()) {
             page->push(runnable);
@@ -230,6 +296,167 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     }
     auto it = std::upper_bound(queue.constBegin(), queue.constEnd(), priority, comparePriority);
     queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
+    updatePriorityTaskQueued();
+}
+
+/*
+    Removes the first runnable from the queue and returns it.
+*/
+QRunnable *QThreadPoolPrivate::takeQueuedTask()
+{
+    Q_ASSERT(!queue.isEmpty());
+    QueuePage *page = queue.first();
+    QRunnable *r = page->pop();
+
+    if (page->isFinished()) {
+        queue.removeFirst();
+        delete page;
+        updatePriorityTaskQueued();
+    }
+    return r;
+}
+
+/*
+    Threads check priorityTaskQueued between the tasks from their local
+    queue, which only has default priority tasks, without locking the mutex.
+*/
+void QThreadPoolPrivate::updatePriorityTaskQueued()
+{
+    priorityTaskQueued.store(!queue.isEmpty() && queue.first()->priority() > 0);
+}
+
+/*
+    If work stealing is enabled and this is called from one of this pool's
+    threads, puts \a runnable on that thread's local queue and returns
+    \c true. Otherwise returns \c false.
+*/
+bool QThreadPoolPrivate::enqueueLocalTask(QRunnable *runnable)
+{
+#if defined(Q_COMPILER_THREAD_LOCAL)
+    QThreadPoolThread *thread = currentPoolThread;
+    if (!thread || thread->manager != this || !workStealing.loadAcquire())
+        return false;
+
+    if (runnable->autoDelete())
+        refRunnable(runnable);
+
+    bool wasEmpty;
+    {
+        QMutexLocker locker(&thread->localMutex);
+        wasEmpty = thread->localQueue.isEmpty();
+        thread->localQueue.append(runnable);
+    }
+
+    // Make sure another thread is around to steal from us. Threads check the
+    // local queues before they go to sleep, and a thief that leaves tasks
+    // behind wakes the next one, so this is only necessary when the queue
+    // was empty until now.
+    if (wasEmpty) {
+        QMutexLocker locker(&mutex);
+        wakeOrStartThread();
+    }
+    return true;
+#else
+    Q_UNUSED(runnable);
+    return false;
+#endif
+}
+
+/*
+    Returns the next runnable for \a thread to run, or \c nullptr if there
+    is none. Tasks queued with a raised priority come first, then the tasks
+    the thread started itself, then the rest of the queue, and finally tasks
+    stolen from other threads.
+*/
+QRunnable *QThreadPoolPrivate::takeNextTask(QThreadPoolThread *thread)
+{
+    if (!queue.isEmpty() && queue.first()->priority() > 0)
+        return takeQueuedTask();
+
+    if (QRunnable *r = thread->takeLocalTask())
+        return r;
+
+    if (!queue.isEmpty())
+        return takeQueuedTask();
+
+    return stealTask(thread);
+}
+
+QRunnable *QThreadPoolPrivate::stealTask(QThreadPoolThread *thief)
+{
+    if (!workStealing.loadAcquire())
+        return nullptr;
+
+    const int count = allThreads.count();
+    for (int i = 0; i < count; ++i) {
+        const int index = (nextVictim + i) % count;
+        QThreadPoolThread *victim = allThreads.at(index);
+        if (victim == thief)
+            continue;
+
+        QMutexLocker locker(&victim->localMutex);
+        if (!victim->localQueue.isEmpty()) {
+            nextVictim = (index + 1) % count;
+            QRunnable *r = victim->localQueue.takeFirst();
+            // the owner only wakes one thief when its queue becomes
+            // non-empty; pass it on, so that all threads get to work on a
+            // large fan-out
+            if (!victim->localQueue.isEmpty()) {
+                locker.unlock();
+                wakeOrStartThread();
+            }
+            return r;
+        }
+    }
+    return nullptr;
+}
+
+/*
+    Wakes up a waiting thread, or starts a new one if the thread limit
+    allows, so that it steals tasks from the local queues. Called with the
+    mutex locked.
+*/
+void QThreadPoolPrivate::wakeOrStartThread()
+{
+    if (!waitingThreads.isEmpty()) {
+        waitingThreads.takeFirst()->runnableReady.wakeOne();
+    } else if (!isExiting && activeThreadCount() < maxThreadCount) {
+        if (!expiredThreads.isEmpty()) {
+            // restart an expired thread
+            QThreadPoolThread *thread = expiredThreads.dequeue();
+            Q_ASSERT(thread->runnable == nullptr);
+            ++activeThreads;
+            thread->start();
+        } else {
+            startThread();
+        }
+    }
+}
+
+/*
+    Returns \c true if any of the pool's threads has tasks on its local
+    queue. Called with the mutex locked.
+*/
+bool QThreadPoolPrivate::hasLocalTasks() const
+{
+    for (QThreadPoolThread *thread : allThreads) {
+        QMutexLocker locker(&thread->localMutex);
+        if (!thread->localQueue.isEmpty())
+            return true;
+    }
+    return false;
+}
+
+/*
+    Moves the tasks left on \a thread's local queue to the pool's queue, so
+    that they are not lost when the thread stops working.
+*/
+void QThreadPoolPrivate::requeueLocalTasks(QThreadPoolThread *thread)
+{
+    QMutexLocker locker(&thread->localMutex);
+    for (QRunnable *r : qAsConst(thread->localQueue))
+        queueTask(r, 0);
+    thread->localQueue.clear();
 }
 
 int QThreadPoolPrivate::activeThreadCount() const
@@ -253,8 +480,15 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
         if (page->isFinished()) {
             queue.removeFirst();
             delete page;
+            updatePriorityTaskQueued();
         }
     }
+
+    // a task started on a local queue while the pool was at its limit did
+    // not get a thread to steal it; make sure one is around now that there
+    // is room, e.g. after its owner called releaseThread() to wait for it
+    if (workStealing.loadAcquire() && activeThreadCount() < maxThreadCount && hasLocalTasks())
+        wakeOrStartThread();
 }
 
 bool QThreadPoolPrivate::tooManyThreadsActive() const
@@ -268,15 +502,15 @@ bool QThreadPoolPrivate::tooManyThreadsActive() const
 */
 void QThreadPoolPrivate::startThread(QRunnable *runnable)
 {
-    Q_ASSERT(runnable != nullptr);
     QScopedPointer <QThreadPoolThread> thread(new QThreadPoolThread(this));
     thread->setObjectName(QLatin1String("Thread (pooled)"));
     Q_ASSERT(!allThreads.contains(thread.data())); // if this assert hits, we have an ABA problem (deleted threads don't get removed here)
     allThreads.append(thread.data());
     ++activeThreads;
 
-    if (runnable->autoDelete())
-        ++runnable->ref;
+    // without a runnable, the thread starts by looking for work to steal
+    if (runnable && runnable->autoDelete())
+        refRunnable(runnable);
     thread->runnable = runnable;
     thread.take()->start();
 }
@@ -335,12 +569,22 @@ void QThreadPoolPrivate::clear()
     for (QueuePage *page : qAsConst(queue)) {
         while (!page->isFinished()) {
             QRunnable *r = page->pop();
-            if (r && r->autoDelete() && !--r->ref)
+            if (r && r->autoDelete() && derefRunnable(r))
                 delete r;
         }
     }
     qDeleteAll(queue);
     queue.clear();
+    updatePriorityTaskQueued();
+
+    for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+        QMutexLocker localLocker(&thread->localMutex);
+        for (QRunnable *r : qAsConst(thread->localQueue)) {
+            if (r->autoDelete() && derefRunnable(r))
+                delete r;
+        }
+        thread->localQueue.clear();
+    }
 }
 
 /*!
@@ -374,9 +618,19 @@ bool QThreadPool::tryTake(QRunnable *runnable)
                 if (page->isFinished()) {
                     d->queue.removeOne(page);
                     delete page;
+                    d->updatePriorityTaskQueued();
                 }
                 if (runnable->autoDelete())
-                    --runnable->ref; // undo ++ref in start()
+                    d->derefRunnable(runnable); // undo ++ref in start()
+                return true;
+            }
+        }
+
+        for (QThreadPoolThread *thread : qAsConst(d->allThreads)) {
+            QMutexLocker localLocker(&thread->localMutex);
+            if (thread->localQueue.removeOne(runnable)) {
+                if (runnable->autoDelete())
+                    d->derefRunnable(runnable); // undo ++ref in start()
                 return true;
             }
         }
@@ -503,6 +757,9 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (priority == 0 && d->enqueueLocalTask(runnable))
+        return;
+
     QMutexLocker locker(&d->mutex);
     if (!d->tryStart(runnable)) {
         d->enqueueTask(runnable, priority);
@@ -617,6 +874,43 @@ int QThreadPool::activeThreadCount() const
     return d->activeThreadCount();
 }
 
+/*! \property QThreadPool::workStealingEnabled
+    \since 5.10
+
+    This property holds whether the thread pool uses work stealing.
+
+    When work stealing is enabled, runnables started with the default
+    priority from one of the pool's own threads are put on a queue local to
+    that thread instead of the pool's shared queue. The thread runs them
+    itself, most recently started first, and idle threads steal the oldest
+    ones from the other threads' queues. This avoids contention on the
+    pool's shared state when many short runnables are started from within
+    other runnables.
+
+    Runnables started with a priority other than the default one, or from
+    threads that do not belong to the pool, are always queued in the shared
+    queue, and queued runnables with a priority higher than the default one
+    are still run before any runnable on the local queues. waitForDone(),
+    clear() and tryTake() take the local queues into account.
+
+    Work stealing is disabled by default.
+*/
+
+bool QThreadPool::isWorkStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    return d->workStealing.loadAcquire();
+}
+
+void QThreadPool::setWorkStealingEnabled(bool enabled)
+{
+    Q_D(QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    if (enabled)
+        d->sharedRefCount.storeRelease(1);
+    d->workStealing.storeRelease(enabled);
+}
+
 /*!
     Reserves one thread, disregarding activeThreadCount() and maxThreadCount().
 
@@ -154,8 +154,21 @@ public:
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
+    void queueTask(QRunnable *task, int priority);
+    QRunnable *takeQueuedTask();
+    void updatePriorityTaskQueued();
     int activeThreadCount() const;
 
+    bool enqueueLocalTask(QRunnable *task);
+    QRunnable *takeNextTask(QThreadPoolThread *thread);
+    QRunnable *stealTask(QThreadPoolThread *thief);
+    void requeueLocalTasks(QThreadPoolThread *thread);
+    void wakeOrStartThread();
+    bool hasLocalTasks() const;
+
+    void refRunnable(QRunnable *runnable);
+    bool derefRunnable(QRunnable *runnable);
+
     void tryToStartMoreThreads();
     bool tooManyThreadsActive() const;
 
@@ -173,6 +186,11 @@ public:
     QVector<QueuePage*> queue;
     QWaitCondition noActiveThreads;
 
+    QAtomicInt workStealing; // bool
+    QAtomicInt sharedRefCount; // bool, see refRunnable()
+    QAtomicInt priorityTaskQueued; // bool, queue has a task with priority > 0
+    int nextVictim;
+
     bool isExiting;
     int expiryTimeout;
     int maxThreadCount;
@@ -39,6 +39,8 @@
 ****************************************************************************/
 
 #include <QtCore/qarraydata.h>
+#include <QtCore/qalgorithms.h>
+#include <QtCore/private/qarraydatapool_p.h>
 #include <QtCore/private/qnumeric_p.h>
 #include <QtCore/private/qtools_p.h>
 
@@ -63,6 +65,18 @@ QT_WARNING_POP
 static const QArrayData &qt_array_empty = qt_array[0];
 static const QArrayData &qt_array_unsharable_empty = qt_array[1];
 
+#if !defined(QT_BOOTSTRAPPED) && defined(Q_COMPILER_THREAD_LOCAL)
+#  define QT_ARRAYDATA_POOL
+// Allocations only look up the thread's pool if some thread has one
+static QBasicAtomicInt activeArrayDataPools = Q_BASIC_ATOMIC_INITIALIZER(0);
+static thread_local QArrayDataPool *currentArrayDataPool = nullptr;
+
+static inline QArrayDataPool *currentPool() Q_DECL_NOTHROW
+{
+    return activeArrayDataPools.load() ? currentArrayDataPool : nullptr;
+}
+#endif
+
 static inline size_t calculateBlockSize(size_t &capacity, size_t objectSize, size_t headerSize,
                                         uint options)
 {
@@ -115,7 +129,18 @@ QArrayData *QArrayData::allocate(size_t objectSize, size_t alignment,
         return 0;
 
     size_t allocSize = calculateBlockSize(capacity, objectSize, headerSize, options);
-    QArrayData *header = static_cast<QArrayData *>(::malloc(allocSize));
+    QArrayData *header;
+#ifdef QT_ARRAYDATA_POOL
+    QArrayDataPool *pool = (options & RawData) ? nullptr : currentPool();
+    if (pool) {
+        header = static_cast<QArrayData *>(pool->allocate(&allocSize));
+        // The pool may hand out a bigger block; make all of it usable
+        capacity = (allocSize - headerSize) / objectSize;
+    } else
+#endif
+    {
+        header = static_cast<QArrayData *>(::malloc(allocSize));
+    }
     if (header) {
         quintptr data = (quintptr(header) + sizeof(QArrayData) + alignment - 1)
                 & ~(alignment - 1);
@@ -155,7 +180,7 @@ void QArrayData::deallocate(QArrayData *data, size_t objectSize,
     // Alignment is a power of two
     Q_ASSERT(alignment >= Q_ALIGNOF(QArrayData)
             && !(alignment & (alignment - 1)));
-    Q_UNUSED(objectSize) Q_UNUSED(alignment)
+    Q_UNUSED(alignment)
 
 #if !defined(QT_NO_UNSHARABLE_CONTAINERS)
     if (data == &qt_array_unsharable_empty)
@@ -164,9 +189,163 @@ void QArrayData::deallocate(QArrayData *data, size_t objectSize,
 
     Q_ASSERT_X(data == 0 || !data->ref.isStatic(), "QArrayData::deallocate",
                "Static data can not be deleted");
+
+    // Raw data headers have no capacity. For everything else, the header and
+    // alloc elements are a lower bound of the size of the block.
+#ifdef QT_ARRAYDATA_POOL
+    if (data && data->alloc) {
+        QArrayDataPool *pool = currentPool();
+        if (pool && pool->release(data, sizeof(QArrayData) + data->alloc * objectSize))
+            return;
+    }
+#else
+    Q_UNUSED(objectSize)
+#endif
     ::free(data);
 }
 
+#ifndef QT_BOOTSTRAPPED
+/*!
+    \class QArrayDataPool
+    \inmodule QtCore
+    \internal
+
+    \brief The QArrayDataPool class recycles QArrayData blocks freed on the
+    current thread.
+
+    While a QArrayDataPool object exists, QArrayData blocks (as used by
+    QString, QByteArray and QVector) that are freed on the thread that
+    created the pool are not returned to the system, but kept in the pool
+    and handed out again by the next allocation of a similar size. The
+    blocks kept are released when the pool is destroyed. This is meant for
+    code that repeatedly creates and discards many small containers, such
+    as a worker thread parsing requests into QVariantMaps:
+
+    \code
+    QArrayDataPool pool;
+    while (hasPendingRequests()) {
+        QVariantMap request = QJsonDocument::fromJson(nextRequest()).object().toVariantMap();
+        handle(request);
+    }
+    \endcode
+
+    Blocks handed out by the pool are ordinary heap blocks, so containers
+    may outlive the pool or be passed to other threads.
+
+    Pools nest: a pool created while another one is current takes over
+    until it is destroyed. Pools must be destroyed in the reverse order of
+    their creation, on the thread that created them.
+*/
+
+/*!
+    Creates a pool and makes it current on this thread.
+*/
+QArrayDataPool::QArrayDataPool()
+    : previous(nullptr)
+{
+    memset(bins, 0, sizeof bins);
+    memset(binSizes, 0, sizeof binSizes);
+    memset(&stats, 0, sizeof stats);
+#ifdef QT_ARRAYDATA_POOL
+    previous = currentArrayDataPool;
+    currentArrayDataPool = this;
+    activeArrayDataPools.ref();
+#endif
+}
+
+/*!
+    Releases all the blocks kept in this pool and makes the previously
+    current pool, if any, current again.
+*/
+QArrayDataPool::~QArrayDataPool()
+{
+#ifdef QT_ARRAYDATA_POOL
+    Q_ASSERT_X(currentArrayDataPool == this, "QArrayDataPool",
+               "Pools must be destroyed in reverse order of creation");
+    currentArrayDataPool = previous;
+    activeArrayDataPools.deref();
+#endif
+    for (void *block : bins) {
+        while (block) {
+            void *next = *static_cast<void **>(block);
+            ::free(block);
+            block = next;
+        }
+    }
+}
+
+/*!
+    Returns the pool current on this thread, or \nullptr if there is none.
+*/
+QArrayDataPool *QArrayDataPool::current() Q_DECL_NOTHROW
+{
+#ifdef QT_ARRAYDATA_POOL
+    return currentPool();
+#else
+    return nullptr;
+#endif
+}
+
+/*!
+    \fn QArrayDataPool::Statistics QArrayDataPool::statistics() const
+
+    Returns how many blocks were allocated while this pool was current, how
+    many of those needed a call to malloc, and how many blocks were kept by
+    the pool instead of being freed.
+*/
+
+/*!
+    \internal
+
+    Returns a block of at least *\a allocSize bytes. Small blocks are rounded
+    up to the size of their bin, and *\a allocSize is updated accordingly.
+*/
+void *QArrayDataPool::allocate(size_t *allocSize) Q_DECL_NOTHROW
+{
+    ++stats.allocations;
+    const size_t payload = *allocSize - sizeof(QArrayData);
+    if (payload <= size_t(1) << MaxPayloadShift) {
+        const int shift = payload <= size_t(1) << MinPayloadShift
+                ? int(MinPayloadShift)
+                : 32 - int(qCountLeadingZeroBits(quint32(payload - 1)));
+        *allocSize = sizeof(QArrayData) + (size_t(1) << shift);
+
+        const int bin = shift - MinPayloadShift;
+        if (void *block = bins[bin]) {
+            bins[bin] = *static_cast<void **>(block);
+            --binSizes[bin];
+            return block;
+        }
+    }
+    ++stats.mallocCalls;
+    return ::malloc(*allocSize);
+}
+
+/*!
+    \internal
+
+    Keeps \a block, which is known to be at least \a blockSize bytes, for
+    reuse. Returns \c false if the block should be freed instead.
+*/
+bool QArrayDataPool::release(void *block, size_t blockSize) Q_DECL_NOTHROW
+{
+    const size_t payload = blockSize - sizeof(QArrayData);
+    if (payload < size_t(1) << MinPayloadShift || payload >= size_t(2) << MaxPayloadShift)
+        return false;
+
+    // round down: the block must be able to hold anything handed out from its bin
+    const int bin = 31 - int(qCountLeadingZeroBits(quint32(payload))) - MinPayloadShift;
+    if (binSizes[bin] == MaxBlocksPerBin)
+        return false;
+
+    *static_cast<void **>(block) = bins[bin];
+    bins[bin] = block;
+    ++binSizes[bin];
+    ++stats.recycled;
+    return true;
+}
+#endif // QT_BOOTSTRAPPED
+
 namespace QtPrivate {
 /*!
   \internal
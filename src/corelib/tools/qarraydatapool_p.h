@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QARRAYDATAPOOL_P_H
+#define QARRAYDATAPOOL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qarraydata.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_CORE_EXPORT QArrayDataPool
+{
+public:
+    struct Statistics
+    {
+        quint64 allocations;    // blocks handed out while the pool was current
+        quint64 mallocCalls;    // ... of which had to be obtained from malloc
+        quint64 recycled;       // blocks kept by the pool instead of being freed
+    };
+
+    QArrayDataPool();
+    ~QArrayDataPool();
+
+    static QArrayDataPool *current() Q_DECL_NOTHROW;
+
+    Statistics statistics() const Q_DECL_NOTHROW { return stats; }
+
+private:
+    Q_DISABLE_COPY(QArrayDataPool)
+    friend struct QArrayData;
+
+    // blocks are binned by the size of their payload (everything after the
+    // QArrayData header), in powers of two from 16 bytes to 4 kB
+    enum {
+        MinPayloadShift = 4,
+        MaxPayloadShift = 12,
+        BinCount = MaxPayloadShift - MinPayloadShift + 1,
+        MaxBlocksPerBin = 512
+    };
+
+    void *allocate(size_t *allocSize) Q_DECL_NOTHROW;
+    bool release(void *block, size_t blockSize) Q_DECL_NOTHROW;
+
+    QArrayDataPool *previous;
+    void *bins[BinCount];
+    int binSizes[BinCount];
+    Statistics stats;
+};
+
+QT_END_NAMESPACE
+
+#endif // QARRAYDATAPOOL_P_H
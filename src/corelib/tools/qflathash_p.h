@@ -0,0 +1,602 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QFLATHASH_P_H
+#define QFLATHASH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/private/qsimd_p.h>
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+
+#include <iterator>
+#include <new>
+#include <utility>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QFlatHashPrivate {
+
+// A slot's control byte holds the low 7 bits of the hash of its key if
+// the slot is in use, or one of these values.
+enum : qint8 {
+    Empty = -128,
+    Deleted = -2
+};
+
+enum { GroupSize = 16 };
+
+// The control bytes of GroupSize consecutive nodes, which are matched
+// against a value all at once.
+struct Group
+{
+#ifdef __SSE2__
+    explicit Group(const qint8 *ctrl) Q_DECL_NOTHROW
+        : ctrl(_mm_load_si128(reinterpret_cast<const __m128i *>(ctrl)))
+    { }
+
+    uint match(qint8 value) const Q_DECL_NOTHROW
+    { return uint(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value)))); }
+
+    // the control bytes of free slots are the only ones with the sign bit set
+    uint matchFree() const Q_DECL_NOTHROW
+    { return uint(_mm_movemask_epi8(ctrl)); }
+
+    __m128i ctrl;
+#else
+    explicit Group(const qint8 *ctrl) Q_DECL_NOTHROW : ctrl(ctrl) {}
+
+    uint match(qint8 value) const Q_DECL_NOTHROW
+    {
+        uint mask = 0;
+        for (int i = 0; i < GroupSize; ++i)
+            mask |= uint(ctrl[i] == value) << i;
+        return mask;
+    }
+
+    uint matchFree() const Q_DECL_NOTHROW
+    {
+        uint mask = 0;
+        for (int i = 0; i < GroupSize; ++i)
+            mask |= uint(ctrl[i] < 0) << i;
+        return mask;
+    }
+
+    const qint8 *ctrl;
+#endif
+
+    uint matchEmpty() const Q_DECL_NOTHROW { return match(Empty); }
+};
+
+// qHash() of integers is the identity, but the slots are chosen with the
+// high bits and the control byte comes from the low ones, so mix them.
+inline size_t mixHash(uint h) Q_DECL_NOTHROW
+{
+#if QT_POINTER_SIZE == 8
+    const quint64 m = quint64(h) * Q_UINT64_C(0x9e3779b97f4a7c15);
+    return size_t(m ^ (m >> 32));
+#else
+    const uint m = h * 0x9e3779b1u;
+    return m ^ (m >> 16);
+#endif
+}
+
+} // namespace QFlatHashPrivate
+
+template <class Key, class T>
+class QFlatHash
+{
+    struct Node
+    {
+        Node(const Key &key, const T &value) : key(key), value(value) {}
+        Key key;
+        T value;
+    };
+
+public:
+    class const_iterator;
+
+    class iterator
+    {
+        friend class QFlatHash;
+        friend class const_iterator;
+
+        QFlatHash *h;
+        int i;
+
+        iterator(QFlatHash *h, int i) Q_DECL_NOTHROW : h(h), i(i) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        iterator() Q_DECL_NOTHROW : h(nullptr), i(0) {}
+
+        const Key &key() const { return h->nodes[i].key; }
+        T &value() const { return h->nodes[i].value; }
+        T &operator*() const { return h->nodes[i].value; }
+        T *operator->() const { return &h->nodes[i].value; }
+        bool operator==(const iterator &o) const Q_DECL_NOTHROW { return i == o.i; }
+        bool operator!=(const iterator &o) const Q_DECL_NOTHROW { return i != o.i; }
+
+        iterator &operator++() { i = h->nextIndex(i); return *this; }
+        iterator operator++(int) { iterator r = *this; i = h->nextIndex(i); return r; }
+    };
+
+    class const_iterator
+    {
+        friend class QFlatHash;
+
+        const QFlatHash *h;
+        int i;
+
+        const_iterator(const QFlatHash *h, int i) Q_DECL_NOTHROW : h(h), i(i) {}
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        const_iterator() Q_DECL_NOTHROW : h(nullptr), i(0) {}
+        const_iterator(const iterator &o) Q_DECL_NOTHROW : h(o.h), i(o.i) {}
+
+        const Key &key() const { return h->nodes[i].key; }
+        const T &value() const { return h->nodes[i].value; }
+        const T &operator*() const { return h->nodes[i].value; }
+        const T *operator->() const { return &h->nodes[i].value; }
+        bool operator==(const const_iterator &o) const Q_DECL_NOTHROW { return i == o.i; }
+        bool operator!=(const const_iterator &o) const Q_DECL_NOTHROW { return i != o.i; }
+
+        const_iterator &operator++() { i = h->nextIndex(i); return *this; }
+        const_iterator operator++(int) { const_iterator r = *this; i = h->nextIndex(i); return r; }
+    };
+
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    QFlatHash() Q_DECL_NOTHROW
+        : ctrl(nullptr), nodes(nullptr), numSlots(0), numItems(0), growthLeft(0),
+          seed(uint(qGlobalQHashSeed()))
+    { }
+    QFlatHash(std::initializer_list<std::pair<Key, T> > list)
+        : QFlatHash()
+    {
+        reserve(int(list.size()));
+        for (auto it = list.begin(); it != list.end(); ++it)
+            insert(it->first, it->second);
+    }
+    QFlatHash(const QFlatHash &other);
+    QFlatHash(QFlatHash &&other) Q_DECL_NOTHROW
+        : ctrl(other.ctrl), nodes(other.nodes), numSlots(other.numSlots), numItems(other.numItems),
+          growthLeft(other.growthLeft), seed(other.seed)
+    {
+        other.ctrl = nullptr;
+        other.nodes = nullptr;
+        other.numSlots = other.numItems = other.growthLeft = 0;
+    }
+    ~QFlatHash() { freeSlots(); }
+
+    QFlatHash &operator=(const QFlatHash &other)
+    { QFlatHash copy(other); swap(copy); return *this; }
+    QFlatHash &operator=(QFlatHash &&other) Q_DECL_NOTHROW
+    { QFlatHash moved(std::move(other)); swap(moved); return *this; }
+
+    void swap(QFlatHash &other) Q_DECL_NOTHROW
+    {
+        qSwap(ctrl, other.ctrl);
+        qSwap(nodes, other.nodes);
+        qSwap(numSlots, other.numSlots);
+        qSwap(numItems, other.numItems);
+        qSwap(growthLeft, other.growthLeft);
+        qSwap(seed, other.seed);
+    }
+
+    bool operator==(const QFlatHash &other) const;
+    bool operator!=(const QFlatHash &other) const { return !(*this == other); }
+
+    int size() const Q_DECL_NOTHROW { return numItems; }
+    int count() const Q_DECL_NOTHROW { return numItems; }
+    bool isEmpty() const Q_DECL_NOTHROW { return numItems == 0; }
+    int capacity() const Q_DECL_NOTHROW { return maxLoad(numSlots); }
+    void reserve(int size);
+    void squeeze();
+    void clear() { freeSlots(); ctrl = nullptr; nodes = nullptr; numSlots = numItems = growthLeft = 0; }
+
+    iterator insert(const Key &key, const T &value);
+    int remove(const Key &key);
+    T take(const Key &key);
+    iterator erase(const_iterator it);
+    iterator erase(iterator it) { return erase(const_iterator(it)); }
+
+    bool contains(const Key &key) const { return findIndex(key) >= 0; }
+    int count(const Key &key) const { return contains(key) ? 1 : 0; }
+    const T value(const Key &key) const;
+    const T value(const Key &key, const T &defaultValue) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const { return value(key); }
+
+    QList<Key> keys() const;
+    QList<T> values() const;
+
+    iterator begin() { return iterator(this, firstIndex()); }
+    const_iterator begin() const { return const_iterator(this, firstIndex()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator constBegin() const { return begin(); }
+    iterator end() Q_DECL_NOTHROW { return iterator(this, numSlots); }
+    const_iterator end() const Q_DECL_NOTHROW { return const_iterator(this, numSlots); }
+    const_iterator cend() const Q_DECL_NOTHROW { return end(); }
+    const_iterator constEnd() const Q_DECL_NOTHROW { return end(); }
+
+    iterator find(const Key &key)
+    { const int i = findIndex(key); return iterator(this, i < 0 ? numSlots : i); }
+    const_iterator find(const Key &key) const
+    { const int i = findIndex(key); return const_iterator(this, i < 0 ? numSlots : i); }
+    const_iterator constFind(const Key &key) const { return find(key); }
+
+private:
+    static int maxLoad(int slotCount) Q_DECL_NOTHROW { return slotCount - slotCount / 8; }
+    static int slotCountFor(int size) Q_DECL_NOTHROW;
+    size_t hashOf(const Key &key) const { return QFlatHashPrivate::mixHash(qHash(key, seed)); }
+    static qint8 ctrlByte(size_t hash) Q_DECL_NOTHROW { return qint8(hash & 0x7f); }
+    uint groupMask() const Q_DECL_NOTHROW { return uint(numSlots / QFlatHashPrivate::GroupSize) - 1; }
+
+    int findIndex(const Key &key) const { return numSlots ? findIndex(key, hashOf(key)) : -1; }
+    int findIndex(const Key &key, size_t hash) const;
+    int findFreeSlot(size_t hash) const Q_DECL_NOTHROW;
+    int prepareInsert(size_t hash);
+    void eraseAt(int i);
+    void rehash(int slotCount);
+    void allocateSlots(int slotCount);
+    void freeSlots();
+
+    int firstIndex() const Q_DECL_NOTHROW { return ctrl && ctrl[0] < 0 ? nextIndex(0) : 0; }
+    int nextIndex(int i) const Q_DECL_NOTHROW
+    {
+        while (++i < numSlots && ctrl[i] < 0)
+            ;
+        return i;
+    }
+
+    // numSlots control bytes, followed by the slots
+    qint8 *ctrl;
+    Node *nodes;
+    int numSlots;
+    int numItems;
+    // number of insertions into empty slots left before the table grows
+    int growthLeft;
+    uint seed;
+};
+
+template <class Key, class T>
+QFlatHash<Key, T>::QFlatHash(const QFlatHash &other)
+    : ctrl(nullptr), nodes(nullptr), numSlots(0), numItems(0), growthLeft(0), seed(other.seed)
+{
+    if (!other.numItems)
+        return;
+    allocateSlots(other.numSlots);
+    memcpy(ctrl, other.ctrl, numSlots);
+    for (int i = 0; i < numSlots; ++i) {
+        if (ctrl[i] >= 0)
+            new (nodes + i) Node(other.nodes[i]);
+    }
+    numItems = other.numItems;
+    growthLeft = other.growthLeft;
+}
+
+template <class Key, class T>
+void QFlatHash<Key, T>::allocateSlots(int slotCount)
+{
+    const size_t alignment = qMax<size_t>(QFlatHashPrivate::GroupSize, Q_ALIGNOF(Node));
+    void *p = qMallocAligned(size_t(slotCount) * (1 + sizeof(Node)), alignment);
+    Q_CHECK_PTR(p);
+    ctrl = static_cast<qint8 *>(p);
+    // slotCount is a multiple of GroupSize, so the slots are aligned too
+    nodes = reinterpret_cast<Node *>(ctrl + slotCount);
+    memset(ctrl, QFlatHashPrivate::Empty, slotCount);
+    numSlots = slotCount;
+}
+
+template <class Key, class T>
+void QFlatHash<Key, T>::freeSlots()
+{
+    if (!ctrl)
+        return;
+    if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex) {
+        for (int i = 0; i < numSlots; ++i) {
+            if (ctrl[i] >= 0)
+                nodes[i].~Node();
+        }
+    }
+    qFreeAligned(ctrl);
+}
+
+template <class Key, class T>
+int QFlatHash<Key, T>::findIndex(const Key &key, size_t hash) const
+{
+    using namespace QFlatHashPrivate;
+    const qint8 h2 = ctrlByte(hash);
+    const uint mask = groupMask();
+    uint g = uint(hash >> 7) & mask;
+    // visiting the groups at triangular offsets covers all of them, and
+    // there is always an empty slot to stop at
+    for (uint step = 1; ; ++step) {
+        const Group group(ctrl + g * GroupSize);
+        for (uint m = group.match(h2); m; m &= m - 1) {
+            const int i = int(g * GroupSize + qCountTrailingZeroBits(m));
+            if (nodes[i].key == key)
+                return i;
+        }
+        if (group.matchEmpty())
+            return -1;
+        g = (g + step) & mask;
+    }
+}
+
+template <class Key, class T>
+int QFlatHash<Key, T>::findFreeSlot(size_t hash) const Q_DECL_NOTHROW
+{
+    using namespace QFlatHashPrivate;
+    const uint mask = groupMask();
+    uint g = uint(hash >> 7) & mask;
+    for (uint step = 1; ; ++step) {
+        if (const uint m = Group(ctrl + g * GroupSize).matchFree())
+            return int(g * GroupSize + qCountTrailingZeroBits(m));
+        g = (g + step) & mask;
+    }
+}
+
+template <class Key, class T>
+int QFlatHash<Key, T>::prepareInsert(size_t hash)
+{
+    int i = numSlots ? findFreeSlot(hash) : 0;
+    if (!numSlots || (!growthLeft && ctrl[i] == QFlatHashPrivate::Empty)) {
+        // grow, unless the table is mostly filled with deleted slots
+        if (numSlots && numItems < maxLoad(numSlots) / 2)
+            rehash(numSlots);
+        else
+            rehash(numSlots ? 2 * numSlots : int(QFlatHashPrivate::GroupSize));
+        i = findFreeSlot(hash);
+    }
+    if (ctrl[i] == QFlatHashPrivate::Empty)
+        --growthLeft;
+    ctrl[i] = ctrlByte(hash);
+    ++numItems;
+    return i;
+}
+
+template <class Key, class T>
+void QFlatHash<Key, T>::rehash(int slotCount)
+{
+    qint8 *oldCtrl = ctrl;
+    Node *oldSlots = nodes;
+    const int oldNumSlots = numSlots;
+
+    allocateSlots(slotCount);
+    for (int i = 0; i < oldNumSlots; ++i) {
+        if (oldCtrl[i] < 0)
+            continue;
+        Node &node = oldSlots[i];
+        const size_t hash = hashOf(node.key);
+        const int j = findFreeSlot(hash);
+        ctrl[j] = ctrlByte(hash);
+        new (nodes + j) Node(std::move(node));
+        node.~Node();
+    }
+    growthLeft = maxLoad(numSlots) - numItems;
+    if (oldCtrl)
+        qFreeAligned(oldCtrl);
+}
+
+template <class Key, class T>
+int QFlatHash<Key, T>::slotCountFor(int size) Q_DECL_NOTHROW
+{
+    int slotCount = QFlatHashPrivate::GroupSize;
+    while (maxLoad(slotCount) < size)
+        slotCount *= 2;
+    return slotCount;
+}
+
+template <class Key, class T>
+void QFlatHash<Key, T>::reserve(int size)
+{
+    if (size > capacity())
+        rehash(slotCountFor(size));
+}
+
+template <class Key, class T>
+void QFlatHash<Key, T>::squeeze()
+{
+    if (!numItems) {
+        clear();
+        return;
+    }
+    const int slotCount = slotCountFor(numItems);
+    if (slotCount != numSlots || growthLeft < maxLoad(numSlots) - numItems)
+        rehash(slotCount);
+}
+
+template <class Key, class T>
+void QFlatHash<Key, T>::eraseAt(int i)
+{
+    using namespace QFlatHashPrivate;
+    nodes[i].~Node();
+    --numItems;
+    // A probe only moves past a group that has no empty slot, so if this
+    // group has one, no probe can have passed this slot to find a key.
+    if (Group(ctrl + (i & ~(GroupSize - 1))).matchEmpty()) {
+        ctrl[i] = Empty;
+        ++growthLeft;
+    } else {
+        ctrl[i] = Deleted;
+    }
+}
+
+template <class Key, class T>
+typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &key, const T &value)
+{
+    const size_t hash = hashOf(key);
+    if (numSlots) {
+        const int i = findIndex(key, hash);
+        if (i >= 0) {
+            nodes[i].value = value;
+            return iterator(this, i);
+        }
+    }
+    const int i = prepareInsert(hash);
+    new (nodes + i) Node(key, value);
+    return iterator(this, i);
+}
+
+template <class Key, class T>
+T &QFlatHash<Key, T>::operator[](const Key &key)
+{
+    const size_t hash = hashOf(key);
+    if (numSlots) {
+        const int i = findIndex(key, hash);
+        if (i >= 0)
+            return nodes[i].value;
+    }
+    const int i = prepareInsert(hash);
+    new (nodes + i) Node(key, T());
+    return nodes[i].value;
+}
+
+template <class Key, class T>
+int QFlatHash<Key, T>::remove(const Key &key)
+{
+    const int i = findIndex(key);
+    if (i < 0)
+        return 0;
+    eraseAt(i);
+    return 1;
+}
+
+template <class Key, class T>
+T QFlatHash<Key, T>::take(const Key &key)
+{
+    const int i = findIndex(key);
+    if (i < 0)
+        return T();
+    T t = std::move(nodes[i].value);
+    eraseAt(i);
+    return t;
+}
+
+template <class Key, class T>
+typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(const_iterator it)
+{
+    Q_ASSERT_X(it.h == this && it.i < numSlots && ctrl[it.i] >= 0,
+               "QFlatHash::erase", "The specified iterator argument 'it' is invalid");
+    eraseAt(it.i);
+    return iterator(this, nextIndex(it.i));
+}
+
+template <class Key, class T>
+const T QFlatHash<Key, T>::value(const Key &key) const
+{
+    const int i = findIndex(key);
+    return i < 0 ? T() : nodes[i].value;
+}
+
+template <class Key, class T>
+const T QFlatHash<Key, T>::value(const Key &key, const T &defaultValue) const
+{
+    const int i = findIndex(key);
+    return i < 0 ? defaultValue : nodes[i].value;
+}
+
+template <class Key, class T>
+QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(numItems);
+    for (const_iterator it = begin(); it != end(); ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <class Key, class T>
+QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(numItems);
+    for (const_iterator it = begin(); it != end(); ++it)
+        res.append(it.value());
+    return res;
+}
+
+template <class Key, class T>
+bool QFlatHash<Key, T>::operator==(const QFlatHash &other) const
+{
+    if (numItems != other.numItems)
+        return false;
+    for (const_iterator it = begin(); it != end(); ++it) {
+        const int i = other.findIndex(it.key());
+        if (i < 0 || !(other.nodes[i].value == it.value()))
+            return false;
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
+
+#endif // QFLATHASH_P_H
@@ -0,0 +1,316 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qlz4_p.h"
+
+#include <QtCore/qendian.h>
+#include <QtCore/qvarlengtharray.h>
+#include <QtCore/private/qtools_p.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+  An implementation of the LZ4 block format, as described in
+  https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+
+  A block is a series of sequences, each made of a token byte, literals and
+  a match: the high four bits of the token are the number of literals, the
+  low four bits the match length minus MinMatch, with 15 meaning that more
+  length bytes follow; the literals are copied as they are; the match is a
+  16-bit little-endian offset back into the output, followed by the extra
+  length bytes. The last sequence only has literals.
+*/
+
+namespace {
+enum {
+    MinMatch = 4,
+    LastLiterals = 5,       // the last five bytes are always literals
+    MatchFindLimit = 12,    // no match starts in the last twelve bytes
+    MaxOffset = 65535,
+    HashLog = 14,
+    SkipStrength = 6        // search faster through data that doesn't compress
+};
+}
+
+static inline quint32 read32(const uchar *p)
+{
+    quint32 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline quint64 read64(const uchar *p)
+{
+    quint64 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint hashSequence(quint32 sequence)
+{
+    return (sequence * 2654435761U) >> (32 - HashLog);
+}
+
+static inline uchar *writeLength(uchar *out, uint length)
+{
+    for (; length >= 255; length -= 255)
+        *out++ = 255;
+    *out++ = uchar(length);
+    return out;
+}
+
+static inline bool readLength(const uchar *&in, const uchar *end, uint *length)
+{
+    uint byte;
+    do {
+        if (in == end)
+            return false;
+        byte = *in++;
+        *length += byte;
+        if (*length > uint(MaxAllocSize))
+            return false;
+    } while (byte == 255);
+    return true;
+}
+
+QByteArray qLz4Compress(const uchar *data, int nbytes)
+{
+    if (nbytes == 0)
+        return QByteArray(4, '\0');
+    if (!data) {
+        qWarning("qLz4Compress: Data is null");
+        return QByteArray();
+    }
+
+    // at worst, there are no matches and every 255 literals need a length byte
+    QByteArray result(4 + nbytes + nbytes / 255 + 16, Qt::Uninitialized);
+    uchar *const begin = reinterpret_cast<uchar *>(result.data());
+    qToBigEndian(quint32(nbytes), begin);
+    uchar *out = begin + 4;
+
+    const uchar *const end = data + nbytes;
+    const uchar *anchor = data;
+
+    if (nbytes > MatchFindLimit) {
+        // positions of the last sequence seen with each hash, plus one
+        QVarLengthArray<int, 1 << HashLog> table(1 << HashLog);
+        memset(table.data(), 0, table.size() * sizeof(int));
+
+        const uchar *const matchLimit = end - LastLiterals;
+        const uchar *const searchLimit = end - MatchFindLimit;
+        const uchar *in = data;
+        uint attempts = 1 << SkipStrength;
+
+        while (in <= searchLimit) {
+            const quint32 sequence = read32(in);
+            int &slot = table[hashSequence(sequence)];
+            const int candidate = slot - 1;
+            slot = int(in - data) + 1;
+            if (candidate < 0 || in - data - candidate > MaxOffset
+                    || read32(data + candidate) != sequence) {
+                in += attempts++ >> SkipStrength;
+                continue;
+            }
+            attempts = 1 << SkipStrength;
+            const uchar *match = data + candidate;
+
+            while (in > anchor && match > data && in[-1] == match[-1]) {
+                --in;
+                --match;
+            }
+
+            const uchar *matchEnd = in + MinMatch;
+            const uchar *ref = match + MinMatch;
+            while (matchEnd + 8 <= matchLimit && read64(matchEnd) == read64(ref)) {
+                matchEnd += 8;
+                ref += 8;
+            }
+            while (matchEnd < matchLimit && *matchEnd == *ref) {
+                ++matchEnd;
+                ++ref;
+            }
+
+            const uint literals = uint(in - anchor);
+            const uint matchLength = uint(matchEnd - in) - MinMatch;
+            uchar *token = out++;
+            *token = uchar((qMin(literals, 15U) << 4) | qMin(matchLength, 15U));
+            if (literals >= 15)
+                out = writeLength(out, literals - 15);
+            memcpy(out, anchor, literals);
+            out += literals;
+
+            const uint offset = uint(in - match);
+            *out++ = uchar(offset);
+            *out++ = uchar(offset >> 8);
+            if (matchLength >= 15)
+                out = writeLength(out, matchLength - 15);
+
+            in = anchor = matchEnd;
+            if (in - 2 > data)
+                table[hashSequence(read32(in - 2))] = int(in - 2 - data) + 1;
+        }
+    }
+
+    const uint literals = uint(end - anchor);
+    *out++ = uchar(qMin(literals, 15U) << 4);
+    if (literals >= 15)
+        out = writeLength(out, literals - 15);
+    memcpy(out, anchor, literals);
+    out += literals;
+
+    result.truncate(int(out - begin));
+    return result;
+}
+
+QLz4Decoder::QLz4Decoder(const uchar *data, int nbytes)
+    : in(0), inEnd(0), begin(0), out(0), end(0), totalSize(-1), finished(true), error(true)
+{
+    if (!data || nbytes < 4)
+        return;
+
+    const uint size = qFromBigEndian<quint32>(data);
+    // QByteArray does not support larger sizes
+    if (size >= uint(MaxAllocSize) - sizeof(QArrayData))
+        return;
+    if (size == 0) {
+        if (nbytes == 4)
+            totalSize = 0;
+        error = nbytes != 4;
+        return;
+    }
+
+    result = QByteArray(int(size), Qt::Uninitialized);
+    begin = out = reinterpret_cast<uchar *>(result.data());
+    end = begin + size;
+    in = data + 4;
+    inEnd = data + nbytes;
+    totalSize = size;
+    finished = error = false;
+}
+
+bool QLz4Decoder::decode(qint64 length)
+{
+    while (!finished && !error && (decodedSize() < length || out == end))
+        error = !decodeSequence();
+    return !error;
+}
+
+QByteArray QLz4Decoder::takeResult()
+{
+    if (!decode(totalSize))
+        return QByteArray();
+    QByteArray data;
+    data.swap(result);
+    begin = out = end = 0;
+    return data;
+}
+
+// Copies of up to 16 bytes are done as one fixed-size copy when there is
+// room, writing past the end of the sequence; what it writes there is
+// overwritten by the next sequence.
+bool QLz4Decoder::decodeSequence()
+{
+    if (in == inEnd)
+        return false;
+    const uint token = *in++;
+
+    uint length = token >> 4;
+    if (length == 15 && !readLength(in, inEnd, &length))
+        return false;
+    if (length > uint(inEnd - in) || length > uint(end - out))
+        return false;
+    if (length <= 16 && inEnd - in >= 16 && end - out >= 16)
+        memcpy(out, in, 16);
+    else
+        memcpy(out, in, length);
+    in += length;
+    out += length;
+
+    if (in == inEnd) {
+        finished = true;
+        return out == end;
+    }
+
+    if (inEnd - in < 2)
+        return false;
+    const uint offset = in[0] | (in[1] << 8);
+    in += 2;
+    if (offset == 0 || offset > uint(out - begin))
+        return false;
+
+    length = token & 15;
+    if (length == 15 && !readLength(in, inEnd, &length))
+        return false;
+    length += MinMatch;
+    if (length > uint(end - out))
+        return false;
+
+    const uchar *match = out - offset;
+    if (offset >= 16 && uint(end - out) >= ((length + 15) & ~15U)) {
+        for (uint i = 0; i < length; i += 16)
+            memcpy(out + i, match + i, 16);
+    } else if (offset >= length) {
+        memcpy(out, match, length);
+    } else {
+        // the match overlaps what it produces
+        for (uint i = 0; i < length; ++i)
+            out[i] = match[i];
+    }
+    out += length;
+    return true;
+}
+
+QByteArray qLz4Uncompress(const uchar *data, int nbytes)
+{
+    if (!data) {
+        qWarning("qLz4Uncompress: Data is null");
+        return QByteArray();
+    }
+
+    QLz4Decoder decoder(data, nbytes);
+    if (!decoder.decode(decoder.size())) {
+        qWarning("qLz4Uncompress: Input data is corrupted");
+        return QByteArray();
+    }
+    return decoder.takeResult();
+}
+
+QT_END_NAMESPACE
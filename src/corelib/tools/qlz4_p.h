@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QLZ4_P_H
+#define QLZ4_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qbytearray.h>
+
+QT_BEGIN_NAMESPACE
+
+// LZ4 block format compression. Like qCompress(), the result starts with the
+// uncompressed size as a 32-bit big-endian integer. It compresses less than
+// zlib does, but uncompresses several times faster.
+Q_CORE_EXPORT QByteArray qLz4Compress(const uchar *data, int nbytes);
+Q_CORE_EXPORT QByteArray qLz4Uncompress(const uchar *data, int nbytes);
+
+inline QByteArray qLz4Compress(const QByteArray &data)
+{ return qLz4Compress(reinterpret_cast<const uchar *>(data.constData()), data.size()); }
+inline QByteArray qLz4Uncompress(const QByteArray &data)
+{ return qLz4Uncompress(reinterpret_cast<const uchar *>(data.constData()), data.size()); }
+
+// Uncompresses the output of qLz4Compress() in steps, so that reading the
+// start of the data does not cost uncompressing all of it. The compressed
+// data must stay valid while the decoder is used.
+class Q_CORE_EXPORT QLz4Decoder
+{
+public:
+    QLz4Decoder(const uchar *data, int nbytes);
+
+    // the size in the header, or -1 if the header is corrupt
+    qint64 size() const { return totalSize; }
+    qint64 decodedSize() const { return out - begin; }
+    const char *data() const { return result.constData(); }
+
+    // Uncompresses at least length bytes, and validates the rest of the input
+    // once all of the output is there. Returns false if the data is corrupt.
+    bool decode(qint64 length);
+    // Uncompresses all of the data and returns it, or an empty array if it
+    // is corrupt.
+    QByteArray takeResult();
+
+private:
+    bool decodeSequence();
+
+    QByteArray result;
+    const uchar *in;
+    const uchar *inEnd;
+    uchar *begin;
+    uchar *out;
+    uchar *end;
+    qint64 totalSize;
+    bool finished;
+    bool error;
+};
+
+QT_END_NAMESPACE
+
+#endif // QLZ4_P_H
@@ -7447,6 +7447,9 @@ static QString replaceArgEscapes(const QString &s, const ArgEscapeData &d, int f
   If there is no unreplaced place marker remaining, a warning message
   is output and the result is undefined. Place marker numbers must be
   in the range 1 to 99.
+
+  To fill the same format string with different arguments repeatedly,
+  QStringFormat is faster.
 */
 QString QString::arg(const QString &a, int fieldWidth, QChar fillChar) const
 {
@@ -0,0 +1,411 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qstringformat.h"
+#include "qlocale_p.h"
+#include "qvarlengtharray.h"
+#include "qvector.h"
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+// in qstring.cpp
+void qt_from_latin1(ushort *dst, const char *str, size_t size) Q_DECL_NOTHROW;
+
+namespace {
+struct Part
+{
+    int position;
+    int size;
+    int index;          // argument replacing this placeholder; -1 for literal text
+    bool localized;     // %L placeholder
+};
+
+enum PlaceholderUsage {
+    UsedPlain = 0x1,
+    UsedLocalized = 0x2
+};
+} // unnamed namespace
+
+Q_DECLARE_TYPEINFO(Part, Q_PRIMITIVE_TYPE);
+
+class QStringFormatPrivate : public QSharedData
+{
+public:
+    explicit QStringFormatPrivate(const QString &format = QString());
+
+    QString format;
+    QVector<Part> parts;
+    QVector<uchar> usage;   // PlaceholderUsage per argument index
+};
+
+QStringFormatPrivate::QStringFormatPrivate(const QString &fmt)
+    : format(fmt)
+{
+    // Placeholders are parsed as in QString::arg(): %n or %Ln, where n is
+    // one or two digits.
+    const QChar *uc = format.constData();
+    const int len = format.size();
+    QVarLengthArray<int, 16> numbers;
+
+    int last = 0;
+    int i = format.indexOf(QLatin1Char('%'));
+    while (i != -1) {
+        int c = i + 1;
+        bool localized = false;
+        if (c < len && uc[c] == QLatin1Char('L')) {
+            localized = true;
+            ++c;
+        }
+        int number = c < len ? uc[c].digitValue() : -1;
+        if (number == -1) {
+            i = format.indexOf(QLatin1Char('%'), i + 1);
+            continue;
+        }
+        if (++c < len) {
+            const int next = uc[c].digitValue();
+            if (next != -1) {
+                number = 10 * number + next;
+                ++c;
+            }
+        }
+
+        if (last != i) {
+            const Part literal = { last, i - last, -1, false };
+            parts.append(literal);
+        }
+        // the number is turned into an argument index below
+        const Part placeholder = { i, c - i, number, localized };
+        parts.append(placeholder);
+        numbers.append(number);
+
+        last = c;
+        i = format.indexOf(QLatin1Char('%'), c);
+    }
+    if (last < len) {
+        const Part literal = { last, len - last, -1, false };
+        parts.append(literal);
+    }
+
+    // the lowest placeholder number takes the first argument, and so on
+    std::sort(numbers.begin(), numbers.end());
+    numbers.erase(std::unique(numbers.begin(), numbers.end()), numbers.end());
+    usage.fill(0, numbers.size());
+    for (Part &part : parts) {
+        if (part.index == -1)
+            continue;
+        part.index = int(std::lower_bound(numbers.begin(), numbers.end(), part.index) - numbers.begin());
+        usage[part.index] |= part.localized ? UsedLocalized : UsedPlain;
+    }
+}
+
+/*!
+    \class QStringFormat
+    \inmodule QtCore
+    \since 5.10
+    \brief The QStringFormat class holds a parsed format string, to be
+    filled with arguments repeatedly.
+
+    \ingroup tools
+    \ingroup string-processing
+    \ingroup shared
+    \reentrant
+
+    Formatting a string with chained calls to QString::arg() scans the
+    format string and allocates a new string for every argument.
+    QStringFormat parses the format string once, when it is constructed.
+    Each call to arg() then converts the arguments, computes the size of
+    the result and fills a single string with it:
+
+    \snippet code/src_corelib_tools_qstringformat.cpp 0
+
+    The place markers are the same as for QString::arg(): \c %1 to \c %99,
+    with an optional \c L (as in \c %L1) to format a number according to
+    the default locale. The first argument replaces the lowest-numbered
+    place marker, the second argument the next one, and so on. Unlike
+    chained QString::arg() calls, the text of an argument is never scanned
+    for place markers.
+
+    Place markers with no corresponding argument are left as they are.
+
+    \sa QString::arg()
+*/
+
+/*!
+    Constructs an empty format.
+*/
+QStringFormat::QStringFormat()
+    : d(new QStringFormatPrivate)
+{
+}
+
+/*!
+    Constructs a format from the string \a format, finding all its
+    place markers.
+*/
+QStringFormat::QStringFormat(const QString &format)
+    : d(new QStringFormatPrivate(format))
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QStringFormat::QStringFormat(const QStringFormat &other)
+    : d(other.d)
+{
+}
+
+/*!
+    Assigns \a other to this format and returns a reference to this format.
+*/
+QStringFormat &QStringFormat::operator=(const QStringFormat &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    \fn QStringFormat &QStringFormat::operator=(QStringFormat &&other)
+
+    Move-assigns \a other to this QStringFormat instance.
+*/
+
+/*!
+    Destroys the format.
+*/
+QStringFormat::~QStringFormat()
+{
+}
+
+/*!
+    \fn void QStringFormat::swap(QStringFormat &other)
+
+    Swaps format \a other with this format. This operation is very fast
+    and never fails.
+*/
+
+/*!
+    Returns the format string.
+*/
+QString QStringFormat::format() const
+{
+    return d->format;
+}
+
+/*!
+    Returns the number of different place markers in the format, which
+    is the number of arguments arg() expects.
+*/
+int QStringFormat::placeholderCount() const
+{
+    return d->usage.size();
+}
+
+/*!
+    \fn template <typename... Args> QString QStringFormat::arg(const Args &... args) const
+
+    Returns the format with its place markers replaced by \a args.
+
+    The arguments can be strings (QString, QStringRef, QLatin1String or
+    anything that converts to QString, such as the result of QStringBuilder
+    concatenations), characters (QChar, QLatin1Char or \c char), integers
+    or \c double values. Integers are formatted in base 10 and
+    \c double values as with QString::arg(double), using the \c g format.
+
+    If there are more arguments than place markers, a warning is printed
+    and the extra arguments are ignored.
+*/
+
+namespace {
+// The text an argument is replaced with
+struct ArgumentText
+{
+    const void *data;
+    int size;
+    bool latin1;
+    ushort buffer[24];  // for characters and integers in the C locale
+    QString text;       // for everything else that needs formatting
+};
+} // unnamed namespace
+
+static void setText(ArgumentText *text, const QString &s)
+{
+    text->text = s;
+    text->data = text->text.constData();
+    text->size = text->text.size();
+    text->latin1 = false;
+}
+
+static void setDecimal(ArgumentText *text, qulonglong magnitude, bool negative)
+{
+    // same as QLocaleData::c()->longLongToString(), without the allocation
+    ushort *end = text->buffer + sizeof text->buffer / sizeof *text->buffer;
+    ushort *p = end;
+    do {
+        *--p = ushort('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (negative)
+        *--p = '-';
+    text->data = p;
+    text->size = int(end - p);
+    text->latin1 = false;
+}
+
+static unsigned localeNumberFlags(const QLocale &locale)
+{
+    unsigned flags = QLocaleData::NoFlags;
+    if (!(locale.numberOptions() & QLocale::OmitGroupSeparator))
+        flags |= QLocaleData::ThousandsGroup;
+    return flags;
+}
+
+template <typename Argument>
+static void convertArgument(const Argument &arg, bool localized, ArgumentText *text)
+{
+    switch (arg.type) {
+    case Argument::Null:
+        Q_UNREACHABLE();
+        break;
+    case Argument::Utf16:
+    case Argument::Latin1:
+        text->data = arg.string.data;
+        text->size = arg.string.size;
+        text->latin1 = arg.type == Argument::Latin1;
+        break;
+    case Argument::Character:
+        text->buffer[0] = arg.character;
+        text->data = text->buffer;
+        text->size = 1;
+        text->latin1 = false;
+        break;
+    case Argument::Integer:
+        if (localized) {
+            QLocale locale;
+            setText(text, QLocalePrivate::get(locale)->m_data->longLongToString(
+                        arg.integer, -1, 10, 0, localeNumberFlags(locale)));
+        } else {
+            setDecimal(text, arg.integer < 0 ? 0 - qulonglong(arg.integer) : qulonglong(arg.integer),
+                       arg.integer < 0);
+        }
+        break;
+    case Argument::UnsignedInteger:
+        if (localized) {
+            QLocale locale;
+            setText(text, QLocalePrivate::get(locale)->m_data->unsLongLongToString(
+                        arg.unsignedInteger, -1, 10, 0, localeNumberFlags(locale)));
+        } else {
+            setDecimal(text, arg.unsignedInteger, false);
+        }
+        break;
+    case Argument::Double:
+        if (localized) {
+            // see QString::arg(double)
+            QLocale locale;
+            const QLocale::NumberOptions numberOptions = locale.numberOptions();
+            unsigned flags = localeNumberFlags(locale);
+            if (!(numberOptions & QLocale::OmitLeadingZeroInExponent))
+                flags |= QLocaleData::ZeroPadExponent;
+            if (numberOptions & QLocale::IncludeTrailingZeroesAfterDot)
+                flags |= QLocaleData::AddTrailingZeroes;
+            setText(text, QLocalePrivate::get(locale)->m_data->doubleToString(
+                        arg.floatingPoint, -1, QLocaleData::DFSignificantDigits, 0, flags));
+        } else {
+            setText(text, QLocaleData::c()->doubleToString(
+                        arg.floatingPoint, -1, QLocaleData::DFSignificantDigits, 0,
+                        QLocaleData::NoFlags));
+        }
+        break;
+    }
+}
+
+/*!
+    \internal
+*/
+QString QStringFormat::render(const Argument *args, int count) const
+{
+    const int placeholders = d->usage.size();
+    if (count > placeholders) {
+        qWarning("QStringFormat::arg: %d surplus argument(s) for %s",
+                 count - placeholders, d->format.toLocal8Bit().constData());
+        count = placeholders;
+    }
+
+    // Convert the arguments first, so that the size of the result is known
+    QVarLengthArray<ArgumentText, 8> plain(count);
+    QVarLengthArray<ArgumentText, 8> localized(count);
+    for (int i = 0; i < count; ++i) {
+        if (d->usage.at(i) & UsedPlain)
+            convertArgument(args[i], false, &plain[i]);
+        if (d->usage.at(i) & UsedLocalized)
+            convertArgument(args[i], true, &localized[i]);
+    }
+
+    int size = 0;
+    for (const Part &part : qAsConst(d->parts)) {
+        if (part.index == -1 || part.index >= count)
+            size += part.size;
+        else
+            size += (part.localized ? localized : plain)[part.index].size;
+    }
+
+    QString result(size, Qt::Uninitialized);
+    ushort *out = reinterpret_cast<ushort *>(result.data());
+    const QChar *format = d->format.constData();
+    for (const Part &part : qAsConst(d->parts)) {
+        if (part.index == -1 || part.index >= count) {
+            memcpy(out, format + part.position, part.size * sizeof(QChar));
+            out += part.size;
+            continue;
+        }
+        const ArgumentText &text = (part.localized ? localized : plain)[part.index];
+        if (text.latin1)
+            qt_from_latin1(out, static_cast<const char *>(text.data), uint(text.size));
+        else
+            memcpy(out, text.data, text.size * sizeof(QChar));
+        out += text.size;
+    }
+    Q_ASSERT(out == reinterpret_cast<const ushort *>(result.constData()) + size);
+
+    return result;
+}
+
+QT_END_NAMESPACE
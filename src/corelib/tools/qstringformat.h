@@ -0,0 +1,132 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSTRINGFORMAT_H
+#define QSTRINGFORMAT_H
+
+#include <QtCore/qstring.h>
+#include <QtCore/qshareddata.h>
+
+QT_BEGIN_NAMESPACE
+
+class QStringFormatPrivate;
+class Q_CORE_EXPORT QStringFormat
+{
+    class Argument
+    {
+    public:
+        enum Type { Null, Utf16, Latin1, Character, Integer, UnsignedInteger, Double };
+
+        Argument() Q_DECL_NOTHROW : type(Null) {}
+        Argument(const QString &s) Q_DECL_NOTHROW : type(Utf16) { setString(s.constData(), s.size()); }
+        Argument(const QStringRef &s) Q_DECL_NOTHROW : type(Utf16) { setString(s.constData(), s.size()); }
+        Argument(QLatin1String s) Q_DECL_NOTHROW : type(Latin1) { setString(s.data(), s.size()); }
+        Argument(QChar c) Q_DECL_NOTHROW : type(Character) { character = c.unicode(); }
+        Argument(QLatin1Char c) Q_DECL_NOTHROW : type(Character) { character = c.unicode(); }
+        Argument(char c) Q_DECL_NOTHROW : type(Character) { character = uchar(c); }
+        Argument(short n) Q_DECL_NOTHROW : type(Integer) { integer = n; }
+        Argument(ushort n) Q_DECL_NOTHROW : type(UnsignedInteger) { unsignedInteger = n; }
+        Argument(int n) Q_DECL_NOTHROW : type(Integer) { integer = n; }
+        Argument(uint n) Q_DECL_NOTHROW : type(UnsignedInteger) { unsignedInteger = n; }
+        Argument(long n) Q_DECL_NOTHROW : type(Integer) { integer = n; }
+        Argument(ulong n) Q_DECL_NOTHROW : type(UnsignedInteger) { unsignedInteger = n; }
+        Argument(qlonglong n) Q_DECL_NOTHROW : type(Integer) { integer = n; }
+        Argument(qulonglong n) Q_DECL_NOTHROW : type(UnsignedInteger) { unsignedInteger = n; }
+        Argument(double n) Q_DECL_NOTHROW : type(Double) { floatingPoint = n; }
+
+        // anything else that converts to QString (such as QStringBuilder
+        // expressions) is converted here, so the result outlives the call
+        template <typename T, typename = typename std::enable_if<
+                      std::is_convertible<const T &, QString>::value>::type>
+        Argument(const T &value)
+            : type(Utf16), converted(value)
+        { setString(converted.constData(), converted.size()); }
+
+        Type type;
+        union {
+            struct {
+                const void *data;
+                int size;
+            } string;
+            ushort character;
+            qlonglong integer;
+            qulonglong unsignedInteger;
+            double floatingPoint;
+        };
+
+    private:
+        void setString(const void *data, int size) Q_DECL_NOTHROW
+        { string.data = data; string.size = size; }
+
+        QString converted;
+    };
+
+public:
+    QStringFormat();
+    explicit QStringFormat(const QString &format);
+    QStringFormat(const QStringFormat &other);
+    QStringFormat &operator=(const QStringFormat &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    QStringFormat &operator=(QStringFormat &&other) Q_DECL_NOTHROW { swap(other); return *this; }
+#endif
+    ~QStringFormat();
+
+    void swap(QStringFormat &other) Q_DECL_NOTHROW { qSwap(d, other.d); }
+
+    QString format() const;
+    int placeholderCount() const;
+
+    template <typename... Args>
+    QString arg(const Args &... args) const
+    {
+        const Argument list[] = { Argument(args)..., Argument() };
+        return render(list, int(sizeof...(Args)));
+    }
+
+private:
+    QString render(const Argument *args, int count) const;
+
+    QSharedDataPointer<QStringFormatPrivate> d;
+};
+
+Q_DECLARE_SHARED(QStringFormat)
+
+QT_END_NAMESPACE
+
+#endif // QSTRINGFORMAT_H
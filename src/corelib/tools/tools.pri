@@ -7,6 +7,7 @@ HEADERS +=  \
         tools/qarraydata.h \
         tools/qarraydataops.h \
         tools/qarraydatapointer.h \
+        tools/qarraydatapool_p.h \
         tools/qbitarray.h \
         tools/qbytearray.h \
         tools/qbytearray_p.h \
@@ -23,6 +24,7 @@ HEADERS +=  \
         tools/qdatetime_p.h \
         tools/qdoublescanprint_p.h \
         tools/qeasingcurve.h \
+        tools/qflathash_p.h \
         tools/qfreelist_p.h \
         tools/qhash.h \
         tools/qhashfunctions.h \
@@ -34,6 +36,7 @@ HEADERS +=  \
         tools/qlocale_p.h \
         tools/qlocale_tools_p.h \
         tools/qlocale_data_p.h \
+        tools/qlz4_p.h \
         tools/qmap.h \
         tools/qmargins.h \
         tools/qmessageauthenticationcode.h \
@@ -59,6 +62,7 @@ HEADERS +=  \
         tools/qstring.h \
         tools/qstringalgorithms_p.h \
         tools/qstringbuilder.h \
+        tools/qstringformat.h \
         tools/qstringiterator_p.h \
         tools/qstringlist.h \
         tools/qstringmatcher.h \
@@ -89,6 +93,7 @@ SOURCES += \
         tools/qlist.cpp \
         tools/qlocale.cpp \
         tools/qlocale_tools.cpp \
+        tools/qlz4.cpp \
         tools/qpoint.cpp \
         tools/qmap.cpp \
         tools/qmargins.cpp \
@@ -104,6 +109,7 @@ SOURCES += \
         tools/qsize.cpp \
         tools/qstring.cpp \
         tools/qstringbuilder.cpp \
+        tools/qstringformat.cpp \
         tools/qstringlist.cpp \
         tools/qtextboundaryfinder.cpp \
         tools/qtimeline.cpp \
@@ -105,7 +105,15 @@ void BitOStream::write(const QByteArray &src, bool compressed)
     if (compressed && byteLen) {
         const auto bitLen = huffman_encoded_bit_length(src);
         Q_ASSERT(bitLen && std::numeric_limits<quint32>::max() >= (bitLen + 7) / 8);
-        byteLen = (bitLen + 7) / 8;
+        // Huffman codes for some octets are longer than 8 bits; for strings
+        // made mostly of those, the raw octets are the shorter form.
+        if ((bitLen + 7) / 8 < byteLen)
+            byteLen = (bitLen + 7) / 8;
+        else
+            compressed = false;
+    }
+
+    if (compressed) {
         writeBits(uchar(1), 1); // bit set - compressed
     } else {
         writeBits(uchar(0), 1); // no compression.
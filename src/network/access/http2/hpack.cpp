@@ -43,6 +43,7 @@
 #include <QtCore/qbytearray.h>
 #include <QtCore/qdebug.h>
 
+#include <algorithm>
 #include <limits>
 
 QT_BEGIN_NAMESPACE
@@ -145,11 +146,33 @@ bool is_request_pseudo_header(const QByteArray &name)
            name == ":authority" || name == ":path";
 }
 
+bool is_per_request_field(const QByteArray &name)
+{
+    // Values of these fields rarely repeat, indexing
+    // them would only evict the entries that do.
+    return name == "content-length" || name == "if-modified-since" ||
+           name == "if-none-match" || name == "if-range" || name == "range";
+}
+
+bool is_sensitive_field(const HeaderField &field)
+{
+    // HPACK, 7.1.3: short credentials and cookies are easy to guess
+    // through compression side channels, never let them be indexed
+    // (by us or by an intermediary). Long ones are safe to index and
+    // are exactly what makes the dynamic table pay off.
+    const int minimalSafeLength = 20;
+    return field.value.size() < minimalSafeLength
+           && (field.name == "authorization" || field.name == "proxy-authorization"
+               || field.name == "cookie");
+}
+
 } // unnamed namespace
 
 Encoder::Encoder(quint32 size, bool compress)
     : lookupTable(size, true /*encoder needs search index*/),
-      compressStrings(compress)
+      compressStrings(compress),
+      sizeUpdatePending(false),
+      smallestTableSize(size)
 {
 }
 
@@ -165,6 +188,9 @@ bool Encoder::encodeRequest(BitOStream &outputStream, const HttpHeader &header)
         return false;
     }
 
+    if (!encodePendingSizeUpdate(outputStream))
+        return false;
+
     if (!encodeRequestPseudoHeaders(outputStream, header))
         return false;
 
@@ -186,6 +212,9 @@ bool Encoder::encodeResponse(BitOStream &outputStream, const HttpHeader &header)
         return false;
     }
 
+    if (!encodePendingSizeUpdate(outputStream))
+        return false;
+
     if (!encodeResponsePseudoHeaders(outputStream, header))
         return false;
 
@@ -217,7 +246,26 @@ void Encoder::setMaxDynamicTableSize(quint32 size)
 {
     // Up to a caller (HTTP2 protocol handler)
     // to validate this size first.
+    const quint32 oldCapacity = lookupTable.dynamicTableCapacity();
     lookupTable.setMaxDynamicTableSize(size);
+    if (size == oldCapacity && !sizeUpdatePending)
+        return;
+
+    smallestTableSize = sizeUpdatePending ? std::min(smallestTableSize, size) : size;
+    sizeUpdatePending = true;
+}
+
+bool Encoder::encodePendingSizeUpdate(BitOStream &outputStream)
+{
+    if (!sizeUpdatePending)
+        return true;
+
+    sizeUpdatePending = false;
+    const quint32 newSize = lookupTable.dynamicTableCapacity();
+    if (smallestTableSize < newSize && !encodeSizeUpdate(outputStream, smallestTableSize))
+        return false;
+
+    return encodeSizeUpdate(outputStream, newSize);
 }
 
 bool Encoder::encodeRequestPseudoHeaders(BitOStream &outputStream,
@@ -293,21 +341,36 @@ bool Encoder::encodeRequestPseudoHeaders(BitOStream &outputStream,
 
 bool Encoder::encodeHeaderField(BitOStream &outputStream, const HeaderField &field)
 {
-    // TODO: at the moment we never use LiteralNo/Never Indexing ...
-
     // Here we try:
     // 1. indexed
-    // 2. literal indexed with indexed name/literal value
-    // 3. literal indexed with literal name/literal value
+    // 2. literal with indexed name/literal value
+    // 3. literal with literal name/literal value
+    // Literals are added to the dynamic table, so that the next
+    // request on this connection can send them as an index, unless:
+    // - the field is sensitive (never indexed),
+    // - its value is not going to repeat, or
+    // - it would take more than half of the table, evicting
+    //   everything else (no indexing).
     if (const auto index = lookupTable.indexOf(field.name, field.value))
         return encodeIndexedField(outputStream, index);
 
+    BitPattern fieldType = LiteralIncrementalIndexing;
+    if (is_sensitive_field(field)) {
+        fieldType = LiteralNeverIndexing;
+    } else if (is_per_request_field(field.name)) {
+        fieldType = LiteralNoIndexing;
+    } else {
+        const auto entrySize = entry_size(field);
+        if (!entrySize.first || entrySize.second > lookupTable.dynamicTableCapacity() / 2)
+            fieldType = LiteralNoIndexing;
+    }
+
     if (const auto index = lookupTable.indexOf(field.name)) {
-        return encodeLiteralField(outputStream, LiteralIncrementalIndexing,
+        return encodeLiteralField(outputStream, fieldType,
                                   index, field.value, compressStrings);
     }
 
-    return encodeLiteralField(outputStream, LiteralIncrementalIndexing,
+    return encodeLiteralField(outputStream, fieldType,
                               field.name, field.value, compressStrings);
 }
 
@@ -85,6 +85,7 @@ public:
     void setMaxDynamicTableSize(quint32 size);
 
 private:
+    bool encodePendingSizeUpdate(BitOStream &outputStream);
     bool encodeRequestPseudoHeaders(BitOStream &outputStream,
                                     const HttpHeader &header);
     bool encodeHeaderField(BitOStream &outputStream,
@@ -112,6 +113,12 @@ private:
 
     FieldLookupTable lookupTable;
     bool compressStrings;
+
+    // A change of the table size by SETTINGS_HEADER_TABLE_SIZE
+    // must be acknowledged at the start of the next header block,
+    // including the smallest size it went through (HPACK, 4.2).
+    bool sizeUpdatePending;
+    quint32 smallestTableSize;
 };
 
 class Q_AUTOTEST_EXPORT Decoder
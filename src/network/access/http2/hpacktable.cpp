@@ -316,6 +316,11 @@ quint32 FieldLookupTable::dynamicDataSize() const
     return dataSize;
 }
 
+quint32 FieldLookupTable::dynamicTableCapacity() const
+{
+    return tableCapacity;
+}
+
 void FieldLookupTable::clearDynamicTable()
 {
     searchIndex.clear();
@@ -504,6 +509,7 @@ bool FieldLookupTable::updateDynamicTableSize(quint32 size)
 {
     if (!size) {
         clearDynamicTable();
+        tableCapacity = 0;
         return true;
     }
 
@@ -111,6 +111,7 @@ public:
     qint64 written;
     qint64 bytesTotal;
     bool resendCurrent;
+    bool freshConnection; // no request has been sent on the current socket yet
     int lastStatus; // last status received on this channel
     bool pendingEncrypt; // for https (send after encrypted)
     int reconnectAttempts; // maximum 2 reconnection attempts
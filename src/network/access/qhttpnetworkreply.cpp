@@ -289,6 +289,11 @@ bool QHttpNetworkReply::isPipeliningUsed() const
     return d_func()->pipeliningUsed;
 }
 
+bool QHttpNetworkReply::isConnectionReused() const
+{
+    return d_func()->connectionReused;
+}
+
 bool QHttpNetworkReply::isSpdyUsed() const
 {
     return d_func()->spdyUsed;
@@ -334,7 +339,7 @@ QHttpNetworkReplyPrivate::QHttpNetworkReplyPrivate(const QUrl &newUrl)
       removedContentLength(-1),
       connection(0),
       autoDecompress(false), responseData(), requestIsPrepared(false)
-      ,pipeliningUsed(false), spdyUsed(false), downstreamLimited(false)
+      ,pipeliningUsed(false), connectionReused(false), spdyUsed(false), downstreamLimited(false)
       ,userProvidedDownloadBuffer(0)
 #ifndef QT_NO_COMPRESS
       ,inflateStrm(0)
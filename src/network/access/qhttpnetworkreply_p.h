@@ -137,6 +137,7 @@ public:
     bool isFinished() const;
 
     bool isPipeliningUsed() const;
+    bool isConnectionReused() const;
     bool isSpdyUsed() const;
     void setSpdyWasUsed(bool spdy);
     qint64 removedContentLength() const;
@@ -267,6 +268,7 @@ public:
     bool requestIsPrepared;
 
     bool pipeliningUsed;
+    bool connectionReused;
     bool spdyUsed;
     bool downstreamLimited;
 
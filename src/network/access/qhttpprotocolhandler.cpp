@@ -277,6 +277,7 @@ bool QHttpProtocolHandler::sendRequest()
         if (scheme == QLatin1String("preconnect-http")
             || scheme == QLatin1String("preconnect-https")) {
             m_channel->state = QHttpNetworkConnectionChannel::IdleState;
+            m_channel->freshConnection = false; // the next request will find it open
             m_reply->d_func()->state = QHttpNetworkReplyPrivate::AllDoneState;
             m_channel->allDone();
             m_connection->preConnectFinished(); // will only decrease the counter
@@ -293,6 +294,8 @@ bool QHttpProtocolHandler::sendRequest()
         replyPrivate->connectionChannel = m_channel;
         replyPrivate->autoDecompress = m_channel->request.d->autoDecompress;
         replyPrivate->pipeliningUsed = false;
+        replyPrivate->connectionReused = !m_channel->freshConnection;
+        m_channel->freshConnection = false;
 
         // if the url contains authentication parameters, use the new ones
         // both channels will use the new authentication parameters
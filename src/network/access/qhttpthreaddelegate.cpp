@@ -178,15 +178,18 @@ class QNetworkAccessCachedHttpConnection: public QHttpNetworkConnection,
     // Q_OBJECT
 public:
 #ifdef QT_NO_BEARERMANAGEMENT
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+    QNetworkAccessCachedHttpConnection(quint16 connectionCount, const QString &hostName, quint16 port,
+                                       bool encrypt,
                                        QHttpNetworkConnection::ConnectionType connectionType)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType)
+        : QHttpNetworkConnection(connectionCount, hostName, port, encrypt, /*parent=*/0,
+                                 connectionType)
 #else
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+    QNetworkAccessCachedHttpConnection(quint16 connectionCount, const QString &hostName, quint16 port,
+                                       bool encrypt,
                                        QHttpNetworkConnection::ConnectionType connectionType,
                                        QSharedPointer<QNetworkSession> networkSession)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType, /*parent=*/0,
-                                 qMove(networkSession))
+        : QHttpNetworkConnection(connectionCount, hostName, port, encrypt, /*parent=*/0,
+                                 qMove(networkSession), connectionType)
 #endif
     {
         setExpires(true);
@@ -227,12 +230,14 @@ QHttpThreadDelegate::QHttpThreadDelegate(QObject *parent) :
     , downloadBufferMaximumSize(0)
     , readBufferMaxSize(0)
     , bytesEmitted(0)
+    , connectionsPerHost(6)
     , pendingDownloadData()
     , pendingDownloadProgress()
     , synchronous(false)
     , incomingStatusCode(0)
     , isPipeliningUsed(false)
     , isSpdyUsed(false)
+    , isConnectionReused(false)
     , incomingContentLength(-1)
     , removedContentLength(-1)
     , incomingErrorCode(QNetworkReply::NoError)
@@ -321,10 +326,12 @@ void QHttpThreadDelegate::startRequest()
         // no entry in cache; create an object
         // the http object is actually a QHttpNetworkConnection
 #ifdef QT_NO_BEARERMANAGEMENT
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
+        httpConnection = new QNetworkAccessCachedHttpConnection(connectionsPerHost, urlCopy.host(),
+                                                                urlCopy.port(), ssl,
                                                                 connectionType);
 #else
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
+        httpConnection = new QNetworkAccessCachedHttpConnection(connectionsPerHost, urlCopy.host(),
+                                                                urlCopy.port(), ssl,
                                                                 connectionType,
                                                                 networkSession);
 #endif
@@ -626,6 +633,7 @@ void QHttpThreadDelegate::headerChangedSlot()
     incomingContentLength = httpReply->contentLength();
     removedContentLength = httpReply->removedContentLength();
     isSpdyUsed = httpReply->isSpdyUsed();
+    isConnectionReused = httpReply->isConnectionReused();
 
     emit downloadMetaData(incomingHeaders,
                           incomingStatusCode,
@@ -634,7 +642,8 @@ void QHttpThreadDelegate::headerChangedSlot()
                           downloadBuffer,
                           incomingContentLength,
                           removedContentLength,
-                          isSpdyUsed);
+                          isSpdyUsed,
+                          isConnectionReused);
 }
 
 void QHttpThreadDelegate::synchronousHeaderChangedSlot()
@@ -651,6 +660,7 @@ void QHttpThreadDelegate::synchronousHeaderChangedSlot()
     incomingReasonPhrase = httpReply->reasonPhrase();
     isPipeliningUsed = httpReply->isPipeliningUsed();
     isSpdyUsed = httpReply->isSpdyUsed();
+    isConnectionReused = httpReply->isConnectionReused();
     incomingContentLength = httpReply->contentLength();
 }
 
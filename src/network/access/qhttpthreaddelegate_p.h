@@ -94,6 +94,8 @@ public:
     qint64 downloadBufferMaximumSize;
     qint64 readBufferMaxSize;
     qint64 bytesEmitted;
+    // Channels per host for connections this delegate creates
+    quint16 connectionsPerHost;
     // From backend, modified by us for signal compression
     QSharedPointer<QAtomicInt> pendingDownloadData;
     QSharedPointer<QAtomicInt> pendingDownloadProgress;
@@ -111,6 +113,7 @@ public:
     QString incomingReasonPhrase;
     bool isPipeliningUsed;
     bool isSpdyUsed;
+    bool isConnectionReused;
     qint64 incomingContentLength;
     qint64 removedContentLength;
     QNetworkReply::NetworkError incomingErrorCode;
@@ -142,7 +145,7 @@ signals:
     void preSharedKeyAuthenticationRequired(QSslPreSharedKeyAuthenticator *);
 #endif
     void downloadMetaData(const QList<QPair<QByteArray,QByteArray> > &, int, const QString &, bool,
-                          QSharedPointer<char>, qint64, qint64, bool);
+                          QSharedPointer<char>, qint64, qint64, bool, bool);
     void downloadProgress(qint64, qint64);
     void downloadData(const QByteArray &);
     void error(QNetworkReply::NetworkError, const QString &);
@@ -72,6 +72,7 @@
 #include "qnetworkreplyhttpimpl_p.h"
 
 #include "qthread.h"
+#include "qmutex.h"
 
 #include <QHostInfo>
 
@@ -92,6 +93,18 @@ Q_GLOBAL_STATIC(QNetworkAccessFtpBackendFactory, ftpBackend)
 Q_GLOBAL_STATIC(QNetworkAccessDebugPipeBackendFactory, debugpipeBackend)
 #endif
 
+// The HTTP thread shared by all managers that enabled the shared connection
+// pool. The connection cache lives in thread-local storage of the HTTP thread,
+// so sharing the thread is what shares the connections.
+struct QNetworkAccessSharedThread
+{
+    QNetworkAccessSharedThread() : thread(0), ref(0) {}
+    QMutex mutex;
+    QThread *thread;
+    int ref;
+};
+Q_GLOBAL_STATIC(QNetworkAccessSharedThread, sharedHttpThread)
+
 #if defined(Q_OS_MACX)
 bool getProxyAuth(const QString& proxyHostname, const QString &scheme, QString& username, QString& password)
 {
@@ -1198,6 +1211,100 @@ QNetworkRequest::RedirectPolicy QNetworkAccessManager::redirectPolicy() const
     return d->redirectPolicy;
 }
 
+/*!
+    \since 5.10
+
+    Sets the maximum number of parallel HTTP/1.x connections the manager
+    opens to a single host (and port) to \a count. Requests beyond that are
+    queued and, where the server allows it, pipelined onto the existing
+    connections. The default is 6.
+
+    The value applies to hosts the manager connects to after the call;
+    connections that are already open keep their size until they expire or
+    clearConnectionCache() is called, or, with the shared connection pool,
+    until the last manager using the pool is gone. HTTP/2 and SPDY
+    connections always use a single connection per host.
+
+    \sa maximumConnectionsPerHost(), QNetworkRequest::HttpPipeliningAllowedAttribute
+*/
+void QNetworkAccessManager::setMaximumConnectionsPerHost(int count)
+{
+    Q_D(QNetworkAccessManager);
+    if (count < 1 || count > 0xffff) {
+        qWarning("QNetworkAccessManager::setMaximumConnectionsPerHost: invalid count %d", count);
+        return;
+    }
+    d->connectionsPerHost = quint16(count);
+}
+
+/*!
+    \since 5.10
+
+    Returns the maximum number of parallel HTTP/1.x connections the manager
+    opens to a single host.
+
+    \sa setMaximumConnectionsPerHost()
+*/
+int QNetworkAccessManager::maximumConnectionsPerHost() const
+{
+    Q_D(const QNetworkAccessManager);
+    return d->connectionsPerHost;
+}
+
+/*!
+    \since 5.10
+
+    If \a enabled is \c true, the manager sends its HTTP requests through a
+    connection pool that is shared with every other QNetworkAccessManager in
+    the process that enabled it, instead of through its own pool. Idle
+    connections opened by one manager can then be reused by another one,
+    saving the TCP and TLS handshakes. This is useful for applications that
+    create many short-lived managers talking to the same hosts.
+
+    The pool stays alive as long as at least one manager using it exists.
+    Connections are matched by host, port, encryption and proxy; the number
+    of connections per host is decided by the manager that opened the first
+    one (see setMaximumConnectionsPerHost()). Because connections carry the
+    authentication state negotiated on them, only enable the shared pool for
+    managers that can trust each other.
+
+    The connections in the shared pool do not belong to any one manager.
+    Destroying a manager, calling clearConnectionCache() or
+    clearAccessCache() on it, or disabling the shared pool again only stops
+    that manager from using the pool; the connections are only closed once
+    no manager uses the pool anymore, or when they expire.
+
+    Changing this setting makes the manager stop using the connections it
+    currently holds, like clearConnectionCache() does, so it is best set
+    before the first request is made. Synchronous requests are not affected.
+
+    By default the shared connection pool is disabled.
+
+    \sa isSharedConnectionPoolEnabled(), QNetworkRequest::ConnectionWasReusedAttribute
+*/
+void QNetworkAccessManager::setSharedConnectionPoolEnabled(bool enabled)
+{
+    Q_D(QNetworkAccessManager);
+    if (d->sharedConnectionPool == enabled)
+        return;
+    d->destroyThread();
+    d->sharedConnectionPool = enabled;
+}
+
+/*!
+    \since 5.10
+
+    Returns \c true if the manager uses the process-wide HTTP connection
+    pool, otherwise returns \c false.
+
+    \sa setSharedConnectionPoolEnabled()
+*/
+bool QNetworkAccessManager::isSharedConnectionPoolEnabled() const
+{
+    Q_D(const QNetworkAccessManager);
+    return d->sharedConnectionPool;
+}
+
 /*!
     \since 4.7
 
@@ -1503,6 +1610,9 @@ QStringList QNetworkAccessManager::supportedSchemesImplementation() const
 
     This function is useful for doing auto tests.
 
+    \note Connections in the shared connection pool are not closed while other
+    managers use the pool, see clearConnectionCache().
+
     \sa clearConnectionCache()
 */
 void QNetworkAccessManager::clearAccessCache()
@@ -1518,7 +1628,14 @@ void QNetworkAccessManager::clearAccessCache()
     In contrast to clearAccessCache() the authentication data
     is preserved.
 
-    \sa clearAccessCache()
+    \note If the manager uses the shared connection pool, the connections in
+    the pool are shared with the other managers using it and are only closed
+    once none of them uses the pool anymore. Until then, the manager's next
+    request may reuse a connection that was open before the call. Disable
+    the shared pool on all managers to make sure that new connections are
+    made.
+
+    \sa clearAccessCache(), setSharedConnectionPoolEnabled()
 */
 void QNetworkAccessManager::clearConnectionCache()
 {
@@ -1735,9 +1852,30 @@ QNetworkAccessManagerPrivate::~QNetworkAccessManagerPrivate()
     destroyThread();
 }
 
+static void quitHttpThread(QThread *thread)
+{
+    thread->quit();
+    thread->wait(5000);
+    if (thread->isFinished())
+        delete thread;
+    else
+        QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
+}
+
 QThread * QNetworkAccessManagerPrivate::createThread()
 {
-    if (!thread) {
+    if (!thread && sharedConnectionPool) {
+        QNetworkAccessSharedThread *shared = sharedHttpThread();
+        QMutexLocker locker(&shared->mutex);
+        if (!shared->thread) {
+            shared->thread = new QThread;
+            shared->thread->setObjectName(QStringLiteral("QNetworkAccessManager shared thread"));
+            shared->thread->start();
+        }
+        ++shared->ref;
+        thread = shared->thread;
+        usesSharedThread = true;
+    } else if (!thread) {
         thread = new QThread;
         thread->setObjectName(QStringLiteral("QNetworkAccessManager thread"));
         thread->start();
@@ -1748,13 +1886,19 @@ QThread * QNetworkAccessManagerPrivate::createThread()
 
 void QNetworkAccessManagerPrivate::destroyThread()
 {
-    if (thread) {
-        thread->quit();
-        thread->wait(5000);
-        if (thread->isFinished())
-            delete thread;
-        else
-            QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
+    if (thread && usesSharedThread) {
+        // only the last manager using the shared pool takes it down
+        QNetworkAccessSharedThread *shared = sharedHttpThread();
+        QMutexLocker locker(&shared->mutex);
+        Q_ASSERT(shared->thread == thread);
+        if (--shared->ref == 0) {
+            quitHttpThread(shared->thread);
+            shared->thread = 0;
+        }
+        thread = 0;
+        usesSharedThread = false;
+    } else if (thread) {
+        quitHttpThread(thread);
         thread = 0;
     }
 }
@@ -158,6 +158,12 @@ public:
     void setRedirectPolicy(QNetworkRequest::RedirectPolicy policy);
     QNetworkRequest::RedirectPolicy redirectPolicy() const;
 
+    void setMaximumConnectionsPerHost(int count);
+    int maximumConnectionsPerHost() const;
+
+    void setSharedConnectionPoolEnabled(bool enabled);
+    bool isSharedConnectionPoolEnabled() const;
+
 Q_SIGNALS:
 #ifndef QT_NO_NETWORKPROXY
     void proxyAuthenticationRequired(const QNetworkProxy &proxy, QAuthenticator *authenticator);
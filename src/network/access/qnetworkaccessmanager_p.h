@@ -78,6 +78,9 @@ public:
     QNetworkAccessManagerPrivate()
         : networkCache(0), cookieJar(0),
           thread(0),
+          connectionsPerHost(6),
+          sharedConnectionPool(false),
+          usesSharedThread(false),
 #ifndef QT_NO_NETWORKPROXY
           proxyFactory(0),
 #endif
@@ -171,6 +174,9 @@ public:
     QNetworkCookieJar *cookieJar;
 
     QThread *thread;
+    quint16 connectionsPerHost;
+    bool sharedConnectionPool;
+    bool usesSharedThread; // thread is the process-wide one, see createThread()
 
 
 #ifndef QT_NO_NETWORKPROXY
@@ -49,6 +49,11 @@
 #include <qdatastream.h>
 #include <qdatetime.h>
 #include <qdiriterator.h>
+#include <qmutex.h>
+#include <qrunnable.h>
+#include <qsavefile.h>
+#include <qset.h>
+#include <qthreadpool.h>
 #include <qurl.h>
 #include <qcryptographichash.h>
 #include <qdebug.h>
@@ -57,6 +62,7 @@
 #define PREPARED_SLASH QLatin1String("prepared/")
 #define CACHE_VERSION 8
 #define DATA_DIR QLatin1String("data")
+#define INDEX_FILE QLatin1String("index")
 
 #define MAX_COMPRESSION_SIZE (1024 * 1024 * 3)
 
@@ -77,6 +83,14 @@ QT_BEGIN_NAMESPACE
     Currently you cannot share the same cache files with more than
     one disk cache.
 
+    Since Qt 5.10 QNetworkDiskCache keeps an index of the cached files
+    together with their size and the time they were last used. The index
+    is stored next to the cache files and updated as items are inserted,
+    used and removed, so that looking up urls which are not in the cache
+    and deciding which items to expire never requires scanning the cache
+    directory. Files expired while inserting a new item are deleted in
+    the background.
+
     QNetworkDiskCache by default limits the amount of space that the cache will
     use on the system to 50MB.
 
@@ -150,6 +164,7 @@ void QNetworkDiskCache::setCacheDirectory(const QString &cacheDir)
 
     d->dataDirectory = d->cacheDirectory + DATA_DIR + QString::number(CACHE_VERSION) + QLatin1Char('/');
     d->prepareLayout();
+    d->openIndex();
 }
 
 /*!
@@ -262,6 +277,341 @@ void QNetworkDiskCachePrivate::prepareLayout()
 }
 
 
+class QNetworkDiskCacheRemovalQueue
+{
+public:
+    QNetworkDiskCacheRemovalQueue() : running(false) {}
+
+    void removeAll();
+
+    QMutex mutex;
+    QSet<QString> fileNames;
+    bool running;
+};
+
+/*!
+    Deletes the queued files. The mutex is held while a file is being
+    deleted, so that storeItem() cannot write a new file with the same
+    name in the meantime.
+*/
+void QNetworkDiskCacheRemovalQueue::removeAll()
+{
+    QMutexLocker locker(&mutex);
+    while (!fileNames.isEmpty()) {
+        const auto it = fileNames.begin();
+        QFile::remove(*it);
+        fileNames.erase(it);
+        locker.unlock();
+        locker.relock();
+    }
+    running = false;
+}
+
+#ifndef QT_NO_THREAD
+class QNetworkDiskCacheRemover : public QRunnable
+{
+public:
+    explicit QNetworkDiskCacheRemover(const QSharedPointer<QNetworkDiskCacheRemovalQueue> &queue)
+        : queue(queue)
+    {}
+
+    void run() override
+    {
+        queue->removeAll();
+    }
+
+private:
+    QSharedPointer<QNetworkDiskCacheRemovalQueue> queue;
+};
+#endif
+
+/*!
+    Deletes \a fileNames, either right away or, if \a background is true,
+    from a thread of the global thread pool.
+*/
+void QNetworkDiskCachePrivate::removeFiles(const QStringList &fileNames, bool background)
+{
+    if (fileNames.isEmpty())
+        return;
+#ifndef QT_NO_THREAD
+    if (background) {
+        if (!removalQueue)
+            removalQueue = QSharedPointer<QNetworkDiskCacheRemovalQueue>::create();
+        QMutexLocker locker(&removalQueue->mutex);
+        for (const QString &fileName : fileNames)
+            removalQueue->fileNames.insert(fileName);
+        if (!removalQueue->running) {
+            removalQueue->running = true;
+            QThreadPool::globalInstance()->start(new QNetworkDiskCacheRemover(removalQueue));
+        }
+        return;
+    }
+#else
+    Q_UNUSED(background);
+#endif
+    for (const QString &fileName : fileNames)
+        QFile::remove(fileName);
+}
+
+/*!
+    Finishes the deletion of files that were scheduled in the background.
+*/
+void QNetworkDiskCachePrivate::flushRemovals()
+{
+    if (removalQueue)
+        removalQueue->removeAll();
+}
+
+enum
+{
+    IndexMagic = 0xe9,
+    IndexVersion = 1
+};
+
+/*!
+    Returns the index key of the cache file \a fileName, or a null string
+    if \a fileName is not inside the data directory.
+*/
+QString QNetworkDiskCachePrivate::indexKey(const QString &fileName) const
+{
+    if (dataDirectory.isEmpty() || !fileName.startsWith(dataDirectory))
+        return QString();
+    return fileName.mid(dataDirectory.length());
+}
+
+/*!
+    Loads the index of the data directory, rebuilding it from the files
+    if it is missing or damaged, and opens it for appending.
+*/
+void QNetworkDiskCachePrivate::openIndex()
+{
+    indexFile.reset();
+    metaDataCache.clear();
+    if (!loadIndex()) {
+        rebuildIndex();
+        writeIndex();
+    } else if (indexRecords > 2 * index.size() + 1024) {
+        writeIndex();
+    } else {
+        QScopedPointer<QFile> journal(new QFile(dataDirectory + INDEX_FILE));
+        if (journal->open(QIODevice::WriteOnly | QIODevice::Append))
+            indexFile.swap(journal);
+    }
+    currentCacheSize = indexSize;
+
+    // files of items that were never inserted, e.g. because of a crash
+    QDirIterator it(cacheDirectory + PREPARED_SLASH, QDir::Files);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (!path.endsWith(CACHE_POSTFIX))
+            continue;
+        bool prepared = false;
+        for (QCacheItem *item : qAsConst(inserting)) {
+            if (item && item->file && item->file->fileName() == path) {
+                prepared = true;
+                break;
+            }
+        }
+        if (!prepared)
+            QFile::remove(path);
+    }
+}
+
+/*!
+    Replays the journal in the index file. Returns \c false if there is
+    no index or if it is incomplete.
+*/
+bool QNetworkDiskCachePrivate::loadIndex()
+{
+    index.clear();
+    accessOrder.clear();
+    indexSize = 0;
+    indexRecords = 0;
+
+    QFile file(dataDirectory + INDEX_FILE);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    qint32 marker;
+    qint32 version;
+    in >> marker >> version;
+    if (in.status() != QDataStream::Ok || marker != IndexMagic || version != IndexVersion)
+        return false;
+
+    while (!in.atEnd()) {
+        quint8 type;
+        QString key;
+        IndexEntry entry = { 0, 0, 0 };
+        in >> type >> key;
+        if (type == IndexInsert)
+            in >> entry.size >> entry.lastAccess >> entry.expirationDate;
+        else if (type == IndexTouch)
+            in >> entry.lastAccess;
+        else if (type != IndexRemove)
+            return false;
+        // a record was only partially written
+        if (in.status() != QDataStream::Ok)
+            return false;
+
+        switch (type) {
+        case IndexInsert:
+            insertIndexEntry(key, entry);
+            break;
+        case IndexTouch: {
+            const auto it = index.constFind(key);
+            if (it != index.cend()) {
+                IndexEntry touched = it.value();
+                touched.lastAccess = entry.lastAccess;
+                insertIndexEntry(key, touched);
+            }
+            break;
+        }
+        case IndexRemove:
+            takeIndexEntry(key);
+            break;
+        }
+        ++indexRecords;
+    }
+    return true;
+}
+
+/*!
+    Recreates the index from the files in the data directory. Only the
+    file system entries are looked at, the files are not opened.
+*/
+void QNetworkDiskCachePrivate::rebuildIndex()
+{
+    index.clear();
+    accessOrder.clear();
+    indexSize = 0;
+    indexRecords = 0;
+
+    QDirIterator it(dataDirectory, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (!path.endsWith(CACHE_POSTFIX))
+            continue;
+        const QFileInfo info = it.fileInfo();
+        const IndexEntry entry = { info.size(), info.lastModified().toMSecsSinceEpoch(), 0 };
+        insertIndexEntry(indexKey(path), entry);
+    }
+}
+
+/*!
+    Writes the whole index to a new index file, replacing the journal,
+    and opens it for appending.
+*/
+void QNetworkDiskCachePrivate::writeIndex()
+{
+    indexFile.reset();
+
+    const QString fileName = dataDirectory + INDEX_FILE;
+    QSaveFile file(fileName);
+    if (file.open(QIODevice::WriteOnly)) {
+        QDataStream out(&file);
+        out.setVersion(QDataStream::Qt_5_0);
+        out << qint32(IndexMagic) << qint32(IndexVersion);
+        for (auto it = accessOrder.cbegin(), end = accessOrder.cend(); it != end; ++it) {
+            const IndexEntry &entry = index[it.value()];
+            out << quint8(IndexInsert) << it.value()
+                << entry.size << entry.lastAccess << entry.expirationDate;
+        }
+        if (!file.commit())
+            qWarning() << "QNetworkDiskCache: couldn't write the cache index" << fileName;
+    }
+    indexRecords = index.size();
+
+    QScopedPointer<QFile> journal(new QFile(fileName));
+    if (journal->open(QIODevice::WriteOnly | QIODevice::Append))
+        indexFile.swap(journal);
+}
+
+/*!
+    Appends a record for a change of the index to the index file.
+    Insertions and removals are written right away, updates of the access
+    time are buffered.
+*/
+void QNetworkDiskCachePrivate::writeIndexRecord(IndexRecordType type, const QString &key,
+                                                const IndexEntry &entry)
+{
+    if (!indexFile)
+        return;
+    QDataStream out(indexFile.data());
+    out.setVersion(QDataStream::Qt_5_0);
+    out << quint8(type) << key;
+    if (type == IndexInsert)
+        out << entry.size << entry.lastAccess << entry.expirationDate;
+    else if (type == IndexTouch)
+        out << entry.lastAccess;
+    if (type != IndexTouch)
+        indexFile->flush();
+
+    if (++indexRecords > 4 * index.size() + 4096)
+        writeIndex();
+}
+
+void QNetworkDiskCachePrivate::insertIndexEntry(const QString &key, const IndexEntry &entry)
+{
+    takeIndexEntry(key);
+    index.insert(key, entry);
+    accessOrder.insert(entry.lastAccess, key);
+    indexSize += entry.size;
+    lastAccessStamp = qMax(lastAccessStamp, entry.lastAccess);
+}
+
+bool QNetworkDiskCachePrivate::takeIndexEntry(const QString &key)
+{
+    const auto it = index.find(key);
+    if (it == index.end())
+        return false;
+    accessOrder.remove(it->lastAccess, key);
+    indexSize -= it->size;
+    index.erase(it);
+    return true;
+}
+
+/*!
+    Returns the current time, made unique so that the access order of
+    items used within the same millisecond is kept.
+*/
+qint64 QNetworkDiskCachePrivate::accessStamp()
+{
+    lastAccessStamp = qMax(QDateTime::currentMSecsSinceEpoch(), lastAccessStamp + 1);
+    return lastAccessStamp;
+}
+
+void QNetworkDiskCachePrivate::addToIndex(const QString &key, qint64 size,
+                                          const QNetworkCacheMetaData &metaData)
+{
+    const QDateTime expirationDate = metaData.expirationDate();
+    const IndexEntry entry = { size, accessStamp(),
+                               expirationDate.isValid() ? expirationDate.toMSecsSinceEpoch() : 0 };
+    insertIndexEntry(key, entry);
+    writeIndexRecord(IndexInsert, key, entry);
+}
+
+void QNetworkDiskCachePrivate::touch(const QString &key)
+{
+    const auto it = index.constFind(key);
+    if (it == index.cend())
+        return;
+    IndexEntry entry = it.value();
+    entry.lastAccess = accessStamp();
+    insertIndexEntry(key, entry);
+    writeIndexRecord(IndexTouch, key, entry);
+}
+
+void QNetworkDiskCachePrivate::removeFromIndex(const QString &key)
+{
+    metaDataCache.remove(key);
+    if (takeIndexEntry(key)) {
+        const IndexEntry entry = { 0, 0, 0 };
+        writeIndexRecord(IndexRemove, key, entry);
+    }
+}
+
 void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
 {
     Q_Q(QNetworkDiskCache);
@@ -269,17 +619,25 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
 
     QString fileName = cacheFileName(cacheItem->metaData.url());
     Q_ASSERT(!fileName.isEmpty());
+    const QString key = indexKey(fileName);
 
+    if (removalQueue) {
+        QMutexLocker locker(&removalQueue->mutex);
+        removalQueue->fileNames.remove(fileName);
+    }
     if (QFile::exists(fileName)) {
         if (!QFile::remove(fileName)) {
             qWarning() << "QNetworkDiskCache: couldn't remove the cache file " << fileName;
             return;
         }
     }
+    removeFromIndex(key);
 
     if (currentCacheSize > 0)
         currentCacheSize += 1024 + cacheItem->size();
+    expireInBackground = true;
     currentCacheSize = q->expire();
+    expireInBackground = false;
     if (!cacheItem->file) {
         QString templateName = tmpCacheFileName();
         cacheItem->file = new QTemporaryFile(templateName, &cacheItem->data);
@@ -294,11 +652,15 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
         && cacheItem->file->error() == QFile::NoError) {
         cacheItem->file->setAutoRemove(false);
         // ### use atomic rename rather then remove & rename
-        if (cacheItem->file->rename(fileName))
-            currentCacheSize += cacheItem->file->size();
-        else
+        if (cacheItem->file->rename(fileName)) {
+            addToIndex(key, cacheItem->file->size(), cacheItem->metaData);
+            metaDataCache.insert(key, new QNetworkCacheMetaData(cacheItem->metaData));
+        } else {
             cacheItem->file->setAutoRemove(true);
+        }
     }
+    // drop the space reserved for expire()
+    currentCacheSize = indexSize;
     if (cacheItem->metaData.url() == lastItem.metaData.url())
         lastItem.reset();
 }
@@ -345,6 +707,7 @@ bool QNetworkDiskCachePrivate::removeFile(const QString &file)
     qint64 size = info.size();
     if (QFile::remove(file)) {
         currentCacheSize -= size;
+        removeFromIndex(indexKey(file));
         return true;
     }
     return false;
@@ -361,7 +724,25 @@ QNetworkCacheMetaData QNetworkDiskCache::metaData(const QUrl &url)
     Q_D(QNetworkDiskCache);
     if (d->lastItem.metaData.url() == url)
         return d->lastItem.metaData;
-    return fileMetaData(d->cacheFileName(url));
+    if (!url.isValid())
+        return QNetworkCacheMetaData();
+
+    const QString key = d->uniqueFileName(url);
+    if (!d->isIndexed(key))
+        return QNetworkCacheMetaData();
+    if (const QNetworkCacheMetaData *metaData = d->metaDataCache.object(key)) {
+        d->touch(key);
+        return *metaData;
+    }
+
+    const QNetworkCacheMetaData metaData = fileMetaData(d->cacheFileName(url));
+    if (metaData.isValid()) {
+        d->touch(key);
+        d->metaDataCache.insert(key, new QNetworkCacheMetaData(metaData));
+    } else {
+        d->removeFromIndex(key);
+    }
+    return metaData;
 }
 
 /*!
@@ -402,9 +783,15 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
         buffer.reset(new QBuffer);
         buffer->setData(d->lastItem.data.data());
     } else {
+        const QString key = d->uniqueFileName(url);
+        if (!d->isIndexed(key))
+            return 0;
         QScopedPointer<QFile> file(new QFile(d->cacheFileName(url)));
-        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered))
+        if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered)) {
+            d->removeFromIndex(key);
             return 0;
+        }
+        d->touch(key);
 
         if (!d->lastItem.read(file.data(), true)) {
             file->close();
@@ -501,8 +888,8 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
 
     When the current size of the cache is greater than the maximumCacheSize()
     older cache files are removed until the total size is less then 90% of
-    maximumCacheSize() starting with the oldest ones first using the file
-    creation date to determine how old a cache file is.
+    maximumCacheSize(). Files of items that have expired are removed first,
+    then the least recently used ones, as recorded in the cache index.
 
     Subclasses can reimplement this function to change the order that cache
     files are removed taking into account information in the application
@@ -516,6 +903,8 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
 qint64 QNetworkDiskCache::expire()
 {
     Q_D(QNetworkDiskCache);
+    if (!d->expireInBackground)
+        d->flushRemovals();
     if (d->currentCacheSize >= 0 && d->currentCacheSize < maximumCacheSize())
         return d->currentCacheSize;
 
@@ -527,54 +916,42 @@ qint64 QNetworkDiskCache::expire()
     // close file handle to prevent "in use" error when QFile::remove() is called
     d->lastItem.reset();
 
-    QDir::Filters filters = QDir::AllDirs | QDir:: Files | QDir::NoDotAndDotDot;
-    QDirIterator it(cacheDirectory(), filters, QDirIterator::Subdirectories);
-
-    QMultiMap<QDateTime, QString> cacheItems;
-    qint64 totalSize = 0;
-    while (it.hasNext()) {
-        QString path = it.next();
-        QFileInfo info = it.fileInfo();
-        QString fileName = info.fileName();
-        if (fileName.endsWith(CACHE_POSTFIX)) {
-            cacheItems.insert(info.created(), path);
-            totalSize += info.size();
+    const qint64 goal = (maximumCacheSize() * 9) / 10;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 totalSize = d->indexSize;
+    QStringList victims;
+    for (auto it = d->accessOrder.cbegin(), end = d->accessOrder.cend();
+         it != end && totalSize >= goal; ++it) {
+        const QNetworkDiskCachePrivate::IndexEntry &entry = d->index[it.value()];
+        if (entry.expirationDate && entry.expirationDate < now) {
+            victims.append(it.value());
+            totalSize -= entry.size;
         }
     }
-
-    int removedFiles = 0;
-    qint64 goal = (maximumCacheSize() * 9) / 10;
-    QMultiMap<QDateTime, QString>::const_iterator i = cacheItems.constBegin();
-    while (i != cacheItems.constEnd()) {
-        if (totalSize < goal)
-            break;
-        QString name = i.value();
-        QFile file(name);
-
-        if (name.contains(PREPARED_SLASH)) {
-            for (QCacheItem *item : qAsConst(d->inserting)) {
-                if (item && item->file && item->file->fileName() == name) {
-                    delete item->file;
-                    item->file = 0;
-                    break;
-                }
-            }
+    for (auto it = d->accessOrder.cbegin(), end = d->accessOrder.cend();
+         it != end && totalSize >= goal; ++it) {
+        const QNetworkDiskCachePrivate::IndexEntry &entry = d->index[it.value()];
+        if (!entry.expirationDate || entry.expirationDate >= now) {
+            victims.append(it.value());
+            totalSize -= entry.size;
         }
+    }
 
-        qint64 size = file.size();
-        file.remove();
-        totalSize -= size;
-        ++removedFiles;
-        ++i;
+    QStringList fileNames;
+    fileNames.reserve(victims.count());
+    for (const QString &key : qAsConst(victims)) {
+        d->removeFromIndex(key);
+        fileNames.append(d->dataDirectory + key);
     }
+    d->removeFiles(fileNames, d->expireInBackground);
 #if defined(QNETWORKDISKCACHE_DEBUG)
-    if (removedFiles > 0) {
+    if (!fileNames.isEmpty()) {
         qDebug() << "QNetworkDiskCache::expire()"
-                << "Removed:" << removedFiles
-                << "Kept:" << cacheItems.count() - removedFiles;
+                << "Removed:" << fileNames.count()
+                << "Kept:" << d->index.count();
     }
 #endif
-    return totalSize;
+    return d->indexSize;
 }
 
 /*!
@@ -55,7 +55,10 @@
 #include "private/qabstractnetworkcache_p.h"
 
 #include <qbuffer.h>
+#include <qcache.h>
 #include <qhash.h>
+#include <qmap.h>
+#include <qsharedpointer.h>
 #include <qtemporaryfile.h>
 
 QT_REQUIRE_CONFIG(networkdiskcache);
@@ -94,6 +97,8 @@ public:
     bool canCompress() const;
 };
 
+class QNetworkDiskCacheRemovalQueue;
+
 class QNetworkDiskCachePrivate : public QAbstractNetworkCachePrivate
 {
 public:
@@ -101,6 +106,11 @@ public:
         : QAbstractNetworkCachePrivate()
         , maximumCacheSize(1024 * 1024 * 50)
         , currentCacheSize(-1)
+        , indexSize(0)
+        , indexRecords(0)
+        , lastAccessStamp(0)
+        , expireInBackground(false)
+        , metaDataCache(1024)
         {}
 
     static QString uniqueFileName(const QUrl &url);
@@ -111,12 +121,55 @@ public:
     void prepareLayout();
     static quint32 crc32(const char *data, uint len);
 
+    // The index: one entry per cache file in dataDirectory, keyed by the
+    // file name relative to it (see uniqueFileName()). It is persisted as
+    // a journal of changes, so that it never has to be rebuilt from the
+    // files themselves, which is slow for large caches.
+    struct IndexEntry
+    {
+        qint64 size;
+        qint64 lastAccess;      // ms since epoch
+        qint64 expirationDate;  // ms since epoch, 0 if unknown
+    };
+    enum IndexRecordType {
+        IndexInsert,
+        IndexTouch,
+        IndexRemove
+    };
+
+    QString indexKey(const QString &fileName) const;
+    bool isIndexed(const QString &key) const
+        { return cacheDirectory.isEmpty() || index.contains(key); }
+    void openIndex();
+    bool loadIndex();
+    void rebuildIndex();
+    void writeIndex();
+    void writeIndexRecord(IndexRecordType type, const QString &key, const IndexEntry &entry);
+    void insertIndexEntry(const QString &key, const IndexEntry &entry);
+    bool takeIndexEntry(const QString &key);
+    qint64 accessStamp();
+    void addToIndex(const QString &key, qint64 size, const QNetworkCacheMetaData &metaData);
+    void touch(const QString &key);
+    void removeFromIndex(const QString &key);
+    void removeFiles(const QStringList &fileNames, bool background);
+    void flushRemovals();
+
     mutable QCacheItem lastItem;
     QString cacheDirectory;
     QString dataDirectory;
     qint64 maximumCacheSize;
     qint64 currentCacheSize;
 
+    QHash<QString, IndexEntry> index;
+    QMultiMap<qint64, QString> accessOrder; // least recently used first
+    QScopedPointer<QFile> indexFile;
+    qint64 indexSize;
+    int indexRecords;
+    qint64 lastAccessStamp;
+    bool expireInBackground;
+    QCache<QString, QNetworkCacheMetaData> metaDataCache;
+    QSharedPointer<QNetworkDiskCacheRemovalQueue> removalQueue;
+
     QHash<QIODevice*, QCacheItem*> inserting;
     Q_DECLARE_PUBLIC(QNetworkDiskCache)
 };
@@ -298,6 +298,14 @@ QT_BEGIN_NAMESPACE
         This attribute obsoletes FollowRedirectsAttribute.
         (This value was introduced in 5.9.)
 
+    \value ConnectionWasReusedAttribute
+        Replies only, type: QMetaType::Bool (default: false)
+        Indicates whether the request was sent over an HTTP/1.x connection
+        that was already established, i.e. whether it saved the TCP and
+        TLS handshakes. Counting the replies with and without this
+        attribute measures how well idle connections are reused.
+        (This value was introduced in 5.10.)
+
     \value User
         Special type. Additional information can be passed in
         QVariants with types ranging from User to UserMax. The default
@@ -92,6 +92,7 @@ public:
         HTTP2WasUsedAttribute,
         OriginalContentLengthAttribute,
         RedirectPolicyAttribute,
+        ConnectionWasReusedAttribute,
 
         User = 1000,
         UserMax = 32767
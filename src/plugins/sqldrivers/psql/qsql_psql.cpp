@@ -50,6 +50,7 @@
 #include <qsqlquery.h>
 #include <qsocketnotifier.h>
 #include <qstringlist.h>
+#include <qqueue.h>
 #include <qlocale.h>
 #include <QtSql/private/qsqlresult_p.h>
 #include <QtSql/private/qsqldriver_p.h>
@@ -107,6 +108,11 @@
 
 #define VARHDRSZ 4
 
+// PQsetSingleRowMode() and PGRES_SINGLE_TUPLE were added in libpq 9.2
+#if defined PG_VERSION_NUM && PG_VERSION_NUM-0 >= 90200
+#define QPSQL_SINGLE_ROW_MODE
+#endif
+
 /* This is a compile time switch - if PQfreemem is declared, the compiler will use that one,
    otherwise it'll run in this template */
 template <typename T>
@@ -143,6 +149,7 @@ protected:
     bool fetch(int i) Q_DECL_OVERRIDE;
     bool fetchFirst() Q_DECL_OVERRIDE;
     bool fetchLast() Q_DECL_OVERRIDE;
+    bool fetchNext() Q_DECL_OVERRIDE;
     QVariant data(int i) Q_DECL_OVERRIDE;
     bool isNull(int field) Q_DECL_OVERRIDE;
     bool reset (const QString &query) Q_DECL_OVERRIDE;
@@ -164,9 +171,19 @@ public:
         pro(QPSQLDriver::Version6),
         sn(0),
         pendingNotifyCheck(false),
-        hasBackslashEscape(false)
+        hasBackslashEscape(false),
+        currentStmtId(InvalidStatementId),
+        stmtCount(InvalidStatementId)
+#ifndef QT_NO_QFUTURE
+        , asyncResult(0)
+#endif
     { dbmsType = QSqlDriver::PostgreSQL; }
 
+    // Identifies a statement sent with sendQuery() whose results are
+    // still being read from the connection.
+    typedef uint StatementId;
+    enum { InvalidStatementId = 0 };
+
     PGconn *connection;
     bool isUtf8;
     QPSQLDriver::Protocol pro;
@@ -174,10 +191,38 @@ public:
     QStringList seid;
     mutable bool pendingNotifyCheck;
     bool hasBackslashEscape;
+    mutable StatementId currentStmtId;
+    mutable StatementId stmtCount;
+#ifndef QT_NO_QFUTURE
+    // Queries started with QSqlQuery::execAsync(). The first one has been
+    // sent, the others wait for it to finish.
+    struct AsyncQuery {
+        QPSQLResultPrivate *result;
+        QString stmt;
+        QFutureInterface<bool> future;
+    };
+    mutable QQueue<AsyncQuery> asyncQueries;
+    // the result of the query that was sent, read so far
+    mutable PGresult *asyncResult;
+#endif
 
     void appendTables(QStringList &tl, QSqlQuery &t, QChar type);
     PGresult * exec(const char * stmt) const;
     PGresult * exec(const QString & stmt) const;
+    StatementId sendQuery(const QString &stmt);
+    StatementId sendStatement(const QString &stmt) const;
+    bool setSingleRowMode() const;
+    PGresult *getResult(StatementId stmtId) const;
+    void finishQuery(StatementId stmtId) const;
+    void checkPendingNotifications() const;
+#ifndef QT_NO_QFUTURE
+    void enqueueAsyncQuery(QPSQLResultPrivate *result, const QString &stmt,
+                           const QFutureInterface<bool> &future);
+    void sendNextAsyncQuery() const;
+    void processAsyncQueries(bool wait) const;
+    void cancelAsyncQueries(const QPSQLResultPrivate *result) const;
+#endif
+    void finishAsyncQueries() const;
     QPSQLDriver::Protocol getPSQLVersion();
     bool setEncodingUtf8();
     void setDatestyle();
@@ -209,14 +254,23 @@ void QPSQLDriverPrivate::appendTables(QStringList &tl, QSqlQuery &t, QChar type)
     }
 }
 
-PGresult * QPSQLDriverPrivate::exec(const char * stmt) const
+void QPSQLDriverPrivate::checkPendingNotifications() const
 {
     Q_Q(const QPSQLDriver);
-    PGresult *result = PQexec(connection, stmt);
     if (seid.size() && !pendingNotifyCheck) {
         pendingNotifyCheck = true;
         QMetaObject::invokeMethod(const_cast<QPSQLDriver*>(q), "_q_handleNotification", Qt::QueuedConnection, Q_ARG(int,0));
     }
+}
+
+PGresult * QPSQLDriverPrivate::exec(const char * stmt) const
+{
+    // The connection can only run one statement at a time, so the rows
+    // of a forward-only query that were not fetched yet are lost.
+    finishAsyncQueries();
+    finishQuery(currentStmtId);
+    PGresult *result = PQexec(connection, stmt);
+    checkPendingNotifications();
     return result;
 }
 
@@ -225,6 +279,79 @@ PGresult * QPSQLDriverPrivate::exec(const QString & stmt) const
     return exec(isUtf8 ? stmt.toUtf8().constData() : stmt.toLocal8Bit().constData());
 }
 
+/*
+    Sends \a stmt without waiting for its results, which are then read
+    with getResult(). Returns InvalidStatementId if sending failed.
+*/
+QPSQLDriverPrivate::StatementId QPSQLDriverPrivate::sendQuery(const QString &stmt)
+{
+    finishAsyncQueries();
+    finishQuery(currentStmtId);
+    return sendStatement(stmt);
+}
+
+QPSQLDriverPrivate::StatementId QPSQLDriverPrivate::sendStatement(const QString &stmt) const
+{
+    const int sent = PQsendQuery(connection, isUtf8 ? stmt.toUtf8().constData()
+                                                    : stmt.toLocal8Bit().constData());
+    if (!sent)
+        return InvalidStatementId;
+    if (++stmtCount == InvalidStatementId)
+        ++stmtCount;
+    currentStmtId = stmtCount;
+    return currentStmtId;
+}
+
+/*
+    Makes libpq return the rows of the statement that was just sent one
+    at a time, instead of collecting all of them in memory first.
+*/
+bool QPSQLDriverPrivate::setSingleRowMode() const
+{
+#ifdef QPSQL_SINGLE_ROW_MODE
+    return PQsetSingleRowMode(connection) == 1;
+#else
+    return false;
+#endif
+}
+
+PGresult *QPSQLDriverPrivate::getResult(StatementId stmtId) const
+{
+    if (stmtId != currentStmtId) {
+        qWarning("QPSQLDriver::getResult: Query results lost - "
+                 "probably discarded on executing another SQL query.");
+        return 0;
+    }
+    PGresult *result = PQgetResult(connection);
+    checkPendingNotifications();
+    return result;
+}
+
+/*
+    Reads and discards the remaining results of \a stmtId, so that the
+    connection can be used for the next statement.
+*/
+void QPSQLDriverPrivate::finishQuery(StatementId stmtId) const
+{
+    if (stmtId == InvalidStatementId || stmtId != currentStmtId)
+        return;
+    while (PGresult *result = PQgetResult(connection))
+        PQclear(result);
+    currentStmtId = InvalidStatementId;
+}
+
+/*
+    Waits for the queries started with QSqlQuery::execAsync() to finish,
+    so that the connection can be used synchronously.
+*/
+void QPSQLDriverPrivate::finishAsyncQueries() const
+{
+#ifndef QT_NO_QFUTURE
+    if (!asyncQueries.isEmpty())
+        processAsyncQueries(true);
+#endif
+}
+
 class QPSQLResultPrivate : public QSqlResultPrivate
 {
     Q_DECLARE_PUBLIC(QPSQLResult)
@@ -234,17 +361,30 @@ public:
       : QSqlResultPrivate(q, drv),
         result(0),
         currentSize(-1),
+        stmtId(QPSQLDriverPrivate::InvalidStatementId),
+        singleRowMode(false),
         preparedQueriesEnabled(false)
     { }
 
     QString fieldSerial(int i) const Q_DECL_OVERRIDE { return QLatin1Char('$') + QString::number(i + 1); }
     void deallocatePreparedStmt();
+    void finishQuery();
+    QString executeStatement() const;
+#ifndef QT_NO_QFUTURE
+    void execAsync(const QSqlQuery &query, const QString *statement,
+                   const QFutureInterface<bool> &future) Q_DECL_OVERRIDE;
+    void finishAsyncQuery(PGresult *res, QFutureInterface<bool> &future);
+#endif
 
     PGresult *result;
     int currentSize;
+    // set while the rows of a forward-only query are read one at a time
+    QPSQLDriverPrivate::StatementId stmtId;
+    bool singleRowMode;
     bool preparedQueriesEnabled;
     QString preparedStmtId;
 
+    bool execute(const QString &stmt);
     bool processResults();
 };
 
@@ -261,29 +401,198 @@ static QSqlError qMakeError(const QString& err, QSqlError::ErrorType type,
     return QSqlError(QLatin1String("QPSQL: ") + err, msg, type, errorCode);
 }
 
+/*
+    Runs \a stmt. The rows of forward-only queries are not read up front
+    but fetched from the server one by one by fetchNext(), so that the
+    memory use does not depend on the size of the result set.
+*/
+bool QPSQLResultPrivate::execute(const QString &stmt)
+{
+    Q_Q(QPSQLResult);
+    QPSQLDriverPrivate *drv = drv_d_func();
+    if (!q->isForwardOnly()) {
+        result = drv->exec(stmt);
+        return processResults();
+    }
+
+    stmtId = drv->sendQuery(stmt);
+    if (stmtId == QPSQLDriverPrivate::InvalidStatementId) {
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                        "Unable to send query"), QSqlError::StatementError, drv));
+        return false;
+    }
+    // without single row mode the whole result set arrives at once
+    drv->setSingleRowMode();
+    result = drv->getResult(stmtId);
+    return processResults();
+}
+
+void QPSQLResultPrivate::finishQuery()
+{
+    if (stmtId == QPSQLDriverPrivate::InvalidStatementId)
+        return;
+    if (const QPSQLDriverPrivate *drv = drv_d_func())
+        drv->finishQuery(stmtId);
+    stmtId = QPSQLDriverPrivate::InvalidStatementId;
+}
+
 bool QPSQLResultPrivate::processResults()
 {
     Q_Q(QPSQLResult);
-    if (!result)
+    if (!result) {
+        finishQuery();
         return false;
+    }
 
     int status = PQresultStatus(result);
+#ifdef QPSQL_SINGLE_ROW_MODE
+    if (status == PGRES_SINGLE_TUPLE) {
+        q->setSelect(true);
+        q->setActive(true);
+        currentSize = -1;
+        singleRowMode = true;
+        return true;
+    }
+#endif
     if (status == PGRES_TUPLES_OK) {
         q->setSelect(true);
         q->setActive(true);
         currentSize = PQntuples(result);
+        finishQuery();
         return true;
     } else if (status == PGRES_COMMAND_OK) {
         q->setSelect(false);
         q->setActive(true);
         currentSize = -1;
+        finishQuery();
         return true;
     }
     q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
                     "Unable to create query"), QSqlError::StatementError, drv_d_func(), result));
+    finishQuery();
     return false;
 }
 
+#ifndef QT_NO_QFUTURE
+/*
+    Sends the query to the server and returns, the results are read by
+    processAsyncQueries() when the socket notifier reports them.
+*/
+void QPSQLResultPrivate::execAsync(const QSqlQuery &query, const QString *statement,
+                                   const QFutureInterface<bool> &future)
+{
+    Q_Q(QPSQLResult);
+    // the bound values are substituted by QSqlResult::exec()
+    if (!statement && !preparedQueriesEnabled) {
+        QSqlResultPrivate::execAsync(query, statement, future);
+        return;
+    }
+
+    q->cleanup();
+    QPSQLDriverPrivate *drv = drv_d_func();
+    if (!drv || !q->driver()->isOpen() || q->driver()->isOpenError()) {
+        QFutureInterface<bool> f(future);
+        const bool ok = false;
+        f.reportFinished(&ok);
+        return;
+    }
+    drv->enqueueAsyncQuery(this, statement ? *statement : executeStatement(), future);
+}
+
+void QPSQLResultPrivate::finishAsyncQuery(PGresult *res, QFutureInterface<bool> &future)
+{
+    Q_Q(QPSQLResult);
+    result = res;
+    bool ok = false;
+    if (result) {
+        ok = processResults();
+    } else {
+        q->setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                        "Unable to send query"), QSqlError::StatementError, drv_d_func()));
+    }
+    future.reportFinished(&ok);
+}
+
+void QPSQLDriverPrivate::enqueueAsyncQuery(QPSQLResultPrivate *result, const QString &stmt,
+                                           const QFutureInterface<bool> &future)
+{
+    Q_Q(QPSQLDriver);
+    const AsyncQuery query = { result, stmt, future };
+    asyncQueries.enqueue(query);
+    if (!sn) {
+        sn = new QSocketNotifier(PQsocket(connection), QSocketNotifier::Read);
+        QObject::connect(sn, SIGNAL(activated(int)), q, SLOT(_q_handleNotification(int)));
+    }
+    if (asyncQueries.size() == 1) {
+        finishQuery(currentStmtId);
+        sendNextAsyncQuery();
+    }
+}
+
+void QPSQLDriverPrivate::sendNextAsyncQuery() const
+{
+    while (!asyncQueries.isEmpty()) {
+        if (sendStatement(asyncQueries.head().stmt) != InvalidStatementId)
+            return;
+        AsyncQuery query = asyncQueries.dequeue();
+        if (query.result)
+            query.result->finishAsyncQuery(0, query.future);
+    }
+}
+
+/*
+    Reads the results of the query that was sent, and sends the next one
+    once they are complete. Unless \a wait is true, only the input that
+    was already received is used.
+*/
+void QPSQLDriverPrivate::processAsyncQueries(bool wait) const
+{
+    while (!asyncQueries.isEmpty()) {
+        if (!wait && PQisBusy(connection))
+            return;
+        // like PQexec(), keep the last result unless there was an error
+        if (PGresult *result = PQgetResult(connection)) {
+            if (asyncResult && PQresultStatus(asyncResult) == PGRES_FATAL_ERROR) {
+                PQclear(result);
+            } else {
+                PQclear(asyncResult);
+                asyncResult = result;
+            }
+            continue;
+        }
+
+        AsyncQuery query = asyncQueries.dequeue();
+        PGresult *result = asyncResult;
+        asyncResult = 0;
+        currentStmtId = InvalidStatementId;
+        if (query.result)
+            query.result->finishAsyncQuery(result, query.future);
+        else
+            PQclear(result);
+        sendNextAsyncQuery();
+    }
+}
+
+/*
+    Drops the queries of \a result that were not sent yet. The results of
+    the one that was sent are still read, but discarded.
+*/
+void QPSQLDriverPrivate::cancelAsyncQueries(const QPSQLResultPrivate *result) const
+{
+    for (int i = 0; i < asyncQueries.size(); ++i) {
+        AsyncQuery &query = asyncQueries[i];
+        if (query.result != result)
+            continue;
+        const bool ok = false;
+        query.future.reportFinished(&ok);
+        if (i == 0)
+            query.result = 0;
+        else
+            asyncQueries.removeAt(i--);
+    }
+}
+#endif
+
 static QVariant::Type qDecodePSQLType(int t)
 {
     QVariant::Type type = QVariant::Invalid;
@@ -366,9 +675,15 @@ QVariant QPSQLResult::handle() const
 void QPSQLResult::cleanup()
 {
     Q_D(QPSQLResult);
+#ifndef QT_NO_QFUTURE
+    if (const QPSQLDriverPrivate *drv = d->drv_d_func())
+        drv->cancelAsyncQueries(d);
+#endif
     if (d->result)
         PQclear(d->result);
     d->result = 0;
+    d->finishQuery();
+    d->singleRowMode = false;
     setAt(QSql::BeforeFirstRow);
     d->currentSize = -1;
     setActive(false);
@@ -381,10 +696,20 @@ bool QPSQLResult::fetch(int i)
         return false;
     if (i < 0)
         return false;
-    if (i >= d->currentSize)
-        return false;
     if (at() == i)
         return true;
+    if (d->singleRowMode) {
+        // rows that were already fetched are gone
+        if (i < at())
+            return false;
+        while (at() < i) {
+            if (!fetchNext())
+                return false;
+        }
+        return true;
+    }
+    if (i >= d->currentSize)
+        return false;
     setAt(i);
     return true;
 }
@@ -397,9 +722,62 @@ bool QPSQLResult::fetchFirst()
 bool QPSQLResult::fetchLast()
 {
     Q_D(const QPSQLResult);
+    if (d->singleRowMode) {
+        // the last row is only known once all rows were fetched
+        if (!isActive() || at() == QSql::AfterLastRow)
+            return false;
+        while (fetchNext()) { }
+        return at() >= 0;
+    }
     return fetch(PQntuples(d->result) - 1);
 }
 
+bool QPSQLResult::fetchNext()
+{
+    Q_D(QPSQLResult);
+    if (!d->singleRowMode)
+        return fetch(at() + 1);
+    if (!isActive())
+        return false;
+
+    // the first row was fetched by exec()
+    if (at() == QSql::BeforeFirstRow) {
+        setAt(0);
+        return true;
+    }
+    if (d->stmtId == QPSQLDriverPrivate::InvalidStatementId)
+        return false;
+
+    PGresult *result = d->drv_d_func()->getResult(d->stmtId);
+    if (!result) {
+        setLastError(QSqlError(QLatin1String("QPSQL: ") + QCoreApplication::translate("QPSQLResult",
+                               "Unable to get result"),
+                               QCoreApplication::translate("QPSQLResult",
+                               "Query results lost - probably discarded on executing another SQL query."),
+                               QSqlError::StatementError));
+        d->stmtId = QPSQLDriverPrivate::InvalidStatementId;
+        return false;
+    }
+
+    switch (PQresultStatus(result)) {
+    case PGRES_SINGLE_TUPLE:
+        PQclear(d->result);
+        d->result = result;
+        setAt(at() + 1);
+        return true;
+    case PGRES_TUPLES_OK:
+        // all rows were fetched, keep the last one
+        break;
+    default:
+        setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
+                                "Unable to get result"), QSqlError::StatementError, d->drv_d_func(), result));
+        break;
+    }
+    PQclear(result);
+    d->finishQuery();
+    return false;
+}
+
 QVariant QPSQLResult::data(int i)
 {
     Q_D(const QPSQLResult);
@@ -407,10 +785,11 @@ QVariant QPSQLResult::data(int i)
         qWarning("QPSQLResult::data: column %d out of range", i);
         return QVariant();
     }
+    const int currentRow = d->singleRowMode ? 0 : at();
     int ptype = PQftype(d->result, i);
     QVariant::Type type = qDecodePSQLType(ptype);
-    const char *val = PQgetvalue(d->result, at(), i);
-    if (PQgetisnull(d->result, at(), i))
+    const char *val = PQgetvalue(d->result, currentRow, i);
+    if (PQgetisnull(d->result, currentRow, i))
         return QVariant(type);
     switch (type) {
     case QVariant::Bool:
@@ -495,8 +874,9 @@ QVariant QPSQLResult::data(int i)
 bool QPSQLResult::isNull(int field)
 {
     Q_D(const QPSQLResult);
-    PQgetvalue(d->result, at(), field);
-    return PQgetisnull(d->result, at(), field);
+    const int currentRow = d->singleRowMode ? 0 : at();
+    PQgetvalue(d->result, currentRow, field);
+    return PQgetisnull(d->result, currentRow, field);
 }
 
 bool QPSQLResult::reset (const QString& query)
@@ -507,8 +887,7 @@ bool QPSQLResult::reset (const QString& query)
         return false;
     if (!driver()->isOpen() || driver()->isOpenError())
         return false;
-    d->result = d->drv_d_func()->exec(query);
-    return d->processResults();
+    return d->execute(query);
 }
 
 int QPSQLResult::size()
@@ -663,16 +1042,16 @@ bool QPSQLResult::exec()
 
     cleanup();
 
-    QString stmt;
-    const QString params = qCreateParamString(boundValues(), driver());
-    if (params.isEmpty())
-        stmt = QString::fromLatin1("EXECUTE %1").arg(d->preparedStmtId);
-    else
-        stmt = QString::fromLatin1("EXECUTE %1 (%2)").arg(d->preparedStmtId, params);
-
-    d->result = d->drv_d_func()->exec(stmt);
+    return d->execute(d->executeStatement());
+}
 
-    return d->processResults();
+QString QPSQLResultPrivate::executeStatement() const
+{
+    Q_Q(const QPSQLResult);
+    const QString params = qCreateParamString(q->boundValues(), q->driver());
+    if (params.isEmpty())
+        return QString::fromLatin1("EXECUTE %1").arg(preparedStmtId);
+    return QString::fromLatin1("EXECUTE %1 (%2)").arg(preparedStmtId, params);
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -871,8 +1250,10 @@ QPSQLDriver::QPSQLDriver(PGconn *conn, QObject *parent)
 QPSQLDriver::~QPSQLDriver()
 {
     Q_D(QPSQLDriver);
-    if (d->connection)
+    if (d->connection) {
+        d->finishAsyncQueries();
         PQfinish(d->connection);
+    }
 }
 
 QVariant QPSQLDriver::handle() const
@@ -976,6 +1357,7 @@ void QPSQLDriver::close()
 {
     Q_D(QPSQLDriver);
     if (isOpen()) {
+        d->finishAsyncQueries();
 
         d->seid.clear();
         if (d->sn) {
@@ -987,6 +1369,7 @@ void QPSQLDriver::close()
         if (d->connection)
             PQfinish(d->connection);
         d->connection = 0;
+        d->currentStmtId = QPSQLDriverPrivate::InvalidStatementId;
         setOpen(false);
         setOpenError(false);
     }
@@ -1473,7 +1856,12 @@ bool QPSQLDriver::unsubscribeFromNotification(const QString &name)
 
     d->seid.removeAll(name);
 
-    if (d->seid.isEmpty()) {
+    bool keepNotifier = false;
+#ifndef QT_NO_QFUTURE
+    // the notifier also reports the results of asynchronous queries
+    keepNotifier = !d->asyncQueries.isEmpty();
+#endif
+    if (d->seid.isEmpty() && !keepNotifier) {
         disconnect(d->sn, SIGNAL(activated(int)), this, SLOT(_q_handleNotification(int)));
         delete d->sn;
         d->sn = 0;
@@ -1493,6 +1881,9 @@ void QPSQLDriver::_q_handleNotification(int)
     Q_D(QPSQLDriver);
     d->pendingNotifyCheck = false;
     PQconsumeInput(d->connection);
+#ifndef QT_NO_QFUTURE
+    d->processAsyncQueries(false);
+#endif
 
     PGnotify *notify = 0;
     while((notify = PQnotifies(d->connection)) != 0) {
@@ -39,6 +39,7 @@
 
 #include "qsql_sqlite_p.h"
 
+#include <qcache.h>
 #include <qcoreapplication.h>
 #include <qdatetime.h>
 #include <qvariant.h>
@@ -101,6 +102,16 @@ static QVariant::Type qGetColumnType(const QString &tpName)
     return QVariant::String;
 }
 
+// Whether executing \a query may change the database schema, which
+// invalidates the statements in the statement cache.
+static bool qIsSchemaStatement(const QString &query)
+{
+    const QStringRef keyword = query.leftRef(16).trimmed();
+    return keyword.startsWith(QLatin1String("create"), Qt::CaseInsensitive)
+        || keyword.startsWith(QLatin1String("drop"), Qt::CaseInsensitive)
+        || keyword.startsWith(QLatin1String("alter"), Qt::CaseInsensitive);
+}
+
 static QSqlError qMakeError(sqlite3 *access, const QString &descr, QSqlError::ErrorType type,
                             int errorCode = -1)
 {
@@ -126,6 +137,7 @@ protected:
     bool reset(const QString &query) Q_DECL_OVERRIDE;
     bool prepare(const QString &query) Q_DECL_OVERRIDE;
     bool exec() Q_DECL_OVERRIDE;
+    bool execBatch(bool arrayBind = false) Q_DECL_OVERRIDE;
     int size() Q_DECL_OVERRIDE;
     int numRowsAffected() Q_DECL_OVERRIDE;
     QVariant lastInsertId() const Q_DECL_OVERRIDE;
@@ -134,17 +146,60 @@ protected:
     void virtual_hook(int id, void *data) Q_DECL_OVERRIDE;
 };
 
+// Owns a prepared statement while it is in the statement cache
+struct QSQLiteCachedStatement
+{
+    explicit QSQLiteCachedStatement(sqlite3_stmt *stmt) : stmt(stmt) {}
+    ~QSQLiteCachedStatement() { sqlite3_finalize(stmt); }
+
+    sqlite3_stmt *stmt;
+};
+
 class QSQLiteDriverPrivate : public QSqlDriverPrivate
 {
     Q_DECLARE_PUBLIC(QSQLiteDriver)
 
 public:
-    inline QSQLiteDriverPrivate() : QSqlDriverPrivate(), access(0) { dbmsType = QSqlDriver::SQLite; }
+    inline QSQLiteDriverPrivate() : QSqlDriverPrivate(), access(0), statementCache(32) { dbmsType = QSqlDriver::SQLite; }
     sqlite3 *access;
     QList <QSQLiteResult *> results;
     QStringList notificationid;
+    // Prepared statements of queries that are not in use anymore, by the
+    // text of the query, so that preparing them again is cheap.
+    QCache<QString, QSQLiteCachedStatement> statementCache;
+
+    sqlite3_stmt *takeStatement(const QString &query);
+    void cacheStatement(const QString &query, sqlite3_stmt *stmt);
 };
 
+sqlite3_stmt *QSQLiteDriverPrivate::takeStatement(const QString &query)
+{
+    QSQLiteCachedStatement *cached = statementCache.take(query);
+    if (!cached)
+        return 0;
+    sqlite3_stmt *stmt = cached->stmt;
+    cached->stmt = 0;
+    delete cached;
+    return stmt;
+}
+
+void QSQLiteDriverPrivate::cacheStatement(const QString &query, sqlite3_stmt *stmt)
+{
+    // Statements prepared with the legacy interface cannot be
+    // recompiled by SQLite after schema changes.
+#if (SQLITE_VERSION_NUMBER >= 3003011)
+    if (statementCache.maxCost() > 0) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        statementCache.insert(query, new QSQLiteCachedStatement(stmt));
+        return;
+    }
+#else
+    Q_UNUSED(query);
+#endif
+    sqlite3_finalize(stmt);
+}
+
 
 class QSQLiteResultPrivate: public QSqlCachedResultPrivate
 {
@@ -158,8 +213,11 @@ public:
     // initializes the recordInfo and the cache
     void initColumns(bool emptyResultset);
     void finalize();
+    void releaseStatement();
+    bool bindValues(const QVector<QVariant> &values);
 
     sqlite3_stmt *stmt;
+    QString stmtQuery;
 
     bool skippedStatus; // the status of the fetchNext() that's skipped
     bool skipRow; // skip the next fetchNext()?
@@ -178,7 +236,7 @@ QSQLiteResultPrivate::QSQLiteResultPrivate(QSQLiteResult *q, const QSQLiteDriver
 void QSQLiteResultPrivate::cleanup()
 {
     Q_Q(QSQLiteResult);
-    finalize();
+    releaseStatement();
     rInf.clear();
     skippedStatus = false;
     skipRow = false;
@@ -196,6 +254,19 @@ void QSQLiteResultPrivate::finalize()
     stmt = 0;
 }
 
+// Hands the statement over to the statement cache of the driver
+void QSQLiteResultPrivate::releaseStatement()
+{
+    if (!stmt)
+        return;
+
+    if (QSQLiteDriverPrivate *drv = drv_d_func())
+        drv->cacheStatement(stmtQuery, stmt);
+    else
+        sqlite3_finalize(stmt);
+    stmt = 0;
+}
+
 void QSQLiteResultPrivate::initColumns(bool emptyResultset)
 {
     Q_Q(QSQLiteResult);
@@ -387,6 +458,13 @@ bool QSQLiteResult::prepare(const QString &query)
 
     setSelect(false);
 
+    d->stmtQuery = query;
+    if (qIsSchemaStatement(query))
+        d->drv_d_func()->statementCache.clear();
+    d->stmt = d->drv_d_func()->takeStatement(query);
+    if (d->stmt)
+        return true;
+
     const void *pzTail = NULL;
 
 #if (SQLITE_VERSION_NUMBER >= 3003011)
@@ -437,90 +515,99 @@ static QString timespecToString(const QDateTime &dateTime)
     }
 }
 
-bool QSQLiteResult::exec()
+bool QSQLiteResultPrivate::bindValues(const QVector<QVariant> &values)
 {
-    Q_D(QSQLiteResult);
-    const QVector<QVariant> values = boundValues();
-
-    d->skippedStatus = false;
-    d->skipRow = false;
-    d->rInf.clear();
-    clearValues();
-    setLastError(QSqlError());
-
-    int res = sqlite3_reset(d->stmt);
-    if (res != SQLITE_OK) {
-        setLastError(qMakeError(d->drv_d_func()->access, QCoreApplication::translate("QSQLiteResult",
-                     "Unable to reset statement"), QSqlError::StatementError, res));
-        d->finalize();
-        return false;
-    }
-    int paramCount = sqlite3_bind_parameter_count(d->stmt);
+    Q_Q(QSQLiteResult);
+    int res;
+    int paramCount = sqlite3_bind_parameter_count(stmt);
     if (paramCount == values.count()) {
         for (int i = 0; i < paramCount; ++i) {
             res = SQLITE_OK;
             const QVariant value = values.at(i);
 
             if (value.isNull()) {
-                res = sqlite3_bind_null(d->stmt, i + 1);
+                res = sqlite3_bind_null(stmt, i + 1);
             } else {
                 switch (value.type()) {
                 case QVariant::ByteArray: {
                     const QByteArray *ba = static_cast<const QByteArray*>(value.constData());
-                    res = sqlite3_bind_blob(d->stmt, i + 1, ba->constData(),
+                    res = sqlite3_bind_blob(stmt, i + 1, ba->constData(),
                                             ba->size(), SQLITE_STATIC);
                     break; }
                 case QVariant::Int:
                 case QVariant::Bool:
-                    res = sqlite3_bind_int(d->stmt, i + 1, value.toInt());
+                    res = sqlite3_bind_int(stmt, i + 1, value.toInt());
                     break;
                 case QVariant::Double:
-                    res = sqlite3_bind_double(d->stmt, i + 1, value.toDouble());
+                    res = sqlite3_bind_double(stmt, i + 1, value.toDouble());
                     break;
                 case QVariant::UInt:
                 case QVariant::LongLong:
-                    res = sqlite3_bind_int64(d->stmt, i + 1, value.toLongLong());
+                    res = sqlite3_bind_int64(stmt, i + 1, value.toLongLong());
                     break;
                 case QVariant::DateTime: {
                     const QDateTime dateTime = value.toDateTime();
                     const QString str = dateTime.toString(QStringLiteral("yyyy-MM-ddThh:mm:ss.zzz") + timespecToString(dateTime));
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
+                    res = sqlite3_bind_text16(stmt, i + 1, str.utf16(),
                                               str.size() * sizeof(ushort), SQLITE_TRANSIENT);
                     break;
                 }
                 case QVariant::Time: {
                     const QTime time = value.toTime();
                     const QString str = time.toString(QStringLiteral("hh:mm:ss.zzz"));
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
+                    res = sqlite3_bind_text16(stmt, i + 1, str.utf16(),
                                               str.size() * sizeof(ushort), SQLITE_TRANSIENT);
                     break;
                 }
                 case QVariant::String: {
                     // lifetime of string == lifetime of its qvariant
                     const QString *str = static_cast<const QString*>(value.constData());
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str->utf16(),
+                    res = sqlite3_bind_text16(stmt, i + 1, str->utf16(),
                                               (str->size()) * sizeof(QChar), SQLITE_STATIC);
                     break; }
                 default: {
                     QString str = value.toString();
                     // SQLITE_TRANSIENT makes sure that sqlite buffers the data
-                    res = sqlite3_bind_text16(d->stmt, i + 1, str.utf16(),
+                    res = sqlite3_bind_text16(stmt, i + 1, str.utf16(),
                                               (str.size()) * sizeof(QChar), SQLITE_TRANSIENT);
                     break; }
                 }
             }
             if (res != SQLITE_OK) {
-                setLastError(qMakeError(d->drv_d_func()->access, QCoreApplication::translate("QSQLiteResult",
+                q->setLastError(qMakeError(drv_d_func()->access, QCoreApplication::translate("QSQLiteResult",
                              "Unable to bind parameters"), QSqlError::StatementError, res));
-                d->finalize();
+                finalize();
                 return false;
             }
         }
     } else {
-        setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult",
+        q->setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult",
                         "Parameter count mismatch"), QString(), QSqlError::StatementError));
         return false;
     }
+    return true;
+}
+
+bool QSQLiteResult::exec()
+{
+    Q_D(QSQLiteResult);
+    const QVector<QVariant> values = boundValues();
+
+    d->skippedStatus = false;
+    d->skipRow = false;
+    d->rInf.clear();
+    clearValues();
+    setLastError(QSqlError());
+
+    int res = sqlite3_reset(d->stmt);
+    if (res != SQLITE_OK) {
+        setLastError(qMakeError(d->drv_d_func()->access, QCoreApplication::translate("QSQLiteResult",
+                     "Unable to reset statement"), QSqlError::StatementError, res));
+        d->finalize();
+        return false;
+    }
+    if (!d->bindValues(values))
+        return false;
     d->skippedStatus = d->fetchNext(d->firstRow, 0, true);
     if (lastError().isValid()) {
         setSelect(false);
@@ -532,6 +619,93 @@ bool QSQLiteResult::exec()
     return true;
 }
 
+/*
+    Executes the prepared statement once for each row of the bound value
+    lists. Unless a transaction was started already, all rows are inserted
+    in a single transaction, which is much faster than committing each row.
+*/
+bool QSQLiteResult::execBatch(bool arrayBind)
+{
+    Q_UNUSED(arrayBind);
+    Q_D(QSQLiteResult);
+    const QVector<QVariant> columns = boundValues();
+    if (columns.isEmpty())
+        return false;
+
+    d->skippedStatus = false;
+    d->skipRow = false;
+    d->rInf.clear();
+    clearValues();
+    setLastError(QSqlError());
+    setSelect(false);
+    setActive(false);
+
+    QVector<QVariantList> lists;
+    lists.reserve(columns.count());
+    for (const QVariant &column : columns)
+        lists.append(column.toList());
+    const int rowCount = lists.at(0).count();
+    for (const QVariantList &list : qAsConst(lists)) {
+        if (list.count() != rowCount) {
+            setLastError(QSqlError(QCoreApplication::translate("QSQLiteResult",
+                            "Parameter count mismatch"), QString(), QSqlError::StatementError));
+            return false;
+        }
+    }
+
+    sqlite3 *access = d->drv_d_func()->access;
+    const bool implicitTransaction = sqlite3_get_autocommit(access);
+    int res;
+    if (implicitTransaction) {
+        res = sqlite3_exec(access, "BEGIN", 0, 0, 0);
+        if (res != SQLITE_OK) {
+            setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to begin transaction"), QSqlError::TransactionError, res));
+            return false;
+        }
+    }
+
+    QVector<QVariant> values(lists.count());
+    for (int row = 0; row < rowCount; ++row) {
+        for (int i = 0; i < lists.count(); ++i)
+            values[i] = lists.at(i).at(row);
+
+        res = sqlite3_reset(d->stmt);
+        if (res == SQLITE_OK) {
+            if (!d->bindValues(values)) {
+                if (implicitTransaction)
+                    sqlite3_exec(access, "ROLLBACK", 0, 0, 0);
+                return false;
+            }
+            do {
+                res = sqlite3_step(d->stmt);
+            } while (res == SQLITE_ROW);
+            if (res == SQLITE_DONE)
+                continue;
+            // SQLITE_ERROR is generic, sqlite3_reset() returns the specific error
+            res = sqlite3_reset(d->stmt);
+        }
+        setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                     "Unable to execute statement"), QSqlError::StatementError, res));
+        if (implicitTransaction)
+            sqlite3_exec(access, "ROLLBACK", 0, 0, 0);
+        return false;
+    }
+
+    if (implicitTransaction) {
+        res = sqlite3_exec(access, "COMMIT", 0, 0, 0);
+        if (res != SQLITE_OK) {
+            setLastError(qMakeError(access, QCoreApplication::translate("QSQLiteResult",
+                         "Unable to commit transaction"), QSqlError::TransactionError, res));
+            sqlite3_exec(access, "ROLLBACK", 0, 0, 0);
+            return false;
+        }
+    }
+    sqlite3_reset(d->stmt);
+    setActive(true);
+    return true;
+}
+
 bool QSQLiteResult::gotoNext(QSqlCachedResult::ValueCache& row, int idx)
 {
     Q_D(QSQLiteResult);
@@ -616,10 +790,10 @@ bool QSQLiteDriver::hasFeature(DriverFeature f) const
     case FinishQuery:
     case LowPrecisionNumbers:
     case EventNotifications:
+    case BatchOperations:
         return true;
     case QuerySize:
     case NamedPlaceholders:
-    case BatchOperations:
     case MultipleResultSets:
     case CancelQuery:
         return false;
@@ -639,6 +813,7 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
 
 
     int timeOut = 5000;
+    int statementCacheSize = 32;
     bool sharedCache = false;
     bool openReadOnlyOption = false;
     bool openUriOption = false;
@@ -654,6 +829,14 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
                 if (ok)
                     timeOut = nt;
             }
+        } else if (option.startsWith(QLatin1String("QSQLITE_STATEMENT_CACHE_SIZE"))) {
+            option = option.mid(28).trimmed();
+            if (option.startsWith(QLatin1Char('='))) {
+                bool ok;
+                const int size = option.mid(1).trimmed().toInt(&ok);
+                if (ok && size >= 0)
+                    statementCacheSize = size;
+            }
         } else if (option == QLatin1String("QSQLITE_OPEN_READONLY")) {
             openReadOnlyOption = true;
         } else if (option == QLatin1String("QSQLITE_OPEN_URI")) {
@@ -671,6 +854,7 @@ bool QSQLiteDriver::open(const QString & db, const QString &, const QString &, c
 
     if (sqlite3_open_v2(db.toUtf8().constData(), &d->access, openMode, NULL) == SQLITE_OK) {
         sqlite3_busy_timeout(d->access, timeOut);
+        d->statementCache.setMaxCost(statementCacheSize);
         setOpen(true);
         setOpenError(false);
         return true;
@@ -693,6 +877,7 @@ void QSQLiteDriver::close()
     if (isOpen()) {
         for (QSQLiteResult *result : qAsConst(d->results))
             result->d_func()->finalize();
+        d->statementCache.clear();
 
         if (d->access && (d->notificationid.count() > 0)) {
             d->notificationid.clear();
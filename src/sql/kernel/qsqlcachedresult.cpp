@@ -42,6 +42,8 @@
 #include <qvariant.h>
 #include <qdatetime.h>
 #include <qvector.h>
+#include <limits>
+#include <string.h>
 #include <QtSql/private/qsqldriver_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -56,13 +58,189 @@ QT_BEGIN_NAMESPACE
    will give you an index where you can start filling in your data. Special
    case: If the user actually wants a forward-only query, idx will be -1
    to indicate that we are not interested in the actual values.
+
+   The cache passed to gotoNext() always holds a single row. Unless the
+   query is forward only, each fetched row is moved into per column
+   storage: numbers, dates and times are kept in a fixed width cell,
+   strings and byte arrays in one buffer per column. QVariants are only
+   created again when a value is requested with data().
 */
 
-static const uint initial_cache_size = 128;
+QSqlCachedColumn::QSqlCachedColumn()
+    : type(QVariant::Invalid),
+      timeSpec(Qt::LocalTime)
+{
+}
+
+static const qint64 msecsPerDay = 86400000;
+
+// Stores value in cell if it is of the column type, which is the type of
+// the first non-null value of the column.
+bool QSqlCachedColumn::pack(const QVariant &value, quint64 *cell)
+{
+    if (type == QVariant::Invalid) {
+        type = value.userType();
+        if (type == QVariant::DateTime)
+            timeSpec = static_cast<const QDateTime *>(value.constData())->timeSpec();
+    } else if (value.userType() != type) {
+        return false;
+    }
+
+    switch (type) {
+    case QVariant::Bool:
+        *cell = *static_cast<const bool *>(value.constData());
+        return true;
+    case QVariant::Int:
+        *cell = quint64(*static_cast<const int *>(value.constData()));
+        return true;
+    case QVariant::UInt:
+        *cell = *static_cast<const uint *>(value.constData());
+        return true;
+    case QVariant::LongLong:
+    case QVariant::ULongLong:
+    case QVariant::Double:
+        memcpy(cell, value.constData(), sizeof(quint64));
+        return true;
+    case QVariant::String: {
+        const QString *str = static_cast<const QString *>(value.constData());
+        if (str->size() > std::numeric_limits<int>::max() - text.size())
+            return false;
+        *cell = (quint64(text.size()) << 32) | uint(str->size());
+        text.append(*str);
+        return true;
+    }
+    case QVariant::ByteArray: {
+        const QByteArray *ba = static_cast<const QByteArray *>(value.constData());
+        if (ba->size() > std::numeric_limits<int>::max() - bytes.size())
+            return false;
+        *cell = (quint64(bytes.size()) << 32) | uint(ba->size());
+        bytes.append(*ba);
+        return true;
+    }
+    case QVariant::Date:
+        *cell = quint64(static_cast<const QDate *>(value.constData())->toJulianDay());
+        return true;
+    case QVariant::Time:
+        if (!static_cast<const QTime *>(value.constData())->isValid())
+            return false;
+        *cell = uint(static_cast<const QTime *>(value.constData())->msecsSinceStartOfDay());
+        return true;
+    case QVariant::DateTime: {
+        const QDateTime *dt = static_cast<const QDateTime *>(value.constData());
+        if ((timeSpec != Qt::LocalTime && timeSpec != Qt::UTC)
+                || dt->timeSpec() != timeSpec || !dt->time().isValid())
+            return false;
+        const qint64 days = dt->date().toJulianDay();
+        if (days > std::numeric_limits<qint64>::max() / msecsPerDay - 1
+                || days < std::numeric_limits<qint64>::min() / msecsPerDay + 1)
+            return false;
+        *cell = quint64(days * msecsPerDay + dt->time().msecsSinceStartOfDay());
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+// Moves value into the column, leaving it invalid
+void QSqlCachedColumn::append(QVariant &value)
+{
+    quint64 cell;
+    if (value.isNull()) {
+        cells.append(uint(value.userType()));
+        kinds.append(NullCell);
+    } else if (pack(value, &cell)) {
+        cells.append(cell);
+        kinds.append(NativeCell);
+    } else {
+        cells.append(variants.size());
+        kinds.append(VariantCell);
+        variants.append(value);
+    }
+    value.clear();
+}
+
+QVariant QSqlCachedColumn::value(int row) const
+{
+    const quint64 cell = cells.at(row);
+    switch (kinds.at(row)) {
+    case NullCell:
+        return QVariant(QVariant::Type(int(cell)));
+    case VariantCell:
+        return variants.at(int(cell));
+    default:
+        break;
+    }
+
+    switch (type) {
+    case QVariant::Bool:
+        return QVariant(cell != 0);
+    case QVariant::Int:
+        return QVariant(int(cell));
+    case QVariant::UInt:
+        return QVariant(uint(cell));
+    case QVariant::LongLong:
+        return QVariant(qint64(cell));
+    case QVariant::ULongLong:
+        return QVariant(cell);
+    case QVariant::Double: {
+        double d;
+        memcpy(&d, &cell, sizeof(double));
+        return QVariant(d);
+    }
+    case QVariant::String:
+        return QVariant(QString(text.constData() + int(cell >> 32), int(uint(cell))));
+    case QVariant::ByteArray:
+        return QVariant(QByteArray(bytes.constData() + int(cell >> 32), int(uint(cell))));
+    case QVariant::Date:
+        return QVariant(QDate::fromJulianDay(qint64(cell)));
+    case QVariant::Time:
+        return QVariant(QTime::fromMSecsSinceStartOfDay(int(cell)));
+    case QVariant::DateTime: {
+        const qint64 msecs = qint64(cell);
+        qint64 days = msecs / msecsPerDay;
+        qint64 msecsOfDay = msecs % msecsPerDay;
+        if (msecsOfDay < 0) {
+            --days;
+            msecsOfDay += msecsPerDay;
+        }
+        return QVariant(QDateTime(QDate::fromJulianDay(days),
+                                  QTime::fromMSecsSinceStartOfDay(int(msecsOfDay)), timeSpec));
+    }
+    default:
+        Q_UNREACHABLE();
+        return QVariant();
+    }
+}
+
+bool QSqlCachedColumn::isNull(int row) const
+{
+    switch (kinds.at(row)) {
+    case NullCell:
+        return true;
+    case VariantCell:
+        return variants.at(int(cells.at(row))).isNull();
+    default:
+        return false;
+    }
+}
+
+void QSqlCachedColumn::clear()
+{
+    cells.clear();
+    kinds.clear();
+    text.clear();
+    bytes.clear();
+    variants.clear();
+    type = QVariant::Invalid;
+    timeSpec = Qt::LocalTime;
+}
+
+//////////////
 
 QSqlCachedResultPrivate::QSqlCachedResultPrivate(QSqlCachedResult *q, const QSqlDriver *drv)
     : QSqlResultPrivate(q, drv),
-      rowCacheEnd(0),
+      rowCount(0),
       colCount(0),
       atEnd(false)
 {
@@ -71,9 +249,10 @@ QSqlCachedResultPrivate::QSqlCachedResultPrivate(QSqlCachedResult *q, const QSql
 void QSqlCachedResultPrivate::cleanup()
 {
     cache.clear();
+    columns.clear();
     atEnd = false;
     colCount = 0;
-    rowCacheEnd = 0;
+    rowCount = 0;
 }
 
 void QSqlCachedResultPrivate::init(int count, bool fo)
@@ -82,45 +261,38 @@ void QSqlCachedResultPrivate::init(int count, bool fo)
     cleanup();
     forwardOnly = fo;
     colCount = count;
-    if (fo) {
-        cache.resize(count);
-        rowCacheEnd = count;
-    } else {
-        cache.resize(initial_cache_size * count);
-    }
+    cache.resize(count);
+    if (!fo)
+        columns.resize(count);
 }
 
-int QSqlCachedResultPrivate::nextIndex()
+void QSqlCachedResultPrivate::clearRows()
 {
-    if (forwardOnly)
-        return 0;
-    int newIdx = rowCacheEnd;
-    if (newIdx + colCount > cache.size())
-        cache.resize(qMin(cache.size() * 2, cache.size() + 10000));
-    rowCacheEnd += colCount;
-
-    return newIdx;
+    for (int i = 0; i < columns.size(); ++i)
+        columns[i].clear();
+    rowCount = 0;
 }
 
-bool QSqlCachedResultPrivate::canSeek(int i) const
+// Moves the fetched row from the cache into the column storage
+void QSqlCachedResultPrivate::appendRow()
 {
-    if (forwardOnly || i < 0)
-        return false;
-    return rowCacheEnd >= (i + 1) * colCount;
+    for (int i = 0; i < colCount; ++i)
+        columns[i].append(cache[i]);
+    ++rowCount;
 }
 
-void QSqlCachedResultPrivate::revertLast()
+bool QSqlCachedResultPrivate::canSeek(int i) const
 {
-    if (forwardOnly)
-        return;
-    rowCacheEnd -= colCount;
+    if (forwardOnly || i < 0)
+        return false;
+    return rowCount > i;
 }
 
 inline int QSqlCachedResultPrivate::cacheCount() const
 {
     Q_ASSERT(!forwardOnly);
     Q_ASSERT(colCount);
-    return rowCacheEnd / colCount;
+    return rowCount;
 }
 
 //////////////
@@ -161,7 +333,7 @@ bool QSqlCachedResult::fetch(int i)
         setAt(i);
         return true;
     }
-    if (d->rowCacheEnd > 0)
+    if (d->rowCount > 0)
         setAt(d->cacheCount());
     while (at() < i + 1) {
         if (!cacheNext()) {
@@ -227,21 +399,27 @@ bool QSqlCachedResult::fetchLast()
 QVariant QSqlCachedResult::data(int i)
 {
     Q_D(const QSqlCachedResult);
-    int idx = d->forwardOnly ? i : at() * d->colCount + i;
-    if (i >= d->colCount || i < 0 || at() < 0 || idx >= d->rowCacheEnd)
+    if (i >= d->colCount || i < 0 || at() < 0)
+        return QVariant();
+    if (d->forwardOnly)
+        return d->cache.value(i);
+    if (at() >= d->rowCount)
         return QVariant();
 
-    return d->cache.at(idx);
+    return d->columns.at(i).value(at());
 }
 
 bool QSqlCachedResult::isNull(int i)
 {
     Q_D(const QSqlCachedResult);
-    int idx = d->forwardOnly ? i : at() * d->colCount + i;
-    if (i >= d->colCount || i < 0 || at() < 0 || idx >= d->rowCacheEnd)
+    if (i >= d->colCount || i < 0 || at() < 0)
+        return true;
+    if (d->forwardOnly)
+        return d->cache.value(i).isNull();
+    if (at() >= d->rowCount)
         return true;
 
-    return d->cache.at(idx).isNull();
+    return d->columns.at(i).isNull(at());
 }
 
 void QSqlCachedResult::cleanup()
@@ -256,7 +434,7 @@ void QSqlCachedResult::clearValues()
 {
     Q_D(QSqlCachedResult);
     setAt(QSql::BeforeFirstRow);
-    d->rowCacheEnd = 0;
+    d->clearRows();
     d->atEnd = false;
 }
 
@@ -266,15 +444,14 @@ bool QSqlCachedResult::cacheNext()
     if (d->atEnd)
         return false;
 
-    if(isForwardOnly()) {
-        d->cache.resize(d->colCount);
-    }
+    d->cache.resize(d->colCount);
 
-    if (!gotoNext(d->cache, d->nextIndex())) {
-        d->revertLast();
+    if (!gotoNext(d->cache, 0)) {
         d->atEnd = true;
         return false;
     }
+    if (!d->forwardOnly)
+        d->appendRow();
     setAt(at() + 1);
     return true;
 }
@@ -54,12 +54,11 @@
 #include <QtSql/private/qtsqlglobal_p.h>
 #include "QtSql/qsqlresult.h"
 #include "QtSql/private/qsqlresult_p.h"
+#include <QtCore/qvector.h>
+#include <QtCore/qvariant.h>
 
 QT_BEGIN_NAMESPACE
 
-class QVariant;
-template <typename T> class QVector;
-
 class QSqlCachedResultPrivate;
 
 class Q_SQL_EXPORT QSqlCachedResult: public QSqlResult
@@ -96,6 +95,39 @@ private:
     bool cacheNext();
 };
 
+class QSqlCachedColumn
+{
+public:
+    QSqlCachedColumn();
+
+    void append(QVariant &value);
+    QVariant value(int row) const;
+    bool isNull(int row) const;
+    void clear();
+
+private:
+    enum CellKind : uchar {
+        NullCell,       // cell holds the type of a null value
+        NativeCell,     // cell holds a value of the column type
+        VariantCell     // cell holds an index into variants
+    };
+
+    bool pack(const QVariant &value, quint64 *cell);
+
+    // one entry per row
+    QVector<quint64> cells;
+    QVector<uchar> kinds;
+
+    // out-of-line storage
+    QString text;
+    QByteArray bytes;
+    QVector<QVariant> variants;
+
+    int type;
+    Qt::TimeSpec timeSpec;
+};
+Q_DECLARE_TYPEINFO(QSqlCachedColumn, Q_MOVABLE_TYPE);
+
 class Q_SQL_EXPORT QSqlCachedResultPrivate: public QSqlResultPrivate
 {
     Q_DECLARE_PUBLIC(QSqlCachedResult)
@@ -106,11 +138,14 @@ public:
     inline int cacheCount() const;
     void init(int count, bool fo);
     void cleanup();
-    int nextIndex();
-    void revertLast();
+    void clearRows();
+    void appendRow();
 
+    // the row the driver fetches into
     QSqlCachedResult::ValueCache cache;
-    int rowCacheEnd;
+    // all rows fetched so far, unless forward only
+    QVector<QSqlCachedColumn> columns;
+    int rowCount;
     int colCount;
     bool atEnd;
 };
@@ -48,6 +48,7 @@
 #include "qsqlindex.h"
 #include "private/qfactoryloader_p.h"
 #include "private/qsqlnulldriver_p.h"
+#include "private/qsqldriver_p.h"
 #include "qmutex.h"
 #include "qhash.h"
 #include <stdlib.h>
@@ -779,11 +780,17 @@ bool QSqlDatabase::open(const QString& user, const QString& password)
 
     This will also affect copies of this QSqlDatabase object.
 
+    Queries started with QSqlQuery::execAsync() that are still running
+    are waited for before the connection is closed.
+
     \sa removeDatabase()
 */
 
 void QSqlDatabase::close()
 {
+#ifndef QT_NO_QFUTURE
+    d->driver->d_func()->waitForAsyncQueries();
+#endif
     d->driver->close();
 }
 
@@ -1186,6 +1193,7 @@ QSqlRecord QSqlDatabase::record(const QString& tablename) const
     \li QSQLITE_OPEN_READONLY
     \li QSQLITE_OPEN_URI
     \li QSQLITE_ENABLE_SHARED_CACHE
+    \li QSQLITE_STATEMENT_CACHE_SIZE
     \endlist
 
     \li
@@ -55,6 +55,9 @@
 #include "private/qobject_p.h"
 #include "qsqldriver.h"
 #include "qsqlerror.h"
+#ifndef QT_NO_QFUTURE
+#include "qthreadpool.h"
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -69,13 +72,39 @@ public:
         isOpenError(false),
         precisionPolicy(QSql::LowPrecisionDouble),
         dbmsType(QSqlDriver::UnknownDbms)
+#ifndef QT_NO_QFUTURE
+        , asyncPool(0)
+#endif
     { }
+#ifndef QT_NO_QFUTURE
+    ~QSqlDriverPrivate() { delete asyncPool; }
+
+    // runs the asynchronous queries of drivers that cannot run them
+    // natively, one after the other
+    QThreadPool *asyncThreadPool()
+    {
+        if (!asyncPool) {
+            asyncPool = new QThreadPool;
+            asyncPool->setMaxThreadCount(1);
+        }
+        return asyncPool;
+    }
+
+    void waitForAsyncQueries()
+    {
+        if (asyncPool)
+            asyncPool->waitForDone();
+    }
+#endif
 
     uint isOpen;
     uint isOpenError;
     QSqlError error;
     QSql::NumericalPrecisionPolicy precisionPolicy;
     QSqlDriver::DbmsType dbmsType;
+#ifndef QT_NO_QFUTURE
+    QThreadPool *asyncPool;
+#endif
 };
 
 QT_END_NAMESPACE
@@ -49,6 +49,7 @@
 #include "qsqldriver.h"
 #include "qsqldatabase.h"
 #include "private/qsqlnulldriver_p.h"
+#include "private/qsqlresult_p.h"
 #include "qvector.h"
 #include "qmap.h"
 
@@ -374,6 +375,66 @@ bool QSqlQuery::exec(const QString& query)
     QElapsedTimer t;
     t.start();
 #endif
+    if (!resetResult(query))
+        return false;
+
+    bool retval = d->sqlResult->reset(query);
+#ifdef QT_DEBUG_SQL
+    qDebug().nospace() << "Executed query (" << t.elapsed() << "ms, " << d->sqlResult->size()
+                       << " results, " << d->sqlResult->numRowsAffected()
+                       << " affected): " << d->sqlResult->lastQuery();
+#endif
+    return retval;
+}
+
+#ifndef QT_NO_QFUTURE
+/*!
+    \since 5.10
+
+    Executes the SQL in \a query without blocking the calling thread, and
+    returns a future that reports whether it succeeded, as exec() would.
+    Once the future has finished, the query is positioned on an invalid
+    record like after exec(), and its results, lastError() and the other
+    properties can be used as usual.
+
+    The QPSQL driver sends the query to the server and reads the results
+    as they arrive, while the event loop of the thread that opened the
+    connection is running. Using the connection synchronously in that
+    thread, or closing it, waits for the pending queries to finish first.
+    Do not block that thread in QFuture::waitForFinished() while such a
+    query is pending: watch the future with a QFutureWatcher instead.
+
+    The other drivers run the query in a worker thread owned by the
+    connection, one query after the other. QSqlDatabase::close() waits for
+    the queries that are still running.
+
+    The query, and other queries on the same connection, must not be used
+    until the future has finished.
+
+    \sa exec(), QFutureWatcher
+*/
+QFuture<bool> QSqlQuery::execAsync(const QString &query)
+{
+    QFutureInterface<bool> future(QFutureInterfaceBase::Started);
+    if (!resetResult(query)) {
+        const bool ok = false;
+        future.reportFinished(&ok);
+        return future.future();
+    }
+    d->sqlResult->d_func()->execAsync(*this, &query, future);
+    return future.future();
+}
+#endif
+
+/*!
+    \internal
+
+    Prepares the result for executing \a query, detaching it from the
+    other copies of this query first. Returns \c false if \a query cannot
+    be executed.
+*/
+bool QSqlQuery::resetResult(const QString &query)
+{
     if (d->ref.load() != 1) {
         bool fo = isForwardOnly();
         *this = QSqlQuery(driver()->createResult());
@@ -395,14 +456,7 @@ bool QSqlQuery::exec(const QString& query)
         qWarning("QSqlQuery::exec: empty query");
         return false;
     }
-
-    bool retval = d->sqlResult->reset(query);
-#ifdef QT_DEBUG_SQL
-    qDebug().nospace() << "Executed query (" << t.elapsed() << "ms, " << d->sqlResult->size()
-                       << " results, " << d->sqlResult->numRowsAffected()
-                       << " affected): " << d->sqlResult->lastQuery();
-#endif
-    return retval;
+    return true;
 }
 
 /*!
@@ -1015,6 +1069,33 @@ bool QSqlQuery::exec()
     return retval;
 }
 
+#ifndef QT_NO_QFUTURE
+/*!
+    \since 5.10
+
+    Executes a previously prepared SQL query without blocking the calling
+    thread, and returns a future that reports whether it succeeded, as
+    exec() would. The bound values are read when the query is executed, so
+    they must not be changed until the future has finished.
+
+    See execAsync(const QString &) for how the query is run and what can
+    be done while it is running.
+
+    \sa exec(), prepare()
+*/
+QFuture<bool> QSqlQuery::execAsync()
+{
+    d->sqlResult->resetBindCount();
+
+    if (d->sqlResult->lastError().isValid())
+        d->sqlResult->setLastError(QSqlError());
+
+    QFutureInterface<bool> future(QFutureInterfaceBase::Started);
+    d->sqlResult->d_func()->execAsync(*this, 0, future);
+    return future.future();
+}
+#endif
+
 /*! \enum QSqlQuery::BatchExecutionMode
 
     \value ValuesAsRows - Updates multiple rows. Treats every entry in a QVariantList as a value for updating the next row.
@@ -43,6 +43,9 @@
 #include <QtSql/qtsqlglobal.h>
 #include <QtSql/qsqldatabase.h>
 #include <QtCore/qstring.h>
+#ifndef QT_NO_QFUTURE
+#include <QtCore/qfuture.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -82,6 +85,9 @@ public:
 
     void setForwardOnly(bool forward);
     bool exec(const QString& query);
+#ifndef QT_NO_QFUTURE
+    QFuture<bool> execAsync(const QString &query);
+#endif
     QVariant value(int i) const;
     QVariant value(const QString& name) const;
 
@@ -98,6 +104,9 @@ public:
 
     // prepared query support
     bool exec();
+#ifndef QT_NO_QFUTURE
+    QFuture<bool> execAsync();
+#endif
     enum BatchExecutionMode { ValuesAsRows, ValuesAsColumns };
     bool execBatch(BatchExecutionMode mode = ValuesAsRows);
     bool prepare(const QString& query);
@@ -114,6 +123,8 @@ public:
     bool nextResult();
 
 private:
+    bool resetResult(const QString &query);
+
     QSqlQueryPrivate* d;
 };
 
@@ -48,6 +48,7 @@
 #include "qvector.h"
 #include "qsqldriver.h"
 #include "qpointer.h"
+#include "qsqlquery.h"
 #include "qsqlresult_p.h"
 #include "private/qsqldriver_p.h"
 #include <QDebug>
@@ -178,6 +179,55 @@ QString QSqlResultPrivate::namedToPositionalBinding(const QString &query)
     return result;
 }
 
+#ifndef QT_NO_QFUTURE
+class QSqlAsyncQueryRunner : public QRunnable
+{
+public:
+    QSqlAsyncQueryRunner(const QSqlQuery &query, QSqlResultPrivate *d, const QString *statement,
+                         const QFutureInterface<bool> &future)
+        : query(query), d(d), statement(statement ? *statement : QString()),
+          prepared(!statement), future(future)
+    { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        const bool ok = d->execNow(prepared ? 0 : &statement);
+        // drop the reference before reporting, so that the result is not
+        // deleted in this thread while the connection is in use again
+        query = QSqlQuery();
+        future.reportFinished(&ok);
+    }
+
+private:
+    QSqlQuery query;
+    QSqlResultPrivate *d;
+    QString statement;
+    bool prepared;
+    QFutureInterface<bool> future;
+};
+
+/*
+    Runs \a statement, or the prepared query if \a statement is null, and
+    reports whether it succeeded to \a future. \a query keeps the result
+    alive until then.
+
+    The default implementation runs the query in the worker thread of the
+    connection. Drivers that can run queries without blocking override it.
+*/
+void QSqlResultPrivate::execAsync(const QSqlQuery &query, const QString *statement,
+                                  const QFutureInterface<bool> &future)
+{
+    QSqlDriverPrivate *drv = sqldriver->d_func();
+    drv->asyncThreadPool()->start(new QSqlAsyncQueryRunner(query, this, statement, future));
+}
+
+bool QSqlResultPrivate::execNow(const QString *statement)
+{
+    Q_Q(QSqlResult);
+    return statement ? q->reset(*statement) : q->exec();
+}
+#endif
+
 /*!
     \class QSqlResult
     \brief The QSqlResult class provides an abstract interface for
@@ -63,6 +63,7 @@ class Q_SQL_EXPORT QSqlResult
     Q_DECLARE_PRIVATE(QSqlResult)
     friend class QSqlQuery;
     friend class QSqlTableModelPrivate;
+    friend class QSqlQueryModelPrivate;
     // for testing:
     friend class ::tst_QSqlQuery;
 
@@ -56,9 +56,14 @@
 #include "qsqlerror.h"
 #include "qsqlresult.h"
 #include "qsqldriver.h"
+#ifndef QT_NO_QFUTURE
+#include <QtCore/qfutureinterface.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
+class QSqlQuery;
+
 // convenience method Q*ResultPrivate::drv_d_func() returns pointer to private driver. Compare to Q_DECLARE_PRIVATE in qglobal.h.
 #define Q_DECLARE_SQLDRIVER_PRIVATE(Class) \
     inline const Class##Private* drv_d_func() const { return !sqldriver ? nullptr : reinterpret_cast<const Class *>(static_cast<const QSqlDriver*>(sqldriver))->d_func(); } \
@@ -118,6 +123,11 @@ public:
     QString positionalToNamedBinding(const QString &query) const;
     QString namedToPositionalBinding(const QString &query);
     QString holderAt(int index) const;
+#ifndef QT_NO_QFUTURE
+    virtual void execAsync(const QSqlQuery &query, const QString *statement,
+                           const QFutureInterface<bool> &future);
+    bool execNow(const QString *statement);
+#endif
 
     QSqlResult *q_ptr;
     QPointer<QSqlDriver> sqldriver;
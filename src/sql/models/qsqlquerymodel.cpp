@@ -43,6 +43,7 @@
 #include <qdebug.h>
 #include <qsqldriver.h>
 #include <qsqlfield.h>
+#include <qsqlresult.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -87,6 +88,84 @@ QSqlQueryModelPrivate::~QSqlQueryModelPrivate()
 {
 }
 
+// Whether the database can select a range of rows with LIMIT and OFFSET
+bool QSqlQueryModelPrivate::canWindow(const QSqlDatabase &db)
+{
+    if (!db.isOpen())
+        return false;
+    switch (db.driver()->dbmsType()) {
+    case QSqlDriver::SQLite:
+    case QSqlDriver::PostgreSQL:
+    case QSqlDriver::MySqlServer:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Returns the statement that selects limit rows of the query starting at
+// row offset, or the number of rows of the query if limit is negative
+QString QSqlQueryModelPrivate::windowStatement(int offset, int limit) const
+{
+    typedef QSqlQueryModelSql Sql;
+    const QString subQuery = Sql::as(Sql::paren(windowQuery), QLatin1String("qt_window"));
+    if (limit < 0)
+        return Sql::concat(Sql::select(QLatin1String("COUNT(*)")), Sql::from(subQuery));
+    return Sql::concat(Sql::select(QLatin1String("*")), Sql::from(subQuery))
+            + QLatin1String(" LIMIT ") + QString::number(limit)
+            + QLatin1String(" OFFSET ") + QString::number(offset);
+}
+
+// Returns the values of the rows of page, fetching them if they are not
+// in the page cache. The values are stored row by row.
+const QVector<QVariant> *QSqlQueryModelPrivate::windowPage(int page)
+{
+    if (QVector<QVariant> *values = pageCache.object(page))
+        return values;
+
+    QSqlQuery pageQuery(windowDb);
+    pageQuery.setForwardOnly(true);
+    if (!pageQuery.exec(windowStatement(page * windowRows, windowRows))) {
+        error = pageQuery.lastError();
+        return 0;
+    }
+
+    QVector<QVariant> *values = new QVector<QVariant>;
+    values->reserve(windowRows * windowColumns);
+    while (pageQuery.next()) {
+        for (int i = 0; i < windowColumns; ++i)
+            values->append(pageQuery.value(i));
+    }
+    pageCache.insert(page, values);
+    return values;
+}
+
+void QSqlQueryModelPrivate::initWindow(const QString &statement, const QSqlDatabase &db)
+{
+    // the statement is only run a page at a time; the model's query just
+    // carries its text
+    query = QSqlQuery(db);
+    const_cast<QSqlResult *>(query.result())->setQuery(statement);
+
+    windowed = true;
+    windowRows = windowPageSize;
+    windowDb = db;
+    windowQuery = statement.trimmed();
+    while (windowQuery.endsWith(QLatin1Char(';')))
+        windowQuery.chop(1);
+    pageCache.setMaxCost(windowPages);
+}
+
+void QSqlQueryModelPrivate::clearWindow()
+{
+    windowed = false;
+    windowQuery.clear();
+    windowRows = 0;
+    windowColumns = 0;
+    windowDb = QSqlDatabase();
+    pageCache.clear();
+}
+
 void QSqlQueryModelPrivate::initColOffsets(int size)
 {
     colOffsets.resize(size);
@@ -144,6 +223,23 @@ int QSqlQueryModelPrivate::columnInQuery(int modelColumn) const
     a query, the model will fetch rows incrementally.
     See fetchMore() for more information.
 
+    \section1 Windowed Fetching
+
+    By default, the rows that have been shown once are kept in the
+    result set of the query, so scrolling to the end of a large result
+    set reads all of it into memory. When a window page size is set with
+    setWindowPageSize(), a query set with setQuery(const QString &, const
+    QSqlDatabase &) is instead read a page at a time, around the rows
+    that are asked for, and only the most recently used pages are kept
+    (see setMaximumWindowPages()). The number of rows is determined with
+    a \c{SELECT COUNT(*)} query.
+
+    Windowed fetching selects row ranges with \c LIMIT and \c OFFSET,
+    and is available for SQLite, PostgreSQL and MySQL databases. The
+    query should have an \c{ORDER BY} clause, so that its rows are
+    returned in the same order every time. For other databases, or when
+    the page size is 0, the model fetches rows incrementally.
+
     \sa QSqlTableModel, QSqlRelationalTableModel, QSqlQuery,
         {Model/View Programming}, {Query Model Example}
 */
@@ -316,6 +412,67 @@ void QSqlQueryModel::endResetModel()
 
     \sa canFetchMore(), QSqlDriver::hasFeature()
  */
+/*!
+    \since 5.10
+
+    Sets the number of rows read at a time in windowed fetching mode to
+    \a rows. A value of 0, the default, disables windowed fetching.
+
+    The setting takes effect with the next call to setQuery(const QString
+    &, const QSqlDatabase &).
+
+    \sa windowPageSize(), setMaximumWindowPages(), {Windowed Fetching}
+*/
+void QSqlQueryModel::setWindowPageSize(int rows)
+{
+    Q_D(QSqlQueryModel);
+    d->windowPageSize = qMax(rows, 0);
+}
+
+/*!
+    \since 5.10
+
+    Returns the number of rows read at a time in windowed fetching mode,
+    or 0 if windowed fetching is disabled.
+
+    \sa setWindowPageSize()
+*/
+int QSqlQueryModel::windowPageSize() const
+{
+    Q_D(const QSqlQueryModel);
+    return d->windowPageSize;
+}
+
+/*!
+    \since 5.10
+
+    Sets the number of pages of rows that are kept in windowed fetching
+    mode to \a pages. When a page that is not kept is needed, the least
+    recently used page is discarded. The default is 16 pages.
+
+    \sa maximumWindowPages(), setWindowPageSize()
+*/
+void QSqlQueryModel::setMaximumWindowPages(int pages)
+{
+    Q_D(QSqlQueryModel);
+    d->windowPages = qMax(pages, 1);
+    d->pageCache.setMaxCost(d->windowPages);
+}
+
+/*!
+    \since 5.10
+
+    Returns the number of pages of rows that are kept in windowed
+    fetching mode.
+
+    \sa setMaximumWindowPages()
+*/
+int QSqlQueryModel::maximumWindowPages() const
+{
+    Q_D(const QSqlQueryModel);
+    return d->windowPages;
+}
+
 int QSqlQueryModel::rowCount(const QModelIndex &index) const
 {
     Q_D(const QSqlQueryModel);
@@ -351,6 +508,16 @@ QVariant QSqlQueryModel::data(const QModelIndex &item, int role) const
     if (!d->rec.isGenerated(item.column()))
         return v;
     QModelIndex dItem = indexInQuery(item);
+    if (d->windowed) {
+        if (dItem.row() < 0 || dItem.row() > d->bottom.row())
+            return v;
+        const QVector<QVariant> *page = const_cast<QSqlQueryModelPrivate *>(d)->windowPage(
+                    dItem.row() / d->windowRows);
+        if (!page)
+            return v;
+        const int row = dItem.row() % d->windowRows;
+        return page->value(row * d->windowColumns + dItem.column());
+    }
     if (dItem.row() > d->bottom.row())
         const_cast<QSqlQueryModelPrivate *>(d)->prefetch(dItem.row());
 
@@ -422,6 +589,7 @@ void QSqlQueryModel::setQuery(const QSqlQuery &query)
     d->query = query;
     d->rec = newRec;
     d->atEnd = true;
+    d->clearWindow();
 
     if (query.isForwardOnly()) {
         d->error = QSqlError(QLatin1String("Forward-only queries "
@@ -464,11 +632,53 @@ void QSqlQueryModel::setQuery(const QSqlQuery &query)
     Example:
     \snippet code/src_sql_models_qsqlquerymodel.cpp 1
 
-    \sa query(), queryChange(), lastError()
+    If a window page size is set and the database supports it, the
+    query is not executed as such; instead its rows are read a page at a
+    time when they are needed. query() then returns an inactive query
+    holding the statement.
+
+    \sa query(), queryChange(), lastError(), setWindowPageSize()
 */
 void QSqlQueryModel::setQuery(const QString &query, const QSqlDatabase &db)
 {
-    setQuery(QSqlQuery(query, db));
+    Q_D(QSqlQueryModel);
+    const QSqlDatabase database = db.isValid() ? db : QSqlDatabase::database();
+    if (d->windowPageSize <= 0 || !QSqlQueryModelPrivate::canWindow(database)) {
+        setQuery(QSqlQuery(query, db));
+        return;
+    }
+
+    beginResetModel();
+
+    d->bottom = QModelIndex();
+    d->error = QSqlError();
+    d->atEnd = true;
+    d->clearWindow();
+    d->initWindow(query, database);
+
+    // an empty page provides the columns of the query
+    QSqlQuery columns(database);
+    columns.setForwardOnly(true);
+    QSqlQuery count(database);
+    count.setForwardOnly(true);
+    QSqlRecord newRec;
+    if (columns.exec(d->windowStatement(0, 0))) {
+        newRec = columns.record();
+        if (!count.exec(d->windowStatement(0, -1)) || !count.next())
+            d->error = count.lastError();
+    } else {
+        d->error = columns.lastError();
+    }
+
+    if (d->colOffsets.size() != newRec.count() || newRec != d->rec)
+        d->initColOffsets(newRec.count());
+    d->rec = newRec;
+    d->windowColumns = newRec.count();
+    d->bottom = createIndex(d->error.isValid() ? -1 : count.value(0).toInt() - 1,
+                            d->rec.count() - 1);
+
+    endResetModel();
+    queryChange();
 }
 
 /*!
@@ -485,6 +695,7 @@ void QSqlQueryModel::clear()
     d->colOffsets.clear();
     d->bottom = QModelIndex();
     d->headers.clear();
+    d->clearWindow();
     endResetModel();
 }
 
@@ -83,6 +83,11 @@ public:
 
     QSqlError lastError() const;
 
+    void setWindowPageSize(int rows);
+    int windowPageSize() const;
+    void setMaximumWindowPages(int pages);
+    int maximumWindowPages() const;
+
     void fetchMore(const QModelIndex &parent = QModelIndex()) Q_DECL_OVERRIDE;
     bool canFetchMore(const QModelIndex &parent = QModelIndex()) const Q_DECL_OVERRIDE;
 
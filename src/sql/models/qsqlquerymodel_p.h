@@ -53,9 +53,11 @@
 
 #include <QtSql/private/qtsqlglobal_p.h>
 #include "private/qabstractitemmodel_p.h"
+#include "QtSql/qsqldatabase.h"
 #include "QtSql/qsqlerror.h"
 #include "QtSql/qsqlquery.h"
 #include "QtSql/qsqlrecord.h"
+#include "QtCore/qcache.h"
 #include "QtCore/qhash.h"
 #include "QtCore/qvarlengtharray.h"
 #include "QtCore/qvector.h"
@@ -66,21 +68,39 @@ class QSqlQueryModelPrivate: public QAbstractItemModelPrivate
 {
     Q_DECLARE_PUBLIC(QSqlQueryModel)
 public:
-    QSqlQueryModelPrivate() : atEnd(false), nestedResetLevel(0) {}
+    QSqlQueryModelPrivate() : atEnd(false), windowed(false), nestedResetLevel(0),
+        windowPageSize(0), windowPages(16), windowRows(0), windowColumns(0) {}
     ~QSqlQueryModelPrivate();
 
     void prefetch(int);
     void initColOffsets(int size);
     int columnInQuery(int modelColumn) const;
 
+    static bool canWindow(const QSqlDatabase &db);
+    QString windowStatement(int offset, int limit) const;
+    const QVector<QVariant> *windowPage(int page);
+    void initWindow(const QString &statement, const QSqlDatabase &db);
+    void clearWindow();
+
     mutable QSqlQuery query;
     mutable QSqlError error;
     QModelIndex bottom;
     QSqlRecord rec;
     uint atEnd : 1;
+    uint windowed : 1;
     QVector<QHash<int, QVariant> > headers;
     QVarLengthArray<int, 56> colOffsets; // used to calculate indexInQuery of columns
     int nestedResetLevel;
+
+    // windowed fetching: the rows of the query are read a page at a time,
+    // only the most recently used pages are kept
+    int windowPageSize;
+    int windowPages;
+    int windowRows; // the page size of the current query
+    int windowColumns;
+    QString windowQuery;
+    QSqlDatabase windowDb;
+    QCache<int, QVector<QVariant> > pageCache;
 };
 
 // helpers for building SQL expressions
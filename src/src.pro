@@ -30,6 +30,10 @@ src_tools_qlalr.target = sub-qlalr
 force_bootstrap: src_tools_qlalr.depends = src_tools_bootstrap
 else: src_tools_qlalr.depends = src_corelib
 
+src_tools_qtracedump.subdir = tools/qtracedump
+src_tools_qtracedump.target = sub-qtracedump
+src_tools_qtracedump.depends = src_corelib
+
 src_tools_uic.subdir = tools/uic
 src_tools_uic.target = sub-uic
 force_bootstrap: src_tools_uic.depends = src_tools_bootstrap
@@ -149,6 +153,10 @@ qtConfig(regularexpression):pcre2 {
 }
 SUBDIRS += src_corelib src_tools_qlalr
 TOOLS = src_tools_moc src_tools_rcc src_tools_qlalr src_tools_qfloat16_tables
+qtConfig(commandlineparser) {
+    SUBDIRS += src_tools_qtracedump
+    TOOLS += src_tools_qtracedump
+}
 win32:SUBDIRS += src_winmain
 qtConfig(network) {
     SUBDIRS += src_network
@@ -210,7 +218,7 @@ nacl: SUBDIRS -= src_network src_testlib
 android: SUBDIRS += src_android src_3rdparty_gradle
 
 TR_EXCLUDE = \
-    src_tools_bootstrap src_tools_moc src_tools_rcc src_tools_uic src_tools_qlalr \
+    src_tools_bootstrap src_tools_moc src_tools_rcc src_tools_uic src_tools_qlalr src_tools_qtracedump \
     src_tools_bootstrap_dbus src_tools_qdbusxml2cpp src_tools_qdbuscpp2xml \
     src_3rdparty_pcre2 src_3rdparty_harfbuzzng src_3rdparty_freetype
 
@@ -69,6 +69,7 @@ SOURCES += \
            ../../corelib/tools/qlinkedlist.cpp \
            ../../corelib/tools/qlocale.cpp \
            ../../corelib/tools/qlocale_tools.cpp \
+           ../../corelib/tools/qlz4.cpp \
            ../../corelib/tools/qmap.cpp \
            ../../corelib/tools/qregexp.cpp \
            ../../corelib/tools/qringbuffer.cpp \
@@ -0,0 +1,299 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the tools applications of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtCore/qcommandlineparser.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qvector.h>
+#include <QtCore/private/qloggingtrace_p.h>
+
+#include <algorithm>
+#include <stdio.h>
+
+QT_USE_NAMESPACE
+
+using namespace QLoggingTrace;
+
+struct Site
+{
+    QtMsgType type;
+    int line;
+    QByteArray argumentTypes;
+    QByteArray category;
+    QByteArray file;
+    QByteArray function;
+    QByteArray format;
+};
+
+struct Event
+{
+    quint64 timestamp; // in ticks
+    qint64 threadId;
+    quint32 site;
+    const char *arguments;
+    int size;
+    bool truncated;
+};
+
+struct ClockReference
+{
+    quint64 ticks;
+    qint64 time;
+};
+
+// Converts ticks to nsecs since the start of the trace. Interpolating
+// between the references of all chunks keeps the error of the measured
+// clock rate small, and the conversion monotonic, so that the records of
+// a thread stay in order.
+class Clock
+{
+public:
+    Clock(quint64 ticksPerSecond, QVector<ClockReference> references)
+        : nsecsPerTick(1e9 / double(ticksPerSecond))
+    {
+        std::sort(references.begin(), references.end(),
+                  [](const ClockReference &l, const ClockReference &r) { return l.ticks < r.ticks; });
+        for (const ClockReference &reference : qAsConst(references)) {
+            if (m_references.isEmpty() || (reference.ticks > m_references.last().ticks
+                                           && reference.time > m_references.last().time)) {
+                m_references.append(reference);
+            }
+        }
+    }
+
+    qint64 nsecs(quint64 ticks) const
+    {
+        if (m_references.isEmpty())
+            return qint64(ticks * nsecsPerTick);
+        const auto next = std::upper_bound(m_references.cbegin(), m_references.cend(), ticks,
+                                           [](quint64 t, const ClockReference &r) { return t < r.ticks; });
+        if (next == m_references.cbegin())
+            return next->time - qint64((next->ticks - ticks) * nsecsPerTick);
+        const ClockReference &previous = *(next - 1);
+        if (next == m_references.cend())
+            return previous.time + qint64((ticks - previous.ticks) * nsecsPerTick);
+        return previous.time + qint64(double(ticks - previous.ticks) * (next->time - previous.time)
+                                      / double(next->ticks - previous.ticks));
+    }
+
+private:
+    QVector<ClockReference> m_references;
+    double nsecsPerTick;
+};
+
+template <typename T>
+static T read(const uchar *data)
+{
+    return qFromUnaligned<T>(data);
+}
+
+// Parses the definition of a call site, returns 0 if it is invalid.
+static quint32 readSite(const uchar *data, int size, Site *site)
+{
+    const uchar *end = data + size;
+    if (size < 16)
+        return 0;
+    const quint32 id = read<quint32>(data);
+    site->type = QtMsgType(read<quint32>(data + 4));
+    site->line = read<qint32>(data + 8);
+    const quint32 argumentCount = read<quint32>(data + 12);
+    data += 16;
+    if (quint32(end - data) < argumentCount)
+        return 0;
+    site->argumentTypes = QByteArray(reinterpret_cast<const char *>(data), argumentCount);
+    data += argumentCount;
+
+    QByteArray *strings[] = { &site->category, &site->file, &site->function, &site->format };
+    for (QByteArray *string : strings) {
+        if (end - data < 4)
+            return 0;
+        const quint32 length = read<quint32>(data);
+        data += 4;
+        if (quint32(end - data) < length)
+            return 0;
+        *string = QByteArray(reinterpret_cast<const char *>(data), length);
+        data += length;
+    }
+    return id;
+}
+
+static const char *typeName(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:
+        return "debug";
+    case QtInfoMsg:
+        return "info";
+    case QtWarningMsg:
+        return "warning";
+    case QtCriticalMsg:
+        return "critical";
+    case QtFatalMsg:
+        return "fatal";
+    }
+    return "unknown";
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationVersion(QLatin1String(QT_VERSION_STR));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QLatin1String(
+        "Prints the messages of a trace file written with QT_LOGGING_TRACE, in the order\n"
+        "in which they were logged, one per line: the time, the thread, the type,\n"
+        "the category and the message."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption contextOption(QStringList() << QStringLiteral("c") << QStringLiteral("context"),
+                                     QStringLiteral("Also print the file, line and function of each message."));
+    parser.addOption(contextOption);
+    QCommandLineOption absoluteOption(QStringList() << QStringLiteral("a") << QStringLiteral("absolute"),
+                                      QStringLiteral("Print the date and time of each message, instead of "
+                                                     "the seconds since the start of the trace."));
+    parser.addOption(absoluteOption);
+    parser.addPositionalArgument(QStringLiteral("file"), QStringLiteral("The trace file."));
+    parser.process(app);
+
+    const QStringList files = parser.positionalArguments();
+    if (files.size() != 1)
+        parser.showHelp(1);
+
+    QFile file(files.first());
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "qtracedump: cannot open %s: %s\n", qPrintable(file.fileName()),
+                qPrintable(file.errorString()));
+        return 1;
+    }
+    const qint64 fileSize = file.size();
+    const uchar *data = fileSize ? file.map(0, fileSize) : 0;
+    FileHeader header;
+    if (!data || fileSize < qint64(sizeof(header))) {
+        fprintf(stderr, "qtracedump: %s is not a trace file\n", qPrintable(file.fileName()));
+        return 1;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, "QTLTRACE", sizeof(header.magic)) != 0) {
+        fprintf(stderr, "qtracedump: %s is not a trace file\n", qPrintable(file.fileName()));
+        return 1;
+    }
+    if (header.byteOrder != ByteOrderMark) {
+        fprintf(stderr, "qtracedump: %s was written on a machine with another byte order\n",
+                qPrintable(file.fileName()));
+        return 1;
+    }
+    if (header.version != Version || header.headerSize < sizeof(FileHeader)
+            || header.chunkSize <= sizeof(ChunkHeader) || !header.ticksPerSecond) {
+        fprintf(stderr, "qtracedump: %s has an unsupported version\n", qPrintable(file.fileName()));
+        return 1;
+    }
+
+    QHash<quint32, Site> sites;
+    QVector<Event> events;
+    QVector<ClockReference> references;
+    for (qint64 offset = header.headerSize; offset + header.chunkSize <= fileSize; offset += header.chunkSize) {
+        const uchar *chunk = data + offset;
+        if (read<quint32>(chunk + offsetof(ChunkHeader, magic)) != ChunkMagic)
+            continue;
+        const qint64 threadId = read<qint64>(chunk + offsetof(ChunkHeader, threadId));
+        const quint32 used = qMin(read<quint32>(chunk + offsetof(ChunkHeader, used)), header.chunkSize);
+        const ClockReference reference = {
+            read<quint64>(chunk + offsetof(ChunkHeader, referenceTicks)),
+            read<qint64>(chunk + offsetof(ChunkHeader, referenceTime))
+        };
+        references.append(reference);
+
+        // a record cut short by a crash ends the chunk
+        quint32 position = sizeof(ChunkHeader);
+        while (position + sizeof(RecordHeader) <= used) {
+            const uchar *record = chunk + position;
+            const quint32 size = read<quint32>(record + offsetof(RecordHeader, size));
+            if (size < sizeof(RecordHeader) || size > used - position)
+                break;
+            const quint32 siteField = read<quint32>(record + offsetof(RecordHeader, site));
+            const quint32 site = siteField & ~quint32(RecordHeader::Truncated);
+            const uchar *payload = record + sizeof(RecordHeader);
+            const int payloadSize = int(size - sizeof(RecordHeader));
+            if (site == 0) {
+                Site definition;
+                if (const quint32 id = readSite(payload, payloadSize, &definition))
+                    sites.insert(id, definition);
+            } else {
+                Event event;
+                event.timestamp = read<quint64>(record + offsetof(RecordHeader, timestamp));
+                event.threadId = threadId;
+                event.site = site;
+                event.arguments = reinterpret_cast<const char *>(payload);
+                event.size = payloadSize;
+                event.truncated = siteField & RecordHeader::Truncated;
+                events.append(event);
+            }
+            position += size;
+        }
+    }
+
+    // the chunks of a thread are in the order in which they were written
+    std::stable_sort(events.begin(), events.end(), [](const Event &l, const Event &r) {
+        return l.timestamp < r.timestamp;
+    });
+
+    const bool printContext = parser.isSet(contextOption);
+    const bool printAbsolute = parser.isSet(absoluteOption);
+    const Clock clock(header.ticksPerSecond, references);
+    const QDateTime start = QDateTime::fromMSecsSinceEpoch(header.startTime);
+    for (const Event &event : qAsConst(events)) {
+        const qint64 nsecs = clock.nsecs(event.timestamp);
+        QByteArray time;
+        if (printAbsolute) {
+            time = start.addMSecs(qMax(Q_INT64_C(0), nsecs) / 1000000).toString(Qt::ISODateWithMs).toLatin1();
+        } else {
+            time = QByteArray::number(double(nsecs) / 1e9, 'f', 6);
+            time.prepend(QByteArray(qMax(0, 12 - time.size()), ' '));
+        }
+
+        const auto it = sites.constFind(event.site);
+        if (it == sites.constEnd()) {
+            printf("%s %lld unknown site %u\n", time.constData(), event.threadId, event.site);
+            continue;
+        }
+        const Site &site = *it;
+        const QString message = qt_formatLoggingTrace(site.format.constData(),
+                                                      reinterpret_cast<const uchar *>(site.argumentTypes.constData()),
+                                                      site.argumentTypes.size(), event.arguments, event.size);
+        printf("%s %lld %s %s: %s", time.constData(), event.threadId, typeName(site.type),
+               site.category.constData(), message.toLocal8Bit().constData());
+        if (event.truncated)
+            fputs(" [truncated]", stdout);
+        if (printContext && !site.file.isEmpty())
+            printf(" (%s:%d, %s)", site.file.constData(), site.line, site.function.constData());
+        putchar('\n');
+    }
+    return 0;
+}
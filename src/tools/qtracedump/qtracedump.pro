@@ -0,0 +1,7 @@
+QT = core-private
+
+DEFINES += QT_NO_CAST_FROM_ASCII QT_NO_FOREACH
+
+SOURCES += main.cpp
+
+load(qt_tool)
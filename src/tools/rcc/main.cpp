@@ -127,6 +127,9 @@ int runRcc(int argc, char *argv[])
     QCommandLineOption rootOption(QStringLiteral("root"), QStringLiteral("Prefix resource access path with root path."), QStringLiteral("path"));
     parser.addOption(rootOption);
 
+    QCommandLineOption compressionAlgoOption(QStringLiteral("compress-algo"), QStringLiteral("Compress input files using algorithm <algo> ([zlib], lz4, none)."), QStringLiteral("algo"));
+    parser.addOption(compressionAlgoOption);
+
     QCommandLineOption compressOption(QStringLiteral("compress"), QStringLiteral("Compress input files by <level>."), QStringLiteral("level"));
     parser.addOption(compressOption);
 
@@ -145,6 +148,9 @@ int runRcc(int argc, char *argv[])
     QCommandLineOption namespaceOption(QStringLiteral("namespace"), QStringLiteral("Turn off namespace macros."));
     parser.addOption(namespaceOption);
 
+    QCommandLineOption pathIndexOption(QStringLiteral("path-index"), QStringLiteral("Write a hash table of all resource paths for faster lookup."));
+    parser.addOption(pathIndexOption);
+
     QCommandLineOption verboseOption(QStringLiteral("verbose"), QStringLiteral("Enable verbose mode."));
     parser.addOption(verboseOption);
 
@@ -165,18 +171,25 @@ int runRcc(int argc, char *argv[])
 
     QString errorMsg;
 
-    quint8 formatVersion = 2;
+    RCCResourceLibrary::CompressionAlgorithm compressionAlgo = RCCResourceLibrary::CompressionAlgorithm::Zlib;
+    if (parser.isSet(compressionAlgoOption))
+        compressionAlgo = RCCResourceLibrary::parseCompressionAlgorithm(parser.value(compressionAlgoOption), &errorMsg);
+
+    // LZ4 compressed entries can only be read by runtimes that understand
+    // format version 3, so only write it when LZ4 was asked for.
+    quint8 formatVersion = compressionAlgo == RCCResourceLibrary::CompressionAlgorithm::Lz4 ? 3 : 2;
     if (parser.isSet(formatVersionOption)) {
         bool ok = false;
         formatVersion = parser.value(formatVersionOption).toUInt(&ok);
         if (!ok) {
             errorMsg = QLatin1String("Invalid format version specified");
-        } else if (formatVersion != 1 && formatVersion != 2) {
+        } else if (formatVersion < 1 || formatVersion > 3) {
             errorMsg = QLatin1String("Unsupported format version specified");
         }
     }
 
     RCCResourceLibrary library(formatVersion);
+    library.setCompressionAlgorithm(compressionAlgo);
     if (parser.isSet(nameOption))
         library.setInitName(parser.value(nameOption));
     if (parser.isSet(rootOption)) {
@@ -201,6 +214,8 @@ int runRcc(int argc, char *argv[])
         else
             errorMsg = QLatin1String("Pass number must be 1 or 2");
     }
+    if (parser.isSet(pathIndexOption))
+        library.setUsePathIndex(true);
     if (parser.isSet(namespaceOption))
         library.setUseNameSpace(!library.useNameSpace());
     if (parser.isSet(verboseOption))
@@ -36,9 +36,13 @@
 #include <qfile.h>
 #include <qiodevice.h>
 #include <qlocale.h>
+#include <qset.h>
 #include <qstack.h>
+#include <qvector.h>
 #include <qxmlstream.h>
 
+#include <private/qlz4_p.h>
+
 #include <algorithm>
 
 // Note: A copy of this file is used in Qt Designer (qttools/src/designer/src/lib/shared/rcc.cpp)
@@ -90,13 +94,16 @@ public:
     {
         NoFlags = 0x00,
         Compressed = 0x01,
-        Directory = 0x02
+        Directory = 0x02,
+        CompressedLz4 = 0x04,
+        PathIndex = 0x08
     };
 
     RCCFileInfo(const QString &name = QString(), const QFileInfo &fileInfo = QFileInfo(),
                 QLocale::Language language = QLocale::C,
                 QLocale::Country country = QLocale::AnyCountry,
                 uint flags = NoFlags,
+                RCCResourceLibrary::CompressionAlgorithm compressAlgo = RCCResourceLibrary::CompressionAlgorithm::Zlib,
                 int compressLevel = CONSTANT_COMPRESSLEVEL_DEFAULT,
                 int compressThreshold = CONSTANT_COMPRESSTHRESHOLD_DEFAULT);
     ~RCCFileInfo();
@@ -115,6 +122,7 @@ public:
     QFileInfo m_fileInfo;
     RCCFileInfo *m_parent;
     QHash<QString, RCCFileInfo*> m_children;
+    RCCResourceLibrary::CompressionAlgorithm m_compressAlgo;
     int m_compressLevel;
     int m_compressThreshold;
 
@@ -125,7 +133,7 @@ public:
 
 RCCFileInfo::RCCFileInfo(const QString &name, const QFileInfo &fileInfo,
     QLocale::Language language, QLocale::Country country, uint flags,
-    int compressLevel, int compressThreshold)
+    RCCResourceLibrary::CompressionAlgorithm compressAlgo, int compressLevel, int compressThreshold)
 {
     m_name = name;
     m_fileInfo = fileInfo;
@@ -136,6 +144,7 @@ RCCFileInfo::RCCFileInfo(const QString &name, const QFileInfo &fileInfo,
     m_nameOffset = 0;
     m_dataOffset = 0;
     m_childOffset = 0;
+    m_compressAlgo = compressAlgo;
     m_compressLevel = compressLevel;
     m_compressThreshold = compressThreshold;
 }
@@ -232,19 +241,44 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset,
     }
     QByteArray data = file.readAll();
 
-#ifndef QT_NO_COMPRESS
+    RCCResourceLibrary::CompressionAlgorithm compressAlgo = m_compressAlgo;
+    if (m_compressLevel == 0)
+        compressAlgo = RCCResourceLibrary::CompressionAlgorithm::None;
+    if (compressAlgo == RCCResourceLibrary::CompressionAlgorithm::Lz4 && lib.formatVersion() < 3) {
+        // older runtimes reject unknown compression flags, so don't produce them
+        const QString msg = QString::fromLatin1("RCC: Warning: LZ4 compression requires format version 3, using zlib for '%1'\n")
+                            .arg(m_fileInfo.absoluteFilePath());
+        lib.m_errorDevice->write(msg.toUtf8());
+        compressAlgo = RCCResourceLibrary::CompressionAlgorithm::Zlib;
+    }
+
     // Check if compression is useful for this file
-    if (m_compressLevel != 0 && data.size() != 0) {
-        QByteArray compressed =
-            qCompress(reinterpret_cast<uchar *>(data.data()), data.size(), m_compressLevel);
-
-        int compressRatio = int(100.0 * (data.size() - compressed.size()) / data.size());
-        if (compressRatio >= m_compressThreshold) {
-            data = compressed;
-            m_flags |= Compressed;
+    if (data.size() != 0) {
+        QByteArray compressed;
+        uint compressedFlag = NoFlags;
+        switch (compressAlgo) {
+        case RCCResourceLibrary::CompressionAlgorithm::Lz4:
+            compressed = qLz4Compress(data);
+            compressedFlag = CompressedLz4;
+            break;
+        case RCCResourceLibrary::CompressionAlgorithm::Zlib:
+#ifndef QT_NO_COMPRESS
+            compressed = qCompress(reinterpret_cast<uchar *>(data.data()), data.size(), m_compressLevel);
+            compressedFlag = Compressed;
+#endif
+            break;
+        case RCCResourceLibrary::CompressionAlgorithm::None:
+            break;
+        }
+
+        if (compressedFlag != NoFlags) {
+            int compressRatio = int(100.0 * (data.size() - compressed.size()) / data.size());
+            if (compressRatio >= m_compressThreshold) {
+                data = compressed;
+                m_flags |= compressedFlag;
+            }
         }
     }
-#endif // QT_NO_COMPRESS
 
     // some info
     if (text || pass1) {
@@ -339,7 +373,8 @@ RCCResourceLibrary::Strings::Strings() :
    ATTRIBUTE_PREFIX(QLatin1String("prefix")),
    ATTRIBUTE_ALIAS(QLatin1String("alias")),
    ATTRIBUTE_THRESHOLD(QLatin1String("threshold")),
-   ATTRIBUTE_COMPRESS(QLatin1String("compress"))
+   ATTRIBUTE_COMPRESS(QLatin1String("compress")),
+   ATTRIBUTE_COMPRESSALGO(QLatin1String("compression-algorithm"))
 {
 }
 
@@ -347,12 +382,14 @@ RCCResourceLibrary::RCCResourceLibrary(quint8 formatVersion)
   : m_root(0),
     m_format(C_Code),
     m_verbose(false),
+    m_compressionAlgo(CompressionAlgorithm::Zlib),
     m_compressLevel(CONSTANT_COMPRESSLEVEL_DEFAULT),
     m_compressThreshold(CONSTANT_COMPRESSTHRESHOLD_DEFAULT),
     m_treeOffset(0),
     m_namesOffset(0),
     m_dataOffset(0),
     m_useNameSpace(CONSTANT_USENAMESPACE),
+    m_usePathIndex(false),
     m_errorDevice(0),
     m_outDevice(0),
     m_formatVersion(formatVersion)
@@ -365,6 +402,23 @@ RCCResourceLibrary::~RCCResourceLibrary()
     delete m_root;
 }
 
+RCCResourceLibrary::CompressionAlgorithm RCCResourceLibrary::parseCompressionAlgorithm(const QString &value, QString *errorMsg)
+{
+    if (value == QLatin1String("lz4"))
+        return CompressionAlgorithm::Lz4;
+    if (value == QLatin1String("zlib")) {
+#ifdef QT_NO_COMPRESS
+        *errorMsg = QLatin1String("zlib support not compiled in");
+#else
+        return CompressionAlgorithm::Zlib;
+#endif
+    } else if (value != QLatin1String("none")) {
+        *errorMsg = QString::fromLatin1("Unknown compression algorithm '%1'").arg(value);
+    }
+
+    return CompressionAlgorithm::None;
+}
+
 enum RCCXmlTag {
     RccTag,
     ResourceTag,
@@ -387,6 +441,7 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
     QLocale::Language language = QLocale::c().language();
     QLocale::Country country = QLocale::c().country();
     QString alias;
+    CompressionAlgorithm compressAlgo = m_compressionAlgo;
     int compressLevel = m_compressLevel;
     int compressThreshold = m_compressThreshold;
 
@@ -440,6 +495,15 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
                     if (attributes.hasAttribute(m_strings.ATTRIBUTE_ALIAS))
                         alias = attributes.value(m_strings.ATTRIBUTE_ALIAS).toString();
 
+                    compressAlgo = m_compressionAlgo;
+                    if (attributes.hasAttribute(m_strings.ATTRIBUTE_COMPRESSALGO)) {
+                        QString errorString;
+                        compressAlgo = parseCompressionAlgorithm(attributes.value(m_strings.ATTRIBUTE_COMPRESSALGO).toString(),
+                                                                 &errorString);
+                        if (!errorString.isEmpty())
+                            reader.raiseError(errorString);
+                    }
+
                     compressLevel = m_compressLevel;
                     if (attributes.hasAttribute(m_strings.ATTRIBUTE_COMPRESS))
                         compressLevel = attributes.value(m_strings.ATTRIBUTE_COMPRESS).toString().toInt();
@@ -517,6 +581,7 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
                                             language,
                                             country,
                                             RCCFileInfo::NoFlags,
+                                            compressAlgo,
                                             compressLevel,
                                             compressThreshold)
                                 );
@@ -546,6 +611,7 @@ bool RCCResourceLibrary::interpretResourceFile(QIODevice *inputDevice,
                                                     language,
                                                     country,
                                                     child.isDir() ? RCCFileInfo::Directory : RCCFileInfo::NoFlags,
+                                                    compressAlgo,
                                                     compressLevel,
                                                     compressThreshold)
                                         );
@@ -984,6 +1050,101 @@ struct qt_rcc_compare_hash
     }
 };
 
+// Hashes of a full resource path for the path index. Must match
+// resourcePathHash() and resourceIndexHash() in qresource.cpp.
+static inline quint64 resourcePathHash(const QString &path)
+{
+    quint64 h = Q_UINT64_C(14695981039346656037);
+    for (int i = 0; i < path.size(); ++i) {
+        h ^= path.at(i).unicode();
+        h *= Q_UINT64_C(1099511628211);
+    }
+    return h;
+}
+
+static inline uint resourceIndexHash(quint64 h, uint seed)
+{
+    h += seed * Q_UINT64_C(0x9e3779b97f4a7c15);
+    h ^= h >> 33;
+    h *= Q_UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return uint(h);
+}
+
+/*
+    Builds a perfect hash table mapping each of the \a hashes of the paths
+    to the corresponding entry of \a nodes (hash and displace): the paths
+    are distributed over buckets by their seed 0 hash, and for each bucket,
+    largest first, a seed is searched that moves all of its paths into free
+    slots. Buckets holding a single path are put into the remaining slots
+    directly.
+*/
+static bool buildPathIndex(const QVector<quint64> &hashes, const QVector<quint32> &nodes,
+                           QVector<qint32> *displacements, QVector<quint32> *slotNodes)
+{
+    const uint keyCount = hashes.size();
+    const uint bucketCount = qMax(1u, keyCount / 2);
+
+    // paths with the same hash cannot be told apart by any seed
+    QVector<quint64> sorted = hashes;
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.constBegin(), sorted.constEnd()) != sorted.constEnd())
+        return false;
+
+    QVector<QVector<int> > buckets(bucketCount);
+    for (uint i = 0; i < keyCount; ++i)
+        buckets[resourceIndexHash(hashes.at(i), 0) % bucketCount].append(i);
+
+    QVector<int> order(bucketCount);
+    for (uint i = 0; i < bucketCount; ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&buckets](int l, int r) {
+        return buckets.at(l).size() > buckets.at(r).size();
+    });
+
+    displacements->fill(0, bucketCount);
+    slotNodes->fill(0, keyCount);
+    QVector<bool> used(keyCount, false);
+    QVector<uint> candidates;
+    uint freeSlot = 0;
+    for (int b : qAsConst(order)) {
+        const QVector<int> &bucket = buckets.at(b);
+        if (bucket.isEmpty())
+            break;
+        if (bucket.size() == 1) {
+            while (used.at(freeSlot))
+                ++freeSlot;
+            used[freeSlot] = true;
+            (*slotNodes)[freeSlot] = nodes.at(bucket.first());
+            (*displacements)[b] = -qint32(freeSlot) - 1;
+            continue;
+        }
+
+        qint32 d = 1;
+        for (; d < (1 << 24); ++d) {
+            candidates.clear();
+            for (int key : bucket) {
+                const uint slot = resourceIndexHash(hashes.at(key), d) % keyCount;
+                if (used.at(slot) || candidates.contains(slot))
+                    break;
+                candidates.append(slot);
+            }
+            if (candidates.size() == bucket.size())
+                break;
+        }
+        if (d == (1 << 24))
+            return false;
+        for (int i = 0; i < bucket.size(); ++i) {
+            used[candidates.at(i)] = true;
+            (*slotNodes)[candidates.at(i)] = nodes.at(bucket.at(i));
+        }
+        (*displacements)[b] = d;
+    }
+    return true;
+}
+
 bool RCCResourceLibrary::writeDataStructure()
 {
     if (m_format == C_Code || m_format == Pass1)
@@ -995,12 +1156,21 @@ bool RCCResourceLibrary::writeDataStructure()
     if (!m_root)
         return false;
 
+    // for the path index: the parent of each node and the nodes by path
+    QVector<quint32> parents(1, 0);
+    QVector<quint64> pathHashes;
+    QVector<quint32> pathNodes;
+    QHash<const RCCFileInfo *, QPair<QString, int> > directories;
+    QSet<QString> indexedPaths;
+    directories.insert(m_root, qMakePair(QString(), 0));
+
     //calculate the child offsets (flat)
     pending.push(m_root);
     int offset = 1;
     while (!pending.isEmpty()) {
         RCCFileInfo *file = pending.pop();
         file->m_childOffset = offset;
+        const QPair<QString, int> parent = directories.value(file);
 
         //sort by hash value for binary lookup
         QList<RCCFileInfo*> m_children = file->m_children.values();
@@ -1009,12 +1179,35 @@ bool RCCResourceLibrary::writeDataStructure()
         //write out the actual data now
         for (int i = 0; i < m_children.size(); ++i) {
             RCCFileInfo *child = m_children.at(i);
+            if (m_usePathIndex) {
+                const QString path = parent.first + QLatin1Char('/') + child->m_name;
+                parents.append(parent.second);
+                // localized variants share their path, any of them will do
+                if (!indexedPaths.contains(path)) {
+                    indexedPaths.insert(path);
+                    pathHashes.append(resourcePathHash(path));
+                    pathNodes.append(offset);
+                }
+                if (child->m_flags & RCCFileInfo::Directory)
+                    directories.insert(child, qMakePair(path, offset));
+            }
             ++offset;
             if (child->m_flags & RCCFileInfo::Directory)
                 pending.push(child);
         }
     }
 
+    // the path index follows the nodes, its offset is stored as the name of the root
+    QVector<qint32> displacements;
+    QVector<quint32> slotNodes;
+    const bool pathIndex = m_usePathIndex && buildPathIndex(pathHashes, pathNodes, &displacements, &slotNodes);
+    if (m_usePathIndex && !pathIndex)
+        m_errorDevice->write("RCC: Warning: Could not build the path index, writing resources without it\n");
+    if (pathIndex) {
+        m_root->m_flags |= RCCFileInfo::PathIndex;
+        m_root->m_nameOffset = offset * (14 + (m_formatVersion >= 2 ? 8 : 0));
+    }
+
     //write out the structure (ie iterate again!)
     pending.push(m_root);
     m_root->writeDataInfo(*this);
@@ -1033,6 +1226,26 @@ bool RCCResourceLibrary::writeDataStructure()
                 pending.push(child);
         }
     }
+
+    if (pathIndex) {
+        const bool text = m_format == C_Code || m_format == Pass1;
+        if (text)
+            writeString("  // path index\n  ");
+        writeNumber4(slotNodes.size());
+        writeNumber4(displacements.size());
+        QVector<quint32> table;
+        table.reserve(displacements.size() + slotNodes.size() + parents.size());
+        for (qint32 d : qAsConst(displacements))
+            table.append(quint32(d));
+        table += slotNodes;
+        table += parents;
+        for (int i = 0; i < table.size(); ++i) {
+            if (text && i % 4 == 0)
+                writeString("\n  ");
+            writeNumber4(table.at(i));
+        }
+    }
+
     if (m_format == C_Code || m_format == Pass1)
         writeString("\n};\n\n");
 
@@ -56,6 +56,7 @@ public:
     bool readFiles(bool ignoreErrors, QIODevice &errorDevice);
 
     enum Format { Binary, C_Code, Pass1, Pass2 };
+    enum class CompressionAlgorithm { Zlib, Lz4, None = -1 };
     void setFormat(Format f) { m_format = f; }
     Format format() const { return m_format; }
 
@@ -77,6 +78,11 @@ public:
     void setOutputName(const QString &name) { m_outputName = name; }
     QString outputName() const { return m_outputName; }
 
+    void setCompressionAlgorithm(CompressionAlgorithm algo) { m_compressionAlgo = algo; }
+    CompressionAlgorithm compressionAlgorithm() const { return m_compressionAlgo; }
+
+    static CompressionAlgorithm parseCompressionAlgorithm(const QString &algo, QString *errorMsg);
+
     void setCompressLevel(int c) { m_compressLevel = c; }
     int compressLevel() const { return m_compressLevel; }
 
@@ -89,6 +95,9 @@ public:
     void setUseNameSpace(bool v) { m_useNameSpace = v; }
     bool useNameSpace() const { return m_useNameSpace; }
 
+    void setUsePathIndex(bool v) { m_usePathIndex = v; }
+    bool usePathIndex() const { return m_usePathIndex; }
+
     QStringList failedResources() const { return m_failedResources; }
 
     int formatVersion() const { return m_formatVersion; }
@@ -104,6 +113,7 @@ private:
         const QString ATTRIBUTE_ALIAS;
         const QString ATTRIBUTE_THRESHOLD;
         const QString ATTRIBUTE_COMPRESS;
+        const QString ATTRIBUTE_COMPRESSALGO;
     };
     friend class RCCFileInfo;
     void reset();
@@ -133,12 +143,14 @@ private:
     QString m_outputName;
     Format m_format;
     bool m_verbose;
+    CompressionAlgorithm m_compressionAlgo;
     int m_compressLevel;
     int m_compressThreshold;
     int m_treeOffset;
     int m_namesOffset;
     int m_dataOffset;
     bool m_useNameSpace;
+    bool m_usePathIndex;
     QStringList m_failedResources;
     QIODevice *m_errorDevice;
     QIODevice *m_outDevice;
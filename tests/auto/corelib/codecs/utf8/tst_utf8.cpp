@@ -33,6 +33,17 @@
 
 static const char utf8bom[] = "\xEF\xBB\xBF";
 
+// longer than two 16-byte SIMD blocks, mixing 1-, 2- and 3-byte sequences
+static const char mixedUtf8[] =
+    "Gr\xc3\xbc\xc3\x9f" "e aus K\xc3\xb6ln \xe2\x80\x93 \xd0\x94\xd0\xbe\xd0\xb1\xd1\x80\xd1\x8b"
+    "\xd0\xb9 \xd0\xb4\xd0\xb5\xd0\xbd\xd1\x8c, \xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae"
+    "\xe6\x96\x87\xe7\xab\xa0 \xe2\x82\xac" "12";
+static const ushort mixedUtf16[] = {
+    'G', 'r', 0x00fc, 0x00df, 'e', ' ', 'a', 'u', 's', ' ', 'K', 0x00f6, 'l', 'n', ' ', 0x2013,
+    ' ', 0x0414, 0x043e, 0x0431, 0x0440, 0x044b, 0x0439, ' ', 0x0434, 0x0435, 0x043d, 0x044c,
+    ',', ' ', 0x65e5, 0x672c, 0x8a9e, 0x306e, 0x6587, 0x7ae0, ' ', 0x20ac, '1', '2', 0
+};
+
 class tst_Utf8 : public QObject
 {
     Q_OBJECT
@@ -59,6 +70,9 @@ private slots:
     void invalidUtf8_data();
     void invalidUtf8();
 
+    void invalidUtf8AfterValid_data();
+    void invalidUtf8AfterValid();
+
     void nonCharacters_data();
     void nonCharacters();
 };
@@ -145,6 +159,25 @@ void tst_Utf8::roundTrip_data()
                                     ' ', 0x10FFFD, ' ',
                                     0x20AC, 'd', 'e', 'f', 0 };
     QTest::newRow("utf8_8") << QByteArray(utf8_8) << QString::fromUcs4(utf32_8);
+
+    // the same with 4-byte sequences, which are surrogate pairs in UTF-16
+    static const char utf8_9[] = "Emoji \xf0\x9f\x98\x80 in Gr\xc3\xbc\xc3\x9f" "e \xe2\x80\x93 "
+                                 "\xe6\x97\xa5\xe6\x9c\xac\xf0\x9f\x98\x80\xe2\x82\xac and "
+                                 "\xf0\x9d\x84\x9e clef";
+    static const ushort utf16_9[] = { 'E', 'm', 'o', 'j', 'i', ' ', 0xd83d, 0xde00, ' ', 'i',
+                                      'n', ' ', 'G', 'r', 0x00fc, 0x00df, 'e', ' ', 0x2013, ' ',
+                                      0x65e5, 0x672c, 0xd83d, 0xde00, 0x20ac, ' ', 'a', 'n', 'd',
+                                      ' ', 0xd834, 0xdd1e, ' ', 'c', 'l', 'e', 'f', 0 };
+
+    // start the long strings at every offset of a 16-byte block
+    for (int i = 0; i < 16; ++i) {
+        const QByteArray prefix(i, 'x');
+        const QString prefix16(i, QLatin1Char('x'));
+        QTest::newRow(("mixed-" + QByteArray::number(i)).constData())
+                << prefix + mixedUtf8 << prefix16 + QString::fromUtf16(mixedUtf16);
+        QTest::newRow(("utf8_9-" + QByteArray::number(i)).constData())
+                << prefix + utf8_9 << prefix16 + QString::fromUtf16(utf16_9);
+    }
 }
 
 void tst_Utf8::roundTrip()
@@ -232,6 +265,47 @@ void tst_Utf8::invalidUtf8()
         qWarning("System codec does not report failure when it should. Should report bug upstream.");
 }
 
+void tst_Utf8::invalidUtf8AfterValid_data()
+{
+    invalidUtf8_data();
+
+    QTest::newRow("overlong-c0") << QByteArray("\xC0\x80");
+    QTest::newRow("overlong-c1") << QByteArray("\xC1\xBF");
+    QTest::newRow("overlong-e0") << QByteArray("\xE0\x9F\xBF");
+    QTest::newRow("surrogate-ed-bf") << QByteArray("\xED\xBF\xBF");
+    QTest::newRow("4chars-f5") << QByteArray("\xF5\x80\x80\x80");
+    QTest::newRow("continuation") << QByteArray("\x80\x80");
+    QTest::newRow("truncated-2") << QByteArray("\xC3");
+    QTest::newRow("truncated-3-1") << QByteArray("\xE2");
+    QTest::newRow("truncated-3-2") << QByteArray("\xE2\x82");
+    QTest::newRow("truncated-4-3") << QByteArray("\xF0\x9F\x98");
+}
+
+void tst_Utf8::invalidUtf8AfterValid()
+{
+    QFETCH(QByteArray, utf8);
+    QFETCH_GLOBAL(bool, useLocale);
+    if (useLocale)
+        QSKIP("Only enforced on our UTF-8 decoder");
+
+    // the sequence alone is too short for the SIMD code
+    utf8 += "tail";
+    const QString expected = codec->toUnicode(utf8);
+
+    // move it through the 16-byte blocks, after more valid text than that
+    for (int i = 0; i < 16; ++i) {
+        const QByteArray prefix = mixedUtf8 + QByteArray(i, 'x');
+        const QString prefix16 = QString::fromUtf16(mixedUtf16) + QString(i, QLatin1Char('x'));
+
+        QCOMPARE(from8Bit(prefix + utf8), prefix16 + expected);
+
+        const QScopedPointer<QTextDecoder> decoder(codec->makeDecoder());
+        const QString decoded = decoder->toUnicode(prefix + utf8 + mixedUtf8);
+        QVERIFY(decoder->hasFailure());
+        QCOMPARE(decoded, prefix16 + expected + QString::fromUtf16(mixedUtf16));
+    }
+}
+
 void tst_Utf8::nonCharacters_data()
 {
     QTest::addColumn<QByteArray>("utf8");
@@ -28,6 +28,7 @@
 
 #include <QCoreApplication>
 #include <QLoggingCategory>
+#include <QThread>
 
 #ifdef Q_CC_GNU
 #define NEVER_INLINE __attribute__((__noinline__))
@@ -60,11 +61,71 @@ void MyClass::myFunction(int a)
     qDebug() << "from_a_function" << a;
 }
 
+class LoggingThread : public QThread
+{
+public:
+    LoggingThread(int id, int count) : id(id), count(count) {}
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < count; ++i)
+            qDebug("thread %d message %d", id, i);
+    }
+
+private:
+    int id;
+    int count;
+};
+
+// Used with QT_LOGGING_ASYNC set
+static int logFromThreads(int threadCount, int count)
+{
+    qDebug("start");
+    QList<LoggingThread *> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.append(new LoggingThread(i, count));
+        threads.last()->start();
+    }
+    for (LoggingThread *thread : qAsConst(threads)) {
+        thread->wait();
+        delete thread;
+    }
+    qDebug("end");
+    return 0;
+}
+
+// Used with QT_LOGGING_ASYNC set; the file and function are gone before
+// the messages are written
+static int logWithTemporaryContext()
+{
+    qSetMessagePattern("%{file}:%{line} %{function} %{message}");
+    for (int i = 1; i <= 100; ++i) {
+        QByteArray file = "script" + QByteArray::number(i) + ".qml";
+        QByteArray function = "onClicked" + QByteArray::number(i);
+        QMessageLogger(file.constData(), i, function.constData()).debug("hello %d", i);
+        file.fill('X');
+        function.fill('X');
+    }
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
     QCoreApplication app(argc, argv);
     app.setApplicationName("tst_qlogging");
 
+    const QByteArray mode = argc > 1 ? argv[1] : "";
+    if (mode == "threads")
+        return logFromThreads(4, 3000);
+    if (mode == "context")
+        return logWithTemporaryContext();
+    if (mode == "fatal") {
+        for (int i = 0; i < 100; ++i)
+            qDebug("message %d", i);
+        qFatal("fatal");
+    }
+
     qSetMessagePattern("[%{type}] %{message}");
 
     qDebug("qDebug");
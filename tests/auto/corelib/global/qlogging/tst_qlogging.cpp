@@ -60,10 +60,17 @@ private slots:
     void qMessagePattern();
     void setMessagePattern();
 
+    void asyncOrdering();
+    void asyncDropCount();
+    void asyncFatal();
+    void asyncTemporaryContext();
+
     void formatLogMessage_data();
     void formatLogMessage();
 
 private:
+    QList<QByteArray> runAsync(const QByteArray &policy, const QString &mode);
+
     QString m_appDir;
     QStringList m_baseEnvironment;
 };
@@ -722,16 +729,16 @@ void tst_qmessagehandler::qMessagePattern_data()
 
     // %{file} is tricky because of shadow builds
     QTest::newRow("basic") << "%{type} %{appname} %{line} %{function} %{message}" << true << (QList<QByteArray>()
-            << "debug  39 T::T static constructor"
+            << "debug  40 T::T static constructor"
             //  we can't be sure whether the QT_MESSAGE_PATTERN is already destructed
             << "static destructor"
-            << "debug tst_qlogging 60 MyClass::myFunction from_a_function 34"
-            << "debug tst_qlogging 70 main qDebug"
-            << "info tst_qlogging 71 main qInfo"
-            << "warning tst_qlogging 72 main qWarning"
-            << "critical tst_qlogging 73 main qCritical"
-            << "warning tst_qlogging 76 main qDebug with category"
-            << "debug tst_qlogging 80 main qDebug2");
+            << "debug tst_qlogging 61 MyClass::myFunction from_a_function 34"
+            << "debug tst_qlogging 131 main qDebug"
+            << "info tst_qlogging 132 main qInfo"
+            << "warning tst_qlogging 133 main qWarning"
+            << "critical tst_qlogging 134 main qCritical"
+            << "warning tst_qlogging 137 main qDebug with category"
+            << "debug tst_qlogging 141 main qDebug2");
 
 
     QTest::newRow("invalid") << "PREFIX: %{unknown} %{message}" << false << (QList<QByteArray>()
@@ -897,6 +904,129 @@ void tst_qmessagehandler::setMessagePattern()
 #endif // QT_CONFIG(process)
 }
 
+QList<QByteArray> tst_qmessagehandler::runAsync(const QByteArray &policy, const QString &mode)
+{
+    QList<QByteArray> lines;
+#if QT_CONFIG(process)
+    QProcess process;
+    const QString appExe = m_appDir + "/app";
+    QStringList environment = m_baseEnvironment;
+    environment.prepend("QT_LOGGING_ASYNC=" + QString::fromLatin1(policy));
+    process.setEnvironment(environment);
+
+    process.start(appExe, QStringList(mode));
+    if (!process.waitForStarted()) {
+        qWarning("Could not start %s: %s", qPrintable(appExe), qPrintable(process.errorString()));
+        return lines;
+    }
+    process.waitForFinished();
+
+    QByteArray output = process.readAllStandardError();
+#ifdef Q_OS_WIN
+    output.replace("\r\n", "\n");
+#endif
+    lines = output.split('\n');
+    if (lines.last().isEmpty())
+        lines.removeLast();
+#else
+    Q_UNUSED(policy);
+    Q_UNUSED(mode);
+#endif
+    return lines;
+}
+
+void tst_qmessagehandler::asyncOrdering()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+    const QList<QByteArray> lines = runAsync("1", "threads");
+
+    // the writer waits for nothing to be lost, and keeps the order of the calls
+    QCOMPARE(lines.count(), 1 + 4 * 3000 + 2 + 1);
+    QCOMPARE(lines.first(), QByteArray("static constructor"));
+    QCOMPARE(lines.at(1), QByteArray("start"));
+    QCOMPARE(lines.at(lines.count() - 2), QByteArray("end"));
+    QCOMPARE(lines.last(), QByteArray("static destructor"));
+
+    int next[4] = { 0, 0, 0, 0 };
+    for (int i = 2; i < lines.count() - 2; ++i) {
+        int thread, message;
+        QVERIFY2(sscanf(lines.at(i).constData(), "thread %d message %d", &thread, &message) == 2,
+                 lines.at(i).constData());
+        QVERIFY(thread >= 0 && thread < 4);
+        QCOMPARE(message, next[thread]);
+        ++next[thread];
+    }
+#endif
+}
+
+void tst_qmessagehandler::asyncDropCount()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+    const QList<QByteArray> lines = runAsync("drop", "threads");
+    QVERIFY(lines.count() >= 4);
+    QCOMPARE(lines.first(), QByteArray("static constructor"));
+    QVERIFY(lines.contains("static destructor"));
+
+    // what is not written is counted
+    int written = 0;
+    int dropped = 0;
+    int next[4] = { 0, 0, 0, 0 };
+    for (const QByteArray &line : lines) {
+        int thread, message, n;
+        if (sscanf(line.constData(), "thread %d message %d", &thread, &message) == 2) {
+            QVERIFY(thread >= 0 && thread < 4);
+            QVERIFY(message >= next[thread]);
+            next[thread] = message + 1;
+            ++written;
+        } else if (sscanf(line.constData(), "QT_LOGGING_ASYNC: dropped %d messages", &n) == 1) {
+            QVERIFY(n > 0);
+            dropped += n;
+        }
+    }
+    QCOMPARE(written + dropped, 4 * 3000);
+#endif
+}
+
+void tst_qmessagehandler::asyncFatal()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+    // messages logged before a fatal one are written before it
+    QList<QByteArray> expected;
+    expected << "static constructor";
+    for (int i = 0; i < 100; ++i)
+        expected << "message " + QByteArray::number(i);
+    expected << "fatal";
+
+    const QList<QByteArray> lines = runAsync("1", "fatal");
+    QCOMPARE(lines.mid(0, expected.count()), expected);
+#endif
+}
+
+void tst_qmessagehandler::asyncTemporaryContext()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+    // the file and function are copied when the message is logged
+    QList<QByteArray> messages;
+    for (const QByteArray &line : runAsync("1", "context")) {
+        if (line.contains("hello"))
+            messages << line;
+    }
+    QCOMPARE(messages.count(), 100);
+    for (int i = 1; i <= 100; ++i) {
+        const QByteArray n = QByteArray::number(i);
+        QCOMPARE(messages.at(i - 1), "script" + n + ".qml:" + n + " onClicked" + n + " hello " + n);
+    }
+#endif
+}
+
 Q_DECLARE_METATYPE(QtMsgType)
 
 void tst_qmessagehandler::formatLogMessage_data()
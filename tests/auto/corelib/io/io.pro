@@ -19,6 +19,7 @@ SUBDIRS=\
     qlockfile \
     qloggingcategory \
     qloggingregistry \
+    qloggingtrace \
     qnodebug \
     qprocess \
     qprocess-noapplication \
@@ -69,6 +70,7 @@ win32:!qtConfig(private_tests): SUBDIRS -= \
     qprocessenvironment
 
 !qtConfig(process): SUBDIRS -= \
+    qloggingtrace \
     qprocess \
     qprocess-noapplication
 
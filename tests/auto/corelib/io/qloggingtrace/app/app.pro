@@ -0,0 +1,12 @@
+TEMPLATE = app
+
+TARGET = app
+QT = core
+
+DESTDIR = ./
+
+CONFIG -= app_bundle
+CONFIG += console
+
+SOURCES += main.cpp
+DEFINES += QT_MESSAGELOGCONTEXT
@@ -0,0 +1,81 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <QThread>
+#include <QVector>
+#include <qloggingtrace.h>
+
+Q_LOGGING_CATEGORY(lcApp, "test.app")
+Q_LOGGING_CATEGORY(lcThreads, "test.threads")
+
+enum Color { Red, Green, Blue };
+
+static const int threadCount = 4;
+static const int messagesPerThread = 5000; // enough to fill more than one chunk
+
+class TracingThread : public QThread
+{
+public:
+    explicit TracingThread(int index) : index(index) {}
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < messagesPerThread; ++i)
+            qCTraceDebug(lcThreads, "thread %1 message %2", index, i);
+    }
+
+private:
+    int index;
+};
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    qCTraceDebug(lcApp, "no arguments");
+    qCTraceInfo(lcApp, "numbers %1 %2 %3 %4 %5", -42, 42u, -Q_INT64_C(1099511627776), 2.5, true);
+    qCTraceWarning(lcApp, "strings %1 %2 %3 %4", "utf8 \xc3\xa9", QByteArray("bytes"),
+                   QLatin1String("latin1"), QString::fromUtf8("utf16 \xc3\xa9"));
+    qCTraceCritical(lcApp, "enum %1 pointer %2", Blue, reinterpret_cast<void *>(0x1234));
+    // larger than a chunk
+    qCTraceDebug(lcApp, "large %1 %2 %3", 1, QByteArray(100000, 'x'), 3);
+
+    QVector<TracingThread *> threads;
+    for (int i = 0; i < threadCount; ++i)
+        threads.append(new TracingThread(i));
+    for (TracingThread *thread : qAsConst(threads))
+        thread->start();
+    for (TracingThread *thread : qAsConst(threads))
+        thread->wait();
+    qDeleteAll(threads);
+
+    qCTraceDebug(lcApp, "done");
+    return 0;
+}
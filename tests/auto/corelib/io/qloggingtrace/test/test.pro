@@ -0,0 +1,8 @@
+CONFIG += testcase
+CONFIG -= debug_and_release_target
+TARGET = ../tst_qloggingtrace
+QT = core testlib
+SOURCES = ../tst_qloggingtrace.cpp
+
+DEFINES += QT_MESSAGELOGCONTEXT
+TEST_HELPER_INSTALLS = ../app/app
@@ -0,0 +1,237 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtTest>
+#include <QLoggingCategory>
+#include <qloggingtrace.h>
+
+Q_LOGGING_CATEGORY(lcTest, "test.trace")
+
+struct Message
+{
+    QtMsgType type;
+    QByteArray category;
+    QString text;
+    int line;
+};
+
+static QVector<Message> s_messages;
+
+static void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &text)
+{
+    const Message message = { type, context.category, text, context.line };
+    s_messages.append(message);
+}
+
+class tst_QLoggingTrace : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void textOutput();
+    void disabledCategory();
+    void placeholders();
+    void binaryTrace();
+    void truncatedTrace();
+
+private:
+    QString m_appDir;
+    QString m_dump;
+    QTemporaryDir m_dir;
+};
+
+void tst_QLoggingTrace::initTestCase()
+{
+    // messages of this process go to the message handler
+    qunsetenv("QT_LOGGING_TRACE");
+
+    QVERIFY(m_dir.isValid());
+    m_appDir = QFINDTESTDATA("app");
+    QVERIFY2(!m_appDir.isEmpty(), qPrintable(
+        QString::fromLatin1("Couldn't find helper app dir starting from %1.").arg(QDir::currentPath())));
+    m_dump = QLibraryInfo::location(QLibraryInfo::BinariesPath) + QLatin1String("/qtracedump");
+}
+
+void tst_QLoggingTrace::cleanup()
+{
+    qInstallMessageHandler(0);
+    s_messages.clear();
+}
+
+void tst_QLoggingTrace::textOutput()
+{
+    qInstallMessageHandler(messageHandler);
+
+    const int line = __LINE__ + 1;
+    qCTraceDebug(lcTest, "int %1 string %2", 42, QStringLiteral("text"));
+    qCTraceWarning(lcTest, "%1 %2 %3", true, "utf8", -1.5);
+
+    QCOMPARE(s_messages.size(), 2);
+    QCOMPARE(s_messages.at(0).type, QtDebugMsg);
+    QCOMPARE(s_messages.at(0).category, QByteArray("test.trace"));
+    QCOMPARE(s_messages.at(0).text, QString::fromLatin1("int 42 string text"));
+    QCOMPARE(s_messages.at(0).line, line);
+    QCOMPARE(s_messages.at(1).type, QtWarningMsg);
+    QCOMPARE(s_messages.at(1).text, QString::fromLatin1("true utf8 -1.5"));
+}
+
+void tst_QLoggingTrace::disabledCategory()
+{
+    qInstallMessageHandler(messageHandler);
+
+    QLoggingCategory category("test.trace.disabled");
+    category.setEnabled(QtDebugMsg, false);
+    qCTraceDebug(category, "not logged %1", 1);
+    QVERIFY(s_messages.isEmpty());
+
+    category.setEnabled(QtDebugMsg, true);
+    qCTraceDebug(category, "logged %1", 1);
+    QCOMPARE(s_messages.size(), 1);
+    QCOMPARE(s_messages.at(0).text, QString::fromLatin1("logged 1"));
+}
+
+void tst_QLoggingTrace::placeholders()
+{
+    qInstallMessageHandler(messageHandler);
+
+    qCTraceDebug(lcTest, "%2 before %1, 100%, %3 is missing", 1, 2);
+    qCTraceDebug(lcTest, "%10 %1%0", 1, 2, 3, 4, 5, 6, 7, 8, 9, 10);
+
+    QCOMPARE(s_messages.size(), 2);
+    QCOMPARE(s_messages.at(0).text, QString::fromLatin1("2 before 1, 100%, %3 is missing"));
+    QCOMPARE(s_messages.at(1).text, QString::fromLatin1("10 1%0"));
+}
+
+static QStringList dump(const QString &program, const QStringList &arguments, int *exitCode)
+{
+    QProcess process;
+    process.start(program, arguments);
+    if (!process.waitForFinished(60000)) {
+        process.kill();
+        *exitCode = -1;
+        return QStringList();
+    }
+    *exitCode = process.exitStatus() == QProcess::NormalExit ? process.exitCode() : -1;
+    return QString::fromLocal8Bit(process.readAllStandardOutput()).split(QLatin1Char('\n'), QString::SkipEmptyParts);
+}
+
+void tst_QLoggingTrace::binaryTrace()
+{
+    if (!QFile::exists(m_dump))
+        QSKIP("qtracedump is not available");
+
+    QProcess app;
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert(QStringLiteral("QT_LOGGING_TRACE"), m_dir.filePath(QStringLiteral("trace-%p.bin")));
+    app.setProcessEnvironment(environment);
+    app.start(m_appDir + QLatin1String("/app"));
+    QVERIFY2(app.waitForStarted(), qPrintable(app.errorString()));
+    const qint64 pid = app.processId();
+    QVERIFY(app.waitForFinished(60000));
+    QCOMPARE(app.exitCode(), 0);
+    // nothing is formatted while tracing
+    QCOMPARE(app.readAllStandardError(), QByteArray());
+
+    const QString traceFile = m_dir.filePath(QString::fromLatin1("trace-%1.bin").arg(pid));
+    QVERIFY2(QFile::exists(traceFile), qPrintable(traceFile));
+
+    int exitCode;
+    const QStringList lines = dump(m_dump, QStringList() << QStringLiteral("-c") << traceFile, &exitCode);
+    QCOMPARE(exitCode, 0);
+
+    // time, thread, type, category: message (file:line, function)
+    const QRegularExpression format(QStringLiteral("^ *(\\d+\\.\\d{6}) (\\d+) (\\w+) ([\\w.]+): (.*) \\((.*):(\\d+), (.*)\\)$"));
+    QStringList appMessages;
+    QHash<QString, int> nextMessage; // per thread
+    int threadMessages = 0;
+    double lastTime = 0;
+    for (const QString &line : lines) {
+        const QRegularExpressionMatch match = format.match(line);
+        QVERIFY2(match.hasMatch(), qPrintable(line));
+        const double time = match.captured(1).toDouble();
+        QVERIFY(time >= lastTime);
+        lastTime = time;
+        QVERIFY(match.captured(6).endsWith(QLatin1String("main.cpp")));
+        QVERIFY(match.captured(8).contains(QLatin1String("run")) || match.captured(8).contains(QLatin1String("main")));
+
+        if (match.captured(4) == QLatin1String("test.threads")) {
+            const QStringList words = match.captured(5).split(QLatin1Char(' '));
+            QCOMPARE(words.size(), 4);
+            QCOMPARE(match.captured(3), QString::fromLatin1("debug"));
+            // every thread's messages are complete and in order
+            const QString thread = match.captured(2) + QLatin1Char('/') + words.at(1);
+            QCOMPARE(words.at(3).toInt(), nextMessage.value(thread));
+            nextMessage[thread] = words.at(3).toInt() + 1;
+            ++threadMessages;
+        } else {
+            QCOMPARE(match.captured(4), QString::fromLatin1("test.app"));
+            appMessages << match.captured(3) + QLatin1Char(' ') + match.captured(5);
+        }
+    }
+
+    QCOMPARE(threadMessages, 4 * 5000);
+    QCOMPARE(nextMessage.size(), 4);
+    const QStringList expected = QStringList()
+            << QStringLiteral("debug no arguments")
+            << QStringLiteral("info numbers -42 42 -1099511627776 2.5 true")
+            << QString::fromUtf8("warning strings utf8 \xc3\xa9 bytes latin1 utf16 \xc3\xa9")
+            << QStringLiteral("critical enum 2 pointer 0x1234")
+            << QStringLiteral("debug large 1   [truncated]")
+            << QStringLiteral("debug done");
+    QCOMPARE(appMessages.size(), expected.size());
+    // qtracedump writes in the local 8-bit encoding
+    for (int i = 0; i < expected.size(); ++i)
+        QCOMPARE(appMessages.at(i), QString::fromLocal8Bit(expected.at(i).toLocal8Bit()));
+}
+
+void tst_QLoggingTrace::truncatedTrace()
+{
+    if (!QFile::exists(m_dump))
+        QSKIP("qtracedump is not available");
+
+    const QStringList traces = QDir(m_dir.path()).entryList(QStringList() << QStringLiteral("trace-*.bin"));
+    if (traces.isEmpty())
+        QSKIP("binaryTrace() did not write a trace");
+    const QString traceFile = m_dir.filePath(traces.first());
+
+    // like a trace of a process that was killed while writing
+    QFile file(traceFile);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(64 + 64 * 1024 + 1000));
+    file.close();
+
+    int exitCode;
+    const QStringList lines = dump(m_dump, QStringList() << traceFile, &exitCode);
+    QCOMPARE(exitCode, 0);
+    QVERIFY(!lines.isEmpty());
+}
+
+QTEST_MAIN(tst_QLoggingTrace)
+#include "tst_qloggingtrace.moc"
@@ -8,15 +8,22 @@ RESOURCES += testqrc/test.qrc
 qtPrepareTool(QMAKE_RCC, rcc, _DEP)
 runtime_resource.target = runtime_resource.rcc
 runtime_resource.depends = $$PWD/testqrc/test.qrc $$QMAKE_RCC_EXE
-runtime_resource.commands = $$QMAKE_RCC -root /runtime_resource/ -binary $$PWD/testqrc/test.qrc -o $${runtime_resource.target}
+runtime_resource.commands = $$QMAKE_RCC -root /runtime_resource/ -path-index -binary $$PWD/testqrc/test.qrc -o $${runtime_resource.target}
 QMAKE_EXTRA_TARGETS = runtime_resource
 PRE_TARGETDEPS += $${runtime_resource.target}
 QMAKE_DISTCLEAN += $${runtime_resource.target}
 
+lz4_resource.target = lz4_resource.rcc
+lz4_resource.depends = $$PWD/testqrc/test.qrc $$QMAKE_RCC_EXE
+lz4_resource.commands = $$QMAKE_RCC -root /lz4_resource/ -compress-algo lz4 -binary $$PWD/testqrc/test.qrc -o $${lz4_resource.target}
+QMAKE_EXTRA_TARGETS += lz4_resource
+PRE_TARGETDEPS += $${lz4_resource.target}
+QMAKE_DISTCLEAN += $${lz4_resource.target}
+
 TESTDATA += \
     parentdir.txt \
     testqrc/*
-GENERATED_TESTDATA = $${runtime_resource.target}
+GENERATED_TESTDATA = $${runtime_resource.target} $${lz4_resource.target}
 
 android {
     RESOURCES += android_testdata.qrc
@@ -37,9 +37,11 @@ class tst_QResourceEngine: public QObject
 public:
     tst_QResourceEngine()
 #if defined(Q_OS_ANDROID)
-        : m_runtimeResourceRcc(QFileInfo(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/runtime_resource.rcc")).absoluteFilePath())
+        : m_runtimeResourceRcc(QFileInfo(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/runtime_resource.rcc")).absoluteFilePath()),
+          m_lz4ResourceRcc(QFileInfo(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/lz4_resource.rcc")).absoluteFilePath())
 #else
-        : m_runtimeResourceRcc(QFINDTESTDATA("runtime_resource.rcc"))
+        : m_runtimeResourceRcc(QFINDTESTDATA("runtime_resource.rcc")),
+          m_lz4ResourceRcc(QFINDTESTDATA("lz4_resource.rcc"))
 #endif
     {}
 
@@ -56,9 +58,11 @@ private slots:
     void doubleSlashInRoot();
     void setLocale();
     void lastModified();
+    void lz4CompressedResource();
 
 private:
     const QString m_runtimeResourceRcc;
+    const QString m_lz4ResourceRcc;
 };
 
 
@@ -504,6 +508,42 @@ void tst_QResourceEngine::lastModified()
     }
 }
 
+void tst_QResourceEngine::lz4CompressedResource()
+{
+    QVERIFY(!m_lz4ResourceRcc.isEmpty());
+    QVERIFY(QResource::registerResource(m_lz4ResourceRcc));
+
+    QFile original(QFINDTESTDATA("testqrc/aliasdir/compressme.txt"));
+    QVERIFY(original.open(QFile::ReadOnly));
+    const QByteArray contents = original.readAll();
+
+    QLocale::setDefault(QLocale("de_CH"));
+    {
+        const QString fileName = QStringLiteral(":/lz4_resource/aliasdir/aliasdir.txt");
+        QResource resource(fileName);
+        QCOMPARE(resource.compressionAlgorithm(), QResource::Lz4Compression);
+        QCOMPARE(resource.uncompressedData(), contents);
+
+        // the file is uncompressed as far as it is read
+        QFile file(fileName);
+        QVERIFY(file.open(QFile::ReadOnly));
+        QCOMPARE(file.size(), qint64(contents.size()));
+        QCOMPARE(file.read(100), contents.left(100));
+        QVERIFY(file.seek(contents.size() - 100));
+        QCOMPARE(file.readAll(), contents.right(100));
+        QVERIFY(file.seek(1000));
+        QCOMPARE(file.read(100), contents.mid(1000, 100));
+        file.close();
+
+        QVERIFY(file.open(QFile::ReadOnly));
+        QCOMPARE(file.readAll(), contents);
+        file.close();
+    }
+
+    QLocale::setDefault(QLocale::system());
+    QVERIFY(QResource::unregisterResource(m_lz4ResourceRcc));
+}
+
 QTEST_MAIN(tst_QResourceEngine)
 
 #include "tst_qresourceengine.moc"
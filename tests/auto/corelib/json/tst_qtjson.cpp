@@ -32,6 +32,7 @@
 #include "qjsonobject.h"
 #include "qjsonvalue.h"
 #include "qjsondocument.h"
+#include "qjsonstream.h"
 #include "qregularexpression.h"
 #include <limits>
 
@@ -96,8 +97,10 @@ private Q_SLOTS:
     void toAndFromBinary_data();
     void toAndFromBinary();
     void invalidBinaryData();
+    void fromBinaryFile();
     void parseNumbers();
     void parseStrings();
+    void parseStringsAtChunkBoundaries();
     void parseDuplicateKeys();
     void testParser();
 
@@ -145,6 +148,17 @@ private Q_SLOTS:
     void parseErrorOffset_data();
     void parseErrorOffset();
 
+    void streamReader();
+    void streamReaderIncremental();
+    void streamReaderDevice();
+    void streamReaderNumberAtEnd();
+    void streamReaderErrors_data();
+    void streamReaderErrors();
+    void streamReaderSkip();
+    void streamWriter_data();
+    void streamWriter();
+    void streamWriterMisuse();
+
 private:
     QString testDataDir;
 };
@@ -1288,6 +1302,28 @@ void tst_QtJson::toVariantList()
     QCOMPARE(vlist.at(1), QVariant(999.));
     QCOMPARE(vlist.at(2), QVariant(QLatin1String("string")));
     QCOMPARE(vlist.at(3), QVariant::fromValue(nullptr));
+
+    // the objects of one conversion share their keys
+    QJsonObject object;
+    object.insert(QLatin1String("key"), 1);
+    object.insert(QString::fromUtf8("k\xc3\xa9y"), 2);
+    array = QJsonArray();
+    array.append(object);
+    object.insert(QLatin1String("key"), 3);
+    array.append(object);
+
+    list = array.toVariantList();
+    QCOMPARE(list.size(), 2);
+    const QVariantMap first = list.at(0).toMap();
+    const QVariantMap second = list.at(1).toMap();
+    QCOMPARE(first.value(QLatin1String("key")), QVariant(1.));
+    QCOMPARE(second.value(QLatin1String("key")), QVariant(3.));
+    QCOMPARE(second.value(QString::fromUtf8("k\xc3\xa9y")), QVariant(2.));
+    QCOMPARE(first.firstKey().constData(), second.firstKey().constData());
+
+    // but not with those of another one
+    const QVariantMap third = array.toVariantList().at(0).toMap();
+    QVERIFY(third.firstKey().constData() != first.firstKey().constData());
 }
 
 void tst_QtJson::toJson()
@@ -1815,6 +1851,61 @@ void tst_QtJson::invalidBinaryData()
     }
 }
 
+void tst_QtJson::fromBinaryFile()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QVERIFY(doc.isArray());
+    const QByteArray binary = doc.toBinaryData();
+
+    QTemporaryFile bfile;
+    QVERIFY(bfile.open());
+    QCOMPARE(bfile.write(binary), qint64(binary.size()));
+    bfile.close();
+
+    QJsonDocument mapped = QJsonDocument::fromBinaryFile(bfile.fileName());
+    QVERIFY(!mapped.isNull());
+    QCOMPARE(mapped, doc);
+    QCOMPARE(mapped.toVariant(), doc.toVariant());
+
+    mapped = QJsonDocument::fromBinaryFile(bfile.fileName(), QJsonDocument::BypassValidation);
+    QVERIFY(!mapped.isNull());
+    QCOMPARE(mapped, doc);
+
+    // values obtained from the document keep the mapping alive
+    QJsonArray array = mapped.array();
+    QJsonObject object = array.at(8).toObject();
+    mapped = QJsonDocument();
+    QCOMPARE(array, doc.array());
+    QCOMPARE(object, doc.array().at(8).toObject());
+
+    // mutating detaches and leaves the file untouched
+    array.removeFirst();
+    QCOMPARE(array.size(), doc.array().size() - 1);
+    const QString firstKey = object.keys().first();
+    object.remove(firstKey);
+    QVERIFY(!object.contains(firstKey));
+    object.insert(QLatin1String("fromBinaryFile"), 42);
+    QCOMPARE(object.value(QLatin1String("fromBinaryFile")).toInt(), 42);
+
+    QVERIFY(bfile.open());
+    QCOMPARE(bfile.readAll(), binary);
+    bfile.close();
+    QCOMPARE(QJsonDocument::fromBinaryFile(bfile.fileName()), doc);
+
+    // invalid input
+    QVERIFY(QJsonDocument::fromBinaryFile(testDataDir + "/doesnotexist.bjson").isNull());
+    QVERIFY(QJsonDocument::fromBinaryFile(testDataDir + "/test.json").isNull());
+
+    QTemporaryFile truncated;
+    QVERIFY(truncated.open());
+    truncated.write(binary.left(binary.size() / 2));
+    truncated.close();
+    QVERIFY(QJsonDocument::fromBinaryFile(truncated.fileName()).isNull());
+    QVERIFY(QJsonDocument::fromBinaryFile(truncated.fileName(), QJsonDocument::BypassValidation).isNull());
+}
+
 void tst_QtJson::parseNumbers()
 {
     {
@@ -1964,6 +2055,46 @@ void tst_QtJson::parseStrings()
 
 }
 
+void tst_QtJson::parseStringsAtChunkBoundaries()
+{
+    // the parser copies plain runs of a string in blocks, make sure that
+    // escapes and multi-byte characters are found at any offset in a block
+    struct Specials {
+        const char *in;
+        const char *out;
+    };
+    Specials specials [] = {
+        { "\\\"", "\"" },
+        { "\\n", "\n" },
+        { "\\u0065", "e" },
+        { "\303\251", "\303\251" },
+        { UNICODE_DJE, UNICODE_DJE },
+        { "\\u0402", UNICODE_DJE }
+    };
+    const int size = sizeof(specials)/sizeof(Specials);
+
+    for (int i = 0; i < size; ++i) {
+        for (int prefix = 0; prefix < 40; ++prefix) {
+            for (int suffix = 0; suffix < 40; suffix += 13) {
+                QByteArray json = "[\"";
+                json += QByteArray(prefix, 'a') + specials[i].in + QByteArray(suffix, 'b');
+                json += "\" ]";
+                const QString expected = QString::fromUtf8(QByteArray(prefix, 'a') + specials[i].out
+                                                           + QByteArray(suffix, 'b'));
+
+                QJsonDocument doc = QJsonDocument::fromJson(json);
+                QVERIFY2(doc.isArray(), json.constData());
+                QCOMPARE(doc.array().at(0).toString(), expected);
+            }
+        }
+    }
+
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson("[\"" + QByteArray(50, 'a'), &error);
+    QVERIFY(doc.isNull());
+    QCOMPARE(error.error, QJsonParseError::UnterminatedString);
+}
+
 void tst_QtJson::parseDuplicateKeys()
 {
     const char *json = "{ \"B\": true, \"A\": null, \"B\": false }";
@@ -2908,5 +3039,406 @@ void tst_QtJson::parseErrorOffset()
     QCOMPARE(error.offset, errorOffset);
 }
 
+// rebuilds the values read by a QJsonStreamReader, one top-level value at a time
+static QJsonValue readStreamValue(QJsonStreamReader &reader)
+{
+    switch (reader.tokenType()) {
+    case QJsonStreamReader::StartObject: {
+        QJsonObject object;
+        while (reader.readNext() == QJsonStreamReader::Name) {
+            const QString name = reader.name();
+            reader.readNext();
+            object.insert(name, readStreamValue(reader));
+        }
+        return reader.tokenType() == QJsonStreamReader::EndObject ? QJsonValue(object) : QJsonValue(QJsonValue::Undefined);
+    }
+    case QJsonStreamReader::StartArray: {
+        QJsonArray array;
+        while (reader.readNext() != QJsonStreamReader::EndArray) {
+            if (reader.tokenType() == QJsonStreamReader::Invalid)
+                return QJsonValue(QJsonValue::Undefined);
+            array.append(readStreamValue(reader));
+        }
+        return array;
+    }
+    case QJsonStreamReader::Value:
+        return reader.value();
+    default:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+}
+
+void tst_QtJson::streamReader()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray json = file.readAll();
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+    QVERIFY(doc.isArray());
+
+    QJsonStreamReader reader(json);
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.atEnd());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(readStreamValue(reader), QJsonValue(doc.array()));
+    QCOMPARE(reader.depth(), 0);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+
+    // a stream of values, as in JSON Lines
+    QJsonStreamReader lines(QByteArray("{\"a\": 1}\n[true, null]\n\"text\"\n-2.5e3 \n"));
+    QCOMPARE(lines.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(lines.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(lines.name(), QString("a"));
+    QCOMPARE(lines.tokenString(), QString("Name"));
+    QCOMPARE(lines.readNext(), QJsonStreamReader::Value);
+    QCOMPARE(lines.value(), QJsonValue(1));
+    QCOMPARE(lines.readNext(), QJsonStreamReader::EndObject);
+    QCOMPARE(lines.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(lines.readNext(), QJsonStreamReader::Value);
+    QCOMPARE(lines.value(), QJsonValue(true));
+    QCOMPARE(lines.readNext(), QJsonStreamReader::Value);
+    QCOMPARE(lines.value(), QJsonValue(QJsonValue::Null));
+    QCOMPARE(lines.readNext(), QJsonStreamReader::EndArray);
+    QCOMPARE(lines.readNext(), QJsonStreamReader::Value);
+    QCOMPARE(lines.value(), QJsonValue(QLatin1String("text")));
+    QCOMPARE(lines.readNext(), QJsonStreamReader::Value);
+    QCOMPARE(lines.value(), QJsonValue(-2500));
+    QCOMPARE(lines.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(lines.atEnd());
+    QVERIFY(!lines.hasError());
+}
+
+void tst_QtJson::streamReaderIncremental()
+{
+    QFile file(testDataDir + "/test.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QByteArray json = file.readAll();
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+
+    // feed the document one byte at a time, the reader has to resume
+    // after every PrematureEndOfDocumentError
+    QJsonStreamReader reader;
+    QJsonArray values;
+    int i = 0;
+    forever {
+        const QJsonStreamReader::TokenType type = reader.readNext();
+        if (type == QJsonStreamReader::Invalid) {
+            QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+            QVERIFY(reader.atEnd());
+            if (i == json.size())
+                break;
+            reader.addData(json.mid(i++, 1));
+            continue;
+        }
+        if (type == QJsonStreamReader::NoToken) {
+            if (i == json.size())
+                break;
+            reader.addData(json.mid(i++, 1));
+            continue;
+        }
+        if (type == QJsonStreamReader::Value)
+            values.append(reader.value());
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.depth(), 0);
+
+    QJsonArray expected;
+    QJsonStreamReader direct(json);
+    while (!direct.atEnd()) {
+        if (direct.readNext() == QJsonStreamReader::Value)
+            expected.append(direct.value());
+    }
+    QVERIFY(!direct.hasError());
+    QCOMPARE(values, expected);
+    QVERIFY(values.size() > 20);
+}
+
+void tst_QtJson::streamReaderDevice()
+{
+    // a document bigger than the reader's internal chunk size, with strings
+    // and numbers crossing chunk boundaries
+    QJsonArray array;
+    for (int i = 0; i < 5000; ++i) {
+        QJsonObject object;
+        object.insert("index", i);
+        object.insert("name", QString("item \\ \"%1\" ").arg(i) + QChar(0xe9) + QChar(0x20ac));
+        object.insert("value", i * 0.25);
+        array.append(object);
+    }
+    const QByteArray json = QJsonDocument(array).toJson(QJsonDocument::Compact) + '\n'
+            + QJsonDocument(array).toJson(QJsonDocument::Indented);
+    QVERIFY(json.size() > 100000);
+
+    QBuffer buffer;
+    buffer.setData(json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.device(), &buffer);
+    for (int n = 0; n < 2; ++n) {
+        QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+        QCOMPARE(readStreamValue(reader), QJsonValue(array));
+    }
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+    QCOMPARE(reader.characterOffset(), qint64(json.size()));
+}
+
+class SequentialDevice : public QIODevice
+{
+public:
+    QByteArray data;
+
+    bool isSequential() const Q_DECL_OVERRIDE { return true; }
+    qint64 bytesAvailable() const Q_DECL_OVERRIDE { return data.size() + QIODevice::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *out, qint64 maxSize) Q_DECL_OVERRIDE
+    {
+        const int n = int(qMin(maxSize, qint64(data.size())));
+        memcpy(out, data.constData(), n);
+        data.remove(0, n);
+        return n;
+    }
+    qint64 writeData(const char *, qint64) Q_DECL_OVERRIDE { return -1; }
+};
+
+void tst_QtJson::streamReaderNumberAtEnd()
+{
+    // a random-access device read to its end ends the number
+    QBuffer buffer;
+    buffer.setData("42");
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Value);
+    QCOMPARE(reader.value(), QJsonValue(42));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(reader.atEnd());
+    QVERIFY(!reader.hasError());
+
+    buffer.close();
+    buffer.setData("[1,-2.5e1");
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    reader.setDevice(&buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Value);
+    QCOMPARE(reader.value(), QJsonValue(1));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Value);
+    QCOMPARE(reader.value(), QJsonValue(-25));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+
+    // an incomplete number at the end of the input is still an error
+    buffer.close();
+    buffer.setData("[1e");
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    reader.setDevice(&buffer);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::NotWellFormedError);
+    QCOMPARE(reader.parseError(), QJsonParseError::IllegalNumber);
+
+    // more data may arrive on a sequential device until it is closed
+    SequentialDevice sequential;
+    sequential.data = "[7, 1";
+    QVERIFY(sequential.open(QIODevice::ReadOnly));
+    reader.setDevice(&sequential);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Value);
+    QCOMPARE(reader.value(), QJsonValue(7));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+    sequential.data = "2";
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+    sequential.close();
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Value);
+    QCOMPARE(reader.value(), QJsonValue(12));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+
+    // the same goes for data added with addData()
+    QJsonStreamReader chunks(QByteArray("1"));
+    QCOMPARE(chunks.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(chunks.error(), QJsonStreamReader::PrematureEndOfDocumentError);
+    chunks.addData("23 ");
+    QCOMPARE(chunks.readNext(), QJsonStreamReader::Value);
+    QCOMPARE(chunks.value(), QJsonValue(123));
+    QCOMPARE(chunks.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(!chunks.hasError());
+}
+
+void tst_QtJson::streamReaderErrors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<int>("error");
+    QTest::addColumn<qint64>("offset");
+
+    QTest::newRow("missing name separator") << QByteArray("{\"a\" 1}") << int(QJsonParseError::MissingNameSeparator) << qint64(5);
+    QTest::newRow("missing value separator") << QByteArray("[1 2]") << int(QJsonParseError::MissingValueSeparator) << qint64(3);
+    QTest::newRow("illegal value") << QByteArray("[1, x]") << int(QJsonParseError::IllegalValue) << qint64(4);
+    QTest::newRow("illegal literal") << QByteArray("[trve]") << int(QJsonParseError::IllegalValue) << qint64(1);
+    QTest::newRow("illegal number") << QByteArray("[-]") << int(QJsonParseError::IllegalNumber) << qint64(1);
+    QTest::newRow("illegal escape") << QByteArray("[\"ab\\u12x4\"]") << int(QJsonParseError::IllegalEscapeSequence) << qint64(8);
+    QTest::newRow("illegal utf8") << QByteArray("[\"a\xff\"]") << int(QJsonParseError::IllegalUTF8String) << qint64(3);
+    QTest::newRow("mismatched end") << QByteArray("[1}") << int(QJsonParseError::UnterminatedArray) << qint64(2);
+    QTest::newRow("number as name") << QByteArray("{\"a\":1,2}") << int(QJsonParseError::UnterminatedObject) << qint64(7);
+    QTest::newRow("deep nesting") << QByteArray(2000, '[') << int(QJsonParseError::DeepNesting) << qint64(1024);
+}
+
+void tst_QtJson::streamReaderErrors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(int, error);
+    QFETCH(qint64, offset);
+
+    QJsonStreamReader reader(json);
+    while (!reader.atEnd())
+        reader.readNext();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.error(), QJsonStreamReader::NotWellFormedError);
+    QCOMPARE(int(reader.parseError()), error);
+    QCOMPARE(reader.characterOffset(), offset);
+    QVERIFY(!reader.errorString().isEmpty());
+
+    // fatal errors stick
+    reader.addData("[]");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(int(reader.parseError()), error);
+
+    reader.clear();
+    QVERIFY(!reader.hasError());
+    reader.addData("[]");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+}
+
+void tst_QtJson::streamReaderSkip()
+{
+    QJsonStreamReader reader(QByteArray("{\"skip\": {\"a\": [1, {\"b\": 2}]}, \"also\": [[], {}], \"keep\": 3}"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartObject);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    reader.skipCurrentValue();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndObject);
+    QCOMPARE(reader.depth(), 1);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    reader.skipCurrentValue();
+    QCOMPARE(reader.tokenType(), QJsonStreamReader::EndArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Name);
+    QCOMPARE(reader.name(), QString("keep"));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Value);
+    QCOMPARE(reader.value(), QJsonValue(3));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::EndObject);
+    QVERIFY(!reader.hasError());
+}
+
+void tst_QtJson::streamWriter_data()
+{
+    QTest::addColumn<QString>("filename");
+    QTest::newRow("test.json") << (testDataDir + "/test.json");
+    QTest::newRow("test2.json") << (testDataDir + "/test2.json");
+}
+
+static void writeStreamValue(QJsonStreamWriter &writer, const QJsonValue &value)
+{
+    if (value.isObject()) {
+        writer.writeStartObject();
+        const QJsonObject object = value.toObject();
+        for (QJsonObject::const_iterator it = object.begin(); it != object.end(); ++it) {
+            writer.writeName(it.key());
+            writeStreamValue(writer, it.value());
+        }
+        writer.writeEndObject();
+    } else if (value.isArray()) {
+        writer.writeStartArray();
+        const QJsonArray array = value.toArray();
+        for (const QJsonValue &v : array)
+            writeStreamValue(writer, v);
+        writer.writeEndArray();
+    } else {
+        writer.writeValue(value);
+    }
+}
+
+void tst_QtJson::streamWriter()
+{
+    QFETCH(QString, filename);
+    QFile file(filename);
+    QVERIFY(file.open(QFile::ReadOnly));
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QVERIFY(!doc.isNull());
+    const QJsonValue root = doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object());
+
+    // written token by token, the output matches QJsonDocument::toJson()
+    QByteArray compact;
+    QJsonStreamWriter writer(&compact);
+    QVERIFY(!writer.autoFormatting());
+    writeStreamValue(writer, root);
+    QCOMPARE(writer.depth(), 0);
+    QCOMPARE(compact, doc.toJson(QJsonDocument::Compact) + '\n');
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QJsonStreamWriter indentedWriter(&buffer);
+    indentedWriter.setAutoFormatting(true);
+    writeStreamValue(indentedWriter, root);
+    QCOMPARE(buffer.data(), doc.toJson(QJsonDocument::Indented));
+    QVERIFY(!indentedWriter.hasError());
+
+    // and so does writing whole values
+    QByteArray whole;
+    QJsonStreamWriter wholeWriter(&whole);
+    wholeWriter.setAutoFormatting(true);
+    wholeWriter.writeValue(root);
+    QCOMPARE(whole, doc.toJson(QJsonDocument::Indented));
+
+    // several top-level values make a JSON Lines stream that reads back
+    QByteArray lines;
+    QJsonStreamWriter linesWriter(&lines);
+    for (int i = 0; i < 3; ++i)
+        linesWriter.writeValue(root);
+    linesWriter.writeValue(QJsonValue(42));
+    QCOMPARE(lines.count('\n'), 4);
+    QJsonStreamReader reader(lines);
+    for (int i = 0; i < 3; ++i) {
+        reader.readNext();
+        QCOMPARE(readStreamValue(reader), root);
+    }
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Value);
+    QCOMPARE(reader.value(), QJsonValue(42));
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+}
+
+void tst_QtJson::streamWriterMisuse()
+{
+    QByteArray json;
+    QJsonStreamWriter writer(&json);
+
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeName: names can only be written in an object");
+    writer.writeName("a");
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeEndObject: no object to end");
+    writer.writeEndObject();
+    QVERIFY(json.isEmpty());
+
+    writer.writeStartObject();
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeValue: values in an object need a name");
+    writer.writeValue(1);
+    writer.writeValue("a", 1);
+    writer.writeStartArray("b");
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeEndObject: no object to end");
+    writer.writeEndObject();
+    writer.writeValue(QJsonValue(QJsonValue::Undefined));
+    writer.writeEndArray();
+    writer.writeName("c");
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter::writeEndObject: the last member has no value");
+    writer.writeEndObject();
+    writer.writeValue(QJsonObject());
+    writer.writeEndObject();
+    QCOMPARE(json, QByteArray("{\"a\":1,\"b\":[null],\"c\":{}}\n"));
+}
+
 QTEST_MAIN(tst_QtJson)
 #include "tst_qtjson.moc"
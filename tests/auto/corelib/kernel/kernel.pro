@@ -4,6 +4,7 @@ SUBDIRS=\
     qdeadlinetimer \
     qelapsedtimer \
     qeventdispatcher \
+    qeventdispatcher_epoll \
     qeventloop \
     qmath \
     qmetaobject \
@@ -19,6 +20,7 @@ SUBDIRS=\
     qsignalblocker \
     qsignalmapper \
     qsocketnotifier \
+    qsocketnotifier_epoll \
     qsystemsemaphore \
     qtimer \
     qtranslator \
@@ -31,12 +33,19 @@ SUBDIRS=\
 !qtHaveModule(network): SUBDIRS -= \
     qeventloop \
     qobject \
-    qsocketnotifier
+    qsocketnotifier \
+    qsocketnotifier_epoll
 
 !qtConfig(private_tests): SUBDIRS -= \
     qsocketnotifier \
+    qsocketnotifier_epoll \
     qsharedmemory
 
+# The epoll backend of QEventDispatcherUNIX only exists on Linux
+!linux: SUBDIRS -= \
+    qeventdispatcher_epoll \
+    qsocketnotifier_epoll
+
 # This test is only applicable on Windows
 !win32*|winrt: SUBDIRS -= qwineventnotifier
 
@@ -34,8 +34,13 @@
 
 #include <private/qcoreapplication_p.h>
 #include <private/qeventloop_p.h>
+#include <private/qobject_p.h>
 #include <private/qthread_p.h>
 
+QT_BEGIN_NAMESPACE
+Q_CORE_EXPORT uint qGlobalPostedEventsCount();
+QT_END_NAMESPACE
+
 typedef QCoreApplication TestApplication;
 
 class EventSpy : public QObject
@@ -51,6 +56,29 @@ public:
     }
 };
 
+class MetaCallSpy : public QObject
+{
+    Q_OBJECT
+
+public:
+    QList<int> recordedSignals;
+    bool event(QEvent *event) Q_DECL_OVERRIDE
+    {
+        if (event->type() != QEvent::MetaCall)
+            return QObject::event(event);
+        // the tests post QMetaCallEvents without a slot to call, and plain
+        // QEvents of that type, which are recorded as -1
+        const QMetaCallEvent *metaCall = dynamic_cast<QMetaCallEvent *>(event);
+        recordedSignals.append(metaCall ? metaCall->signalId() : -1);
+        return true;
+    }
+};
+
+static void postMetaCall(QObject *receiver, int signalId, int priority = Qt::NormalEventPriority)
+{
+    QCoreApplication::postEvent(receiver, new QMetaCallEvent(0, 0, 0, receiver, signalId), priority);
+}
+
 class ThreadedEventReceiver : public QObject
 {
     Q_OBJECT
@@ -415,6 +443,74 @@ void tst_QCoreApplication::removePostedEvents()
     expected.clear();
 }
 
+void tst_QCoreApplication::removePostedMetaCallEvents()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    // QMetaCallEvents are posted without locking the event list; they must
+    // be found by the functions that look at it
+    MetaCallSpy one, two;
+    QList<int> expected;
+
+    // remove all events for one object, keeping the priorities of the others
+    postMetaCall(&one, 1);
+    postMetaCall(&two, 2, Qt::LowEventPriority);
+    postMetaCall(&one, 3, Qt::HighEventPriority);
+    postMetaCall(&two, 4);
+    postMetaCall(&two, 5, Qt::HighEventPriority);
+    QCOMPARE(qGlobalPostedEventsCount(), 5u);
+    QCoreApplication::removePostedEvents(&one);
+    QCOMPARE(qGlobalPostedEventsCount(), 3u);
+    QCoreApplication::sendPostedEvents();
+    expected << 5 << 4 << 2;
+    QCOMPARE(two.recordedSignals, expected);
+    QVERIFY(one.recordedSignals.isEmpty());
+    two.recordedSignals.clear();
+    expected.clear();
+
+    // remove the meta call events only, mixed with other events
+    postMetaCall(&one, 6);
+    QCoreApplication::postEvent(&one, new QEvent(QEvent::User));
+    postMetaCall(&one, 7);
+    QCoreApplication::removePostedEvents(&one, QEvent::MetaCall);
+    QCOMPARE(qGlobalPostedEventsCount(), 1u);
+    QCoreApplication::sendPostedEvents();
+    QVERIFY(one.recordedSignals.isEmpty());
+
+    // posting order is kept within a priority
+    postMetaCall(&one, 8);
+    postMetaCall(&one, 9, Qt::HighEventPriority);
+    QCoreApplication::postEvent(&one, new QEvent(QEvent::User), Qt::HighEventPriority);
+    postMetaCall(&one, 10);
+    postMetaCall(&one, 11, Qt::HighEventPriority);
+    QCoreApplication::sendPostedEvents();
+    expected << 9 << 11 << 8 << 10;
+    QCOMPARE(one.recordedSignals, expected);
+}
+
+void tst_QCoreApplication::postPlainMetaCallEvent()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>(QTest::currentAppName()) };
+    TestApplication app(argc, argv);
+
+    // a plain QEvent of type MetaCall is not a QMetaCallEvent, and must not
+    // be treated as one when it is posted
+    MetaCallSpy spy;
+    QCoreApplication::postEvent(&spy, new QEvent(QEvent::MetaCall));
+    postMetaCall(&spy, 1);
+    QCoreApplication::postEvent(&spy, new QEvent(QEvent::MetaCall), Qt::HighEventPriority);
+    QCOMPARE(qGlobalPostedEventsCount(), 3u);
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(spy.recordedSignals, QList<int>() << -1 << -1 << 1);
+
+    QCoreApplication::postEvent(&spy, new QEvent(QEvent::MetaCall));
+    QCoreApplication::removePostedEvents(&spy, QEvent::MetaCall);
+    QCOMPARE(qGlobalPostedEventsCount(), 0u);
+}
+
 #ifndef QT_NO_THREAD
 class DeliverInDefinedOrderThread : public QThread
 {
@@ -539,10 +635,6 @@ void tst_QCoreApplication::applicationPid()
     QVERIFY(QCoreApplication::applicationPid() > 0);
 }
 
-QT_BEGIN_NAMESPACE
-Q_CORE_EXPORT uint qGlobalPostedEventsCount();
-QT_END_NAMESPACE
-
 class GlobalPostedEventsCountObject : public QObject
 {
     Q_OBJECT
@@ -33,6 +33,12 @@
 #endif
 #include <QtTest/QtTest>
 
+#ifdef TEST_EPOLL_DISPATCHER
+// read when QCoreApplication creates the dispatcher of the main thread
+static const bool epollDispatcher = qputenv("QT_NO_GLIB", "1")
+        && qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+#endif
+
 enum {
     PreciseTimerInterval    =   10,
     CoarseTimerInterval     =  200,
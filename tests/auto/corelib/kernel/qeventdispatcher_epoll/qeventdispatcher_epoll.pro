@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qeventdispatcher_epoll
+QT = core testlib
+DEFINES += TEST_EPOLL_DISPATCHER
+SOURCES += ../qeventdispatcher/tst_qeventdispatcher.cpp
@@ -79,6 +79,8 @@ private slots:
     void thread();
     void thread0();
     void moveToThread();
+    void moveToThreadWhileReceivingQueuedSignals();
+    void deleteWithPendingQueuedSignals();
     void senderTest();
     void declareInterface();
     void qpointerResetBeforeDestroyedSignal();
@@ -1907,6 +1909,122 @@ void tst_QObject::moveToThread()
 #endif
 }
 
+class QueuedEmitThread : public QThread
+{
+    Q_OBJECT
+public:
+    QueuedEmitThread(int count, bool customType = false)
+        : count(count), customType(customType)
+    { }
+
+signals:
+    void ping();
+    void customTypePing(CustomType);
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        for (int i = 0; i < count; ++i) {
+            if (customType)
+                emit customTypePing(CustomType(i));
+            else
+                emit ping();
+        }
+    }
+
+private:
+    const int count;
+    const bool customType;
+};
+
+class MovingReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    QThread *home;
+    QSemaphore movedHome;
+    QAtomicInt received;
+    QAtomicInt receivedInWrongThread;
+
+public slots:
+    void ping()
+    {
+        received.ref();
+        if (QThread::currentThread() != thread())
+            receivedInWrongThread.ref();
+    }
+    void moveHome()
+    {
+        moveToThread(home);
+        movedHome.release();
+    }
+};
+
+void tst_QObject::moveToThreadWhileReceivingQueuedSignals()
+{
+    // the queued signals are posted without locking the receiver's event
+    // list; none may be lost or delivered in the wrong thread while the
+    // receiver moves back and forth
+    enum { ThreadCount = 4, SignalCount = 5000 };
+
+    MoveToThreadThread thread;
+    thread.start();
+
+    MovingReceiver receiver;
+    receiver.home = QThread::currentThread();
+
+    QueuedEmitThread *emitters[ThreadCount];
+    for (int i = 0; i < ThreadCount; ++i) {
+        emitters[i] = new QueuedEmitThread(SignalCount);
+        connect(emitters[i], SIGNAL(ping()), &receiver, SLOT(ping()), Qt::QueuedConnection);
+    }
+    for (int i = 0; i < ThreadCount; ++i)
+        emitters[i]->start();
+
+    bool emitting = true;
+    while (emitting) {
+        receiver.moveToThread(&thread);
+        QMetaObject::invokeMethod(&receiver, "moveHome", Qt::QueuedConnection);
+        QVERIFY(receiver.movedHome.tryAcquire(1, 10000));
+        QCOMPARE(receiver.thread(), QThread::currentThread());
+        QCoreApplication::processEvents();
+
+        emitting = false;
+        for (int i = 0; i < ThreadCount; ++i)
+            emitting |= !emitters[i]->isFinished();
+    }
+    for (int i = 0; i < ThreadCount; ++i)
+        QVERIFY(emitters[i]->wait(10000));
+    qDeleteAll(emitters, emitters + ThreadCount);
+
+    QTRY_COMPARE(receiver.received.load(), int(ThreadCount * SignalCount));
+    QCOMPARE(receiver.receivedInWrongThread.load(), 0);
+
+    thread.quit();
+    thread.wait();
+}
+
+void tst_QObject::deleteWithPendingQueuedSignals()
+{
+    qRegisterMetaType<CustomType>("CustomType");
+
+    QCustomTypeChecker *receiver = new QCustomTypeChecker;
+    QueuedEmitThread thread(50, true);
+    connect(&thread, SIGNAL(customTypePing(CustomType)), receiver, SLOT(slot1(CustomType)),
+            Qt::QueuedConnection);
+    const int instances = instanceCount;
+    thread.start();
+    QVERIFY(thread.wait(30000));
+
+    // the events hold copies of the arguments until they are deleted with
+    // the receiver
+    QCOMPARE(instanceCount, instances + 50);
+    delete receiver;
+    QCOMPARE(instanceCount, instances - 1);
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(instanceCount, instances - 1);
+}
+
 
 void tst_QObject::property()
 {
@@ -33,6 +33,8 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QTimer>
 #include <QtCore/QSocketNotifier>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QThread>
 #include <QtNetwork/QTcpServer>
 #include <QtNetwork/QTcpSocket>
 #include <QtNetwork/QUdpSocket>
@@ -44,10 +46,17 @@
 #define NATIVESOCKETENGINE QNativeSocketEngine
 #ifdef Q_OS_UNIX
 #include <private/qnet_unix_p.h>
+#include <private/qeventdispatcher_unix_p.h>
 #include <sys/select.h>
 #endif
 #include <limits>
 
+#ifdef TEST_EPOLL_DISPATCHER
+// read when QCoreApplication creates the dispatcher of the main thread
+static const bool epollDispatcher = qputenv("QT_NO_GLIB", "1")
+        && qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+#endif
+
 #if defined (Q_CC_MSVC) && defined(max)
 #  undef max
 #  undef min
@@ -61,6 +70,9 @@ private slots:
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
     void posixSockets();
+#endif
+#ifdef Q_OS_LINUX
+    void epollDispatcher();
 #endif
     void asyncMultipleDatagram();
 
@@ -325,6 +337,91 @@ void tst_QSocketNotifier::posixSockets()
 }
 #endif
 
+#ifdef Q_OS_LINUX
+class EpollDispatcherThread : public QThread
+{
+public:
+    EpollDispatcherThread()
+        : readCount(0), writeCount(0), fileReadCount(0)
+    {
+        if (qEnvironmentVariableIsSet("QT_EVENT_DISPATCHER_EPOLL")) {
+            setEventDispatcher(new QEventDispatcherUNIX);
+        } else {
+            qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+            setEventDispatcher(new QEventDispatcherUNIX);
+            qunsetenv("QT_EVENT_DISPATCHER_EPOLL");
+        }
+    }
+
+    int readCount;
+    int writeCount;
+    int fileReadCount;
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        int sv[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == -1)
+            return;
+
+        QEventLoop loop;
+        QTimer timeout;
+        timeout.setSingleShot(true);
+        QObject::connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+
+        {
+            QSocketNotifier rn(sv[0], QSocketNotifier::Read);
+            QObject::connect(&rn, &QSocketNotifier::activated, [&]() {
+                ++readCount;
+                rn.setEnabled(false);
+                loop.quit();
+            });
+            QSocketNotifier wn(sv[0], QSocketNotifier::Write);
+            QObject::connect(&wn, &QSocketNotifier::activated, [&]() {
+                ++writeCount;
+                wn.setEnabled(false);
+            });
+
+            qt_safe_write(sv[1], "a", 1);
+            timeout.start(5000);
+            loop.exec();
+
+            // nothing was consumed; re-enabling must report the data again
+            rn.setEnabled(true);
+            timeout.start(5000);
+            loop.exec();
+        }
+
+        // regular files are refused by epoll and must still be reported
+        QTemporaryFile file;
+        if (file.open()) {
+            QSocketNotifier fn(file.handle(), QSocketNotifier::Read);
+            QObject::connect(&fn, &QSocketNotifier::activated, [&]() {
+                ++fileReadCount;
+                fn.setEnabled(false);
+                loop.quit();
+            });
+            timeout.start(5000);
+            loop.exec();
+        }
+
+        qt_safe_close(sv[0]);
+        qt_safe_close(sv[1]);
+    }
+};
+
+void tst_QSocketNotifier::epollDispatcher()
+{
+    EpollDispatcherThread thread;
+    thread.start();
+    QVERIFY(thread.wait(30000));
+
+    QCOMPARE(thread.readCount, 2);
+    QCOMPARE(thread.writeCount, 1);
+    QCOMPARE(thread.fileReadCount, 1);
+}
+#endif
+
 void tst_QSocketNotifier::async_readDatagramSlot()
 {
     char buf[1];
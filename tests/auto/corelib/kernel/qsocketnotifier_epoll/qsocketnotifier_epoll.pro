@@ -0,0 +1,9 @@
+CONFIG += testcase
+TARGET = tst_qsocketnotifier_epoll
+QT = core-private network-private testlib
+DEFINES += TEST_EPOLL_DISPATCHER
+SOURCES = ../qsocketnotifier/tst_qsocketnotifier.cpp
+
+requires(qtConfig(private_tests))
+
+include(../../../network/socket/platformsocketengine/platformsocketengine.pri)
@@ -67,6 +67,7 @@ private slots:
     void timerFiresOnlyOncePerProcessEvents();
     void timerIdPersistsAfterThreadExit();
     void cancelLongTimer();
+    void manyTimers();
     void singleShotStaticFunctionZeroTimeout();
     void recurseOnTimeoutAndStopTimer();
     void singleShotToFunctors();
@@ -690,6 +691,80 @@ void tst_QTimer::cancelLongTimer()
     QVERIFY(!timer.isActive());
 }
 
+class ManyTimersObject : public QObject
+{
+public:
+    QVector<int> fired;
+
+protected:
+    void timerEvent(QTimerEvent *event) Q_DECL_OVERRIDE
+    {
+        fired.append(event->timerId());
+        killTimer(event->timerId());
+    }
+};
+
+void tst_QTimer::manyTimers()
+{
+    const int TimerCount = 1000;
+    const int Intervals = 20;
+
+    ManyTimersObject object;
+    QVector<int> ids;
+    QVector<bool> alive; // by index in ids; killed timer ids get reused
+    for (int i = 0; i < TimerCount; ++i) {
+        const int id = object.startTimer(i % Intervals, Qt::PreciseTimer);
+        QVERIFY(id > 0);
+        ids.append(id);
+        alive.append(true);
+    }
+
+    // stop every third timer, and restart every fifth one with a short interval
+    for (int i = 0; i < TimerCount; i += 3) {
+        object.killTimer(ids.at(i));
+        alive[i] = false;
+    }
+    for (int i = 0; i < TimerCount; i += 5) {
+        if (!alive.at(i))
+            continue;
+        object.killTimer(ids.at(i));
+        alive[i] = false;
+        const int id = object.startTimer(1, Qt::PreciseTimer);
+        QVERIFY(id > 0);
+        ids.append(id);
+        alive.append(true);
+    }
+
+    QSet<int> liveIds;
+    for (int i = 0; i < ids.size(); ++i) {
+        if (alive.at(i))
+            liveIds.insert(ids.at(i));
+    }
+    const int expected = liveIds.size();
+    QCOMPARE(expected, alive.count(true));
+    QTRY_COMPARE(object.fired.size(), expected);
+    QTest::qWait(2 * Intervals);
+    QCOMPARE(object.fired.size(), expected);
+
+    // every live timer fired exactly once
+    QHash<int, int> order;
+    for (int i = 0; i < object.fired.size(); ++i) {
+        const int id = object.fired.at(i);
+        QVERIFY(liveIds.contains(id));
+        QVERIFY(!order.contains(id));
+        order.insert(id, i);
+    }
+
+#ifdef Q_OS_UNIX
+    // timers sharing an interval fire in the order they were started
+    for (int i = Intervals; i < TimerCount; ++i) {
+        if (!alive.at(i) || !alive.at(i - Intervals))
+            continue;
+        QVERIFY(order.value(ids.at(i - Intervals)) < order.value(ids.at(i)));
+    }
+#endif
+}
+
 void tst_QTimer::singleShotStaticFunctionZeroTimeout()
 {
     TimerHelper helper;
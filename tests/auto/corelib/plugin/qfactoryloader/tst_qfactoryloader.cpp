@@ -29,7 +29,14 @@
 #include <QtTest/qtest.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
 #include <QtCore/qplugin.h>
+#include <QtCore/qpluginloader.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qsysinfo.h>
+#include <QtCore/qtemporarydir.h>
 #include <private/qfactoryloader_p.h>
 #include "plugin1/plugininterface1.h"
 #include "plugin2/plugininterface2.h"
@@ -47,9 +54,32 @@ public slots:
 
 private slots:
     void usingTwoFactoriesFromSameDir();
+    void metaDataCache();
+
+private:
+    QTemporaryDir m_tempDir;
+    QString m_cachedFileName;
 };
 
 static const char binFolderC[] = "bin";
+static const char cachedIidC[] = "org.qt-project.tst_qfactoryloader.cached";
+
+static QString cacheFileName()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+            + QLatin1String("/qtplugincache-") + QSysInfo::buildAbi() + QLatin1String(".qbjs");
+}
+
+static QJsonObject cacheEntry(const QFileInfo &info, qint64 size, const QString &iid)
+{
+    QJsonObject metaData;
+    metaData.insert(QLatin1String("IID"), iid);
+    QJsonObject entry;
+    entry.insert(QLatin1String("size"), double(size));
+    entry.insert(QLatin1String("lastModified"), double(info.lastModified().toMSecsSinceEpoch()));
+    entry.insert(QLatin1String("metaData"), metaData);
+    return entry;
+}
 
 void tst_QFactoryLoader::initTestCase()
 {
@@ -57,6 +87,37 @@ void tst_QFactoryLoader::initTestCase()
     QVERIFY2(!binFolder.isEmpty(), "Unable to locate 'bin' folder");
 #if QT_CONFIG(library)
     QCoreApplication::setLibraryPaths(QStringList(QFileInfo(binFolder).absolutePath()));
+
+    // start from a plugin metadata cache with a stale entry for plugin2
+    // and an entry for a file that is not a plugin at all, before anything
+    // reads the cache
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_tempDir.isValid());
+    QFile cached(m_tempDir.path() + QLatin1String("/cachedplugin.so"));
+    QVERIFY(cached.open(QIODevice::WriteOnly));
+    cached.write("not a plugin");
+    cached.close();
+    const QFileInfo cachedInfo(cached.fileName());
+    m_cachedFileName = cachedInfo.canonicalFilePath();
+
+    QJsonObject plugins;
+    plugins.insert(m_cachedFileName, cacheEntry(cachedInfo, cachedInfo.size(),
+                                                QLatin1String(cachedIidC)));
+    const QFileInfoList files = QDir(binFolder).entryInfoList(QStringList(QLatin1String("*plugin2*")),
+                                                              QDir::Files);
+    QVERIFY(!files.isEmpty());
+    for (const QFileInfo &info : files) {
+        plugins.insert(info.canonicalFilePath(), cacheEntry(info, info.size() + 1,
+                                                            QLatin1String("stale")));
+    }
+    QJsonObject root;
+    root.insert(QLatin1String("version"), 1);
+    root.insert(QLatin1String("plugins"), plugins);
+
+    QDir().mkpath(QFileInfo(cacheFileName()).absolutePath());
+    QFile file(cacheFileName());
+    QVERIFY2(file.open(QIODevice::WriteOnly), qPrintable(file.errorString()));
+    file.write(QJsonDocument(root).toBinaryData());
 #endif
 }
 
@@ -81,5 +142,54 @@ void tst_QFactoryLoader::usingTwoFactoriesFromSameDir()
     QCOMPARE(plugin2->pluginName(), QLatin1String("Plugin2 ok"));
 }
 
+void tst_QFactoryLoader::metaDataCache()
+{
+#if !QT_CONFIG(library)
+    QSKIP("Plugin metadata is only cached for dynamic plugins");
+#else
+    if (qEnvironmentVariableIsSet("QT_NO_PLUGIN_CACHE"))
+        QSKIP("The plugin metadata cache is disabled");
+
+    const QString suffix = QLatin1Char('/') + QLatin1String(binFolderC);
+    QFactoryLoader loader(PluginInterface1_iid, suffix);
+    QCOMPARE(loader.metaData().size(), 1);
+
+    // an entry with a stale stamp is not used, the plugin is scanned again
+    QFactoryLoader loader2(PluginInterface2_iid, suffix);
+    QCOMPARE(loader2.metaData().size(), 1);
+    QCOMPARE(loader2.metaData().first().value(QLatin1String("IID")).toString(),
+             QLatin1String(PluginInterface2_iid));
+
+    // an entry with a matching stamp is served without reading the file
+    QPluginLoader cachedLoader(m_cachedFileName);
+    QCOMPARE(cachedLoader.metaData().value(QLatin1String("IID")).toString(),
+             QLatin1String(cachedIidC));
+
+    QFile file(cacheFileName());
+    QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable(file.errorString()));
+    const QJsonObject root = QJsonDocument::fromBinaryData(file.readAll()).object();
+    QCOMPARE(root.value(QLatin1String("version")).toInt(), 1);
+
+    // the cache has an entry for each plugin we loaded, matching the file
+    const QJsonObject plugins = root.value(QLatin1String("plugins")).toObject();
+    int found = 0;
+    for (QJsonObject::const_iterator it = plugins.constBegin(); it != plugins.constEnd(); ++it) {
+        const QJsonObject entry = it.value().toObject();
+        const QString iid = entry.value(QLatin1String("metaData")).toObject()
+                .value(QLatin1String("IID")).toString();
+        if (iid != QLatin1String(PluginInterface1_iid) && iid != QLatin1String(PluginInterface2_iid))
+            continue;
+
+        const QFileInfo info(it.key());
+        QVERIFY2(info.exists(), qPrintable(it.key()));
+        QCOMPARE(qint64(entry.value(QLatin1String("size")).toDouble()), info.size());
+        QCOMPARE(qint64(entry.value(QLatin1String("lastModified")).toDouble()),
+                 info.lastModified().toMSecsSinceEpoch());
+        ++found;
+    }
+    QCOMPARE(found, 2);
+#endif
+}
+
 QTEST_MAIN(tst_QFactoryLoader)
 #include "tst_qfactoryloader.moc"
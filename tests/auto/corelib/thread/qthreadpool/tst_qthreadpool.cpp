@@ -94,6 +94,11 @@ private slots:
     void destroyingWaitsForTasksToFinish();
     void stressTest();
     void takeAllAndIncreaseMaxThreadCount();
+    void workStealing_data();
+    void workStealing();
+    void workStealingPriority();
+    void workStealingFanOut();
+    void workStealingReleaseThread();
 
 private:
     QMutex m_functionTestMutex;
@@ -1200,6 +1205,191 @@ void tst_QThreadPool::stressTest()
     }
 }
 
+class SpawningTask : public QRunnable
+{
+public:
+    SpawningTask(QThreadPool *pool, QAtomicInt *counter, int depth)
+        : pool(pool), counter(counter), depth(depth) {}
+
+    void run() Q_DECL_OVERRIDE
+    {
+        counter->ref();
+        if (depth > 0) {
+            for (int i = 0; i < 4; ++i)
+                pool->start(new SpawningTask(pool, counter, depth - 1));
+        }
+    }
+
+private:
+    QThreadPool *pool;
+    QAtomicInt *counter;
+    int depth;
+};
+
+void tst_QThreadPool::workStealing_data()
+{
+    QTest::addColumn<int>("maxThreadCount");
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+    QTest::newRow("8") << 8;
+}
+
+void tst_QThreadPool::workStealing()
+{
+    QFETCH(int, maxThreadCount);
+
+    QThreadPool threadPool;
+    QVERIFY(!threadPool.isWorkStealingEnabled());
+    threadPool.setWorkStealingEnabled(true);
+    QVERIFY(threadPool.isWorkStealingEnabled());
+    threadPool.setMaxThreadCount(maxThreadCount);
+
+    // 1 + 4 + 16 + ... + 4^6 tasks, all but the first started from pool threads
+    QAtomicInt counter;
+    threadPool.start(new SpawningTask(&threadPool, &counter, 6));
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(counter.load(), 5461);
+
+    // the pool is still usable after waitForDone()
+    threadPool.start(new SpawningTask(&threadPool, &counter, 2));
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(counter.load(), 5461 + 21);
+}
+
+void tst_QThreadPool::workStealingPriority()
+{
+    class Runner : public QRunnable
+    {
+    public:
+        QAtomicPointer<QRunnable> &ptr;
+        Runner(QAtomicPointer<QRunnable> &ptr) : ptr(ptr) {}
+        void run() Q_DECL_OVERRIDE
+        {
+            ptr.testAndSetRelaxed(0, this);
+        }
+    };
+    class Spawner : public QRunnable
+    {
+    public:
+        QThreadPool &pool;
+        QAtomicPointer<QRunnable> &ptr;
+        QSemaphore &spawned;
+        QSemaphore &proceed;
+        Spawner(QThreadPool &pool, QAtomicPointer<QRunnable> &ptr,
+                QSemaphore &spawned, QSemaphore &proceed)
+            : pool(pool), ptr(ptr), spawned(spawned), proceed(proceed) {}
+        void run() Q_DECL_OVERRIDE
+        {
+            // these go to this thread's local queue
+            for (int i = 0; i < 10; ++i)
+                pool.start(new Runner(ptr));
+            spawned.release();
+            proceed.acquire();
+        }
+    };
+
+    QAtomicPointer<QRunnable> firstStarted;
+    QSemaphore spawned, proceed;
+    QThreadPool threadPool;
+    threadPool.setWorkStealingEnabled(true);
+    threadPool.setMaxThreadCount(1);
+
+    threadPool.start(new Spawner(threadPool, firstStarted, spawned, proceed));
+    spawned.acquire();
+
+    QRunnable *expected = new Runner(firstStarted);
+    threadPool.start(expected, 1);
+    proceed.release();
+
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(firstStarted.load(), expected);
+}
+
+void tst_QThreadPool::workStealingFanOut()
+{
+    class Blocker : public QRunnable
+    {
+    public:
+        QSemaphore &running;
+        QSemaphore &proceed;
+        Blocker(QSemaphore &running, QSemaphore &proceed)
+            : running(running), proceed(proceed) {}
+        void run() Q_DECL_OVERRIDE
+        {
+            running.release();
+            proceed.acquire();
+        }
+    };
+    class Spawner : public QRunnable
+    {
+    public:
+        QThreadPool &pool;
+        QSemaphore &running;
+        QSemaphore &proceed;
+        Spawner(QThreadPool &pool, QSemaphore &running, QSemaphore &proceed)
+            : pool(pool), running(running), proceed(proceed) {}
+        void run() Q_DECL_OVERRIDE
+        {
+            // these all go to this thread's local queue
+            for (int i = 0; i < 8; ++i)
+                pool.start(new Blocker(running, proceed));
+        }
+    };
+
+    QSemaphore running, proceed;
+    QThreadPool threadPool;
+    threadPool.setWorkStealingEnabled(true);
+    threadPool.setMaxThreadCount(4);
+
+    // all threads must get to work on the tasks started by one task
+    threadPool.start(new Spawner(threadPool, running, proceed));
+    const bool allRunning = running.tryAcquire(4, 10000);
+    proceed.release(8);
+    QVERIFY(allRunning);
+    QVERIFY(threadPool.waitForDone());
+}
+
+void tst_QThreadPool::workStealingReleaseThread()
+{
+    class SubTask : public QRunnable
+    {
+    public:
+        QSemaphore &done;
+        SubTask(QSemaphore &done) : done(done) {}
+        void run() Q_DECL_OVERRIDE
+        {
+            done.release();
+        }
+    };
+    class Task : public QRunnable
+    {
+    public:
+        QThreadPool &pool;
+        QAtomicInt &subTaskRan;
+        Task(QThreadPool &pool, QAtomicInt &subTaskRan)
+            : pool(pool), subTaskRan(subTaskRan) {}
+        void run() Q_DECL_OVERRIDE
+        {
+            // the sub task goes to this thread's local queue while the pool
+            // is at its limit; releasing the thread must get it stolen
+            QSemaphore done;
+            pool.start(new SubTask(done));
+            pool.releaseThread();
+            subTaskRan.store(done.tryAcquire(1, 10000));
+            pool.reserveThread();
+        }
+    };
+
+    QAtomicInt subTaskRan;
+    QThreadPool threadPool;
+    threadPool.setWorkStealingEnabled(true);
+    threadPool.setMaxThreadCount(1);
+
+    threadPool.start(new Task(threadPool, subTaskRan));
+    QVERIFY(threadPool.waitForDone());
+    QVERIFY(subTaskRan.load());
+}
+
 void tst_QThreadPool::takeAllAndIncreaseMaxThreadCount() {
     class Task : public QRunnable
     {
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qarraydatapool
+QT = core-private testlib
+SOURCES = tst_qarraydatapool.cpp
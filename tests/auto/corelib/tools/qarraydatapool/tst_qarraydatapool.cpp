@@ -0,0 +1,195 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtTest/QtTest>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <private/qarraydatapool_p.h>
+
+class tst_QArrayDataPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void current();
+    void recycle();
+    void escapingData();
+    void blocksFromOutside();
+    void rawData();
+    void largeBlocks();
+    void otherThread();
+};
+
+void tst_QArrayDataPool::initTestCase()
+{
+    QArrayDataPool pool;
+    if (!QArrayDataPool::current())
+        QSKIP("QArrayDataPool requires thread_local support");
+}
+
+void tst_QArrayDataPool::current()
+{
+    QVERIFY(!QArrayDataPool::current());
+    {
+        QArrayDataPool outer;
+        QCOMPARE(QArrayDataPool::current(), &outer);
+        {
+            QArrayDataPool inner;
+            QCOMPARE(QArrayDataPool::current(), &inner);
+        }
+        QCOMPARE(QArrayDataPool::current(), &outer);
+    }
+    QVERIFY(!QArrayDataPool::current());
+}
+
+void tst_QArrayDataPool::recycle()
+{
+    QArrayDataPool pool;
+    const QChar *first;
+    {
+        QString s(20, QLatin1Char('a'));
+        first = s.constData();
+    }
+    {
+        QString s(20, QLatin1Char('b'));
+        QCOMPARE(s.constData(), first);
+        QCOMPARE(s, QString(20, QLatin1Char('b')));
+
+        // the rounded up block is usable
+        const int capacity = s.capacity();
+        QVERIFY(capacity >= 20);
+        s.append(QString(capacity - 20, QLatin1Char('c')));
+        QCOMPARE(s.constData(), first);
+    }
+
+    QArrayDataPool::Statistics stats = pool.statistics();
+    QCOMPARE(stats.allocations, quint64(4));
+    QCOMPARE(stats.mallocCalls, quint64(3));
+    QCOMPARE(stats.recycled, quint64(4));
+}
+
+void tst_QArrayDataPool::escapingData()
+{
+    QString string;
+    QByteArray bytes;
+    QVector<int> vector;
+    {
+        QArrayDataPool pool;
+        QString temporary = QStringLiteral("temporary ") + QString::number(42);
+        string = temporary;
+        bytes = temporary.toLatin1();
+        vector.append(1);
+        vector.append(2);
+        temporary.clear();
+        QVERIFY(pool.statistics().allocations >= 3);
+    }
+
+    QCOMPARE(string, QLatin1String("temporary 42"));
+    QCOMPARE(bytes, QByteArray("temporary 42"));
+    QCOMPARE(vector, QVector<int>() << 1 << 2);
+
+    // the blocks are regular heap blocks
+    string += QLatin1String(" and more");
+    bytes.resize(1000);
+    vector.squeeze();
+    QCOMPARE(string, QLatin1String("temporary 42 and more"));
+    QVERIFY(bytes.startsWith("temporary 42"));
+    QCOMPARE(vector, QVector<int>() << 1 << 2);
+}
+
+void tst_QArrayDataPool::blocksFromOutside()
+{
+    QString outside = QString::fromLatin1("allocated before the pool");
+    QArrayDataPool pool;
+    outside = QString();
+    QCOMPARE(pool.statistics().recycled, quint64(1));
+
+    // a block allocated outside the pool can be rounded down to a bin, but
+    // never up: writing the whole capacity must stay within the block
+    QString inside(8, Qt::Uninitialized);
+    QVERIFY(inside.capacity() >= 8);
+    inside.fill(QLatin1Char('x'), inside.capacity());
+    QCOMPARE(inside.count(QLatin1Char('x')), inside.size());
+    QCOMPARE(pool.statistics().mallocCalls, quint64(0));
+}
+
+void tst_QArrayDataPool::rawData()
+{
+    static const QChar data[] = { QLatin1Char('r'), QLatin1Char('a'), QLatin1Char('w') };
+    QArrayDataPool pool;
+    {
+        QString raw = QString::fromRawData(data, 3);
+        QCOMPARE(raw.constData(), data);
+    }
+    QCOMPARE(pool.statistics().allocations, quint64(0));
+    QCOMPARE(pool.statistics().recycled, quint64(0));
+}
+
+void tst_QArrayDataPool::largeBlocks()
+{
+    QArrayDataPool pool;
+    {
+        QByteArray large(1024 * 1024, 'l');
+        QCOMPARE(large.count('l'), large.size());
+    }
+    QArrayDataPool::Statistics stats = pool.statistics();
+    QCOMPARE(stats.allocations, quint64(1));
+    QCOMPARE(stats.mallocCalls, quint64(1));
+    QCOMPARE(stats.recycled, quint64(0));
+}
+
+class StringThread : public QThread
+{
+public:
+    void run() override
+    {
+        hadPool = QArrayDataPool::current() != nullptr;
+        for (int i = 0; i < 100; ++i)
+            result += QString::number(i);
+    }
+
+    QString result;
+    bool hadPool = true;
+};
+
+void tst_QArrayDataPool::otherThread()
+{
+    QArrayDataPool pool;
+    StringThread thread;
+    thread.start();
+    QVERIFY(thread.wait());
+    QVERIFY(!thread.hadPool);
+    QCOMPARE(pool.statistics().allocations, quint64(0));
+
+    // freeing data allocated by another thread is fine
+    thread.result.clear();
+    QCOMPARE(pool.statistics().recycled, quint64(1));
+}
+
+QTEST_APPLESS_MAIN(tst_QArrayDataPool)
+#include "tst_qarraydatapool.moc"
@@ -33,6 +33,7 @@
 #include <qfile.h>
 #include <qhash.h>
 #include <limits.h>
+#include <private/qlz4_p.h>
 #include <private/qtools_p.h>
 
 class tst_QByteArray : public QObject
@@ -52,6 +53,10 @@ private slots:
     void qUncompressCorruptedData();
     void qCompressionZeroTermination();
 #endif
+    void qLz4Compress_data();
+    void qLz4Compress();
+    void qLz4UncompressCorruptedData_data();
+    void qLz4UncompressCorruptedData();
     void constByteArray();
     void leftJustified();
     void rightJustified();
@@ -349,6 +354,94 @@ void tst_QByteArray::qCompressionZeroTermination()
 
 #endif
 
+void tst_QByteArray::qLz4Compress_data()
+{
+    qCompress_data();
+
+    QTest::newRow("short") << QByteArray("abcdabcdabcd");
+    QTest::newRow("overlapping match") << QByteArray(100, 'x');
+}
+
+void tst_QByteArray::qLz4Compress()
+{
+    QFETCH(QByteArray, ba);
+    QByteArray compressed = ::qLz4Compress(ba);
+    QTEST(::qLz4Uncompress(compressed), "ba");
+
+    // uncompressing in steps gives the same result
+    QLz4Decoder decoder(reinterpret_cast<const uchar *>(compressed.constData()), compressed.size());
+    QCOMPARE(decoder.size(), qint64(ba.size()));
+    for (qint64 length = 0; length < ba.size(); length += 12345) {
+        QVERIFY(decoder.decode(length));
+        QVERIFY(decoder.decodedSize() >= length);
+        QCOMPARE(QByteArray(decoder.data(), int(length)), ba.left(int(length)));
+    }
+    QTEST(decoder.takeResult(), "ba");
+}
+
+void tst_QByteArray::qLz4UncompressCorruptedData_data()
+{
+    QTest::addColumn<QByteArray>("in");
+
+    // a size header, then tokens: four bits of literal length and four of
+    // match length, the literals, a little-endian offset, and more length
+    // bytes where the lengths are 15
+    QTest::newRow("no header") << QByteArray("\x00\x00\x04", 3);
+    QTest::newRow("no tokens") << QByteArray("\x00\x00\x00\x04", 4);
+    QTest::newRow("empty with token") << QByteArray("\x00\x00\x00\x00\x00", 5);
+    QTest::newRow("truncated literals") << QByteArray("\x00\x00\x00\x04\x40" "ab", 7);
+    QTest::newRow("truncated literal length") << QByteArray("\x00\x00\x00\x14\xf0", 5);
+    QTest::newRow("truncated offset") << QByteArray("\x00\x00\x00\x08\x40" "abcd" "\x04", 10);
+    QTest::newRow("truncated match length") << QByteArray("\x00\x00\x00\x20\x4f" "abcd" "\x04\x00", 11);
+    QTest::newRow("zero offset") << QByteArray("\x00\x00\x00\x08\x40" "abcd" "\x00\x00\x00", 12);
+    QTest::newRow("offset too large") << QByteArray("\x00\x00\x00\x08\x40" "abcd" "\x05\x00\x00", 12);
+    QTest::newRow("offset without output") << QByteArray("\x00\x00\x00\x04\x00\x01\x00\x00", 8);
+    QTest::newRow("literals past size") << QByteArray("\x00\x00\x00\x04\x50" "abcde", 10);
+    QTest::newRow("match past size") << QByteArray("\x00\x00\x00\x07\x40" "abcd" "\x04\x00\x00", 12);
+    QTest::newRow("no last literals") << QByteArray("\x00\x00\x00\x08\x40" "abcd" "\x04\x00", 11);
+    QTest::newRow("size too small") << QByteArray("\x00\x00\x00\x03\x40" "abcd", 9);
+    QTest::newRow("size too large") << QByteArray("\x00\x00\x00\x0a\x40" "abcd", 9);
+    QTest::newRow("size 0x7fffffff") << QByteArray("\x7f\xff\xff\xff\x40" "abcd", 9);
+    QTest::newRow("size 0xffffffff") << QByteArray("\xff\xff\xff\xff\x40" "abcd", 9);
+
+    // lengths that overflow
+    QByteArray overflow("\x00\x01\x00\x00\xf0", 5);
+    overflow += QByteArray(MaxAllocSize / 255 + 1, '\xff');
+    QTest::newRow("literal length overflow") << overflow;
+    overflow = QByteArray("\x00\x01\x00\x00\x4f" "abcd" "\x04\x00", 11);
+    overflow += QByteArray(MaxAllocSize / 255 + 1, '\xff');
+    QTest::newRow("match length overflow") << overflow;
+
+    const QByteArray compressed = ::qLz4Compress(QByteArray(1000, 'x') + "abcdefghijklmnop");
+    QByteArray wrongSize = compressed;
+    wrongSize[3] = char(wrongSize.at(3) + 1);
+    QTest::newRow("size header +1") << wrongSize;
+    wrongSize[3] = char(wrongSize.at(3) - 2);
+    QTest::newRow("size header -1") << wrongSize;
+    QTest::newRow("truncated") << compressed.left(compressed.size() - 1);
+    QTest::newRow("trailing data") << compressed + "blah";
+}
+
+// This test is expected to produce some warning messages in the test output.
+void tst_QByteArray::qLz4UncompressCorruptedData()
+{
+    QFETCH(QByteArray, in);
+
+    QByteArray res;
+    res = ::qLz4Uncompress(in);
+    QCOMPARE(res, QByteArray());
+
+    res = ::qLz4Uncompress(in + "blah");
+    QCOMPARE(res, QByteArray());
+
+    // the decoder finds the error when it gets to it, and once all of the
+    // output is there
+    QLz4Decoder decoder(reinterpret_cast<const uchar *>(in.constData()), in.size());
+    if (decoder.size() >= 0)
+        QVERIFY(!decoder.decode(decoder.size()));
+    QCOMPARE(decoder.takeResult(), QByteArray());
+}
+
 void tst_QByteArray::constByteArray()
 {
     const char *ptr = "abc";
@@ -0,0 +1,276 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <private/qflathash_p.h>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insert();
+    void remove();
+    void iterate();
+    void eraseWhileIterating();
+    void copyAndMove();
+    void reserveAndSqueeze();
+    void complexValues();
+    void compareWithQHash();
+};
+
+void tst_QFlatHash::insert()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.value(1), 0);
+    QCOMPARE(hash.value(1, -1), -1);
+    QVERIFY(!hash.contains(1));
+    QVERIFY(hash.find(1) == hash.end());
+
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i * 2);
+    QCOMPARE(hash.size(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(hash.contains(i));
+        QCOMPARE(hash.value(i), i * 2);
+        QCOMPARE(hash.find(i).key(), i);
+        QCOMPARE(*hash.constFind(i), i * 2);
+    }
+    QVERIFY(!hash.contains(1000));
+    QVERIFY(hash.capacity() >= 1000);
+
+    // inserting an existing key replaces its value
+    QFlatHash<int, int>::iterator it = hash.insert(7, 70);
+    QCOMPARE(it.key(), 7);
+    QCOMPARE(it.value(), 70);
+    QCOMPARE(hash.size(), 1000);
+
+    hash[7] = 71;
+    QCOMPARE(hash.value(7), 71);
+    QCOMPARE(hash[2000], 0);
+    QCOMPARE(hash.size(), 1001);
+
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+    QVERIFY(!hash.contains(7));
+}
+
+void tst_QFlatHash::remove()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+
+    QCOMPARE(hash.remove(1000), 0);
+    for (int i = 0; i < 100; i += 2)
+        QCOMPARE(hash.remove(i), 1);
+    QCOMPARE(hash.size(), 50);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.contains(i), i % 2 == 1);
+
+    QCOMPARE(hash.take(1), 1);
+    QCOMPARE(hash.take(1), 0);
+    QCOMPARE(hash.size(), 49);
+
+    // reusing removed slots
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 1000; i < 1100; ++i)
+            hash.insert(i, i);
+        for (int i = 1000; i < 1100; ++i)
+            QCOMPARE(hash.remove(i), 1);
+    }
+    QCOMPARE(hash.size(), 49);
+    QVERIFY(hash.capacity() < 1000);
+    for (int i = 3; i < 100; i += 2)
+        QCOMPARE(hash.value(i), i);
+}
+
+void tst_QFlatHash::iterate()
+{
+    QFlatHash<QString, int> hash;
+    QCOMPARE(hash.begin(), hash.end());
+    QCOMPARE(hash.constBegin(), hash.constEnd());
+
+    QSet<QString> expected;
+    for (int i = 0; i < 300; ++i) {
+        hash.insert(QString::number(i), i);
+        expected.insert(QString::number(i));
+    }
+
+    QSet<QString> seen;
+    for (QFlatHash<QString, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        QCOMPARE(it.key(), QString::number(it.value()));
+        seen.insert(it.key());
+    }
+    QCOMPARE(seen, expected);
+
+    for (QFlatHash<QString, int>::iterator it = hash.begin(); it != hash.end(); ++it)
+        *it += 1;
+    QCOMPARE(hash.value(QStringLiteral("42")), 43);
+
+    QCOMPARE(hash.keys().toSet(), expected);
+    QCOMPARE(hash.values().size(), 300);
+}
+
+void tst_QFlatHash::eraseWhileIterating()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 500; ++i)
+        hash.insert(i, i);
+
+    QFlatHash<int, int>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        if (it.key() % 3 == 0)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(hash.size(), 333);
+    for (int i = 0; i < 500; ++i)
+        QCOMPARE(hash.contains(i), i % 3 != 0);
+}
+
+void tst_QFlatHash::copyAndMove()
+{
+    QFlatHash<QString, QString> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(QString::number(i), QString::number(i * i));
+
+    QFlatHash<QString, QString> copy = hash;
+    QCOMPARE(copy, hash);
+    copy.insert(QStringLiteral("x"), QStringLiteral("y"));
+    QVERIFY(copy != hash);
+    QVERIFY(!hash.contains(QStringLiteral("x")));
+
+    QFlatHash<QString, QString> moved = std::move(copy);
+    QVERIFY(copy.isEmpty());
+    QCOMPARE(moved.size(), 101);
+    QCOMPARE(moved.value(QStringLiteral("9")), QStringLiteral("81"));
+
+    copy = moved;
+    QCOMPARE(copy, moved);
+    moved = QFlatHash<QString, QString>();
+    QVERIFY(moved.isEmpty());
+    QCOMPARE(copy.size(), 101);
+
+    QFlatHash<int, int> list = { { 1, 2 }, { 3, 4 } };
+    QCOMPARE(list.size(), 2);
+    QCOMPARE(list.value(3), 4);
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    const int capacity = hash.capacity();
+    QVERIFY(capacity >= 1000);
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    // reserving less does not shrink the table
+    hash.reserve(10);
+    QCOMPARE(hash.capacity(), capacity);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < 100);
+    QCOMPARE(hash.size(), 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i), i);
+
+    hash.clear();
+    hash.squeeze();
+    QCOMPARE(hash.capacity(), 0);
+}
+
+struct Counted
+{
+    Counted(int v = 0) : v(v) { ++alive; }
+    Counted(const Counted &o) : v(o.v) { ++alive; }
+    ~Counted() { --alive; }
+    Counted &operator=(const Counted &o) { v = o.v; return *this; }
+    bool operator==(const Counted &o) const { return v == o.v; }
+
+    int v;
+    static int alive;
+};
+
+int Counted::alive = 0;
+
+void tst_QFlatHash::complexValues()
+{
+    {
+        QFlatHash<int, Counted> hash;
+        for (int i = 0; i < 200; ++i)
+            hash.insert(i, Counted(i));
+        QCOMPARE(Counted::alive, 200);
+        for (int i = 0; i < 100; ++i)
+            hash.remove(i);
+        QCOMPARE(Counted::alive, 100);
+        QFlatHash<int, Counted> copy = hash;
+        QCOMPARE(Counted::alive, 200);
+        hash.squeeze();
+        QCOMPARE(Counted::alive, 200);
+        QCOMPARE(hash.value(150).v, 150);
+    }
+    QCOMPARE(Counted::alive, 0);
+}
+
+void tst_QFlatHash::compareWithQHash()
+{
+    QFlatHash<QString, int> flat;
+    QHash<QString, int> reference;
+    quint32 state = 1;
+    for (int i = 0; i < 100000; ++i) {
+        state = state * 1664525u + 1013904223u;
+        const QString key = QString::number(state % 5000);
+        switch ((state >> 16) % 3) {
+        case 0:
+        case 1:
+            flat.insert(key, i);
+            reference.insert(key, i);
+            break;
+        case 2:
+            QCOMPARE(flat.remove(key), reference.remove(key));
+            break;
+        }
+    }
+    QCOMPARE(flat.size(), reference.size());
+    for (QHash<QString, int>::const_iterator it = reference.constBegin(); it != reference.constEnd(); ++it)
+        QCOMPARE(flat.value(it.key(), -1), it.value());
+    int n = 0;
+    for (QFlatHash<QString, int>::const_iterator it = flat.constBegin(); it != flat.constEnd(); ++it, ++n)
+        QCOMPARE(reference.value(it.key(), -1), it.value());
+    QCOMPARE(n, reference.size());
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
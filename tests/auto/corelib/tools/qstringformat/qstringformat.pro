@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qstringformat
+QT = core testlib
+SOURCES = tst_qstringformat.cpp
@@ -0,0 +1,201 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtTest/QtTest>
+#include <QtCore/QStringFormat>
+
+class tst_QStringFormat : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+    void placeholders_data();
+    void placeholders();
+    void strings();
+    void numbers_data();
+    void numbers();
+    void localized();
+    void missingArguments();
+    void extraArguments();
+    void argumentsNotScanned();
+    void copy();
+};
+
+void tst_QStringFormat::cleanup()
+{
+    QLocale::setDefault(QLocale::c());
+}
+
+void tst_QStringFormat::placeholders_data()
+{
+    QTest::addColumn<QString>("format");
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("empty") << QString() << 0;
+    QTest::newRow("plain") << QStringLiteral("no place markers") << 0;
+    QTest::newRow("one") << QStringLiteral("%1") << 1;
+    QTest::newRow("ordered") << QStringLiteral("%1 and %2, %3") << 3;
+    QTest::newRow("reversed") << QStringLiteral("%3 and %2, %1") << 3;
+    QTest::newRow("gaps") << QStringLiteral("[%5|%12|%3]") << 3;
+    QTest::newRow("repeated") << QStringLiteral("%1%2%1%2") << 2;
+    QTest::newRow("localized") << QStringLiteral("%L1 %1 %L2") << 2;
+    QTest::newRow("two-digits") << QStringLiteral("%99 %123") << 2;
+    QTest::newRow("not-markers") << QStringLiteral("100% %L %a %%1 %") << 1;
+}
+
+void tst_QStringFormat::placeholders()
+{
+    QFETCH(QString, format);
+    QFETCH(int, count);
+
+    const QStringFormat f(format);
+    QCOMPARE(f.format(), format);
+    QCOMPARE(f.placeholderCount(), count);
+}
+
+void tst_QStringFormat::strings()
+{
+    const QString first = QStringLiteral("first");
+    const QString second = QStringLiteral("second");
+    const QString longer = QStringLiteral("<a somewhat longer text>");
+
+    QStringFormat f(QStringLiteral("%1 and %2, %3"));
+    QCOMPARE(f.arg(first, second, longer),
+             QStringLiteral("%1 and %2, %3").arg(first).arg(second).arg(longer));
+
+    f = QStringFormat(QStringLiteral("[%3|%2|%1|%3]"));
+    QCOMPARE(f.arg(first, second, longer),
+             QStringLiteral("[%3|%2|%1|%3]").arg(first).arg(second).arg(longer));
+
+    QCOMPARE(f.arg(QLatin1String("latin1"), QChar(0x20ac), QLatin1Char('c')),
+             QString::fromUtf8("[c|\xe2\x82\xac|latin1|c]"));
+    QCOMPARE(f.arg('a', first.midRef(1, 3), first + QLatin1Char('-') + second),
+             QStringLiteral("[first-second|irs|a|first-second]"));
+    QCOMPARE(f.arg(QString(), QString(), QString()), QStringLiteral("[|||]"));
+
+    QCOMPARE(QStringFormat(QStringLiteral("%1")).arg(longer), longer);
+    QCOMPARE(QStringFormat(QStringLiteral("100% %L %a %%1 %")).arg(first),
+             QStringLiteral("100% %L %a %first %"));
+}
+
+void tst_QStringFormat::numbers_data()
+{
+    QTest::addColumn<QString>("format");
+
+    QTest::newRow("plain") << QStringLiteral("%1/%2/%3/%4/%5");
+    QTest::newRow("localized") << QStringLiteral("%L1/%L2/%L3/%L4/%L5");
+    QTest::newRow("mixed") << QStringLiteral("%1/%L2/%3/%L4/%5 (%L1)");
+}
+
+void tst_QStringFormat::numbers()
+{
+    QFETCH(QString, format);
+
+    QLocale::setDefault(QLocale(QLocale::German, QLocale::Germany));
+    const QStringFormat f(format);
+
+    const qlonglong minimum = std::numeric_limits<qlonglong>::min();
+    const qulonglong maximum = std::numeric_limits<qulonglong>::max();
+    QCOMPARE(f.arg(0, -1, minimum, maximum, 1234567),
+             format.arg(0).arg(-1).arg(minimum).arg(maximum).arg(1234567));
+
+    const short s = -42;
+    const ushort us = 65535;
+    const long l = -1234567890L;
+    const ulong ul = 4000000000UL;
+    QCOMPARE(f.arg(s, us, l, ul, 12u),
+             format.arg(s).arg(us).arg(l).arg(ul).arg(12u));
+
+    QCOMPARE(f.arg(0.0, -1.5, 1234567.891, 1e100, 3.14159265358979),
+             format.arg(0.0).arg(-1.5).arg(1234567.891).arg(1e100).arg(3.14159265358979));
+}
+
+void tst_QStringFormat::localized()
+{
+    const QStringFormat f(QStringLiteral("%1 %L1"));
+    QCOMPARE(f.arg(1234567), QStringLiteral("1234567 1234567"));
+
+    QLocale::setDefault(QLocale(QLocale::German, QLocale::Germany));
+    QCOMPARE(f.arg(1234567), QStringLiteral("1234567 1.234.567"));
+    QCOMPARE(f.arg(1234.5), QStringLiteral("1234.5 1.234,5"));
+
+    // strings are not affected
+    QCOMPARE(f.arg(QStringLiteral("1234567")), QStringLiteral("1234567 1234567"));
+
+    QLocale german = QLocale();
+    german.setNumberOptions(QLocale::OmitGroupSeparator);
+    QLocale::setDefault(german);
+    QCOMPARE(f.arg(1234567), QStringLiteral("1234567 1234567"));
+}
+
+void tst_QStringFormat::missingArguments()
+{
+    const QStringFormat f(QStringLiteral("%1 %2 %L3 %1"));
+    QCOMPARE(f.arg(QStringLiteral("a")), QStringLiteral("a %2 %L3 a"));
+    QCOMPARE(f.arg(1, 2), QStringLiteral("1 2 %L3 1"));
+    QCOMPARE(f.arg(), f.format());
+}
+
+void tst_QStringFormat::extraArguments()
+{
+    const QStringFormat f(QStringLiteral("%1 %2"));
+    QTest::ignoreMessage(QtWarningMsg, "QStringFormat::arg: 1 surplus argument(s) for %1 %2");
+    QCOMPARE(f.arg(1, 2, 3), QStringLiteral("1 2"));
+
+    QTest::ignoreMessage(QtWarningMsg, "QStringFormat::arg: 1 surplus argument(s) for ");
+    QCOMPARE(QStringFormat().arg(1), QString());
+}
+
+void tst_QStringFormat::argumentsNotScanned()
+{
+    // chained arg() calls would replace the %2 inserted by the first one
+    const QStringFormat f(QStringLiteral("%1 %2"));
+    QCOMPARE(f.arg(QStringLiteral("%2"), QStringLiteral("x")), QStringLiteral("%2 x"));
+    QCOMPARE(QStringLiteral("%1 %2").arg(QStringLiteral("%2")).arg(QStringLiteral("x")),
+             QStringLiteral("x x"));
+}
+
+void tst_QStringFormat::copy()
+{
+    QStringFormat f(QStringLiteral("<%1>"));
+    QStringFormat copy = f;
+    QCOMPARE(copy.format(), f.format());
+    QCOMPARE(copy.arg(1), QStringLiteral("<1>"));
+
+    QStringFormat other;
+    QCOMPARE(other.placeholderCount(), 0);
+    other.swap(copy);
+    QCOMPARE(other.arg(2), QStringLiteral("<2>"));
+    QVERIFY(copy.format().isEmpty());
+
+    copy = std::move(other);
+    QCOMPARE(copy.arg(3), QStringLiteral("<3>"));
+}
+
+QTEST_APPLESS_MAIN(tst_QStringFormat)
+#include "tst_qstringformat.moc"
@@ -4,6 +4,7 @@ SUBDIRS=\
     qalgorithms \
     qarraydata \
     qarraydata_strictiterators \
+    qarraydatapool \
     qbitarray \
     qbytearray \
     qbytearraylist \
@@ -19,6 +20,7 @@ SUBDIRS=\
     qdatetime \
     qeasingcurve \
     qexplicitlyshareddatapointer \
+    qflathash \
     qfreelist \
     qhash \
     qhash_strictiterators \
@@ -52,6 +54,7 @@ SUBDIRS=\
     qstring_no_cast_from_bytearray \
     qstringapisymmetry \
     qstringbuilder \
+    qstringformat \
     qstringiterator \
     qstringlist \
     qstringmatcher \
@@ -68,6 +68,8 @@ private slots:
     void updateMetaData();
     void fileMetaData();
     void expire();
+    void expireLeastRecentlyUsed();
+    void index();
 
     void oldCacheVersionFile_data();
     void oldCacheVersionFile();
@@ -260,11 +262,25 @@ static QStringList countFiles(const QString dir)
     QStringList list;
     QDir::Filters filter(QDir::AllEntries | QDir::NoDotAndDotDot);
     QDirIterator it(dir, filter, QDirIterator::Subdirectories);
-    while (it.hasNext())
-        list.append(it.next());
+    while (it.hasNext()) {
+        const QString path = it.next();
+        // the cache index is not a cache item
+        if (it.fileName() != QLatin1String("index"))
+            list.append(path);
+    }
     return list;
 }
 
+static void insertItem(QNetworkDiskCache *cache, const QUrl &url, int size)
+{
+    QNetworkCacheMetaData m;
+    m.setUrl(url);
+    QIODevice *d = cache->prepare(m);
+    QVERIFY(d);
+    d->write(QByteArray(size, 'Z'));
+    cache->insert(d);
+}
+
 // public void clear()
 void tst_QNetworkDiskCache::clear()
 {
@@ -527,6 +543,96 @@ void tst_QNetworkDiskCache::expire()
     }
 }
 
+void tst_QNetworkDiskCache::expireLeastRecentlyUsed()
+{
+    SubQNetworkDiskCache cache;
+    cache.setCacheDirectory(tempDir.path());
+    cache.setMaximumCacheSize(1024 * 1024);
+
+    const QUrl a("http://localhost:4/a");
+    const QUrl b("http://localhost:4/b");
+    const QUrl c("http://localhost:4/c");
+    insertItem(&cache, a, 200 * 1024);
+    insertItem(&cache, b, 200 * 1024);
+    insertItem(&cache, c, 200 * 1024);
+
+    // using a makes b the least recently used item
+    QVERIFY(cache.metaData(a).isValid());
+
+    cache.setMaximumCacheSize(512 * 1024);
+    QVERIFY(cache.cacheSize() < 512 * 1024);
+    QVERIFY(cache.metaData(a).isValid());
+    QVERIFY(!cache.metaData(b).isValid());
+    QVERIFY(cache.metaData(c).isValid());
+    QCOMPARE(countFiles(cache.cacheDirectory()).count(), NUM_SUBDIRECTORIES + 4);
+}
+
+void tst_QNetworkDiskCache::index()
+{
+    const QUrl a("http://localhost:4/a");
+    const QUrl b("http://localhost:4/b");
+    qint64 size;
+    {
+        QNetworkDiskCache cache;
+        cache.setCacheDirectory(tempDir.path());
+        insertItem(&cache, a, 1000);
+        insertItem(&cache, b, 2000);
+        size = cache.cacheSize();
+        QVERIFY(size > 3000);
+        cache.remove(a);
+        QVERIFY(cache.cacheSize() < size);
+        size = cache.cacheSize();
+    }
+
+    const QString indexFile = tempDir.path() + QLatin1String("/data8/index");
+    QVERIFY(QFile::exists(indexFile));
+
+    // the index is kept between instances
+    {
+        SubQNetworkDiskCache cache;
+        cache.setCacheDirectory(tempDir.path());
+        QCOMPARE(cache.cacheSize(), size);
+        QVERIFY(!cache.metaData(a).isValid());
+        QVERIFY(cache.metaData(b).isValid());
+    }
+    QCOMPARE(countFiles(tempDir.path()).count(), NUM_SUBDIRECTORIES + 2);
+
+    // and recreated from the files if it is lost
+    {
+        QNetworkDiskCache cache;
+        cache.setCacheDirectory(tempDir.path());
+        insertItem(&cache, a, 1000);
+        size = cache.cacheSize();
+    }
+    QVERIFY(QFile::remove(indexFile));
+    {
+        SubQNetworkDiskCache cache;
+        cache.setCacheDirectory(tempDir.path());
+        QVERIFY(QFile::exists(indexFile));
+        QCOMPARE(cache.cacheSize(), size);
+        QVERIFY(cache.metaData(a).isValid());
+    }
+
+    // a partially written record is ignored
+    {
+        QNetworkDiskCache cache;
+        cache.setCacheDirectory(tempDir.path());
+        insertItem(&cache, b, 1000);
+        size = cache.cacheSize();
+    }
+    {
+        QFile file(indexFile);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+        file.write("\x00\x00\x00", 3);
+    }
+    {
+        SubQNetworkDiskCache cache;
+        cache.setCacheDirectory(tempDir.path());
+        QCOMPARE(cache.cacheSize(), size);
+        QVERIFY(cache.metaData(b).isValid());
+    }
+}
+
 void tst_QNetworkDiskCache::oldCacheVersionFile_data()
 {
     QTest::addColumn<int>("pass");
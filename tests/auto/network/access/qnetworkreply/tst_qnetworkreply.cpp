@@ -382,6 +382,9 @@ private Q_SLOTS:
     void httpReUsingConnectionSequential();
     void httpReUsingConnectionFromFinishedSlot_data();
     void httpReUsingConnectionFromFinishedSlot();
+    void httpMaximumConnectionsPerHost();
+    void httpConnectionWasReused();
+    void httpSharedConnectionPool();
 
     void httpRecursiveCreation();
 
@@ -6061,6 +6064,99 @@ void tst_QNetworkReply::httpReUsingConnectionFromFinishedSlot()
     QCOMPARE(server.totalConnections, 1);
 }
 
+void tst_QNetworkReply::httpMaximumConnectionsPerHost()
+{
+    QNetworkAccessManager qnam;
+    QCOMPARE(qnam.maximumConnectionsPerHost(), 6);
+    QTest::ignoreMessage(QtWarningMsg, "QNetworkAccessManager::setMaximumConnectionsPerHost: invalid count 0");
+    qnam.setMaximumConnectionsPerHost(0);
+    QCOMPARE(qnam.maximumConnectionsPerHost(), 6);
+    qnam.setMaximumConnectionsPerHost(2);
+    QCOMPARE(qnam.maximumConnectionsPerHost(), 2);
+
+    QTcpServer server;
+    QVERIFY(server.listen());
+
+    for (int i = 0; i < 10; i++) {
+        QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + QLatin1Char('/') + QString::number(i)));
+        QNetworkReply *reply = qnam.get(request);
+        reply->setParent(&server);
+    }
+
+    int pendingConnectionCount = 0;
+    QTime time;
+    time.start();
+    while (time.elapsed() < 3000) {
+        QTestEventLoop::instance().enterLoop(1);
+        while (QTcpSocket *socket = server.nextPendingConnection()) {
+            pendingConnectionCount++;
+            socket->setParent(&server);
+        }
+    }
+
+    QCOMPARE(pendingConnectionCount, 2);
+}
+
+void tst_QNetworkReply::httpConnectionWasReused()
+{
+    QByteArray response("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+    MiniHttpServer server(response);
+    server.multiple = true;
+    server.doClose = false;
+
+    QUrl url("http://127.0.0.1:" + QString::number(server.serverPort()));
+    QNetworkReplyPtr reply1(manager.get(QNetworkRequest(url)));
+    QVERIFY2(waitForFinish(reply1) == Success, msgWaitForFinished(reply1));
+    QCOMPARE(reply1->attribute(QNetworkRequest::ConnectionWasReusedAttribute).toBool(), false);
+
+    QNetworkReplyPtr reply2(manager.get(QNetworkRequest(url)));
+    QVERIFY2(waitForFinish(reply2) == Success, msgWaitForFinished(reply2));
+    QCOMPARE(reply2->attribute(QNetworkRequest::ConnectionWasReusedAttribute).toBool(), true);
+
+    QCOMPARE(server.totalConnections, 1);
+}
+
+void tst_QNetworkReply::httpSharedConnectionPool()
+{
+    QByteArray response("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+    MiniHttpServer server(response);
+    server.multiple = true;
+    server.doClose = false;
+
+    QUrl url("http://127.0.0.1:" + QString::number(server.serverPort()));
+
+    QNetworkAccessManager first;
+    QVERIFY(!first.isSharedConnectionPoolEnabled());
+    first.setSharedConnectionPoolEnabled(true);
+    QVERIFY(first.isSharedConnectionPoolEnabled());
+    QNetworkReplyPtr reply1(first.get(QNetworkRequest(url)));
+    QVERIFY2(waitForFinish(reply1) == Success, msgWaitForFinished(reply1));
+    QCOMPARE(reply1->attribute(QNetworkRequest::ConnectionWasReusedAttribute).toBool(), false);
+
+    {
+        // a second manager picks up the idle connection of the first one
+        QNetworkAccessManager second;
+        second.setSharedConnectionPoolEnabled(true);
+        QNetworkReplyPtr reply2(second.get(QNetworkRequest(url)));
+        QVERIFY2(waitForFinish(reply2) == Success, msgWaitForFinished(reply2));
+        QCOMPARE(reply2->attribute(QNetworkRequest::ConnectionWasReusedAttribute).toBool(), true);
+        QCOMPARE(server.totalConnections, 1);
+    }
+
+    // the pool survives the second manager as long as the first one exists
+    QNetworkReplyPtr reply3(first.get(QNetworkRequest(url)));
+    QVERIFY2(waitForFinish(reply3) == Success, msgWaitForFinished(reply3));
+    QCOMPARE(reply3->attribute(QNetworkRequest::ConnectionWasReusedAttribute).toBool(), true);
+    QCOMPARE(server.totalConnections, 1);
+
+    // a manager with its own pool does not see the shared connections
+    QNetworkAccessManager separate;
+    QNetworkReplyPtr reply4(separate.get(QNetworkRequest(url)));
+    QVERIFY2(waitForFinish(reply4) == Success, msgWaitForFinished(reply4));
+    QCOMPARE(reply4->attribute(QNetworkRequest::ConnectionWasReusedAttribute).toBool(), false);
+    QCOMPARE(server.totalConnections, 2);
+}
+
 class HttpRecursiveCreationHelper : public QObject
 {
     Q_OBJECT
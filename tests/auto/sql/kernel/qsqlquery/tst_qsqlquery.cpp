@@ -158,6 +158,10 @@ private slots:
     void psql_bindWithDoubleColonCastOperator();
     void psql_specialFloatValues_data() { generic_data("QPSQL"); }
     void psql_specialFloatValues();
+    void psql_forwardOnlyQuery_data() { generic_data("QPSQL"); }
+    void psql_forwardOnlyQuery();
+    void psql_forwardOnlyQueryResultsLost_data() { generic_data("QPSQL"); }
+    void psql_forwardOnlyQueryResultsLost();
     void queryOnInvalidDatabase_data() { generic_data(); }
     void queryOnInvalidDatabase();
     void createQueryOnClosedDatabase_data() { generic_data(); }
@@ -237,6 +241,15 @@ private slots:
     void sqlite_real_data() { generic_data("QSQLITE"); }
     void sqlite_real();
 
+    void sqlite_statementCache_data() { generic_data("QSQLITE"); }
+    void sqlite_statementCache();
+
+    void sqlite_execBatchRollback_data() { generic_data("QSQLITE"); }
+    void sqlite_execBatchRollback();
+
+    void execAsync_data() { generic_data(); }
+    void execAsync();
+
     void aggregateFunctionTypes_data() { generic_data(); }
     void aggregateFunctionTypes();
 
@@ -2158,7 +2171,10 @@ void tst_QSqlQuery::batchExec()
     q.addBindValue( numCol );
 
     QVERIFY_SQL( q, execBatch() );
-    QVERIFY_SQL( q, exec( "select id, name, dt, num from " + tableName + " order by id" ) );
+    // SQLite sorts NULL values first
+    const QString nullsLast = tst_Databases::getDatabaseType(db) == QSqlDriver::SQLite
+            ? QString("id is null, ") : QString();
+    QVERIFY_SQL( q, exec( "select id, name, dt, num from " + tableName + " order by " + nullsLast + "id" ) );
 
     QVERIFY( q.next() );
     QCOMPARE( q.value( 0 ).toInt(), 1 );
@@ -2460,6 +2476,68 @@ void tst_QSqlQuery::psql_specialFloatValues()
     QVERIFY_SQL( query, exec("drop table " + tableName) );
 }
 
+void tst_QSqlQuery::psql_forwardOnlyQuery()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    QSqlQuery q( db );
+    q.setForwardOnly( true );
+    QVERIFY_SQL( q, exec( "select generate_series(1, 100000)" ) );
+    int count = 0;
+    while ( q.next() ) {
+        ++count;
+        QCOMPARE( q.value( 0 ).toInt(), count );
+    }
+    QCOMPARE( count, 100000 );
+    QVERIFY( !q.lastError().isValid() );
+    QCOMPARE( q.at(), int( QSql::AfterLastRow ) );
+
+    // the connection is ready for the next statement
+    QVERIFY_SQL( q, exec( "select 42" ) );
+    QVERIFY_SQL( q, next() );
+    QCOMPARE( q.value( 0 ).toInt(), 42 );
+
+    QVERIFY_SQL( q, exec( "select generate_series(1, 10)" ) );
+    QVERIFY( q.seek( 4 ) );
+    QCOMPARE( q.value( 0 ).toInt(), 5 );
+    QVERIFY( q.last() );
+    QCOMPARE( q.value( 0 ).toInt(), 10 );
+    QVERIFY( !q.next() );
+
+    // an empty result set
+    QVERIFY_SQL( q, exec( "select generate_series(1, 0)" ) );
+    QVERIFY( !q.next() );
+    QVERIFY( !q.lastError().isValid() );
+}
+
+void tst_QSqlQuery::psql_forwardOnlyQueryResultsLost()
+{
+    QFETCH( QString, dbName );
+    QSqlDatabase db = QSqlDatabase::database( dbName );
+    CHECK_DATABASE( db );
+
+    QSqlQuery q1( db );
+    q1.setForwardOnly( true );
+    QVERIFY_SQL( q1, exec( "select generate_series(1, 10)" ) );
+    if ( q1.size() != -1 )
+        QSKIP( "The PostgreSQL client library does not support single row mode" );
+    QVERIFY_SQL( q1, next() );
+    QCOMPARE( q1.value( 0 ).toInt(), 1 );
+
+    // executing another statement on the connection discards the remaining rows
+    QSqlQuery q2( db );
+    QVERIFY_SQL( q2, exec( "select 2" ) );
+    QVERIFY_SQL( q2, next() );
+    QCOMPARE( q2.value( 0 ).toInt(), 2 );
+
+    QTest::ignoreMessage( QtWarningMsg, "QPSQLDriver::getResult: Query results lost - "
+                                        "probably discarded on executing another SQL query." );
+    QVERIFY( !q1.next() );
+    QCOMPARE( q1.lastError().type(), QSqlError::StatementError );
+}
+
 /* For task 157397: Using QSqlQuery with an invalid QSqlDatabase
    does not set the last error of the query.
    This test function will output some warnings, that's ok.
@@ -3844,6 +3922,137 @@ void tst_QSqlQuery::sqlite_real()
     QCOMPARE(q.value(0).toDouble(), 5.6);
 }
 
+void tst_QSqlQuery::sqlite_statementCache()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName(qTableName("sqlitestmtcache", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INTEGER, name VARCHAR(20))"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " VALUES (1, 'one')"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " VALUES (2, 'two')"));
+
+    const QString select = "SELECT name FROM " + tableName + " WHERE id = ?";
+    for (int i = 0; i < 3; ++i) {
+        QSqlQuery q2(db);
+        QVERIFY_SQL(q2, prepare(select));
+        q2.addBindValue(2);
+        QVERIFY_SQL(q2, exec());
+        QVERIFY(q2.next());
+        QCOMPARE(q2.value(0).toString(), QString("two"));
+        QVERIFY(!q2.next());
+    }
+
+    // two queries with the same text must not share a statement
+    QSqlQuery q3(db);
+    QSqlQuery q4(db);
+    QVERIFY_SQL(q3, prepare(select));
+    QVERIFY_SQL(q4, prepare(select));
+    q3.addBindValue(1);
+    q4.addBindValue(2);
+    QVERIFY_SQL(q3, exec());
+    QVERIFY_SQL(q4, exec());
+    QVERIFY(q3.next());
+    QVERIFY(q4.next());
+    QCOMPARE(q3.value(0).toString(), QString("one"));
+    QCOMPARE(q4.value(0).toString(), QString("two"));
+    q3.clear();
+    q4.clear();
+
+    // cached statements must not outlive the table they refer to
+    QVERIFY_SQL(q, exec("DROP TABLE " + tableName));
+    QVERIFY(!q.prepare(select));
+}
+
+void tst_QSqlQuery::sqlite_execBatchRollback()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName(qTableName("sqlitebatch", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INTEGER PRIMARY KEY, name VARCHAR(20))"));
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?)"));
+
+    q.addBindValue(QVariantList() << 1 << 2 << 3);
+    q.addBindValue(QVariantList() << "a" << "b" << "c");
+    QVERIFY_SQL(q, execBatch());
+
+    // the duplicate key fails the batch, none of its rows are inserted
+    q.addBindValue(QVariantList() << 4 << 5 << 1);
+    q.addBindValue(QVariantList() << "d" << "e" << "f");
+    QVERIFY(!q.execBatch());
+    QVERIFY(q.lastError().isValid());
+
+    // lists of different lengths are rejected
+    q.addBindValue(QVariantList() << 6 << 7);
+    q.addBindValue(QVariantList() << "g");
+    QVERIFY(!q.execBatch());
+
+    QVERIFY_SQL(q, exec("SELECT COUNT(*) FROM " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 3);
+    QVERIFY(db.driver()->hasFeature(QSqlDriver::Transactions));
+    QVERIFY(db.transaction());
+    QVERIFY(db.commit());
+}
+
+void tst_QSqlQuery::execAsync()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName(qTableName("asyncexec", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INTEGER, name VARCHAR(20))"));
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?)"));
+    for (int i = 1; i <= 2; ++i) {
+        q.bindValue(0, i);
+        q.bindValue(1, QString(QLatin1Char('a' + i - 1)));
+        QFuture<bool> inserted = q.execAsync();
+        // the results of the QPSQL driver are read by the event loop
+        QTRY_VERIFY(inserted.isFinished());
+        QVERIFY2(inserted.result(), tst_Databases::printError(q.lastError(), db));
+    }
+
+    // the queries of a connection run in the order they were started
+    QSqlQuery insert(db);
+    QSqlQuery select(db);
+    const QFuture<bool> inserted = insert.execAsync("INSERT INTO " + tableName + " VALUES (3, 'c')");
+    const QFuture<bool> selected = select.execAsync("SELECT id, name FROM " + tableName + " ORDER BY id");
+    QTRY_VERIFY(selected.isFinished());
+    QVERIFY(inserted.isFinished());
+    QVERIFY2(inserted.result(), tst_Databases::printError(insert.lastError(), db));
+    QVERIFY2(selected.result(), tst_Databases::printError(select.lastError(), db));
+    QVERIFY(select.isActive());
+    QVERIFY(select.isSelect());
+    for (int i = 1; i <= 3; ++i) {
+        QVERIFY(select.next());
+        QCOMPARE(select.value(0).toInt(), i);
+        QCOMPARE(select.value(1).toString(), QString(QLatin1Char('a' + i - 1)));
+    }
+    QVERIFY(!select.next());
+
+    const QFuture<bool> failed = select.execAsync("SELECT * FROM " + tableName + "_doesnotexist");
+    QTRY_VERIFY(failed.isFinished());
+    QVERIFY(!failed.result());
+    QVERIFY(select.lastError().isValid());
+    QVERIFY(!select.isActive());
+
+    // nothing is started when the query is rejected up front
+    QTest::ignoreMessage(QtWarningMsg, "QSqlQuery::exec: empty query");
+    const QFuture<bool> empty = select.execAsync(QString());
+    QVERIFY(empty.isFinished());
+    QVERIFY(!empty.result());
+}
+
 void tst_QSqlQuery::aggregateFunctionTypes()
 {
     QFETCH(QString, dbName);
@@ -33,6 +33,7 @@
 #include <QtSql/QSqlDriver>
 #include <QtSql/QSqlRecord>
 #include <private/qsqldriver_p.h>
+#include <private/qsqlcachedresult_p.h>
 
 class TestSqlDriverResult : public QSqlResult
 {
@@ -63,6 +64,46 @@ protected:
     QSqlRecord record() const { return QSqlRecord(); }
 };
 
+// Serves the rows it was given through the QSqlCachedResult row cache
+class TestSqlCachedResult : public QSqlCachedResult
+{
+public:
+    TestSqlCachedResult(const QSqlDriver *driver, const QVector<QVector<QVariant> > &rows)
+        : QSqlCachedResult(*new QSqlCachedResultPrivate(this, driver)), rows(rows), next(0)
+    {
+        setSelect(true);
+        setActive(true);
+        init(rows.at(0).count());
+    }
+
+    using QSqlCachedResult::data;
+    using QSqlCachedResult::isNull;
+    using QSqlCachedResult::fetch;
+    using QSqlCachedResult::fetchLast;
+    using QSqlCachedResult::at;
+
+protected:
+    bool gotoNext(ValueCache &values, int index)
+    {
+        if (next >= rows.count())
+            return false;
+        if (index >= 0) {
+            for (int i = 0; i < rows.at(next).count(); ++i)
+                values[index + i] = rows.at(next).at(i);
+        }
+        ++next;
+        return true;
+    }
+    bool reset(const QString & /* query */) { return false; }
+    int size() { return -1; }
+    int numRowsAffected() { return 0; }
+    QSqlRecord record() const { return QSqlRecord(); }
+
+private:
+    QVector<QVector<QVariant> > rows;
+    int next;
+};
+
 class TestSqlDriver : public QSqlDriver
 {
     Q_DECLARE_PRIVATE(QSqlDriver)
@@ -41,6 +41,7 @@ public:
 private slots:
     void positionalToNamedBinding();
     void parseOfBoundValues();
+    void cachedValues();
 
 };
 
@@ -101,5 +102,50 @@ void tst_QSqlResult::parseOfBoundValues()
     QCOMPARE(result.boundValues().count(), 1);
 }
 
+void tst_QSqlResult::cachedValues()
+{
+    const QDate date(2017, 9, 14);
+    const QTime time(13, 37, 42, 123);
+    const QVector<QVariant> columns[] = {
+        { 1, -2, QVariant(QVariant::Int), 2147483647, QString("mixed") },
+        { 1.5, -0.0, 1e300, QVariant(QVariant::Double), 3 },
+        { QString("abc"), QString(""), QVariant(QVariant::String), QString(QChar(0x263a)), QString() },
+        { QByteArray("a\0b", 3), QByteArray(), QByteArray(""), QByteArray("x"), QVariant() },
+        { Q_INT64_C(-9007199254740993), Q_UINT64_C(18446744073709551615), true, false, 7u },
+        { date, QDate(1, 1, 1), QDate(-4713, 1, 2), QVariant(QVariant::Date), date },
+        { time, QTime(0, 0), QTime(23, 59, 59, 999), QVariant(QVariant::Time), QTime() },
+        { QDateTime(date, time), QDateTime(QDate(1600, 2, 29), QTime(1, 2, 3)),
+          QDateTime(date, time, Qt::UTC), QDateTime(date, time, Qt::OffsetFromUTC, 3600),
+          QVariant(QVariant::DateTime) }
+    };
+    const int columnCount = int(sizeof(columns) / sizeof(columns[0]));
+    const int rowCount = columns[0].count();
+
+    QVector<QVector<QVariant> > rows(rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        for (int column = 0; column < columnCount; ++column)
+            rows[row].append(columns[column].at(row));
+    }
+
+    TestSqlDriver testDriver;
+    TestSqlCachedResult result(&testDriver, rows);
+    QVERIFY(result.fetchLast());
+    QCOMPARE(result.at(), rowCount - 1);
+    for (int row = rowCount - 1; row >= 0; --row) {
+        QVERIFY(result.fetch(row));
+        for (int column = 0; column < columnCount; ++column) {
+            const QVariant expected = rows.at(row).at(column);
+            const QVariant actual = result.data(column);
+            QCOMPARE(actual.userType(), expected.userType());
+            QCOMPARE(actual.isNull(), expected.isNull());
+            QCOMPARE(result.isNull(column), expected.isNull());
+            QCOMPARE(actual, expected);
+            if (expected.userType() == QVariant::DateTime)
+                QCOMPARE(actual.toDateTime().timeSpec(), expected.toDateTime().timeSpec());
+        }
+    }
+    QVERIFY(!result.fetch(rowCount));
+}
+
 QTEST_MAIN( tst_QSqlResult )
 #include "tst_qsqlresult.moc"
@@ -70,6 +70,8 @@ private slots:
     void setHeaderData();
     void fetchMore_data() { generic_data(); }
     void fetchMore();
+    void windowedFetch_data() { generic_data(); }
+    void windowedFetch();
 
     //problem specific tests
     void withSortFilterProxyModel_data() { generic_data(); }
@@ -490,6 +492,77 @@ void tst_QSqlQueryModel::fetchMore()
     }
 }
 
+void tst_QSqlQueryModel::windowedFetch()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QSqlDriver::DbmsType dbType = tst_Databases::getDatabaseType(db);
+    if (dbType != QSqlDriver::SQLite && dbType != QSqlDriver::PostgreSQL
+            && dbType != QSqlDriver::MySqlServer)
+        QSKIP("Windowed fetching is not supported by this database");
+
+    const QString many = qTableName("many", __FILE__, db);
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("select count(*) from " + many));
+    QVERIFY(q.next());
+    const int rowCount = q.value(0).toInt();
+    QVERIFY(rowCount > 1000);
+
+    QSqlQueryModel model;
+    QCOMPARE(model.windowPageSize(), 0);
+    QCOMPARE(model.maximumWindowPages(), 16);
+    model.setWindowPageSize(100);
+    model.setMaximumWindowPages(2);
+    QCOMPARE(model.windowPageSize(), 100);
+    QCOMPARE(model.maximumWindowPages(), 2);
+
+    QSignalSpy modelResetSpy(&model, SIGNAL(modelReset()));
+    QSignalSpy rowsInsertedSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    model.setQuery("select id, name from " + many + " order by id;", db);
+    QVERIFY2(!model.lastError().isValid(), qPrintable(model.lastError().text()));
+    QCOMPARE(modelResetSpy.count(), 1);
+
+    // the row count is known up front, nothing is fetched incrementally
+    QCOMPARE(model.rowCount(), rowCount);
+    QCOMPARE(model.columnCount(), 2);
+    QVERIFY(!model.canFetchMore());
+    QCOMPARE(model.query().lastQuery(), "select id, name from " + many + " order by id;");
+
+    const int rows[] = { rowCount - 1, 0, 99, 100, 1234 % rowCount, rowCount - 1, 1 };
+    for (int row : rows) {
+        QCOMPARE(model.data(model.index(row, 0)).toInt(), row);
+        QCOMPARE(model.data(model.index(row, 1)).toString(), QString("harry"));
+    }
+    QCOMPARE(model.record(5).value(0).toInt(), 5);
+    QCOMPARE(model.data(model.index(rowCount, 0)), QVariant());
+    QCOMPARE(rowsInsertedSpy.count(), 0);
+
+    // a new page size only applies to the next query
+    model.setWindowPageSize(0);
+    QCOMPARE(model.data(model.index(250, 0)).toInt(), 250);
+    model.setWindowPageSize(30);
+    QCOMPARE(model.data(model.index(150, 0)).toInt(), 150);
+    QCOMPARE(model.data(model.index(99, 0)).toInt(), 99);
+    model.setWindowPageSize(100);
+
+    QVERIFY(model.insertColumn(0));
+    QCOMPARE(model.data(model.index(7, 0)), QVariant());
+    QCOMPARE(model.data(model.index(7, 1)).toInt(), 7);
+
+    // errors in the query are reported by setQuery()
+    model.setQuery("select nonexistent from " + many, db);
+    QVERIFY(model.lastError().isValid());
+    QCOMPARE(model.rowCount(), 0);
+
+    // with a page size of 0 the model fetches incrementally again
+    model.setWindowPageSize(0);
+    model.setQuery("select id, name from " + many + " order by id", db);
+    QCOMPARE(model.data(model.index(3, 0)).toInt(), 3);
+    if (!db.driver()->hasFeature(QSqlDriver::QuerySize))
+        QVERIFY(model.canFetchMore());
+}
+
 // For task 149491: When used with QSortFilterProxyModel, a view and a
 // database that doesn't support the QuerySize feature, blank rows was
 // appended if the query returned more than 256 rows and setQuery()
@@ -38,6 +38,7 @@
 #include <QtCore/QMap>
 #include <QtCore/QList>
 #include <QtCore/QResource>
+#include <QtCore/QTemporaryDir>
 #include <QtCore/QLocale>
 #include <QtCore/QtGlobal>
 
@@ -45,6 +46,7 @@
 
 typedef QMap<QString, QString> QStringMap;
 Q_DECLARE_METATYPE(QStringMap)
+Q_DECLARE_METATYPE(QResource::Compression)
 
 class tst_rcc : public QObject
 {
@@ -57,6 +59,8 @@ private slots:
     void rcc();
     void binary_data();
     void binary();
+    void compressionAlgorithm_data();
+    void compressionAlgorithm();
 
     void cleanupTestCase();
 
@@ -353,6 +357,64 @@ void tst_rcc::binary()
     QLocale::setDefault(oldDefaultLocale);
 }
 
+void tst_rcc::compressionAlgorithm_data()
+{
+    QTest::addColumn<QStringList>("arguments");
+    QTest::addColumn<QResource::Compression>("expectedCompression");
+
+    QTest::newRow("default") << QStringList() << QResource::ZlibCompression;
+    QTest::newRow("zlib") << (QStringList() << "--compress-algo" << "zlib")
+                          << QResource::ZlibCompression;
+    QTest::newRow("lz4") << (QStringList() << "--compress-algo" << "lz4")
+                         << QResource::Lz4Compression;
+    QTest::newRow("lz4-format-version-2")
+        << (QStringList() << "--compress-algo" << "lz4" << "--format-version" << "2")
+        << QResource::ZlibCompression;
+    QTest::newRow("none") << (QStringList() << "--compress-algo" << "none")
+                          << QResource::NoCompression;
+}
+
+void tst_rcc::compressionAlgorithm()
+{
+    QFETCH(QStringList, arguments);
+    QFETCH(QResource::Compression, expectedCompression);
+
+    const QString dataPath = QFINDTESTDATA("data/compression/");
+    if (dataPath.isEmpty())
+        QFAIL("data path not found");
+
+    QTemporaryDir outputDir;
+    QVERIFY(outputDir.isValid());
+    const QString rccFileName = outputDir.path() + QLatin1String("/compression.rcc");
+
+    QProcess rccProcess;
+    rccProcess.setWorkingDirectory(dataPath);
+    rccProcess.start(m_rcc, QStringList() << "-binary" << arguments
+                                          << "-o" << rccFileName << "compression.qrc");
+    QVERIFY2(rccProcess.waitForFinished(), qPrintable(rccProcess.errorString()));
+    QCOMPARE(rccProcess.exitCode(), 0);
+
+    const QString rootPrefix = QLatin1String("/compression_root/");
+    QVERIFY(QResource::registerResource(rccFileName, rootPrefix));
+
+    {
+        QResource resource(QLatin1Char(':') + rootPrefix + QLatin1String("compressible.txt"));
+        QVERIFY(resource.isValid());
+        QCOMPARE(resource.compressionAlgorithm(), expectedCompression);
+        QCOMPARE(resource.isCompressed(), expectedCompression != QResource::NoCompression);
+
+        QFile actualFile(dataPath + QLatin1String("compressible.txt"));
+        QVERIFY(actualFile.open(QIODevice::ReadOnly));
+        const QByteArray actualData = actualFile.readAll();
+        QCOMPARE(resource.uncompressedData(), actualData);
+
+        QFile resourceFile(resource.absoluteFilePath());
+        QVERIFY(resourceFile.open(QIODevice::ReadOnly));
+        QCOMPARE(resourceFile.readAll(), actualData);
+    }
+
+    QVERIFY(QResource::unregisterResource(rccFileName, rootPrefix));
+}
 
 void tst_rcc::cleanupTestCase()
 {
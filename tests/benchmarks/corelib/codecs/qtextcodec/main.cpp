@@ -27,6 +27,7 @@
 ****************************************************************************/
 #include <QTextCodec>
 #include <QFile>
+#include <QScopedPointer>
 #include <qtest.h>
 
 Q_DECLARE_METATYPE(QTextCodec *)
@@ -42,6 +43,10 @@ private slots:
     void fromUnicode() const;
     void toUnicode_data() const;
     void toUnicode() const;
+    void utf8Decoder_data() const;
+    void utf8Decoder() const;
+    void utf8Encoder_data() const;
+    void utf8Encoder() const;
 };
 
 void tst_QTextCodec::codecForName() const
@@ -161,8 +166,80 @@ void tst_QTextCodec::toUnicode() const
     }
 }
 
+void tst_QTextCodec::utf8Decoder_data() const
+{
+    QTest::addColumn<QString>("text");
+
+    const QString ascii = QStringLiteral("The quick brown fox jumps over the lazy dog. ");
+    const QString latin = QString::fromUtf8("Voil\xc3\xa0 o\xc3\xb9 na\xc3\xaft l'\xc3\xa9t\xc3\xa9 : "
+                                            "Gr\xc3\xb6\xc3\x9f" "e und H\xc3\xa4user. ");
+    const QString cyrillic = QString::fromUtf8("\xd0\xa1\xd1\x8a\xd0\xb5\xd1\x88\xd1\x8c \xd0\xb6\xd0\xb5 "
+                                               "\xd0\xb5\xd1\x89\xd1\x91 \xd1\x8d\xd1\x82\xd0\xb8\xd1\x85 "
+                                               "\xd0\xbc\xd1\x8f\xd0\xb3\xd0\xba\xd0\xb8\xd1\x85. ");
+    const QString cjk = QString::fromUtf8("\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\x96\x87"
+                                          "\xe7\xab\xa0\xe3\x80\x82\xe4\xb8\xad\xe6\x96\x87\xe6\x96\x87"
+                                          "\xe6\x9c\xac\xe3\x80\x82");
+
+    QString text;
+    while (text.size() < 100000)
+        text += ascii;
+    QTest::newRow("ascii") << text;
+    text.clear();
+    while (text.size() < 100000)
+        text += latin;
+    QTest::newRow("latin") << text;
+    text.clear();
+    while (text.size() < 100000)
+        text += cyrillic;
+    QTest::newRow("cyrillic") << text;
+    text.clear();
+    while (text.size() < 100000)
+        text += cjk;
+    QTest::newRow("cjk") << text;
+    text.clear();
+    while (text.size() < 100000)
+        text += ascii + cyrillic + cjk + latin;
+    QTest::newRow("mixed") << text;
+}
+
+// feeds the text in chunks that split multi-byte sequences, like a QTextStream
+void tst_QTextCodec::utf8Decoder() const
+{
+    QFETCH(QString, text);
+    QTextCodec *codec = QTextCodec::codecForMib(106);
+    const QByteArray data = codec->fromUnicode(text);
+    const int chunkSize = 4093;
 
+    QString result;
+    QBENCHMARK {
+        const QScopedPointer<QTextDecoder> decoder(codec->makeDecoder());
+        result.clear();
+        for (int i = 0; i < data.size(); i += chunkSize)
+            result += decoder->toUnicode(data.constData() + i, qMin(chunkSize, data.size() - i));
+    }
+    QCOMPARE(result, text);
+}
 
+void tst_QTextCodec::utf8Encoder_data() const
+{
+    utf8Decoder_data();
+}
+
+void tst_QTextCodec::utf8Encoder() const
+{
+    QFETCH(QString, text);
+    QTextCodec *codec = QTextCodec::codecForMib(106);
+    const int chunkSize = 4093;
+
+    QByteArray result;
+    QBENCHMARK {
+        const QScopedPointer<QTextEncoder> encoder(codec->makeEncoder(QTextCodec::IgnoreHeader));
+        result.clear();
+        for (int i = 0; i < text.size(); i += chunkSize)
+            result += encoder->fromUnicode(text.constData() + i, qMin(chunkSize, text.size() - i));
+    }
+    QCOMPARE(codec->toUnicode(result), text);
+}
 
 QTEST_MAIN(tst_QTextCodec)
 
@@ -0,0 +1,150 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QVector>
+
+#include <qtest.h>
+
+#include <stdio.h>
+
+Q_LOGGING_CATEGORY(lcBench, "qt.bench.logging")
+
+static const int threadCount = 16;
+static const int messagesPerThread = 20000;
+
+class LoggingThread : public QThread
+{
+protected:
+    void run() override
+    {
+        for (int i = 0; i < messagesPerThread; ++i)
+            qCDebug(lcBench) << "message" << i << "from a busy thread";
+    }
+};
+
+// Runs in a child process, as the asynchronous output is chosen once
+// per process. Prints the time the logging threads took, in msecs.
+static int logFromThreads()
+{
+    QVector<LoggingThread *> threads;
+    for (int i = 0; i < threadCount; ++i)
+        threads.append(new LoggingThread);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (LoggingThread *thread : qAsConst(threads))
+        thread->start();
+    for (LoggingThread *thread : qAsConst(threads))
+        thread->wait();
+    const qint64 elapsed = timer.elapsed();
+
+    qDeleteAll(threads);
+    printf("%lld\n", elapsed);
+    return 0;
+}
+
+class tst_QLogging : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void threads_data();
+    void threads();
+
+private:
+    QTemporaryDir m_dir;
+};
+
+void tst_QLogging::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+}
+
+void tst_QLogging::threads_data()
+{
+    QTest::addColumn<QByteArray>("async");
+    QTest::addColumn<QByteArray>("pattern");
+
+    const QByteArray plain = "%{category}: %{message}";
+    const QByteArray detailed = "%{time process} %{threadid} %{type} %{category}: %{message}";
+
+    QTest::newRow("sync") << QByteArray() << plain;
+    QTest::newRow("async") << QByteArrayLiteral("block") << plain;
+    QTest::newRow("async-drop") << QByteArrayLiteral("drop") << plain;
+    QTest::newRow("sync-detailed") << QByteArray() << detailed;
+    QTest::newRow("async-detailed") << QByteArrayLiteral("block") << detailed;
+    QTest::newRow("async-drop-detailed") << QByteArrayLiteral("drop") << detailed;
+}
+
+void tst_QLogging::threads()
+{
+    QFETCH(QByteArray, async);
+    QFETCH(QByteArray, pattern);
+
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert(QStringLiteral("QT_BENCH_LOGGING_CHILD"), QStringLiteral("1"));
+    env.insert(QStringLiteral("QT_LOGGING_RULES"), QStringLiteral("qt.bench.logging=true"));
+    env.insert(QStringLiteral("QT_LOGGING_TO_CONSOLE"), QStringLiteral("1"));
+    env.insert(QStringLiteral("QT_MESSAGE_PATTERN"), QString::fromLatin1(pattern));
+    env.remove(QStringLiteral("QT_LOGGING_ASYNC"));
+    if (!async.isEmpty())
+        env.insert(QStringLiteral("QT_LOGGING_ASYNC"), QString::fromLatin1(async));
+
+    // the messages go to a file, as they would on a build server
+    QProcess child;
+    child.setProcessEnvironment(env);
+    child.setStandardErrorFile(m_dir.filePath(QStringLiteral("log.txt")));
+    child.start(QCoreApplication::applicationFilePath(), QStringList());
+    QVERIFY(child.waitForFinished(300000));
+    QCOMPARE(child.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(child.exitCode(), 0);
+
+    bool ok;
+    const qint64 elapsed = child.readAllStandardOutput().trimmed().toLongLong(&ok);
+    QVERIFY(ok);
+    QTest::setBenchmarkResult(elapsed, QTest::WalltimeMilliseconds);
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    if (qEnvironmentVariableIsSet("QT_BENCH_LOGGING_CHILD"))
+        return logFromThreads();
+
+    tst_QLogging test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "main.moc"
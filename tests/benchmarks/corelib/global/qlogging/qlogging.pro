@@ -0,0 +1,5 @@
+TEMPLATE = app
+TARGET = tst_bench_qlogging
+QT = core testlib
+
+SOURCES += main.cpp
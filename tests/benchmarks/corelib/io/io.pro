@@ -5,6 +5,8 @@ SUBDIRS = \
         qfile \
         qfileinfo \
         qiodevice \
+        qloggingtrace \
+        qresource \
         qtemporaryfile \
         qtextstream
 
@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <qloggingtrace.h>
+
+#include <qtest.h>
+
+Q_LOGGING_CATEGORY(lcBench, "bench.trace")
+
+// every benchmark iteration logs this many messages
+static const int callCount = 10000;
+
+static void discardMessage(QtMsgType, const QMessageLogContext &, const QString &)
+{
+}
+
+class tst_QLoggingTrace : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void traceIntegers();
+    void traceString();
+    void traceDisabled();
+    void debugIntegers();
+
+private:
+    QTemporaryDir m_dir;
+};
+
+void tst_QLoggingTrace::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    // read on the first trace call
+    qputenv("QT_LOGGING_TRACE", QFile::encodeName(m_dir.filePath(QStringLiteral("trace.bin"))));
+}
+
+void tst_QLoggingTrace::cleanup()
+{
+    qInstallMessageHandler(0);
+}
+
+void tst_QLoggingTrace::traceIntegers()
+{
+    int value = 0;
+    QBENCHMARK {
+        for (int i = 0; i < callCount; ++i)
+            qCTraceDebug(lcBench, "frame %1 took %2 us", i, ++value);
+    }
+}
+
+void tst_QLoggingTrace::traceString()
+{
+    const QString name = QStringLiteral("texture.png");
+    QBENCHMARK {
+        for (int i = 0; i < callCount; ++i)
+            qCTraceDebug(lcBench, "loaded %1 in %2 us", name, i);
+    }
+}
+
+void tst_QLoggingTrace::traceDisabled()
+{
+    QLoggingCategory category("bench.trace.disabled");
+    category.setEnabled(QtDebugMsg, false);
+    QBENCHMARK {
+        for (int i = 0; i < callCount; ++i)
+            qCTraceDebug(category, "frame %1", i);
+    }
+}
+
+// the cost of the text output, up to the message handler
+void tst_QLoggingTrace::debugIntegers()
+{
+    qInstallMessageHandler(discardMessage);
+    int value = 0;
+    QBENCHMARK {
+        for (int i = 0; i < callCount; ++i)
+            qCDebug(lcBench) << "frame" << i << "took" << ++value << "us";
+    }
+}
+
+QTEST_MAIN(tst_QLoggingTrace)
+
+#include "main.moc"
@@ -0,0 +1,172 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QFile>
+#include <QLibraryInfo>
+#include <QProcess>
+#include <QResource>
+#include <QTemporaryDir>
+
+#include <qtest.h>
+
+// Number of resources in the generated .rcc files, laid out like an icon
+// theme: 5 themes with 10 sizes of 1000 icons each.
+static const int resourceCount = 50000;
+
+class tst_QResource : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void lookup_data();
+    void lookup();
+    void open_data();
+    void open();
+
+private:
+    void addRows();
+    bool generateRcc(const QString &fileName, const QStringList &extraArguments);
+
+    QTemporaryDir m_dir;
+    QString m_qrcFileName;
+    QStringList m_paths;
+};
+
+static QString resourcePath(int i)
+{
+    return QString::fromLatin1("icons/theme%1/size%2/icon%3.png")
+            .arg(i / 10000).arg(i / 1000 % 10).arg(i % 1000);
+}
+
+void tst_QResource::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    QFile payload(m_dir.filePath(QStringLiteral("payload.txt")));
+    QVERIFY(payload.open(QIODevice::WriteOnly));
+    payload.write("payload\n");
+    payload.close();
+
+    // all resources alias the same file, so that only the table of contents grows
+    m_qrcFileName = m_dir.filePath(QStringLiteral("resources.qrc"));
+    QFile qrc(m_qrcFileName);
+    QVERIFY(qrc.open(QIODevice::WriteOnly | QIODevice::Text));
+    qrc.write("<!DOCTYPE RCC><RCC version=\"1.0\">\n<qresource>\n");
+    m_paths.reserve(resourceCount);
+    for (int i = 0; i < resourceCount; ++i) {
+        const QString path = resourcePath(i);
+        qrc.write(QString::fromLatin1("<file alias=\"%1\">payload.txt</file>\n").arg(path).toLatin1());
+        m_paths.append(path);
+    }
+    qrc.write("</qresource>\n</RCC>\n");
+    qrc.close();
+
+    QVERIFY(generateRcc(m_dir.filePath(QStringLiteral("tree.rcc")), QStringList()));
+    QVERIFY(generateRcc(m_dir.filePath(QStringLiteral("index.rcc")),
+                        QStringList(QStringLiteral("-path-index"))));
+}
+
+bool tst_QResource::generateRcc(const QString &fileName, const QStringList &extraArguments)
+{
+    const QString rcc = QLibraryInfo::location(QLibraryInfo::BinariesPath) + QLatin1String("/rcc");
+    QProcess process;
+    process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    process.start(rcc, QStringList() << QStringLiteral("-binary") << extraArguments
+                                     << QStringLiteral("-o") << fileName << m_qrcFileName);
+    if (!process.waitForFinished(5 * 60 * 1000)) {
+        qWarning("Could not run %s: %s", qPrintable(rcc), qPrintable(process.errorString()));
+        return false;
+    }
+    return process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+}
+
+void tst_QResource::addRows()
+{
+    QTest::addColumn<QString>("rccFileName");
+    QTest::newRow("tree") << m_dir.filePath(QStringLiteral("tree.rcc"));
+    QTest::newRow("path-index") << m_dir.filePath(QStringLiteral("index.rcc"));
+}
+
+void tst_QResource::lookup_data()
+{
+    addRows();
+}
+
+void tst_QResource::lookup()
+{
+    QFETCH(QString, rccFileName);
+    const QString root = QStringLiteral("/bench/");
+    QVERIFY(QResource::registerResource(rccFileName, root));
+
+    QStringList paths;
+    paths.reserve(m_paths.size());
+    for (const QString &path : qAsConst(m_paths))
+        paths.append(QLatin1Char(':') + root + path);
+
+    QBENCHMARK {
+        for (const QString &path : qAsConst(paths)) {
+            QResource resource(path);
+            if (!resource.isValid())
+                QFAIL(qPrintable(path));
+        }
+    }
+
+    QVERIFY(QResource::unregisterResource(rccFileName, root));
+}
+
+void tst_QResource::open_data()
+{
+    addRows();
+}
+
+void tst_QResource::open()
+{
+    QFETCH(QString, rccFileName);
+    const QString root = QStringLiteral("/bench/");
+    QVERIFY(QResource::registerResource(rccFileName, root));
+
+    QStringList paths;
+    paths.reserve(m_paths.size());
+    for (const QString &path : qAsConst(m_paths))
+        paths.append(QLatin1Char(':') + root + path);
+
+    QBENCHMARK {
+        for (const QString &path : qAsConst(paths)) {
+            QFile file(path);
+            if (!file.open(QIODevice::ReadOnly))
+                QFAIL(qPrintable(path));
+        }
+    }
+
+    QVERIFY(QResource::unregisterResource(rccFileName, root));
+}
+
+QTEST_MAIN(tst_QResource)
+
+#include "main.moc"
@@ -1,5 +1,5 @@
 TARGET = tst_bench_qtbinaryjson
-QT = core testlib
+QT = core-private testlib
 CONFIG -= app_bundle
 
 SOURCES += tst_bench_qtbinaryjson.cpp
@@ -29,6 +29,8 @@
 #include <QtTest>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qjsonarray.h>
+#include <private/qarraydatapool_p.h>
 
 class BenchmarkQtBinaryJson: public QObject
 {
@@ -45,12 +47,21 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseThroughput_data();
+    void parseThroughput();
 
     void toByteArray();
     void fromByteArray();
+    void fromBinaryFile_data();
+    void fromBinaryFile();
 
     void jsonObjectInsert();
     void variantMapInsert();
+
+    void requestToVariantMap_data();
+    void requestToVariantMap();
+    void requestMallocCalls_data();
+    void requestMallocCalls();
 };
 
 BenchmarkQtBinaryJson::BenchmarkQtBinaryJson(QObject *parent) : QObject(parent)
@@ -120,6 +131,49 @@ void BenchmarkQtBinaryJson::parseJsonToVariant()
     }
 }
 
+void BenchmarkQtBinaryJson::parseThroughput_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    const char *files[] = { "test.json", "numbers.json" };
+    for (const char *fileName : files) {
+        QString testFile = QFINDTESTDATA(fileName);
+        QVERIFY2(!testFile.isEmpty(), "cannot find test file!");
+        QFile file(testFile);
+        file.open(QFile::ReadOnly);
+        QTest::newRow(fileName) << file.readAll();
+    }
+
+    // long indented strings, mostly ASCII with an occasional escape or non-latin1 character
+    QJsonArray strings;
+    for (int i = 0; i < 2000; i++) {
+        QString s = QString::fromLatin1("entry %1: the quick brown fox jumps over the lazy dog").arg(i);
+        if (i % 10 == 0)
+            s += QLatin1String(" \"quoted\"");
+        if (i % 25 == 0)
+            s += QChar(0x20ac);
+        strings.append(s);
+    }
+    QTest::newRow("strings") << QJsonDocument(strings).toJson(QJsonDocument::Indented);
+}
+
+void BenchmarkQtBinaryJson::parseThroughput()
+{
+    QFETCH(QByteArray, json);
+    QVERIFY(!QJsonDocument::fromJson(json).isNull());
+
+    // report bytes of JSON text parsed per second
+    const int iterations = 200;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; i++) {
+        QJsonDocument doc = QJsonDocument::fromJson(json);
+        Q_UNUSED(doc);
+    }
+    const qint64 nsecs = qMax(timer.nsecsElapsed(), Q_INT64_C(1));
+    QTest::setBenchmarkResult(qreal(json.size()) * iterations * 1000000000 / nsecs, QTest::BytesPerSecond);
+}
+
 void BenchmarkQtBinaryJson::toByteArray()
 {
     // Example: send information over a datastream to another process
@@ -150,6 +204,47 @@ void BenchmarkQtBinaryJson::fromByteArray()
     }
 }
 
+void BenchmarkQtBinaryJson::fromBinaryFile_data()
+{
+    QTest::addColumn<bool>("mapped");
+    QTest::newRow("fromBinaryData") << false;
+    QTest::newRow("fromBinaryFile") << true;
+}
+
+void BenchmarkQtBinaryJson::fromBinaryFile()
+{
+    // Example: load a large document written by toBinaryData() at startup
+    // and look up a single value in it
+    QFETCH(bool, mapped);
+
+    QJsonObject catalog;
+    for (int i = 0; i < 20000; i++) {
+        QJsonObject entry;
+        entry.insert("id", i);
+        entry.insert("name", "entry_" + QString::number(i));
+        entry.insert("enabled", (i % 2) == 0);
+        catalog.insert("key_" + QString::number(i), entry);
+    }
+    const QByteArray binary = QJsonDocument(catalog).toBinaryData();
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(binary), qint64(binary.size()));
+    file.close();
+
+    QBENCHMARK {
+        QJsonDocument doc;
+        if (mapped) {
+            doc = QJsonDocument::fromBinaryFile(file.fileName(), QJsonDocument::BypassValidation);
+        } else {
+            QFile in(file.fileName());
+            in.open(QFile::ReadOnly);
+            doc = QJsonDocument::fromBinaryData(in.readAll(), QJsonDocument::BypassValidation);
+        }
+        QCOMPARE(doc.object().value("key_12345").toObject().value("id").toInt(), 12345);
+    }
+}
+
 void BenchmarkQtBinaryJson::jsonObjectInsert()
 {
     QJsonObject object;
@@ -174,6 +269,80 @@ void BenchmarkQtBinaryJson::variantMapInsert()
     }
 }
 
+// A typical request body: a few header fields and a list of records
+static QByteArray requestJson()
+{
+    QJsonArray items;
+    for (int i = 0; i < 50; i++) {
+        QJsonObject item;
+        item.insert(QStringLiteral("id"), i);
+        item.insert(QStringLiteral("sku"), QString::fromLatin1("SKU-%1").arg(i * 7919));
+        item.insert(QStringLiteral("name"), QString::fromLatin1("Item number %1").arg(i));
+        item.insert(QStringLiteral("description"),
+                    QStringLiteral("A somewhat longer description of the item in the order"));
+        item.insert(QStringLiteral("price"), 9.99 + i);
+        item.insert(QStringLiteral("tags"), QJsonArray::fromStringList(
+                        QStringList() << QStringLiteral("new") << QStringLiteral("sale")));
+        items.append(item);
+    }
+    QJsonObject request;
+    request.insert(QStringLiteral("method"), QStringLiteral("order.update"));
+    request.insert(QStringLiteral("session"), QStringLiteral("c1b3a52e-9a4f-4d0b-8f8e-0d1b7e5c2f11"));
+    request.insert(QStringLiteral("user"), QStringLiteral("someone@example.com"));
+    request.insert(QStringLiteral("items"), items);
+    return QJsonDocument(request).toJson(QJsonDocument::Compact);
+}
+
+static int handleRequest(const QByteArray &json)
+{
+    const QVariantMap request = QJsonDocument::fromJson(json).object().toVariantMap();
+    int size = request.value(QStringLiteral("method")).toString().size();
+    const QVariantList items = request.value(QStringLiteral("items")).toList();
+    for (const QVariant &item : items)
+        size += item.toMap().value(QStringLiteral("name")).toString().size();
+    return size;
+}
+
+void BenchmarkQtBinaryJson::requestToVariantMap_data()
+{
+    QTest::addColumn<bool>("pooled");
+    QTest::newRow("malloc") << false;
+    QTest::newRow("pool") << true;
+}
+
+void BenchmarkQtBinaryJson::requestToVariantMap()
+{
+    QFETCH(bool, pooled);
+    const QByteArray json = requestJson();
+
+    // like a worker thread serving requests: one pool for all of them
+    QScopedPointer<QArrayDataPool> pool(pooled ? new QArrayDataPool : nullptr);
+    QBENCHMARK {
+        handleRequest(json);
+    }
+}
+
+void BenchmarkQtBinaryJson::requestMallocCalls_data()
+{
+    requestToVariantMap_data();
+}
+
+void BenchmarkQtBinaryJson::requestMallocCalls()
+{
+    QFETCH(bool, pooled);
+    const QByteArray json = requestJson();
+    const int requests = 100;
+
+    // Reports the calls to malloc made per request for QArrayData (QString,
+    // QByteArray and QVector) blocks. Without a pool, each allocation is one.
+    QArrayDataPool pool;
+    for (int i = 0; i < requests; i++)
+        handleRequest(json);
+    const QArrayDataPool::Statistics stats = pool.statistics();
+    const quint64 calls = pooled ? stats.mallocCalls : stats.allocations;
+    QTest::setBenchmarkResult(qreal(calls) / requests, QTest::Events);
+}
+
 QTEST_MAIN(BenchmarkQtBinaryJson)
 #include "tst_bench_qtbinaryjson.moc"
 
@@ -83,6 +83,45 @@ int EventTester::foo(int bar)
     return bar + 1;
 }
 
+class Counter : public QObject
+{
+    Q_OBJECT
+public:
+    Counter() : m_count(0), m_expected(0) {}
+    void expect(int count) { m_count = 0; m_expected = count; }
+
+public slots:
+    void count()
+    {
+        if (++m_count == m_expected)
+            QTestEventLoop::instance().exitLoop();
+    }
+
+private:
+    int m_count;
+    int m_expected;
+};
+
+class Producer : public QThread
+{
+    Q_OBJECT
+public:
+    explicit Producer(int count) : m_count(count) {}
+
+signals:
+    void produced();
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < m_count; ++i)
+            emit produced();
+    }
+
+private:
+    int m_count;
+};
+
 class EventsBench : public QObject
 {
     Q_OBJECT
@@ -96,6 +135,8 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+    void postEventFromThreads_data();
+    void postEventFromThreads();
 };
 
 void EventsBench::initTestCase()
@@ -169,6 +210,42 @@ void EventsBench::postEvent()
     }
 }
 
+void EventsBench::postEventFromThreads_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("8 threads") << 8;
+}
+
+void EventsBench::postEventFromThreads()
+{
+    QFETCH(int, threadCount);
+    const int eventsPerThread = 1000;
+
+    // every emission posts a QMetaCallEvent to the main thread
+    Counter counter;
+    QVector<Producer *> producers;
+    for (int i = 0; i < threadCount; ++i) {
+        Producer *producer = new Producer(eventsPerThread);
+        connect(producer, &Producer::produced, &counter, &Counter::count, Qt::QueuedConnection);
+        producers.append(producer);
+    }
+
+    QBENCHMARK {
+        counter.expect(threadCount * eventsPerThread);
+        for (Producer *producer : qAsConst(producers))
+            producer->start();
+        QTestEventLoop::instance().enterLoop(60);
+        for (Producer *producer : qAsConst(producers))
+            producer->wait();
+    }
+    QVERIFY(!QTestEventLoop::instance().timeout());
+
+    qDeleteAll(producers);
+}
+
 QTEST_MAIN(EventsBench)
 
 #include "main.moc"
@@ -5,7 +5,10 @@ SUBDIRS = \
         qmetatype \
         qobject \
         qvariant \
-        qcoreapplication
+        qcoreapplication \
+        qtimer
+
+linux: SUBDIRS += qsocketnotifier
 
 !qtHaveModule(widgets): SUBDIRS -= \
     qmetaobject \
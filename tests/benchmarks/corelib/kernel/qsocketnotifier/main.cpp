@@ -0,0 +1,157 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtCore/QCoreApplication>
+#include <QtCore/QSocketNotifier>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtCore/private/qcore_unix_p.h>
+#include <QtCore/private/qeventdispatcher_unix_p.h>
+
+#include <qtest.h>
+
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+/*
+    A worker thread that echoes every byte it receives on one end of a socket
+    pair while a configurable number of idle socket notifiers are registered
+    with its event dispatcher. The round trip therefore measures how much a
+    single wakeup of QEventDispatcherUNIX costs as the number of registered
+    descriptors grows.
+*/
+class EchoThread : public QThread
+{
+public:
+    EchoThread(bool epoll, int echoFd, const QVector<int> &idleFds)
+        : m_echoFd(echoFd), m_idleFds(idleFds)
+    {
+        if (epoll)
+            qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+        setEventDispatcher(new QEventDispatcherUNIX);
+        qunsetenv("QT_EVENT_DISPATCHER_EPOLL");
+    }
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        QVector<QSocketNotifier *> idle;
+        idle.reserve(m_idleFds.size());
+        for (int fd : qAsConst(m_idleFds))
+            idle.append(new QSocketNotifier(fd, QSocketNotifier::Read));
+
+        QSocketNotifier echo(m_echoFd, QSocketNotifier::Read);
+        QObject::connect(&echo, &QSocketNotifier::activated, [this]() {
+            char c;
+            if (qt_safe_read(m_echoFd, &c, 1) == 1)
+                qt_safe_write(m_echoFd, &c, 1);
+        });
+
+        exec();
+
+        qDeleteAll(idle);
+    }
+
+private:
+    int m_echoFd;
+    QVector<int> m_idleFds;
+};
+
+class tst_QSocketNotifier : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void roundTrip_data();
+    void roundTrip();
+};
+
+void tst_QSocketNotifier::initTestCase()
+{
+    // we need room for the idle sockets, so raise the soft limit as far as we may
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+void tst_QSocketNotifier::roundTrip_data()
+{
+    QTest::addColumn<bool>("epoll");
+    QTest::addColumn<int>("idleSockets");
+
+    const int counts[] = { 0, 100, 1000, 10000 };
+    for (int count : counts) {
+        QTest::newRow(qPrintable(QString("poll, %1 idle").arg(count))) << false << count;
+        QTest::newRow(qPrintable(QString("epoll, %1 idle").arg(count))) << true << count;
+    }
+}
+
+void tst_QSocketNotifier::roundTrip()
+{
+    QFETCH(bool, epoll);
+    QFETCH(int, idleSockets);
+
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < rlim_t(idleSockets + 64))
+        QSKIP("Not enough file descriptors available");
+
+    // the idle sockets are never written to, so their notifiers never fire
+    QVector<int> idleFds;
+    idleFds.reserve(idleSockets);
+    while (idleFds.size() < idleSockets) {
+        int sv[2];
+        QVERIFY(::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == 0);
+        idleFds << sv[0] << sv[1];
+    }
+
+    int echo[2];
+    QVERIFY(::socketpair(AF_UNIX, SOCK_STREAM, 0, echo) == 0);
+
+    EchoThread thread(epoll, echo[1], idleFds);
+    thread.start();
+
+    char c = 'x';
+    QBENCHMARK {
+        QCOMPARE(qt_safe_write(echo[0], &c, 1), qint64(1));
+        QCOMPARE(qt_safe_read(echo[0], &c, 1), qint64(1));
+    }
+
+    thread.quit();
+    thread.wait();
+
+    qt_safe_close(echo[0]);
+    qt_safe_close(echo[1]);
+    for (int fd : qAsConst(idleFds))
+        qt_safe_close(fd);
+}
+
+QTEST_MAIN(tst_QSocketNotifier)
+
+#include "main.moc"
@@ -0,0 +1,6 @@
+TEMPLATE = app
+TARGET = tst_bench_qsocketnotifier
+
+QT = core-private testlib
+
+SOURCES += main.cpp
@@ -0,0 +1,123 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+#include <qtest.h>
+
+class tst_QTimer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void restart_data();
+    void restart();
+    void startStop_data();
+    void startStop();
+};
+
+static void addTimerRows()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<Qt::TimerType>("timerType");
+
+    const int counts[] = { 100, 1000, 10000, 100000 };
+    for (int count : counts) {
+        QTest::newRow(qPrintable(QString("precise, %1").arg(count))) << count << Qt::PreciseTimer;
+        QTest::newRow(qPrintable(QString("coarse, %1").arg(count))) << count << Qt::CoarseTimer;
+    }
+}
+
+void tst_QTimer::restart_data()
+{
+    addTimerRows();
+}
+
+// Restarting keep-alive style timers: all timers stay registered, and a
+// rotating subset of them is restarted with a new deadline.
+void tst_QTimer::restart()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, timerType);
+
+    QVector<QTimer *> timers;
+    timers.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QTimer *timer = new QTimer;
+        timer->setTimerType(timerType);
+        timer->setInterval(60 * 1000 + i % 1000);
+        timer->start();
+        timers.append(timer);
+    }
+
+    int next = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            timers.at(next)->start();
+            if (++next == count)
+                next = 0;
+        }
+    }
+
+    qDeleteAll(timers);
+}
+
+void tst_QTimer::startStop_data()
+{
+    addTimerRows();
+}
+
+// Starting and stopping a single timer while many others are registered.
+void tst_QTimer::startStop()
+{
+    QFETCH(int, count);
+    QFETCH(Qt::TimerType, timerType);
+
+    QVector<QTimer *> timers;
+    timers.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QTimer *timer = new QTimer;
+        timer->setTimerType(timerType);
+        timer->start(60 * 1000 + i % 1000);
+        timers.append(timer);
+    }
+
+    QTimer timer;
+    timer.setTimerType(timerType);
+    QBENCHMARK {
+        timer.start(30 * 1000);
+        timer.stop();
+    }
+
+    qDeleteAll(timers);
+}
+
+QTEST_MAIN(tst_QTimer)
+
+#include "main.moc"
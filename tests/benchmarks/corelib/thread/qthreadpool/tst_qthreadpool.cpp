@@ -40,6 +40,10 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void manyTinyTasks_data();
+    void manyTinyTasks();
+    void fanOutFromOneTask_data();
+    void fanOutFromOneTask();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,5 +79,98 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+class TinyTask : public QRunnable
+{
+public:
+    TinyTask(QAtomicInt *counter) : counter(counter) {}
+    void run() Q_DECL_OVERRIDE {
+        counter->ref();
+    }
+
+private:
+    QAtomicInt *counter;
+};
+
+// Starts tiny tasks from within pool threads, which is where work stealing
+// applies: each fan-out task starts a batch of tiny tasks.
+class FanOutTask : public QRunnable
+{
+public:
+    FanOutTask(QThreadPool *pool, QAtomicInt *counter, int count)
+        : pool(pool), counter(counter), count(count) {}
+    void run() Q_DECL_OVERRIDE {
+        for (int i = 0; i < count; ++i)
+            pool->start(new TinyTask(counter));
+    }
+
+private:
+    QThreadPool *pool;
+    QAtomicInt *counter;
+    int count;
+};
+
+void tst_QThreadPool::manyTinyTasks_data()
+{
+    QTest::addColumn<bool>("workStealing");
+    QTest::addColumn<int>("threadCount");
+
+    const int threadCounts[] = { 1, 2, 4, 8, 16, 32, 64 };
+    for (int threadCount : threadCounts) {
+        QTest::newRow(qPrintable(QString("shared queue, %1 threads").arg(threadCount)))
+            << false << threadCount;
+        QTest::newRow(qPrintable(QString("work stealing, %1 threads").arg(threadCount)))
+            << true << threadCount;
+    }
+}
+
+void tst_QThreadPool::manyTinyTasks()
+{
+    QFETCH(bool, workStealing);
+    QFETCH(int, threadCount);
+
+    const int fanOutTasks = 64;
+    const int tasksPerFanOut = 1000;
+
+    QThreadPool threadPool;
+    threadPool.setWorkStealingEnabled(workStealing);
+    threadPool.setMaxThreadCount(threadCount);
+    QAtomicInt counter;
+
+    QBENCHMARK {
+        counter.store(0);
+        for (int i = 0; i < fanOutTasks; ++i)
+            threadPool.start(new FanOutTask(&threadPool, &counter, tasksPerFanOut));
+        threadPool.waitForDone();
+    }
+    QCOMPARE(counter.load(), fanOutTasks * tasksPerFanOut);
+}
+
+void tst_QThreadPool::fanOutFromOneTask_data()
+{
+    manyTinyTasks_data();
+}
+
+// All tiny tasks are started from a single pool task, so the other threads
+// only get to work by stealing them.
+void tst_QThreadPool::fanOutFromOneTask()
+{
+    QFETCH(bool, workStealing);
+    QFETCH(int, threadCount);
+
+    const int tasks = 64000;
+
+    QThreadPool threadPool;
+    threadPool.setWorkStealingEnabled(workStealing);
+    threadPool.setMaxThreadCount(threadCount);
+    QAtomicInt counter;
+
+    QBENCHMARK {
+        counter.store(0);
+        threadPool.start(new FanOutTask(&threadPool, &counter, tasks));
+        threadPool.waitForDone();
+    }
+    QCOMPARE(counter.load(), tasks);
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
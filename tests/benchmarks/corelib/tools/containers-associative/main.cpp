@@ -26,9 +26,13 @@
 **
 ****************************************************************************/
 #include <QString>
+#include <private/qflathash_p.h>
 
 #include <qtest.h>
 
+enum Container { Hash, FlatHash, Map };
+Q_DECLARE_METATYPE(Container)
+
 class tst_associative_containers : public QObject
 {
     Q_OBJECT
@@ -37,6 +41,11 @@ private slots:
     void insert();
     void lookup_data();
     void lookup();
+    void erase_data();
+    void erase();
+
+private:
+    void data();
 };
 
 template <typename T>
@@ -50,32 +59,45 @@ void testInsert(int size)
     }
 }
 
-void tst_associative_containers::insert_data()
+void tst_associative_containers::data()
 {
-    QTest::addColumn<bool>("useHash");
+    QTest::addColumn<Container>("container");
     QTest::addColumn<int>("size");
 
     for (int size = 10; size < 20000; size += 100) {
 
         const QByteArray sizeString = QByteArray::number(size);
 
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
+        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << Hash << size;
+        QTest::newRow(QByteArray("flathash--" + sizeString).constData()) << FlatHash << size;
+        QTest::newRow(QByteArray("map--" + sizeString).constData()) << Map << size;
     }
+
+    QTest::newRow("hash--1000000") << Hash << 1000000;
+    QTest::newRow("flathash--1000000") << FlatHash << 1000000;
+    QTest::newRow("map--1000000") << Map << 1000000;
+}
+
+void tst_associative_containers::insert_data()
+{
+    data();
 }
 
 void tst_associative_containers::insert()
 {
-    QFETCH(bool, useHash);
+    QFETCH(Container, container);
     QFETCH(int, size);
 
-    QHash<int, int> testHash;
-    QMap<int, int> testMap;
-
-    if (useHash) {
+    switch (container) {
+    case Hash:
         testInsert<QHash<int, int> >(size);
-    } else {
+        break;
+    case FlatHash:
+        testInsert<QFlatHash<int, int> >(size);
+        break;
+    case Map:
         testInsert<QMap<int, int> >(size);
+        break;
     }
 }
 
@@ -84,16 +106,7 @@ void tst_associative_containers::lookup_data()
 //    setReportType(LineChartReport);
 //    setChartTitle("Time to call value(), with an increasing number of items in the container");
 
-    QTest::addColumn<bool>("useHash");
-    QTest::addColumn<int>("size");
-
-    for (int size = 10; size < 20000; size += 100) {
-
-        const QByteArray sizeString = QByteArray::number(size);
-
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
-    }
+    data();
 }
 
 template <typename T>
@@ -115,13 +128,55 @@ void testLookup(int size)
 
 void tst_associative_containers::lookup()
 {
-    QFETCH(bool, useHash);
+    QFETCH(Container, container);
     QFETCH(int, size);
 
-    if (useHash) {
+    switch (container) {
+    case Hash:
         testLookup<QHash<int, int> >(size);
-    } else {
+        break;
+    case FlatHash:
+        testLookup<QFlatHash<int, int> >(size);
+        break;
+    case Map:
         testLookup<QMap<int, int> >(size);
+        break;
+    }
+}
+
+void tst_associative_containers::erase_data()
+{
+    data();
+}
+
+template <typename T>
+void testErase(int size)
+{
+    T container;
+
+    QBENCHMARK {
+        for (int i = 0; i < size; ++i)
+            container.insert(i, i);
+        for (int i = 0; i < size; ++i)
+            container.remove(i);
+    }
+}
+
+void tst_associative_containers::erase()
+{
+    QFETCH(Container, container);
+    QFETCH(int, size);
+
+    switch (container) {
+    case Hash:
+        testErase<QHash<int, int> >(size);
+        break;
+    case FlatHash:
+        testErase<QFlatHash<int, int> >(size);
+        break;
+    case Map:
+        testErase<QMap<int, int> >(size);
+        break;
     }
 }
 
@@ -35,6 +35,7 @@
 #include <QStringList>
 #include <QUuid>
 #include <QTest>
+#include <private/qflathash_p.h>
 
 
 class tst_QHash : public QObject
@@ -61,15 +62,33 @@ private slots:
     void hashing_javaString_data() { data(); }
     void hashing_javaString() { hashing_template<JavaString>(); }
 
+    void insert_qhash_data() { containerData(); }
+    void insert_qhash() { insert_template<QHash<QString, int> >(); }
+    void insert_qflathash_data() { containerData(); }
+    void insert_qflathash() { insert_template<QFlatHash<QString, int> >(); }
+    void lookup_qhash_data() { containerData(); }
+    void lookup_qhash() { lookup_template<QHash<QString, int> >(); }
+    void lookup_qflathash_data() { containerData(); }
+    void lookup_qflathash() { lookup_template<QFlatHash<QString, int> >(); }
+    void erase_qhash_data() { containerData(); }
+    void erase_qhash() { erase_template<QHash<QString, int> >(); }
+    void erase_qflathash_data() { containerData(); }
+    void erase_qflathash() { erase_template<QFlatHash<QString, int> >(); }
+
 private:
     void data();
+    void containerData();
     template <typename String> void qhash_template();
     template <typename String> void hashing_template();
+    template <typename Container> void insert_template();
+    template <typename Container> void lookup_template();
+    template <typename Container> void erase_template();
 
     QStringList smallFilePaths;
     QStringList uuids;
     QStringList dict;
     QStringList numbers;
+    QStringList millionNumbers;
 };
 
 ///////////////////// QHash /////////////////////
@@ -125,6 +144,10 @@ void tst_QHash::initTestCase()
     // string versions of numbers.
     for (int i = 5000000; i < 5005001; ++i)
         numbers.append(QString::number(i));
+
+    millionNumbers.reserve(1000000);
+    for (int i = 0; i < 1000000; ++i)
+        millionNumbers.append(QString::number(quint64(i) * 7919));
 }
 
 void tst_QHash::data()
@@ -136,6 +159,12 @@ void tst_QHash::data()
     QTest::newRow("numbers") << numbers;
 }
 
+void tst_QHash::containerData()
+{
+    data();
+    QTest::newRow("numbers-1M") << millionNumbers;
+}
+
 template <typename String> void tst_QHash::qhash_template()
 {
     QFETCH(QStringList, items);
@@ -168,6 +197,48 @@ template <typename String> void tst_QHash::hashing_template()
     }
 }
 
+template <typename Container> void tst_QHash::insert_template()
+{
+    QFETCH(QStringList, items);
+
+    QBENCHMARK {
+        Container container;
+        for (int i = 0, n = items.size(); i != n; ++i)
+            container.insert(items.at(i), i);
+    }
+}
+
+template <typename Container> void tst_QHash::lookup_template()
+{
+    QFETCH(QStringList, items);
+
+    Container container;
+    for (int i = 0, n = items.size(); i != n; ++i)
+        container.insert(items.at(i), i);
+
+    int sum = 0;
+    QBENCHMARK {
+        for (int i = 0, n = items.size(); i != n; ++i)
+            sum += container.value(items.at(i));
+    }
+    QVERIFY(sum != -1);
+}
+
+template <typename Container> void tst_QHash::erase_template()
+{
+    QFETCH(QStringList, items);
+
+    Container container;
+    for (int i = 0, n = items.size(); i != n; ++i)
+        container.insert(items.at(i), i);
+
+    QBENCHMARK_ONCE {
+        for (int i = 0, n = items.size(); i != n; ++i)
+            container.remove(items.at(i));
+    }
+    QVERIFY(container.isEmpty());
+}
+
 QTEST_MAIN(tst_QHash)
 
 #include "main.moc"
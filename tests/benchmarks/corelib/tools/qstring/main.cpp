@@ -27,6 +27,7 @@
 ****************************************************************************/
 #include <QStringList>
 #include <QFile>
+#include <QStringFormat>
 #include <QtTest/QtTest>
 
 class tst_QString: public QObject
@@ -49,6 +50,14 @@ private slots:
     void toCaseFolded_data();
     void toCaseFolded();
 
+    void arg_data();
+    void arg();
+
+    void fromUtf8_data();
+    void fromUtf8();
+    void toUtf8_data();
+    void toUtf8();
+
 private:
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
@@ -188,6 +197,138 @@ void tst_QString::toCaseFolded()
     }
 }
 
+enum ArgCase { ThreeStrings, LogLine, ReportRow };
+Q_DECLARE_METATYPE(ArgCase)
+
+void tst_QString::arg_data()
+{
+    QTest::addColumn<ArgCase>("argCase");
+    QTest::addColumn<bool>("precompiled");
+
+    QTest::newRow("strings-arg") << ThreeStrings << false;
+    QTest::newRow("strings-qstringformat") << ThreeStrings << true;
+    QTest::newRow("log-arg") << LogLine << false;
+    QTest::newRow("log-qstringformat") << LogLine << true;
+    QTest::newRow("report-arg") << ReportRow << false;
+    QTest::newRow("report-qstringformat") << ReportRow << true;
+}
+
+void tst_QString::arg()
+{
+    QFETCH(ArgCase, argCase);
+    QFETCH(bool, precompiled);
+
+    const QString path = QStringLiteral("/usr/local/share");
+    const QString dir = QStringLiteral("applications");
+    const QString file = QStringLiteral("org.qt-project.example.desktop");
+    const QString category = QStringLiteral("qt.network.ssl");
+    const QString message = QStringLiteral("Handshake with the remote peer finished");
+    const QString item = QStringLiteral("Widget, large, blue");
+
+    QString format;
+    switch (argCase) {
+    case ThreeStrings:
+        format = QStringLiteral("%1/%2/%3");
+        break;
+    case LogLine:
+        format = QStringLiteral("%1 [%2] %3: %4 (took %5 ms)");
+        break;
+    case ReportRow:
+        format = QStringLiteral("| %1 | %2 | %3 | %4 | %5 | %6 |");
+        break;
+    }
+    const QStringFormat compiled(format);
+
+    QString result;
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            switch (argCase) {
+            case ThreeStrings:
+                result = precompiled ? compiled.arg(path, dir, file)
+                                     : format.arg(path).arg(dir).arg(file);
+                break;
+            case LogLine:
+                result = precompiled
+                        ? compiled.arg(1507219200 + i, QLatin1String("debug"), category, message, i)
+                        : format.arg(1507219200 + i).arg(QLatin1String("debug")).arg(category)
+                                .arg(message).arg(i);
+                break;
+            case ReportRow:
+                result = precompiled
+                        ? compiled.arg(i, item, 1000 + i, 4.25, 5 * i, 21.25 * i)
+                        : format.arg(i).arg(item).arg(1000 + i).arg(4.25).arg(5 * i)
+                                .arg(21.25 * i);
+                break;
+            }
+        }
+    }
+    QVERIFY(!result.contains(QLatin1Char('%')));
+}
+
+void tst_QString::fromUtf8_data()
+{
+    QTest::addColumn<QString>("s");
+
+    const QString latin = QString::fromUtf8("Voil\xc3\xa0 o\xc3\xb9 na\xc3\xaft l'\xc3\xa9t\xc3\xa9 : "
+                                            "Gr\xc3\xb6\xc3\x9fe und H\xc3\xa4user. ");
+    const QString cyrillic = QString::fromUtf8("\xd0\xa1\xd1\x8a\xd0\xb5\xd1\x88\xd1\x8c \xd0\xb6\xd0\xb5 "
+                                               "\xd0\xb5\xd1\x89\xd1\x91 \xd1\x8d\xd1\x82\xd0\xb8\xd1\x85 "
+                                               "\xd0\xbc\xd1\x8f\xd0\xb3\xd0\xba\xd0\xb8\xd1\x85. ");
+    const QString cjk = QString::fromUtf8("\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\x96\x87"
+                                          "\xe7\xab\xa0\xe3\x80\x82\xe4\xb8\xad\xe6\x96\x87\xe6\x96\x87"
+                                          "\xe6\x9c\xac\xe3\x80\x82");
+    const QString ascii = QStringLiteral("The quick brown fox jumps over the lazy dog. ");
+
+    QString s;
+    while (s.size() < 1000)
+        s += ascii;
+    QTest::newRow("ascii") << s;
+    s.clear();
+    while (s.size() < 1000)
+        s += latin;
+    QTest::newRow("latin") << s;
+    s.clear();
+    while (s.size() < 1000)
+        s += cyrillic;
+    QTest::newRow("cyrillic") << s;
+    s.clear();
+    while (s.size() < 1000)
+        s += cjk;
+    QTest::newRow("cjk") << s;
+    s.clear();
+    while (s.size() < 1000)
+        s += ascii + cyrillic + cjk + latin;
+    QTest::newRow("mixed") << s;
+}
+
+void tst_QString::fromUtf8()
+{
+    QFETCH(QString, s);
+    const QByteArray utf8 = s.toUtf8();
+
+    QString result;
+    QBENCHMARK {
+        result = QString::fromUtf8(utf8);
+    }
+    QCOMPARE(result, s);
+}
+
+void tst_QString::toUtf8_data()
+{
+    fromUtf8_data();
+}
+
+void tst_QString::toUtf8()
+{
+    QFETCH(QString, s);
+
+    QByteArray result;
+    QBENCHMARK {
+        result = s.toUtf8();
+    }
+    QCOMPARE(QString::fromUtf8(result), s);
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "main.moc"
@@ -3,4 +3,8 @@ SUBDIRS = \
         qfile_vs_qnetworkaccessmanager \
         qnetworkreply \
         qnetworkreply_from_cache \
-        qnetworkdiskcache
+        qnetworkdiskcache \
+        qnetworkaccessmanager_connectionpool
+
+qtConfig(private_tests): SUBDIRS += \
+        hpack
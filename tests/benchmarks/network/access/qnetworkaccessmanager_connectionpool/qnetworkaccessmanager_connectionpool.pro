@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tst_bench_qnetworkaccessmanager_connectionpool
+
+QT = core network testlib
+
+CONFIG += release
+
+SOURCES += tst_qnetworkaccessmanager_connectionpool.cpp
@@ -0,0 +1,210 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+// This file contains benchmarks for HTTP connection reuse in QNetworkAccessManager.
+
+#include <QtTest/QtTest>
+#include <QtCore/qvector.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qthread.h>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qnetworkrequest.h>
+#include <QtNetwork/qtcpserver.h>
+#include <QtNetwork/qtcpsocket.h>
+
+#include <algorithm>
+
+// A keep-alive HTTP/1.1 server on the loopback interface, running in its own
+// thread. It answers every request (pipelined or not) with a small fixed
+// response and counts the connections it accepts, i.e. the TCP handshakes
+// the clients had to do.
+class LoopbackHttpServer : public QThread
+{
+    Q_OBJECT
+public:
+    LoopbackHttpServer() : port(0)
+    {
+        start();
+        ready.acquire();
+    }
+    ~LoopbackHttpServer()
+    {
+        quit();
+        wait();
+    }
+
+    quint16 serverPort() const { return port; }
+    int acceptedConnections() const { return accepted.load(); }
+    void resetCounters() { accepted.store(0); }
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        QTcpServer server;
+        server.listen(QHostAddress::LocalHost);
+        connect(&server, &QTcpServer::newConnection, &server, [&server, this]() {
+            while (QTcpSocket *socket = server.nextPendingConnection()) {
+                accepted.ref();
+                socket->setParent(&server);
+                connect(socket, &QTcpSocket::readyRead, socket, [socket]() { serve(socket); });
+            }
+        });
+        port = server.serverPort();
+        ready.release();
+        exec();
+    }
+
+private:
+    static void serve(QTcpSocket *socket)
+    {
+        static const QByteArray response("HTTP/1.1 200 OK\r\n"
+                                         "Content-Type: text/plain\r\n"
+                                         "Content-Length: 2\r\n"
+                                         "\r\n"
+                                         "OK");
+        QByteArray buffer = socket->property("buffer").toByteArray() + socket->readAll();
+        int end;
+        while ((end = buffer.indexOf("\r\n\r\n")) != -1) {
+            buffer.remove(0, end + 4);
+            socket->write(response);
+        }
+        socket->setProperty("buffer", buffer);
+    }
+
+    QSemaphore ready;
+    QAtomicInt accepted;
+    quint16 port;
+};
+
+class tst_qnetworkaccessmanager_connectionpool : public QObject
+{
+    Q_OBJECT
+public:
+    tst_qnetworkaccessmanager_connectionpool() : server(0) {}
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void shortLivedManagers_data();
+    void shortLivedManagers();
+
+private:
+    QVector<qint64> runManagers(bool shared, int managers, int parallel, int rounds);
+
+    LoopbackHttpServer *server;
+};
+
+void tst_qnetworkaccessmanager_connectionpool::initTestCase()
+{
+    server = new LoopbackHttpServer;
+    QVERIFY(server->serverPort() != 0);
+}
+
+void tst_qnetworkaccessmanager_connectionpool::cleanupTestCase()
+{
+    delete server;
+}
+
+// Creates \a managers managers one after the other, as applications do that
+// create a manager per task. Each manager issues \a parallel requests at once
+// and waits for them, \a rounds times. Returns the latency of every request
+// in nanoseconds.
+QVector<qint64> tst_qnetworkaccessmanager_connectionpool::runManagers(bool shared, int managers,
+                                                                     int parallel, int rounds)
+{
+    const QUrl url(QLatin1String("http://127.0.0.1:") + QString::number(server->serverPort())
+                   + QLatin1String("/resource"));
+    QVector<qint64> latencies;
+    latencies.reserve(managers * parallel * rounds);
+
+    // keeps the shared pool alive between the short-lived managers below
+    QNetworkAccessManager anchor;
+    anchor.setSharedConnectionPoolEnabled(shared);
+
+    for (int m = 0; m < managers; ++m) {
+        QNetworkAccessManager manager;
+        manager.setSharedConnectionPoolEnabled(shared);
+        for (int r = 0; r < rounds; ++r) {
+            QElapsedTimer timer;
+            int pending = parallel;
+            timer.start();
+            for (int i = 0; i < parallel; ++i) {
+                QNetworkReply *reply = manager.get(QNetworkRequest(url));
+                connect(reply, &QNetworkReply::finished, [&, reply]() {
+                    latencies.append(timer.nsecsElapsed());
+                    reply->deleteLater();
+                    if (--pending == 0)
+                        QTestEventLoop::instance().exitLoop();
+                });
+            }
+            QTestEventLoop::instance().enterLoop(10);
+            if (QTestEventLoop::instance().timeout())
+                return QVector<qint64>();
+        }
+    }
+    return latencies;
+}
+
+void tst_qnetworkaccessmanager_connectionpool::shortLivedManagers_data()
+{
+    QTest::addColumn<bool>("shared");
+    QTest::addColumn<int>("parallel");
+
+    QTest::newRow("own-pool-1") << false << 1;
+    QTest::newRow("shared-pool-1") << true << 1;
+    QTest::newRow("own-pool-4") << false << 4;
+    QTest::newRow("shared-pool-4") << true << 4;
+}
+
+void tst_qnetworkaccessmanager_connectionpool::shortLivedManagers()
+{
+    QFETCH(bool, shared);
+    QFETCH(int, parallel);
+    const int managers = 32;
+    const int rounds = 4;
+
+    // one untimed pass to get the host lookup and the thread start-up out of the way
+    QVERIFY(!runManagers(shared, 1, parallel, 1).isEmpty());
+
+    server->resetCounters();
+    QVector<qint64> latencies = runManagers(shared, managers, parallel, rounds);
+    QCOMPARE(latencies.size(), managers * parallel * rounds);
+
+    std::sort(latencies.begin(), latencies.end());
+    const qint64 p50 = latencies.at(latencies.size() / 2);
+    const qint64 p99 = latencies.at((latencies.size() * 99) / 100);
+    qDebug() << "handshakes:" << server->acceptedConnections()
+             << "p50:" << p50 / 1000 << "us p99:" << p99 / 1000 << "us";
+
+    // the tail latency is what the shared pool is meant to improve
+    QTest::setBenchmarkResult(p99, QTest::WalltimeNanoseconds);
+}
+
+QTEST_MAIN(tst_qnetworkaccessmanager_connectionpool)
+
+#include "tst_qnetworkaccessmanager_connectionpool.moc"
@@ -52,6 +52,12 @@ private slots:
     void benchmark();
     void benchmarkSelectPrepared_data() { generic_data(); }
     void benchmarkSelectPrepared();
+    void benchmarkInsertPrepared_data() { generic_data(); }
+    void benchmarkInsertPrepared();
+    void benchmarkInsertBatch_data() { generic_data(); }
+    void benchmarkInsertBatch();
+    void benchmarkPrepareRepeated_data() { generic_data(); }
+    void benchmarkPrepareRepeated();
 
 private:
     // returns all database connections
@@ -299,4 +305,89 @@ void tst_QSqlQuery::benchmarkSelectPrepared()
     tst_Databases::safeDropTable(db, tableName);
 }
 
+void tst_QSqlQuery::benchmarkInsertPrepared()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQuery q(db);
+    const QString tableName(qTableName("benchmark", __FILE__, db));
+
+    tst_Databases::safeDropTable(db, tableName);
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + "(id INT NOT NULL, name VARCHAR(20))"));
+
+    const int NUM_ROWS = 1000;
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?)"));
+    QBENCHMARK {
+        QVERIFY(db.transaction());
+        for (int i = 0; i < NUM_ROWS; ++i) {
+            q.bindValue(0, i);
+            q.bindValue(1, QString::number(i));
+            QVERIFY_SQL(q, exec());
+        }
+        QVERIFY(db.commit());
+    }
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+void tst_QSqlQuery::benchmarkInsertBatch()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQuery q(db);
+    const QString tableName(qTableName("benchmark", __FILE__, db));
+
+    tst_Databases::safeDropTable(db, tableName);
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + "(id INT NOT NULL, name VARCHAR(20))"));
+
+    const int NUM_ROWS = 1000;
+    QVariantList ids;
+    QVariantList names;
+    for (int i = 0; i < NUM_ROWS; ++i) {
+        ids << i;
+        names << QString::number(i);
+    }
+
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?)"));
+    QBENCHMARK {
+        q.addBindValue(ids);
+        q.addBindValue(names);
+        QVERIFY_SQL(q, execBatch());
+    }
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+void tst_QSqlQuery::benchmarkPrepareRepeated()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+
+    QSqlQuery q(db);
+    const QString tableName(qTableName("benchmark", __FILE__, db));
+
+    tst_Databases::safeDropTable(db, tableName);
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + "(id INT NOT NULL, name VARCHAR(20))"));
+    QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " VALUES (1, 'one')"));
+
+    const QString selectQuery = "SELECT name FROM " + tableName + " WHERE id = ?";
+    QBENCHMARK {
+        QSqlQuery select(db);
+        QVERIFY_SQL(select, prepare(selectQuery));
+        select.addBindValue(1);
+        QVERIFY_SQL(select, exec());
+        QVERIFY(select.next());
+    }
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
 #include "main.moc"